@@ -24,6 +24,7 @@
 #include "dgn-overview.h"
 #include "dgn-proclayouts.h"
 #include "files.h"
+#include "hash.h"
 #include "hiscores.h"
 #include "itemprop.h"
 #include "items.h"
@@ -64,6 +65,27 @@ static ProceduralLayout *abyssLayout = nullptr, *levelLayout = nullptr;
 typedef priority_queue<ProceduralSample, vector<ProceduralSample>, ProceduralSamplePQCompare> sample_queue;
 
 static sample_queue abyss_sample_queue;
+
+// Samples already taken at the current depth, by absolute coordinate.
+// The layouts are pure functions of (coordinate, depth), and a morph
+// revisits the same cells -- and pops the same queued changepoints --
+// several times per depth step, so a repeat can reuse the first result.
+// A repeated sample is also already in the queue and need not be pushed
+// again.
+struct abyss_sample_memo
+{
+    abyss_sample_memo() : depth(0), feat(DNGN_UNSEEN), changepoint(0),
+                          mask(MMT_NONE), valid(false) { }
+
+    coord_def pos;
+    uint32_t depth;
+    dungeon_feature_type feat;
+    uint32_t changepoint;
+    map_mask_type mask;
+    bool valid;
+};
+static const int ABYSS_SAMPLE_MEMO_SIZE = 8192;
+static abyss_sample_memo abyss_sample_memos[ABYSS_SAMPLE_MEMO_SIZE];
 static vector<dungeon_feature_type> abyssal_features;
 static list<monster*> displaced_monsters;
 
@@ -235,7 +257,7 @@ static void _abyss_postvault_fixup()
 static bool _abyss_place_rune_vault(const map_bitmask &abyss_genlevel_mask)
 {
     // Make sure we're not about to link bad items.
-    debug_item_scan();
+    debug_item_scan(false);
 
     bool result = false;
     int tries = 10;
@@ -861,12 +883,6 @@ static void _abyss_identify_area_to_shift(coord_def source, int radius,
         _abyss_expand_mask_to_cover_vault(mask, i);
 }
 
-static void _abyss_invert_mask(map_bitmask *mask)
-{
-    for (rectangle_iterator ri(0); ri; ++ri)
-        mask->set(*ri, !mask->get(*ri));
-}
-
 // Moves everything in the given radius around the player (where radius=0 =>
 // only the player) to another part of the level, centred on target_centre.
 // Everything not in the given radius is wiped to DNGN_UNSEEN and the provided
@@ -929,7 +945,7 @@ static void _abyss_shift_level_contents_around_player(
     // So far we've used the mask to track the portions of the level we're
     // preserving. The inverse of the mask represents the area to be filled
     // with brand new abyss:
-    _abyss_invert_mask(&abyss_destruction_mask);
+    abyss_destruction_mask.flip();
 
     // Update env.level_vaults to discard any vaults that are no longer in
     // the picture.
@@ -1055,10 +1071,23 @@ const static RiverLayout rivers(1800, baseLayout);
 // This one is not fixed: [0] is a level pulled from the current game
 static vector<const ProceduralLayout*> complex_vec(2);
 
+// Forget the memoised samples; needed whenever the layout or the sample
+// queue is thrown away.
+static void _clear_abyss_sample_memos()
+{
+    for (abyss_sample_memo &memo : abyss_sample_memos)
+        memo.valid = false;
+}
+
 static ProceduralSample _abyss_grid(const coord_def &p)
 {
     const coord_def pt = p + abyssal_state.major_coord;
 
+    abyss_sample_memo &memo =
+        abyss_sample_memos[hash3(pt.x, pt.y, 0) % ABYSS_SAMPLE_MEMO_SIZE];
+    if (memo.valid && memo.pos == pt && memo.depth == abyssal_state.depth)
+        return ProceduralSample(pt, memo.feat, memo.changepoint, memo.mask);
+
     if (_in_wastes(pt))
     {
         ProceduralSample sample = wastes(pt, abyssal_state.depth);
@@ -1073,11 +1102,19 @@ static ProceduralSample _abyss_grid(const coord_def &p)
         complex_vec[0] = levelLayout;
         complex_vec[1] = &rivers; // const
         abyssLayout = new WorleyLayout(23571113, complex_vec, 6.1);
+        _clear_abyss_sample_memos();
     }
 
     const ProceduralSample sample = (*abyssLayout)(pt, abyssal_state.depth);
     ASSERT(sample.feat() > DNGN_UNSEEN);
 
+    memo.pos = pt;
+    memo.depth = abyssal_state.depth;
+    memo.feat = sample.feat();
+    memo.changepoint = sample.changepoint();
+    memo.mask = sample.mask();
+    memo.valid = true;
+
     abyss_sample_queue.push(sample);
     return sample;
 }
@@ -1356,7 +1393,7 @@ static void _generate_area(const map_bitmask &abyss_genlevel_mask)
     _abyss_apply_terrain(abyss_genlevel_mask);
 
     // Make sure we're not about to link bad items.
-    debug_item_scan();
+    debug_item_scan(false);
     _abyss_place_vaults(abyss_genlevel_mask);
 
     // Link the vault-placed items.
@@ -1381,6 +1418,7 @@ static void _initialize_abyss_state()
     abyssal_state.destroy_all_terrain = false;
     abyssal_state.level = _get_random_level();
     abyss_sample_queue = sample_queue(ProceduralSamplePQCompare());
+    _clear_abyss_sample_memos();
 }
 
 void set_abyss_state(coord_def coord, uint32_t depth)
@@ -1391,6 +1429,7 @@ void set_abyss_state(coord_def coord, uint32_t depth)
     abyssal_state.phase = 0.0;
     abyssal_state.destroy_all_terrain = true;
     abyss_sample_queue = sample_queue(ProceduralSamplePQCompare());
+    _clear_abyss_sample_memos();
     you.moveto(ABYSS_CENTRE);
     map_bitmask abyss_genlevel_mask(true);
     _abyss_apply_terrain(abyss_genlevel_mask, true, true);
@@ -1430,7 +1469,9 @@ static void abyss_area_shift()
     place_transiting_monsters();
     place_transiting_items();
 
-    check_map_validity();
+    // This happens on every shift, so leave the slow checks for level
+    // creation (or debug builds and wizmode).
+    check_map_validity(false);
 }
 
 void destroy_abyss()
@@ -1442,6 +1483,7 @@ void destroy_abyss()
         delete levelLayout;
         levelLayout = nullptr;
     }
+    _clear_abyss_sample_memos();
 }
 
 static colour_t _roll_abyss_floor_colour()
@@ -5,9 +5,133 @@
 #include "env.h"
 #include "losglobal.h"
 
+// Monster slots past this have not been used on this level.
+static int _mons_slot_end()
+{
+    return min<int>(env.mons_slots_used, MAX_MONSTERS);
+}
+
+// A coarse grid of buckets, each with a bit for every monster slot that
+// may stand in it. Bits can be stale (a monster that died or was reset),
+// but every live monster in menv has its bit set in the bucket it is in.
+#define MONS_BUCKET_SHIFT 4
+static const int MONS_BUCKETS_X = ((GXM - 1) >> MONS_BUCKET_SHIFT) + 1;
+static const int MONS_BUCKETS_Y = ((GYM - 1) >> MONS_BUCKET_SHIFT) + 1;
+static const int MONS_BUCKET_WORDS = (MAX_MONSTERS + 63) / 64;
+static uint64_t _mons_buckets[MONS_BUCKETS_X][MONS_BUCKETS_Y][MONS_BUCKET_WORDS];
+
+static void _mons_bucket_set(int mi, const coord_def &p, bool on)
+{
+    // The origin is where monsters off the level are kept.
+    if (!map_bounds(p) || p.origin())
+        return;
+
+    uint64_t &word = _mons_buckets[p.x >> MONS_BUCKET_SHIFT]
+                                  [p.y >> MONS_BUCKET_SHIFT][mi / 64];
+    const uint64_t bit = (uint64_t)1 << (mi % 64);
+    if (on)
+        word |= bit;
+    else
+        word &= ~bit;
+}
+
+void mons_index_moved(const monster* mons, const coord_def &oldpos)
+{
+    // Scratch and saved copies of monsters live outside menv.
+    if (mons < menv.buffer() || mons >= menv.buffer() + MAX_MONSTERS)
+        return;
+
+    const int mi = mons->mindex();
+    _mons_bucket_set(mi, oldpos, false);
+    _mons_bucket_set(mi, mons->pos(), true);
+}
+
+void mons_index_clear()
+{
+    memset(_mons_buckets, 0, sizeof(_mons_buckets));
+}
+
+void mons_index_rebuild()
+{
+    mons_index_clear();
+    for (int mi = 0; mi < MAX_MONSTERS; ++mi)
+        if (menv[mi].type != MONS_NO_MONSTER)
+            _mons_bucket_set(mi, menv[mi].pos(), true);
+}
+
+// The buckets that can hold a monster within LOS range of c, or an empty
+// span (br < tl) if the query has to look at every monster.
+static void _near_buckets(const coord_def &c, los_type los,
+                          coord_def &tl, coord_def &br)
+{
+    tl = coord_def(0, 0);
+    br = coord_def(-1, -1);
+    if (los == LOS_NONE || !map_bounds(c))
+        return;
+
+    tl.x = max(c.x - LOS_MAX_RANGE, 0) >> MONS_BUCKET_SHIFT;
+    tl.y = max(c.y - LOS_MAX_RANGE, 0) >> MONS_BUCKET_SHIFT;
+    br.x = min(c.x + LOS_MAX_RANGE, GXM - 1) >> MONS_BUCKET_SHIFT;
+    br.y = min(c.y + LOS_MAX_RANGE, GYM - 1) >> MONS_BUCKET_SHIFT;
+}
+
+// Step i to the next monster slot that might be in range of a near query
+// over the given buckets. Returns false once there are no more slots.
+static bool _next_near_slot(int &i, const coord_def &tl, const coord_def &br)
+{
+    const int end = _mons_slot_end();
+    if (++i >= end)
+        return false;
+
+    if (br.x < tl.x)
+        return true;
+
+    for (int w = i / 64; w * 64 < end; ++w)
+    {
+        uint64_t bits = 0;
+        for (int bx = tl.x; bx <= br.x; ++bx)
+            for (int by = tl.y; by <= br.y; ++by)
+                bits |= _mons_buckets[bx][by][w];
+        if (w == i / 64)
+            bits &= ~(uint64_t)0 << (i % 64);
+        if (!bits)
+            continue;
+
+        i = w * 64;
+        while (!(bits & 1))
+        {
+            bits >>= 1;
+            ++i;
+        }
+        return i < end;
+    }
+    return false;
+}
+
+vector<coord_def> monster_cells_near(const coord_def &c, int range)
+{
+    const coord_def tl(max(c.x - range, 0) >> MONS_BUCKET_SHIFT,
+                       max(c.y - range, 0) >> MONS_BUCKET_SHIFT);
+    const coord_def br(min(c.x + range, GXM - 1) >> MONS_BUCKET_SHIFT,
+                       min(c.y + range, GYM - 1) >> MONS_BUCKET_SHIFT);
+
+    vector<coord_def> cells;
+    for (int i = -1; _next_near_slot(i, tl, br);)
+    {
+        const coord_def p = menv[i].pos();
+        if (map_bounds(p) && grid_distance(c, p) <= range
+            && mgrd(p) == i)
+        {
+            cells.push_back(p);
+        }
+    }
+    return cells;
+}
+
 actor_near_iterator::actor_near_iterator(coord_def c, los_type los)
     : center(c), _los(los), viewer(nullptr), i(-1)
 {
+    _near_buckets(center, _los, bucket_tl, bucket_br);
     if (!valid(&you))
         advance();
 }
@@ -15,6 +139,7 @@ actor_near_iterator::actor_near_iterator(coord_def c, los_type los)
 actor_near_iterator::actor_near_iterator(const actor* a, los_type los)
     : center(a->pos()), _los(los), viewer(a), i(-1)
 {
+    _near_buckets(center, _los, bucket_tl, bucket_br);
     if (!valid(&you))
         advance();
 }
@@ -64,25 +189,28 @@ bool actor_near_iterator::valid(const actor* a) const
 void actor_near_iterator::advance()
 {
     do
-         if (++i >= MAX_MONSTERS)
+         if (!_next_near_slot(i, bucket_tl, bucket_br))
+         {
+             i = MAX_MONSTERS;
              return;
+         }
     while (!valid(**this));
 }
 
 //////////////////////////////////////////////////////////////////////////
 
 monster_near_iterator::monster_near_iterator(coord_def c, los_type los)
-    : center(c), _los(los), viewer(nullptr), i(0)
+    : center(c), _los(los), viewer(nullptr), i(-1)
 {
-    if (!valid(&menv[0]))
-        advance();
+    _near_buckets(center, _los, bucket_tl, bucket_br);
+    advance();
 }
 
 monster_near_iterator::monster_near_iterator(const actor *a, los_type los)
-    : center(a->pos()), _los(los), viewer(a), i(0)
+    : center(a->pos()), _los(los), viewer(a), i(-1)
 {
-    if (!valid(&menv[0]))
-        advance();
+    _near_buckets(center, _los, bucket_tl, bucket_br);
+    advance();
 }
 
 monster_near_iterator::operator bool() const
@@ -128,18 +256,20 @@ bool monster_near_iterator::valid(const monster* a) const
 void monster_near_iterator::advance()
 {
     do
-         if (++i >= MAX_MONSTERS)
+         if (!_next_near_slot(i, bucket_tl, bucket_br))
+         {
+             i = MAX_MONSTERS;
              return;
+         }
     while (!valid(**this));
 }
 
 //////////////////////////////////////////////////////////////////////////
 
 monster_iterator::monster_iterator()
-    : i(0)
+    : i(-1)
 {
-    while (i < MAX_MONSTERS && !menv[i].alive())
-        i++;
+    ++(*this);
 }
 
 monster_iterator::operator bool() const
@@ -162,9 +292,11 @@ monster* monster_iterator::operator->() const
 
 monster_iterator& monster_iterator::operator++()
 {
-    while (++i < MAX_MONSTERS)
+    const int end = _mons_slot_end();
+    while (++i < end)
         if (menv[i].alive())
-            break;
+            return *this;
+    i = MAX_MONSTERS;
     return *this;
 }
 
@@ -177,8 +309,5 @@ monster_iterator monster_iterator::operator++(int)
 
 void monster_iterator::advance()
 {
-    do
-         if (++i >= MAX_MONSTERS)
-             return;
-    while (!(*this)->alive());
+    ++(*this);
 }
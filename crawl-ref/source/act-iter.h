@@ -23,6 +23,9 @@ protected:
     los_type _los;
     const actor* viewer;
     int i;
+    // Index buckets overlapping the range of center, or an empty span for
+    // a full scan.
+    coord_def bucket_tl, bucket_br;
 
     bool valid(const actor* a) const;
     void advance();
@@ -45,6 +48,9 @@ protected:
     los_type _los;
     const actor* viewer;
     int i;
+    // Index buckets overlapping the range of center, or an empty span for
+    // a full scan.
+    coord_def bucket_tl, bucket_br;
 
     bool valid(const monster* a) const;
     void advance();
@@ -66,4 +72,16 @@ protected:
     void advance();
 };
 
+// Maintain the spatial index of monster slots that the near iterators use
+// to skip monsters out of range. Every position change of a monster in menv
+// goes through actor::set_position() or monster::init_with(), which call
+// mons_index_moved(); loading or restoring a level rebuilds the index.
+void mons_index_moved(const monster* mons, const coord_def &oldpos);
+void mons_index_clear();
+void mons_index_rebuild();
+
+// The cells within grid distance range of c that hold a monster, in no
+// particular order; found through the index rather than by scanning cells.
+vector<coord_def> monster_cells_near(const coord_def &c, int range);
+
 #endif
@@ -152,6 +152,8 @@ void actor::set_position(const coord_def &c)
 {
     const coord_def oldpos = position;
     position = c;
+    if (!is_player())
+        mons_index_moved(as_monster(), oldpos);
     los_actor_moved(this, oldpos);
     areas_actor_moved(this, oldpos);
 }
@@ -56,15 +56,59 @@ struct area_centre
 
 typedef FixedArray<areaprops, GXM, GYM> propgrid_t;
 
+// The number of distinct areaprops.
+static const int NUM_AREAPROPS = 12;
+
+// What one actor (or the sunlight) contributed to the grid, so that when an
+// aura-bearer moves we can lift its old footprint and stamp the new one
+// rather than rebuilding everything.
+struct area_source
+{
+    mid_t mid;                      // MID_NOBODY for sunlight
+    coord_def pos;
+    vector<size_t> centres;         // indices into _agrid_centres
+    vector<pair<coord_def, areaprop>> stamps;
+};
+
 static vector<area_centre> _agrid_centres;
+static vector<area_source> _agrid_sources;
+// How many sources set each areaprop on each cell.
+static FixedArray<FixedVector<uint16_t, NUM_AREAPROPS>, GXM, GYM>
+    _agrid_counts;
+// Liquefaction depends on the terrain under it, which can change without
+// the grid being invalidated, so its presence forces full rebuilds.
+static bool _agrid_has_liquid = false;
+static area_source *_stamping = nullptr;
 
 static propgrid_t _agrid;
 static bool _agrid_valid = false;
 static bool no_areas = false;
 
+static agrid_stats _agrid_stats;
+
+static int _areaprop_index(areaprop f)
+{
+    int i = 0;
+    while (i < NUM_AREAPROPS && areaprops::exponent(i) != f)
+        ++i;
+    ASSERT(i < NUM_AREAPROPS);
+    return i;
+}
+
 static void _set_agrid_flag(const coord_def& p, areaprop f)
 {
     _agrid(p) |= f;
+    ++_agrid_counts(p)[_areaprop_index(f)];
+    if (_stamping)
+        _stamping->stamps.emplace_back(p, f);
+}
+
+static void _unset_agrid_flag(const coord_def& p, areaprop f)
+{
+    uint16_t &count = _agrid_counts(p)[_areaprop_index(f)];
+    ASSERT(count > 0);
+    if (!--count)
+        _agrid(p) &= ~areaprops(f);
 }
 
 static bool _check_agrid_flag(const coord_def& p, areaprop f)
@@ -77,8 +121,21 @@ void invalidate_agrid(bool recheck_new)
     _agrid_valid = false;
     if (recheck_new)
         no_areas = false;
+    _agrid_stats.invalidations++;
+}
+
+const agrid_stats& get_agrid_stats()
+{
+    return _agrid_stats;
+}
+
+void reset_agrid_stats()
+{
+    _agrid_stats = agrid_stats();
 }
 
+static bool _move_area_source(const actor *act, const coord_def &oldpos);
+
 void areas_actor_moved(const actor* act, const coord_def& oldpos)
 {
     if (act->alive() &&
@@ -90,6 +147,9 @@ void areas_actor_moved(const actor* act, const coord_def& oldpos)
 #endif
          ))
     {
+        if (!you.entering_level && _move_area_source(act, oldpos))
+            return;
+
         // Not necessarily new, but certainly potentially interesting.
         invalidate_agrid(true);
     }
@@ -120,6 +180,7 @@ static void _actor_areas(actor *a)
     if ((r = a->liquefying_radius()) >= 0)
     {
         _agrid_centres.emplace_back(AREA_LIQUID, a->pos(), r);
+        _agrid_has_liquid = true;
 
         for (radius_iterator ri(a->pos(), r, C_SQUARE, LOS_SOLID); ri; ++ri)
         {
@@ -154,29 +215,9 @@ static void _actor_areas(actor *a)
 #endif
 }
 
-/**
- * Update the area grid cache.
- *
- * Updates the _agrid FixedArray of grid information flags using the
- * areaprop types.
- */
-static void _update_agrid()
+// The areas centred on the player that don't come from an aura of theirs.
+static void _player_areas()
 {
-    if (no_areas)
-    {
-        _agrid_valid = true;
-        return;
-    }
-
-    _agrid.init(areaprops());
-    _agrid_centres.clear();
-
-    no_areas = true;
-
-    _actor_areas(&you);
-    for (monster_iterator mi; mi; ++mi)
-        _actor_areas(*mi);
-
     if (player_has_orb() && !you.pos().origin())
     {
         const int r = 2;
@@ -211,7 +252,80 @@ static void _update_agrid()
         }
         no_areas = false;
     }
+}
+
+// Add an actor's auras, recording them as one source if it has any.
+static void _add_area_source(actor *a)
+{
+    area_source src;
+    src.mid = a->mid;
+    src.pos = a->pos();
+    const size_t first = _agrid_centres.size();
+
+    _stamping = &src;
+    _actor_areas(a);
+    _stamping = nullptr;
+
+    for (size_t i = first; i < _agrid_centres.size(); ++i)
+        src.centres.push_back(i);
+    if (!src.centres.empty())
+        _agrid_sources.push_back(move(src));
+}
+
+/**
+ * Update the area grid cache.
+ *
+ * Updates the _agrid FixedArray of grid information flags using the
+ * areaprop types.
+ */
+static void _update_agrid()
+{
+    if (no_areas)
+    {
+        _agrid_valid = true;
+        return;
+    }
+
+    _agrid_stats.rebuilds++;
+    _agrid.init(areaprops());
+    _agrid_counts.init(FixedVector<uint16_t, NUM_AREAPROPS>(0));
+    _agrid_centres.clear();
+    _agrid_sources.clear();
+    _agrid_has_liquid = false;
+
+    no_areas = true;
+
+    // The player's own auras and the ones centred on them count as a
+    // single source, though the latter are listed after every monster's.
+    _add_area_source(&you);
+    for (monster_iterator mi; mi; ++mi)
+        _add_area_source(*mi);
+    {
+        area_source *player_src = nullptr;
+        if (!_agrid_sources.empty() && _agrid_sources[0].mid == MID_PLAYER)
+            player_src = &_agrid_sources[0];
+
+        area_source extras;
+        const size_t first = _agrid_centres.size();
+        _stamping = player_src ? player_src : &extras;
+        _player_areas();
+        _stamping = nullptr;
+        if (_agrid_centres.size() > first)
+        {
+            if (!player_src)
+            {
+                extras.mid = MID_PLAYER;
+                extras.pos = you.pos();
+                _agrid_sources.insert(_agrid_sources.begin(), move(extras));
+                player_src = &_agrid_sources[0];
+            }
+            for (size_t i = first; i < _agrid_centres.size(); ++i)
+                player_src->centres.push_back(i);
+        }
+    }
 
+    // Sunlight never moves, so needn't be recorded as a source; its counts
+    // keep a moving halo from clearing it.
     if (!env.sunlight.empty())
     {
         for (const auto &entry : env.sunlight)
@@ -224,6 +338,64 @@ static void _update_agrid()
     _agrid_valid = true;
 }
 
+/**
+ * Move one aura-bearer's areas with it, if the cache is otherwise still good.
+ *
+ * Everything that changes an aura's size invalidates the grid, so if the
+ * mover's areas come out with the same types and radii as before, the rest
+ * of the grid is as a rebuild would make it.
+ *
+ * @return whether the grid was updated; if not, it needs a rebuild.
+ */
+static bool _move_area_source(const actor *act, const coord_def &oldpos)
+{
+    if (!_agrid_valid || no_areas || _agrid_has_liquid)
+        return false;
+
+    auto src = find_if(_agrid_sources.begin(), _agrid_sources.end(),
+                       [act](const area_source &as)
+                       { return as.mid == act->mid; });
+    if (src == _agrid_sources.end() || src->pos != oldpos)
+        return false;
+
+    for (const auto &stamp : src->stamps)
+        _unset_agrid_flag(stamp.first, stamp.second);
+    src->stamps.clear();
+
+    // Stamp the new footprint, with its centres added to the end for now.
+    const size_t first = _agrid_centres.size();
+    _stamping = &*src;
+    _actor_areas(const_cast<actor *>(act));
+    if (act->is_player())
+        _player_areas();
+    _stamping = nullptr;
+
+    bool same = _agrid_centres.size() - first == src->centres.size()
+                && !_agrid_has_liquid;
+    for (size_t i = 0; same && i < src->centres.size(); ++i)
+    {
+        const area_centre &was = _agrid_centres[src->centres[i]];
+        const area_centre &now = _agrid_centres[first + i];
+        same = was.type == now.type && was.radius == now.radius;
+    }
+    if (!same)
+    {
+        _agrid_centres.erase(_agrid_centres.begin() + first,
+                             _agrid_centres.end());
+        return false;
+    }
+
+    // Put the centres back where they were, so find_centre_for breaks ties
+    // in the same order.
+    for (size_t i = 0; i < src->centres.size(); ++i)
+        _agrid_centres[src->centres[i]] = _agrid_centres[first + i];
+    _agrid_centres.erase(_agrid_centres.begin() + first,
+                         _agrid_centres.end());
+    src->pos = act->pos();
+    _agrid_stats.moves++;
+    return true;
+}
+
 static area_centre_type _get_first_area(const coord_def& f)
 {
     areaprops a = _agrid(f);
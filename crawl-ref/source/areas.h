@@ -19,6 +19,18 @@ enum area_centre_type
 
 void invalidate_agrid(bool recheck_new = false);
 
+struct agrid_stats
+{
+    uint64_t rebuilds;      // full rebuilds of the area grid
+    uint64_t moves;         // aura-bearer moves applied without one
+    uint64_t invalidations; // invalidate_agrid() calls
+
+    agrid_stats() : rebuilds(0), moves(0), invalidations(0) { }
+};
+
+const agrid_stats& get_agrid_stats();
+void reset_agrid_stats();
+
 class actor;
 void areas_actor_moved(const actor* act, const coord_def& oldpos);
 
@@ -7,12 +7,19 @@
 
 #include "arena.h"
 
+#include <cerrno>
+#ifndef TARGET_OS_WINDOWS
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
 #include "act-iter.h"
 #include "colour.h"
 #include "command.h"
 #include "dungeon.h"
 #include "end.h"
 #include "food.h"
+#include "initfile.h"
 #include "itemname.h"
 #include "items.h"
 #include "libutil.h"
@@ -26,9 +33,11 @@
 #include "mon-pick.h"
 #include "mon-tentacle.h"
 #include "ng-init.h"
+#include "random.h"
 #include "spl-miscast.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "teleport.h"
 #include "terrain.h"
 #ifdef USE_TILE
@@ -40,6 +49,10 @@
 
 #define ARENA_VERBOSE
 
+// A batch fight still going after this many turns is called a tie.
+#define ARENA_BATCH_MAX_TURNS 20000
+#define ARENA_BATCH_MAX_TRIALS 100000
+
 extern void world_reacts();
 
 namespace arena
@@ -82,6 +95,9 @@ namespace arena
 
     static string teams;
 
+    // Set for -arena-batch: no display, input, delays or results file.
+    static bool batch = false;
+
     static int total_trials = 0;
 
     static bool contest_cancelled = false;
@@ -270,7 +286,8 @@ namespace arena
             env.floor_colour = LIGHTGREY;
 
 #ifdef USE_TILE
-        tile_new_level(true);
+        if (!batch)
+            tile_new_level(true);
 #endif
         los_changed();
         env.markers.activate_all();
@@ -328,7 +345,8 @@ namespace arena
         random_uniques = strip_tag(spec, "random_uniques");
 
         const int ntrials = strip_number_tag(spec, "t:");
-        if (ntrials != TAG_UNFOUND && ntrials >= 1 && ntrials <= 99
+        if (ntrials != TAG_UNFOUND && ntrials >= 1
+            && ntrials <= (batch ? ARENA_BATCH_MAX_TRIALS : 99)
             && !total_trials)
         {
             total_trials = ntrials;
@@ -426,6 +444,9 @@ namespace arena
 
     static void show_fight_banner(bool after_fight = false)
     {
+        if (batch)
+            return;
+
         int line = 1;
 
         cgotoxy(1, line++, GOTO_STAT);
@@ -772,13 +793,22 @@ namespace arena
 
     static void do_fight()
     {
-        viewwindow();
+        if (!batch)
+            viewwindow();
         clear_messages(true);
         {
-            cursor_control coff(false);
+            unique_ptr<cursor_control> coff(batch ? nullptr
+                                                  : new cursor_control(false));
             while (fight_is_on())
             {
-                if (kbhit())
+                if (batch && turns >= ARENA_BATCH_MAX_TURNS)
+                {
+                    trials_done++;
+                    ties++;
+                    return;
+                }
+
+                if (!batch && kbhit())
                 {
                     const int ch = getchm();
                     handle_keypress(ch);
@@ -796,7 +826,8 @@ namespace arena
                 if ((turns++ % 100) == 0)
                     count_foes();
 
-                viewwindow();
+                if (!batch)
+                    viewwindow();
                 you.time_taken = 10;
                 // Make sure we don't starve.
                 you.hunger = HUNGER_MAXIMUM;
@@ -806,12 +837,14 @@ namespace arena
                 do_respawn(faction_a);
                 do_respawn(faction_b);
                 balance_spawners();
-                delay(Options.view_delay);
+                if (!batch)
+                    delay(Options.view_delay);
                 clear_messages();
                 dump_messages();
                 ASSERT(you.pet_target == MHITNOT);
             }
-            viewwindow();
+            if (!batch)
+                viewwindow();
         }
 
         clear_messages();
@@ -888,17 +921,35 @@ namespace arena
         dump_messages();
     }
 
-    static void global_setup(const string& arena_teams)
+    // Clear the state that a monster spec sets up.
+    static void reset_spec()
     {
-        // Clear some things that shouldn't persist across restart_after_game.
-        // parse_monster_spec and setup_fight will clear the rest.
         total_trials = trials_done = team_a_wins = ties = 0;
         contest_cancelled = false;
         is_respawning = false;
-        uniques_list.clear();
         memset(banned_glyphs, 0, sizeof(banned_glyphs));
         arena_type = "";
         place = level_id(BRANCH_DEPTHS, 1);
+    }
+
+    static void init_uniques_list()
+    {
+        uniques_list.clear();
+        for (monster_type i = MONS_0; i < NUM_MONSTERS; ++i)
+        {
+            if (i == MONS_PLAYER_GHOST)
+                continue;
+
+            if (mons_is_unique(i) && !arena_veto_random_monster(i))
+                uniques_list.push_back(i);
+        }
+    }
+
+    static void global_setup(const string& arena_teams)
+    {
+        // Clear some things that shouldn't persist across restart_after_game.
+        // parse_monster_spec and setup_fight will clear the rest.
+        reset_spec();
 
         // [ds] Turning off view_lock crashes arena.
         Options.view_lock_x = Options.view_lock_y = true;
@@ -930,14 +981,7 @@ namespace arena
 
         expand_mlist(5);
 
-        for (monster_type i = MONS_0; i < NUM_MONSTERS; ++i)
-        {
-            if (i == MONS_PLAYER_GHOST)
-                continue;
-
-            if (mons_is_unique(i) && !arena_veto_random_monster(i))
-                uniques_list.push_back(i);
-        }
+        init_uniques_list();
     }
 
     static void global_shutdown()
@@ -1004,6 +1048,190 @@ namespace arena
 
         write_results();
     }
+
+    struct batch_result
+    {
+        int rounds = 0;
+        int a_wins = 0;
+        int b_wins = 0;
+        int ties = 0;
+        int errors = 0;
+        long long turns = 0;
+    };
+
+    static vector<string> read_batch_matchups(const string &filename)
+    {
+        FILE *f = fopen_u(filename.c_str(), "r");
+        if (!f)
+        {
+            end(1, true, "Can't read arena batch file %s",
+                filename.c_str());
+        }
+
+        vector<string> matchups;
+        char buf[1024];
+        while (fgets(buf, sizeof buf, f))
+        {
+            string line = trimmed_string(buf);
+            if (!line.empty() && line[0] != '#')
+                matchups.push_back(line);
+        }
+        fclose(f);
+        return matchups;
+    }
+
+    /**
+     * Run this job's share of the batch. Rounds are numbered across all the
+     * matchups, and job n of m runs every round whose number is n mod m.
+     */
+    static void run_batch_rounds(const vector<string> &matchups,
+                                 vector<batch_result> &results,
+                                 int job, int jobs)
+    {
+        int round = 0;
+        for (unsigned int i = 0; i < matchups.size(); ++i)
+        {
+            int mine = 0;
+            for (int r = 0; r < results[i].rounds; ++r, ++round)
+                if (round % jobs == job)
+                    mine++;
+            if (!mine)
+                continue;
+
+            reset_spec();
+            teams = matchups[i];
+            for (int r = 0; r < mine; ++r)
+            {
+                try
+                {
+                    setup_fight();
+                }
+                catch (const string &error)
+                {
+                    fprintf(stderr, "Arena matchup \"%s\": %s\n",
+                            matchups[i].c_str(), error.c_str());
+                    results[i].errors += mine - r;
+                    break;
+                }
+
+                const int a_before = team_a_wins;
+                const int ties_before = ties;
+                do_fight();
+
+                if (team_a_wins > a_before)
+                    results[i].a_wins++;
+                else if (ties > ties_before)
+                    results[i].ties++;
+                else
+                    results[i].b_wins++;
+                results[i].turns += turns;
+            }
+        }
+    }
+
+#ifndef TARGET_OS_WINDOWS
+    static string batch_worker_file(int job)
+    {
+        return make_stringf("arena.worker%d.tmp", job);
+    }
+
+    static bool run_batch_in_workers(const vector<string> &matchups,
+                                     vector<batch_result> &results, int jobs)
+    {
+        const uint64_t base_seed = get_uint64();
+        vector<pid_t> workers;
+        fflush(stdout);
+        for (int job = 0; job < jobs; ++job)
+        {
+            const pid_t pid = fork();
+            if (pid == -1)
+            {
+                fprintf(stderr, "Couldn't fork arena worker: %s\n",
+                        strerror(errno));
+                end(1);
+            }
+            if (pid == 0)
+            {
+                uint64_t seed[2] = { base_seed, uint64_t(job) };
+                seed_rng(seed, ARRAYSZ(seed));
+                vector<batch_result> part(results);
+                for (batch_result &res : part)
+                    res.a_wins = res.b_wins = res.ties = res.errors = 0;
+                run_batch_rounds(matchups, part, job, jobs);
+
+                FILE *f = fopen_u(batch_worker_file(job).c_str(), "w");
+                if (!f)
+                    _exit(1);
+                for (const batch_result &res : part)
+                {
+                    fprintf(f, "%d %d %d %d %lld\n", res.a_wins, res.b_wins,
+                            res.ties, res.errors, res.turns);
+                }
+                _exit(fclose(f) ? 1 : 0);
+            }
+            workers.push_back(pid);
+        }
+
+        bool all_success = true;
+        for (int job = 0; job < jobs; ++job)
+        {
+            int status = 0;
+            waitpid(workers[job], &status, 0);
+            const string worker_file = batch_worker_file(job);
+            FILE *f = nullptr;
+            bool success = WIFEXITED(status) && !WEXITSTATUS(status)
+                           && (f = fopen_u(worker_file.c_str(), "r"));
+            for (unsigned int i = 0; success && i < results.size(); ++i)
+            {
+                batch_result part;
+                success = fscanf(f, "%d %d %d %d %lld\n", &part.a_wins,
+                                 &part.b_wins, &part.ties, &part.errors,
+                                 &part.turns) == 5;
+                results[i].a_wins += part.a_wins;
+                results[i].b_wins += part.b_wins;
+                results[i].ties += part.ties;
+                results[i].errors += part.errors;
+                results[i].turns += part.turns;
+            }
+            if (!success)
+                fprintf(stderr, "Arena worker %d failed.\n", job);
+            if (f)
+                fclose(f);
+            unlink_u(worker_file.c_str());
+            all_success = all_success && success;
+        }
+        return all_success;
+    }
+#endif
+
+    static void write_batch_results(const vector<string> &matchups,
+                                    const vector<batch_result> &results)
+    {
+        const char *filename = "arena-batch.csv";
+        FILE *f = fopen_u(filename, "w");
+        if (!f)
+        {
+            fprintf(stderr, "Can't write %s: %s\n", filename,
+                    strerror(errno));
+            return;
+        }
+
+        fprintf(f, "matchup,rounds,a_wins,b_wins,ties,errors,a_win_rate,"
+                   "mean_turns\n");
+        for (unsigned int i = 0; i < matchups.size(); ++i)
+        {
+            const batch_result &res = results[i];
+            const int fought = res.a_wins + res.b_wins + res.ties;
+            fprintf(f, "\"%s\",%d,%d,%d,%d,%d,%.3f,%.1f\n",
+                    replace_all(matchups[i], "\"", "\"\"").c_str(),
+                    res.rounds, res.a_wins, res.b_wins, res.ties, res.errors,
+                    fought ? double(res.a_wins) / fought : 0.0,
+                    fought ? double(res.turns) / fought : 0.0);
+        }
+        fclose(f);
+        printf("Wrote results for %u matchups to %s\n",
+               (unsigned int)matchups.size(), filename);
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1281,9 +1509,14 @@ static bool _sort_by_age(int a, int b)
 // because of being polymorphed, rather than because of dying, are
 // culled earlier than they should be, but it's not like we have to be
 // fair to the arena monsters.
+//
+// This only runs when mitm[] is full, and then frees half of it, so the
+// scan and sort below are paid once per MAX_ITEMS / 2 new items; keeping
+// a separate age index up to date on every drop and pickup would cost more.
 int arena_cull_items()
 {
     vector<int> items;
+    items.reserve(MAX_ITEMS);
 
     int first_avail = NON_ITEM;
 
@@ -1390,3 +1623,57 @@ NORETURN void run_arena(const string& teams)
     arena::global_shutdown();
     game_ended();
 }
+
+/**
+ * Run every matchup in a file, one arena spec per line, without any display
+ * and write the win and turn counts to arena-batch.csv. Each matchup is
+ * fought for its t: rounds (default 1), split between -jobs workers.
+ */
+NORETURN void run_arena_batch(const string &filename)
+{
+    arena::batch = true;
+    crawl_state.type = GAME_TYPE_ARENA;
+    _init_arena();
+
+#ifdef WIZARD
+    unwind_bool wiz(you.wizard, true);
+#endif
+
+    // [ds] Turning off view_lock crashes arena.
+    Options.view_lock_x = Options.view_lock_y = true;
+
+    const vector<string> matchups = arena::read_batch_matchups(filename);
+    vector<arena::batch_result> results(matchups.size());
+
+    // Parse each spec once up front, to count its rounds.
+    for (unsigned int i = 0; i < matchups.size(); ++i)
+    {
+        arena::reset_spec();
+        arena::teams = matchups[i];
+        try
+        {
+            arena::parse_monster_spec();
+            results[i].rounds = max(arena::total_trials, 1);
+        }
+        catch (const string &error)
+        {
+            fprintf(stderr, "Arena matchup \"%s\": %s\n",
+                    matchups[i].c_str(), error.c_str());
+            results[i].errors = 1;
+        }
+    }
+    arena::init_uniques_list();
+    init_level_connectivity();
+
+    bool success = true;
+#ifndef TARGET_OS_WINDOWS
+    if (SysEnv.map_gen_jobs > 1)
+        success = arena::run_batch_in_workers(matchups, results,
+                                              SysEnv.map_gen_jobs);
+    else
+#endif
+        arena::run_batch_rounds(matchups, results, 0, 1);
+
+    arena::write_batch_results(matchups, results);
+    end(success ? 0 : 1, false);
+}
@@ -15,6 +15,7 @@ struct mgen_data;
 struct coord_def;
 
 NORETURN void run_arena(const string& teams);
+NORETURN void run_arena_batch(const string &filename);
 
 monster_type arena_pick_random_monster(const level_id &place);
 
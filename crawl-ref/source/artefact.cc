@@ -1060,15 +1060,40 @@ void artefact_properties(const item_def &item,
 int artefact_property(const item_def &item, artefact_prop_type prop,
                       bool &_known)
 {
-    artefact_properties_t  proprt;
-    artefact_known_props_t known;
-    proprt.init(0);
-    known.init(0);
+    // The same as artefact_properties(), but only for the one property
+    // asked for: this is called for every worn artefact whenever a
+    // resistance or the like is checked.
+    ASSERT(is_artefact(item));
+    _known = false;
+    if (!item.props.exists(KNOWN_PROPS_KEY))
+        return 0;
 
-    artefact_properties(item, proprt, known);
+    if (item_ident(item, ISFLAG_KNOW_PROPERTIES))
+        _known = true;
+    else
+    {
+        const CrawlStoreValue &_val = item.props[KNOWN_PROPS_KEY];
+        ASSERT(_val.get_type() == SV_VEC);
+        const CrawlVector &known_vec = _val.get_vector();
+        ASSERT(known_vec.get_type()     == SV_BOOL);
+        ASSERT(known_vec.size()         == ART_PROPERTIES);
+        _known = known_vec[prop].get_bool();
+    }
 
-    _known = known[prop];
+    if (item.props.exists(ARTEFACT_PROPS_KEY))
+    {
+        const CrawlVector &rap_vec =
+            item.props[ARTEFACT_PROPS_KEY].get_vector();
+        ASSERT(rap_vec.get_type()     == SV_SHORT);
+        ASSERT(rap_vec.size()         == ART_PROPERTIES);
+        return rap_vec[prop].get_short();
+    }
+    else if (is_unrandom_artefact(item))
+        return static_cast<short>(_seekunrandart(item)->prpty[prop]);
 
+    artefact_properties_t proprt;
+    proprt.init(0);
+    _get_randart_properties(item, proprt);
     return proprt[prop];
 }
 
@@ -1081,17 +1106,10 @@ int artefact_property(const item_def &item, artefact_prop_type prop)
 
 int artefact_known_property(const item_def &item, artefact_prop_type prop)
 {
-    artefact_properties_t  proprt;
-    artefact_known_props_t known;
-    proprt.init(0);
-    known.init(0);
-
-    artefact_properties(item, proprt, known);
+    bool known;
+    const int val = artefact_property(item, prop, known);
 
-    if (known[prop])
-        return proprt[prop];
-    else
-        return 0;
+    return known ? val : 0;
 }
 
 static int _artefact_num_props(const artefact_properties_t &proprt)
@@ -1121,6 +1139,7 @@ void artefact_learn_prop(item_def &item, artefact_prop_type prop)
         return;
 
     known_vec[prop] = static_cast<bool>(true);
+    item.name_memo.clear();
 }
 
 static string _get_artefact_type(const item_def &item, bool appear = false)
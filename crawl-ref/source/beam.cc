@@ -2161,6 +2161,88 @@ int silver_damages_victim(actor* victim, int damage, string &dmg_msg)
     return ret;
 }
 
+// Everything about a tracer that can change what it hits.
+struct tracer_memo_key
+{
+    spell_type origin_spell;
+    int range;
+    beam_type flavour, real_flavour;
+    coord_def source, target;
+    int dam_num, dam_size, ench_power, hit, ex_size, foe_ratio;
+    killer_type thrower;
+    mid_t source_id;
+    string name;
+    bool pierce, is_explosion, aimed_at_spot, affects_nothing, evoked;
+    bool use_target_as_pos, auto_hit, explode_only;
+    mon_attitude_type attitude;
+    ac_type ac_rule;
+    const item_def *item;
+    const bolt *special_explosion;
+
+    tracer_memo_key(const bolt &b, bool explode)
+        : origin_spell(b.origin_spell), range(b.range), flavour(b.flavour),
+          real_flavour(b.real_flavour), source(b.source), target(b.target),
+          dam_num(b.damage.num), dam_size(b.damage.size),
+          ench_power(b.ench_power), hit(b.hit), ex_size(b.ex_size),
+          foe_ratio(b.foe_ratio), thrower(b.thrower), source_id(b.source_id),
+          name(b.name), pierce(b.pierce), is_explosion(b.is_explosion),
+          aimed_at_spot(b.aimed_at_spot), affects_nothing(b.affects_nothing),
+          evoked(b.evoked), use_target_as_pos(b.use_target_as_pos),
+          auto_hit(b.auto_hit), explode_only(explode), attitude(b.attitude),
+          ac_rule(b.ac_rule), item(b.item),
+          special_explosion(b.special_explosion)
+    {
+    }
+
+    bool operator == (const tracer_memo_key &o) const
+    {
+        return origin_spell == o.origin_spell && range == o.range
+            && flavour == o.flavour && real_flavour == o.real_flavour
+            && source == o.source && target == o.target
+            && dam_num == o.dam_num && dam_size == o.dam_size
+            && ench_power == o.ench_power && hit == o.hit
+            && ex_size == o.ex_size && foe_ratio == o.foe_ratio
+            && thrower == o.thrower && source_id == o.source_id
+            && pierce == o.pierce && is_explosion == o.is_explosion
+            && aimed_at_spot == o.aimed_at_spot
+            && affects_nothing == o.affects_nothing && evoked == o.evoked
+            && use_target_as_pos == o.use_target_as_pos
+            && auto_hit == o.auto_hit && explode_only == o.explode_only
+            && attitude == o.attitude && ac_rule == o.ac_rule
+            && item == o.item && special_explosion == o.special_explosion
+            && name == o.name;
+    }
+};
+
+static bool _tracer_memo_active = false;
+static vector<pair<tracer_memo_key, bolt>> _tracer_memo;
+
+tracer_memo_scope::tracer_memo_scope() : outermost(!_tracer_memo_active)
+{
+    _tracer_memo_active = true;
+}
+
+tracer_memo_scope::~tracer_memo_scope()
+{
+    if (outermost)
+    {
+        _tracer_memo_active = false;
+        _tracer_memo.clear();
+    }
+}
+
+static void _fire_tracer_bolt(bolt &pbolt, bool explode_only)
+{
+    // Fire!
+    if (explode_only)
+        pbolt.explode(false);
+    else
+        pbolt.fire();
+
+    // Unset tracer flag (convenience).
+    pbolt.is_tracer = false;
+}
+
 //  Used by monsters in "planning" which spell to cast. Fires off a "tracer"
 //  which tells the monster what it'll hit if it breathes/casts etc.
 //
@@ -2202,14 +2284,23 @@ void fire_tracer(const monster* mons, bolt &pbolt, bool explode_only)
 
     pbolt.in_explosion_phase = false;
 
-    // Fire!
-    if (explode_only)
-        pbolt.explode(false);
-    else
-        pbolt.fire();
+    // A specific ray can't be compared cheaply, so don't remember those.
+    if (!_tracer_memo_active || pbolt.chose_ray)
+    {
+        _fire_tracer_bolt(pbolt, explode_only);
+        return;
+    }
 
-    // Unset tracer flag (convenience).
-    pbolt.is_tracer = false;
+    const tracer_memo_key key(pbolt, explode_only);
+    for (const auto &entry : _tracer_memo)
+        if (entry.first == key)
+        {
+            pbolt = entry.second;
+            return;
+        }
+
+    _fire_tracer_bolt(pbolt, explode_only);
+    _tracer_memo.emplace_back(key, pbolt);
 }
 
 static coord_def _random_point_hittable_from(const coord_def &c,
@@ -5983,9 +6074,11 @@ void bolt::refine_for_explosion()
     }
 }
 
+#define MAX_EXPLOSION_RADIUS 9
+
 typedef vector< vector<coord_def> > sweep_type;
 
-static sweep_type _radial_sweep(int r)
+static sweep_type _make_radial_sweep(int r)
 {
     sweep_type result;
 
@@ -6013,6 +6106,14 @@ static sweep_type _radial_sweep(int r)
     return result;
 }
 
+// The rings of the largest possible explosion; one of radius r uses the
+// first r + 1 of them.
+static const sweep_type &_radial_sweep()
+{
+    static const sweep_type sweep = _make_radial_sweep(MAX_EXPLOSION_RADIUS);
+    return sweep;
+}
+
 /** How much noise does an explosion this big make?
  *
  *  @param the size of the explosion (radius, not diamater)
@@ -6023,7 +6124,6 @@ int explosion_noise(int rad)
     return 10 + rad * 5;
 }
 
-#define MAX_EXPLOSION_RADIUS 9
 // Returns true if we saw something happening.
 bool bolt::explode(bool show_more, bool hole_in_the_middle)
 {
@@ -6090,16 +6190,16 @@ bool bolt::explode(bool show_more, bool hole_in_the_middle)
 
     // We get a bit fancy, drawing all radius 0 effects, then radius
     // 1, radius 2, etc. It looks a bit better that way.
-    const vector< vector<coord_def> > sweep = _radial_sweep(r);
+    const sweep_type &sweep = _radial_sweep();
     const coord_def centre(9,9);
 
     // Draw pass.
     if (!is_tracer)
     {
-        for (const auto &line : sweep)
+        for (int rad = 0; rad <= r; ++rad)
         {
             bool pass_visible = false;
-            for (const coord_def delta : line)
+            for (const coord_def delta : sweep[rad])
             {
                 if (delta.origin() && hole_in_the_middle)
                     continue;
@@ -6117,9 +6217,9 @@ bool bolt::explode(bool show_more, bool hole_in_the_middle)
 
     // Affect pass.
     int cells_seen = 0;
-    for (const auto &line : sweep)
+    for (int rad = 0; rad <= r; ++rad)
     {
-        for (const coord_def delta : line)
+        for (const coord_def delta : sweep[rad])
         {
             if (delta.origin() && hole_in_the_middle)
                 continue;
@@ -6233,6 +6333,14 @@ void bolt::determine_affected_cells(explosion_map& m, const coord_def& delta,
 
     m(delta + centre) = min(count, m(delta + centre));
 
+    // If we were at a wall, only move to squares the caster can see.
+    coord_def caster_pos;
+    if (at_wall)
+    {
+        const actor *caster = actor_by_mid(source_id);
+        caster_pos = caster ? caster->pos() : you.pos();
+    }
+
     // Now recurse in every direction.
     for (int i = 0; i < 8; ++i)
     {
@@ -6245,11 +6353,6 @@ void bolt::determine_affected_cells(explosion_map& m, const coord_def& delta,
         if (m(new_delta + centre) <= count)
             continue;
 
-        // If we were at a wall, only move to visible squares.
-        coord_def caster_pos = actor_by_mid(source_id) ?
-                                   actor_by_mid(source_id)->pos() :
-                                   you.pos();
-
         if (at_wall && !cell_see_cell(caster_pos, loc + Compass[i], LOS_NO_TRANS))
             continue;
 
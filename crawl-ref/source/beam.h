@@ -321,6 +321,19 @@ bool curare_actor(actor* source, actor* target, int levels, string name,
 int silver_damages_victim(actor* victim, int damage, string &dmg_msg);
 void fire_tracer(const monster* mons, bolt &pbolt,
                   bool explode_only = false);
+
+// While one of these is in scope, fire_tracer() remembers its results and
+// hands them back when the same tracer is fired again, rather than refiring.
+// Only use it where nothing on the level changes in between, such as while
+// a single monster is deciding what to cast.
+class tracer_memo_scope
+{
+public:
+    tracer_memo_scope();
+    ~tracer_memo_scope();
+private:
+    bool outermost;
+};
 bool imb_can_splash(coord_def origin, coord_def center,
                     vector<coord_def> path_taken, coord_def target);
 spret_type zapping(zap_type ztype, int power, bolt &pbolt,
@@ -187,6 +187,28 @@ public:
         data &= x.data;
         return *this;
     }
+
+    inline FixedBitArray<SIZEX, SIZEY>& operator^=(const FixedBitArray<SIZEX, SIZEY>&x)
+    {
+        data ^= x.data;
+        return *this;
+    }
+
+    // Invert every bit.
+    inline void flip()
+    {
+        data.flip();
+    }
+
+    inline unsigned int count() const
+    {
+        return data.count();
+    }
+
+    inline bool any() const
+    {
+        return data.any();
+    }
 };
 
 #endif
@@ -163,18 +163,13 @@ static void dump_section(dump_params &par)
 bool dump_char(const string &fname, bool quiet, bool full_id,
                const scorefile_entry *se)
 {
-    // Start with enough room for 100 80 character lines.
+    // Sections are written out one at a time, so this only ever holds the
+    // largest of them.
     string text;
     text.reserve(100 * 80);
 
     dump_params par(text, "", full_id, se);
 
-    for (const string &section : Options.dump_order)
-    {
-        par.section = section;
-        dump_section(par);
-    }
-
     return _write_dump(fname, par, quiet);
 }
 
@@ -1350,7 +1345,13 @@ static bool _write_dump(const string &fname, dump_params &par, bool quiet)
 
     if (handle != nullptr)
     {
-        fputs(OUTS(par.text), handle);
+        for (const string &section : Options.dump_order)
+        {
+            par.section = section;
+            dump_section(par);
+            fputs(OUTS(par.text), handle);
+            par.text.clear();
+        }
         fclose(handle);
         succeeded = true;
         if (!quiet)
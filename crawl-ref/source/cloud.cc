@@ -35,7 +35,7 @@
 
 cloud_struct* cloud_at(coord_def pos)
 {
-    return map_find(env.cloud, pos);
+    return env.cloud.find(pos);
 }
 
 /// A portrait of a cloud_type.
@@ -309,9 +309,10 @@ static int _spread_cloud(const cloud_struct &cloud)
         if (newdecay >= cloud.decay)
             newdecay = cloud.decay - 1;
 
-        env.cloud[*ai] = cloud;
-        env.cloud[*ai].pos = *ai;
-        env.cloud[*ai].decay = newdecay;
+        cloud_struct &spread = env.cloud[*ai];
+        spread = cloud;
+        spread.pos = *ai;
+        spread.decay = newdecay;
 
         extra_decay += 8;
     }
@@ -335,10 +336,11 @@ static void _spread_fire(const cloud_struct &cloud)
         // burning trees produce flames all around
         if (!cell_is_solid(*ai) && make_flames)
         {
-            env.cloud[*ai] = cloud;
-            env.cloud[*ai].type = CLOUD_FIRE;
-            env.cloud[*ai].pos = *ai;
-            env.cloud[*ai].decay = cloud.decay / 2 + 1;
+            cloud_struct &flames = env.cloud[*ai];
+            flames = cloud;
+            flames.type = CLOUD_FIRE;
+            flames.pos = *ai;
+            flames.decay = cloud.decay / 2 + 1;
         }
 
         // forest fire doesn't spread in all directions at once,
@@ -352,9 +354,10 @@ static void _spread_fire(const cloud_struct &cloud)
         if (you.see_cell(*ai))
             mpr("The forest fire spreads!");
         destroy_wall(*ai);
-        env.cloud[*ai] = cloud;
-        env.cloud[*ai].pos = *ai;
-        env.cloud[*ai].decay = random2(30) + 25;
+        cloud_struct &fire = env.cloud[*ai];
+        fire = cloud;
+        fire.pos = *ai;
+        fire.decay = random2(30) + 25;
         if (cloud.whose == KC_YOU)
         {
             did_god_conduct(DID_KILL_PLANT, 1);
@@ -487,10 +490,20 @@ static void _handle_spectral_cloud(const cloud_struct& cloud)
 void manage_clouds()
 {
     // We can't iterate over env.cloud directly because _dissipate_cloud
-    // will remove this cloud and invalidate our iterator.
+    // will remove this cloud and invalidate our iterator. Clouds are handled
+    // in order of position, so that the random rolls don't depend on when
+    // each cloud happened to be made. The list's storage is kept between
+    // turns rather than reallocated every time.
+    static vector<cloud_struct *> spare_ptrs;
     vector<cloud_struct *> cloud_ptrs;
-    for (auto& entry : env.cloud)
-        cloud_ptrs.push_back(&entry.second);
+    cloud_ptrs.swap(spare_ptrs);
+    cloud_ptrs.clear();
+    cloud_ptrs.reserve(env.cloud.size());
+    for (auto& cloud : env.cloud)
+        cloud_ptrs.push_back(&cloud);
+    sort(cloud_ptrs.begin(), cloud_ptrs.end(),
+         [](const cloud_struct *a, const cloud_struct *b)
+         { return a->pos < b->pos; });
 
     for (auto ptr : cloud_ptrs)
     {
@@ -522,6 +535,8 @@ void manage_clouds()
 
         _dissipate_cloud(cloud);
     }
+
+    cloud_ptrs.swap(spare_ptrs);
 }
 
 static void _maybe_leave_water(const coord_def pos)
@@ -574,8 +589,10 @@ void delete_all_clouds()
     // We can't iterate over env.cloud directly because delete_cloud
     // will remove this cloud and invalidate our iterator.
     vector<coord_def> cloud_locs;
-    for (auto& entry : env.cloud)
-        cloud_locs.push_back(entry.first);
+    for (auto& cloud : env.cloud)
+        cloud_locs.push_back(cloud.pos);
+    // In order of position, for the sake of rain's random rolls.
+    sort(cloud_locs.begin(), cloud_locs.end());
 
     for (auto pos : cloud_locs)
         delete_cloud(pos);
@@ -1650,9 +1667,13 @@ void remove_tornado_clouds(mid_t whose)
     // example, this approach doesn't work if we ever make Tornado a monster
     // spell (excluding immobile and mindless casters).
 
-    for (auto& entry : env.cloud)
-        if (entry.second.type == CLOUD_TORNADO && entry.second.source == whose)
-            delete_cloud(entry.first);
+    vector<coord_def> cloud_locs;
+    for (auto& cloud : env.cloud)
+        if (cloud.type == CLOUD_TORNADO && cloud.source == whose)
+            cloud_locs.push_back(cloud.pos);
+
+    for (auto pos : cloud_locs)
+        delete_cloud(pos);
 }
 
 static void _spread_cloud(coord_def pos, cloud_type type, int radius, int pow,
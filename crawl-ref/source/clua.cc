@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "cluautil.h"
+#include "dbg-util.h"
 #include "dlua.h"
 #include "end.h"
 #include "files.h"
@@ -53,9 +54,10 @@ CLua::CLua(bool managed)
     : error(), managed_vm(managed), shutting_down(false),
       throttle_unit_lines(10000),
       throttle_sleep_ms(0), throttle_sleep_start(2),
-      throttle_sleep_end(800), n_throttle_sleeps(0), mixed_call_depth(0),
+      throttle_sleep_end(800), n_throttle_sleeps(0), throttle_start_ms(0),
+      mixed_call_depth(0),
       lua_call_depth(0), max_mixed_call_depth(8),
-      max_lua_call_depth(100), memory_used(0),
+      max_lua_call_depth(100), memory_used(0), alloc_pool(),
       _state(nullptr), sourced_files(), uniqindex(0)
 {
 }
@@ -251,6 +253,7 @@ void CLua::init_throttle()
                     LUA_MASKCOUNT, throttle_unit_lines);
         throttle_sleep_ms = 0;
         n_throttle_sleeps = 0;
+        throttle_start_ms = get_milliseconds();
     }
 }
 
@@ -544,6 +547,7 @@ bool CLua::calltopfn(lua_State *ls, const char *params, va_list args,
     if (retc == -1)
         retc = return_count(ls, params);
     lua_call_throttle strangler(this);
+    PROFILE_SECTION(PROF_LUA);
     int err = lua_pcall(ls, argc, retc, 0);
     set_error(err, ls);
     return !err;
@@ -644,9 +648,18 @@ bool CLua::proc_returns(const char *par) const
 //
 void CLua::pushglobal(const string &name)
 {
-    vector<string> pieces = split_string(".", name);
     lua_State *ls(state());
 
+    // Hooks and callbacks are looked up this way many times a turn, nearly
+    // always by a plain name that the user never defined; don't split it.
+    if (!name.empty() && name.find_first_of(". \t\r\n") == string::npos)
+    {
+        lua_getglobal(ls, name.c_str());
+        return;
+    }
+
+    vector<string> pieces = split_string(".", name);
+
     if (pieces.empty())
         lua_pushnil(ls);
 
@@ -728,6 +741,7 @@ bool CLua::callfn(const char *fn, int nargs, int nret)
     }
 
     lua_call_throttle strangler(this);
+    PROFILE_SECTION(PROF_LUA);
     int err = lua_pcall(ls, nargs, nret, 0);
     set_error(err, ls);
     return !err;
@@ -747,8 +761,9 @@ void CLua::init_lua()
 # endif
     _state = luaL_newstate();
 #else
-    // Throttle memory usage in managed (clua) VMs
-    _state = managed_vm? lua_newstate(_clua_allocator, this) : luaL_newstate();
+    // Pool small allocations; also throttle memory usage in managed (clua)
+    // VMs.
+    _state = lua_newstate(_clua_allocator, this);
 #endif
     if (!_state)
         end(1, false, "Unable to create Lua state.");
@@ -1073,25 +1088,124 @@ static int _clua_panic(lua_State *ls)
 }
 
 #ifndef NO_CUSTOM_ALLOCATOR
+lua_alloc_pool::lua_alloc_pool()
+    : slabs(), slab_used(SLAB_SIZE), pooled_allocs(0), reused_allocs(0),
+      large_allocs(0)
+{
+    for (void *&head : free_list)
+        head = nullptr;
+}
+
+lua_alloc_pool::~lua_alloc_pool()
+{
+    for (char *slab : slabs)
+        free(slab);
+}
+
+void *lua_alloc_pool::alloc(size_t size)
+{
+    if (!pooled(size))
+    {
+        ++large_allocs;
+        return malloc(size);
+    }
+
+    const size_t cls = size_class(size);
+    ++pooled_allocs;
+    if (void *block = free_list[cls])
+    {
+        ++reused_allocs;
+        free_list[cls] = *static_cast<void **>(block);
+        return block;
+    }
+
+    const size_t block_size = (cls + 1) * POOL_GRANULARITY;
+    if (slab_used + block_size > SLAB_SIZE)
+    {
+        char *slab = static_cast<char *>(malloc(SLAB_SIZE));
+        if (!slab)
+            return nullptr;
+        slabs.push_back(slab);
+        slab_used = 0;
+    }
+    void *block = slabs.back() + slab_used;
+    slab_used += block_size;
+    return block;
+}
+
+void lua_alloc_pool::release(void *ptr, size_t size)
+{
+    if (!pooled(size))
+    {
+        free(ptr);
+        return;
+    }
+
+    const size_t cls = size_class(size);
+    *static_cast<void **>(ptr) = free_list[cls];
+    free_list[cls] = ptr;
+}
+
+string lua_alloc_pool::stats() const
+{
+    return make_stringf("%lu pooled allocations (%lu reused), %lu large, "
+                        "%u KB in slabs",
+                        pooled_allocs, reused_allocs, large_allocs,
+                        (unsigned int)(slabs.size() * SLAB_SIZE / 1024));
+}
+
 static void *_clua_allocator(void *ud, void *ptr, size_t osize, size_t nsize)
 {
     CLua *cl = static_cast<CLua *>(ud);
-    cl->memory_used += nsize - osize;
 
-    if (nsize > osize && cl->memory_used >= CLUA_MAX_MEMORY_USE * 1024
+    if (nsize > osize && cl->managed_vm
+        && cl->memory_used + long(nsize - osize) >= CLUA_MAX_MEMORY_USE * 1024
         && cl->mixed_call_depth)
     {
         return nullptr;
     }
 
+    lua_alloc_pool &pool = cl->alloc_pool;
+    if (!ptr)
+        osize = 0;
+
+    void *block;
     if (!nsize)
     {
-        free(ptr);
-        return nullptr;
+        if (ptr)
+            pool.release(ptr, osize);
+        block = nullptr;
+    }
+    else if (ptr && lua_alloc_pool::pooled(osize)
+             && lua_alloc_pool::pooled(nsize)
+             && lua_alloc_pool::size_class(osize)
+                == lua_alloc_pool::size_class(nsize))
+    {
+        // Still fits in the same size of block.
+        block = ptr;
     }
+    else if (!lua_alloc_pool::pooled(osize) && !lua_alloc_pool::pooled(nsize))
+        block = realloc(ptr, nsize);
     else
-        return realloc(ptr, nsize);
+    {
+        block = pool.alloc(nsize);
+        if (!block)
+            return nullptr;
+        if (ptr)
+        {
+            memcpy(block, ptr, min(osize, nsize));
+            pool.release(ptr, osize);
+        }
+    }
+
+    cl->memory_used += nsize - osize;
+    return block;
 }
+#else
+// 64-bit LuaJIT doesn't allow a custom allocator, so there's no pool.
+lua_alloc_pool::lua_alloc_pool() { }
+lua_alloc_pool::~lua_alloc_pool() { }
+string lua_alloc_pool::stats() const { return "no allocation pool"; }
 #endif
 
 static void _clua_throttle_hook(lua_State *ls, lua_Debug *dbg)
@@ -1105,6 +1219,14 @@ static void _clua_throttle_hook(lua_State *ls, lua_Debug *dbg)
 
     if (lua)
     {
+        // Well-behaved scripts finish well inside the grace period; only
+        // start slowing down calls that have been running for a while.
+        if (get_milliseconds() - lua->throttle_start_ms
+            < CLua::THROTTLE_GRACE_MS)
+        {
+            return;
+        }
+
         if (!lua->throttle_sleep_ms)
             lua->throttle_sleep_ms = lua->throttle_sleep_start;
         else if (lua->throttle_sleep_ms < lua->throttle_sleep_end)
@@ -1134,7 +1256,13 @@ lua_call_throttle::lua_call_throttle(CLua *_lua)
 lua_call_throttle::~lua_call_throttle()
 {
     if (!--lua->mixed_call_depth)
+    {
         lua_map.erase(lua->state());
+        // The hook is rearmed by the next call; don't leave it counting
+        // instructions for code that runs outside a throttled call.
+        if (lua->managed_vm)
+            lua_sethook(lua->state(), nullptr, 0, 0);
+    }
 }
 
 CLua *lua_call_throttle::find_clua(lua_State *ls)
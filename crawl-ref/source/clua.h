@@ -12,6 +12,7 @@ extern "C" {
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #ifndef CLUA_MAX_MEMORY_USE
 #define CLUA_MAX_MEMORY_USE (6 * 1024)
@@ -19,6 +20,45 @@ extern "C" {
 
 class CLua;
 
+// Free lists for the small blocks that make up most Lua allocations, carved
+// out of slabs that are kept until the Lua state that uses them is closed.
+// Larger blocks go straight to malloc.
+class lua_alloc_pool
+{
+public:
+    lua_alloc_pool();
+    ~lua_alloc_pool();
+
+    void *alloc(size_t size);
+    void release(void *ptr, size_t size);
+
+    static bool pooled(size_t size)
+    {
+        return size && size <= MAX_POOLED_SIZE;
+    }
+    static size_t size_class(size_t size)
+    {
+        return (size - 1) / POOL_GRANULARITY;
+    }
+
+    string stats() const;
+
+private:
+    static const size_t POOL_GRANULARITY = 16;
+    static const size_t MAX_POOLED_SIZE = 512;
+    static const size_t SLAB_SIZE = 64 * 1024;
+    static const size_t NUM_SIZE_CLASSES = MAX_POOLED_SIZE / POOL_GRANULARITY;
+
+    void *free_list[NUM_SIZE_CLASSES];
+    vector<char *> slabs;
+    size_t slab_used;
+
+    unsigned long pooled_allocs, reused_allocs, large_allocs;
+
+    lua_alloc_pool(const lua_alloc_pool &) = delete;
+    lua_alloc_pool &operator=(const lua_alloc_pool &) = delete;
+};
+
 class lua_stack_cleaner
 {
 public:
@@ -158,14 +198,18 @@ public:
     int throttle_sleep_ms;
     int throttle_sleep_start, throttle_sleep_end;
     int n_throttle_sleeps;
+    unsigned int throttle_start_ms; // When the outermost call began.
     int mixed_call_depth;
     int lua_call_depth;
     int max_mixed_call_depth;
     int max_lua_call_depth;
 
     long memory_used;
+    lua_alloc_pool alloc_pool;
 
     static const int MAX_THROTTLE_SLEEPS = 100;
+    // How long a call may run before the throttle starts sleeping.
+    static const unsigned int THROTTLE_GRACE_MS = 100;
 
 private:
     lua_State *_state;
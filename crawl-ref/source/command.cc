@@ -1417,6 +1417,9 @@ int list_wizard_commands(bool do_redraw_screen)
                        "<w>Ctrl-T</w> dungeon (D)Lua interpreter\n"
                        "<w>Ctrl-U</w> client (C)Lua interpreter\n"
                        "<w>Ctrl-X</w> Xom effect stats\n"
+#ifdef DEBUG_PROFILE
+                       "<w>Ctrl-Y</w> show turn profile\n"
+#endif
 #ifdef DEBUG_DIAGNOSTICS
                        "<w>Ctrl-Q</w> make some debug messages quiet\n"
 #endif
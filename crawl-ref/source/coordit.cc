@@ -183,9 +183,7 @@ radius_iterator::radius_iterator(const coord_def _center, int r,
     case C_SQUARE: credit = r; break;
     }
     is_square = (ctype == C_SQUARE);
-    ++(*this);
-    if (_exclude_center)
-        ++(*this);
+    start(_exclude_center);
 }
 
 radius_iterator::radius_iterator(const coord_def _center,
@@ -198,9 +196,7 @@ radius_iterator::radius_iterator(const coord_def _center,
     ASSERT(map_bounds(_center));
     credit = los_radius;
     is_square = true;
-    ++(*this);
-    if (_exclude_center)
-        ++(*this);
+    start(_exclude_center);
 }
 
 radius_iterator::radius_iterator(const coord_def _center,
@@ -221,8 +217,73 @@ radius_iterator::radius_iterator(const coord_def _center,
     case C_SQUARE: credit = r; break;
     }
     is_square = (ctype == C_SQUARE);
+    start(_exclude_center);
+}
+
+// Offset tables are kept for squares and circles that fit in the largest
+// LOS; bigger regions run the coroutine below.
+static const int RI_MAX_TABLE_SQUARE = LOS_MAX_RANGE;
+static const int RI_MAX_TABLE_CIRCLE = LOS_MAX_RANGE * LOS_MAX_RANGE + 1;
+
+// The offsets the coroutine visits for this credit, in the same order and
+// before any clipping to the map.
+static vector<coord_def> _radius_offsets(int credit, bool is_square)
+{
+    vector<coord_def> offsets;
+    const int base_cost = is_square ? 1 : -1;
+    const int inc_cost = is_square ? 0 : 2;
+    int y = 0, cost_y = base_cost, credit_y = credit;
+    do
+    {
+        int x = 0, cost_x = base_cost;
+        int credit_x = is_square ? credit : credit_y;
+        do
+        {
+            offsets.emplace_back(x, y);
+            if (y)
+                offsets.emplace_back(x, -y);
+            if (x)
+            {
+                offsets.emplace_back(-x, y);
+                if (y)
+                    offsets.emplace_back(-x, -y);
+            }
+            x++;
+            credit_x -= (cost_x += inc_cost);
+        } while (credit_x >= 0);
+
+        y++;
+        credit_y -= (cost_y += inc_cost);
+    } while (credit_y >= 0);
+    return offsets;
+}
+
+static const vector<coord_def> &_cached_radius_offsets(int credit,
+                                                       bool is_square)
+{
+    static vector<coord_def> squares[RI_MAX_TABLE_SQUARE + 1];
+    static vector<coord_def> circles[RI_MAX_TABLE_CIRCLE + 1];
+    vector<coord_def> &offsets = is_square ? squares[credit] : circles[credit];
+    if (offsets.empty())
+        offsets = _radius_offsets(credit, is_square);
+    return offsets;
+}
+
+void radius_iterator::start(bool exclude_center)
+{
+    use_table = false;
+    if (credit >= 0
+        && credit <= (is_square ? RI_MAX_TABLE_SQUARE : RI_MAX_TABLE_CIRCLE))
+    {
+        const vector<coord_def> &offsets =
+            _cached_radius_offsets(credit, is_square);
+        // The centre always comes first.
+        offset = offsets.data() + (exclude_center ? 1 : 0);
+        offset_end = offsets.data() + offsets.size();
+        use_table = true;
+    }
     ++(*this);
-    if (_exclude_center)
+    if (exclude_center && !use_table)
         ++(*this);
 }
 
@@ -254,6 +315,22 @@ const coord_def* radius_iterator::operator->() const
 
 void radius_iterator::operator++()
 {
+    if (use_table)
+    {
+        while (offset != offset_end)
+        {
+            current = center + *offset++;
+            if (current.x >= 0 && current.x < GXM
+                && current.y >= 0 && current.y < GYM
+                && (!los || cell_see_cell(center, current, los)))
+            {
+                return;
+            }
+        }
+        state = RI_DONE;
+        return;
+    }
+
     cobegin(RI_START);
 
     base_cost = is_square ? 1 : -1;
@@ -75,6 +75,8 @@ public:
     void operator ++ (int);
 
 private:
+    void start(bool exclude_center);
+
     enum costate { RI_DONE, RI_START, RI_SE, RI_NE, RI_SW, RI_NW };
     int x, y, cost_x, cost_y, credit, credit_x, credit_y, base_cost, inc_cost;
     bool is_square;
@@ -83,6 +85,11 @@ private:
     coord_def center;
     los_type los;
     coord_def current;    // storage for operator->
+
+    // Set if walking a cached offset table instead of the coroutine.
+    bool use_table;
+    const coord_def *offset;
+    const coord_def *offset_end;
 };
 
 class adjacent_iterator : public iterator<forward_iterator_tag, coord_def>
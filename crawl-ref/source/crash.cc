@@ -94,6 +94,50 @@ static int _crash_signal    = 0;
 static int _recursion_depth = 0;
 static mutex_t crash_mutex;
 
+#if defined(BACKTRACE_SUPPORTED) && !defined(TARGET_OS_MACOSX)
+# define RAW_CRASH_SNAPSHOT
+#endif
+
+#ifdef RAW_CRASH_SNAPSHOT
+static void _write_raw(const char *str)
+{
+    ssize_t ret = write(STDERR_FILENO, str, strlen(str));
+    UNUSED(ret);
+}
+
+// The first thing done on a crash: the signal and a bare stack trace,
+// using only write() and backtrace_symbols_fd(), neither of which needs
+// the heap or stdio. The full report written afterwards may hang or die
+// if the crash left malloc or stdio in a bad state; this part will not.
+// Only written when stderr is not the terminal the game is being played
+// on, i.e. when a server or wrapper is logging it.
+static void _write_raw_crash_snapshot(int sig_num)
+{
+    if (isatty(STDERR_FILENO))
+        return;
+
+    char num[12];
+    char *p = num + sizeof(num) - 1;
+    *p = 0;
+    int n = sig_num;
+    do
+    {
+        *--p = '0' + n % 10;
+        n /= 10;
+    }
+    while (n && p > num);
+
+    _write_raw("\nCrash snapshot: signal ");
+    _write_raw(p);
+    _write_raw("\n");
+
+    void* frames[50];
+    const int num_frames = backtrace(frames, ARRAYSZ(frames));
+    backtrace_symbols_fd(frames, num_frames, STDERR_FILENO);
+    _write_raw("End of crash snapshot.\n");
+}
+#endif
+
 // Make this non-static so stack traces are easier to follow
 void crash_signal_handler(int sig_num);
 
@@ -147,6 +191,10 @@ void crash_signal_handler(int sig_num)
     _crash_signal            = sig_num;
     crawl_state.game_crashed = true;
 
+#ifdef RAW_CRASH_SNAPSHOT
+    _write_raw_crash_snapshot(sig_num);
+#endif
+
     // During a crash, we may be in an inconsistent state (duh). Doing a number
     // of things can cause a lock up, especially calling non-reentrant functions
     // like malloc() and friends, used by C++ basics like std::string
@@ -203,6 +251,13 @@ void init_crash_handler()
 #if defined(USE_UNIX_SIGNALS)
     mutex_init(crash_mutex);
 
+#ifdef RAW_CRASH_SNAPSHOT
+    // backtrace() may load libgcc and allocate the first time it is called;
+    // get that done now rather than inside a signal handler.
+    void* frames[2];
+    backtrace(frames, ARRAYSZ(frames));
+#endif
+
     for (int i = 1; i <= 64; i++)
     {
 #ifdef SIGALRM
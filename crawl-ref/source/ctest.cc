@@ -19,6 +19,11 @@
 
 #include <algorithm>
 #include <vector>
+#ifndef TARGET_OS_WINDOWS
+# include <cerrno>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
 
 #include "clua.h"
 #include "cluautil.h"
@@ -27,6 +32,7 @@
 #include "end.h"
 #include "errors.h"
 #include "files.h"
+#include "initfile.h"
 #include "itemname.h"
 #include "jobs.h"
 #include "libutil.h"
@@ -37,6 +43,7 @@
 #include "ng-init.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 
 static const string test_dir = "test";
 static const string script_dir = "scripts";
@@ -134,6 +141,110 @@ static void run_test(const string &file)
         failures.emplace_back(file, dlua.error);
 }
 
+#ifndef TARGET_OS_WINDOWS
+static string _worker_result_file(int job)
+{
+    return make_stringf("test.worker%d.tmp", job);
+}
+
+static void _write_worker_string(FILE *f, const string &s)
+{
+    fprintf(f, "%u:", (unsigned int)s.size());
+    fwrite(s.data(), 1, s.size(), f);
+    fputc('\n', f);
+}
+
+static bool _read_worker_string(FILE *f, string &s)
+{
+    unsigned int len;
+    if (fscanf(f, "%u:", &len) != 1)
+        return false;
+    s.resize(len);
+    if (len && fread(&s[0], 1, len, f) != len)
+        return false;
+    return fgetc(f) == '\n';
+}
+
+// Dump a worker's counts and failures, for merging by the parent.
+static void _write_worker_results(FILE *f)
+{
+    fprintf(f, "%d %d %u\n", ntests, nsuccess, (unsigned int)failures.size());
+    for (const file_error &fe : failures)
+    {
+        _write_worker_string(f, fe.first);
+        _write_worker_string(f, fe.second);
+    }
+}
+
+static bool _merge_worker_results(FILE *f)
+{
+    int tests, successes;
+    unsigned int nfailures;
+    if (fscanf(f, "%d %d %u\n", &tests, &successes, &nfailures) != 3)
+        return false;
+    ntests   += tests;
+    nsuccess += successes;
+    for (unsigned int i = 0; i < nfailures; ++i)
+    {
+        string file, err;
+        if (!_read_worker_string(f, file) || !_read_worker_string(f, err))
+            return false;
+        failures.emplace_back(file, err);
+    }
+    return true;
+}
+
+// Deal the selected test files out round-robin to forked workers, so each
+// file runs in a fresh copy of the post-setup state, and merge their results
+// in worker order.
+static void _run_tests_in_workers(const vector<string> &tests, int jobs)
+{
+    vector<pid_t> workers;
+    fflush(stdout);
+    fflush(stderr);
+    for (int job = 0; job < jobs; ++job)
+    {
+        const pid_t pid = fork();
+        if (pid == -1)
+        {
+            fprintf(stderr, "Couldn't fork test worker: %s\n",
+                    strerror(errno));
+            end(1);
+        }
+        if (pid == 0)
+        {
+            ntests = nsuccess = 0;
+            failures.clear();
+            for (size_t i = job; i < tests.size(); i += jobs)
+                run_test(tests[i]);
+            FILE *f = fopen_u(_worker_result_file(job).c_str(), "wb");
+            if (!f)
+                _exit(1);
+            _write_worker_results(f);
+            _exit(fclose(f) ? 1 : 0);
+        }
+        workers.push_back(pid);
+    }
+
+    for (int job = 0; job < jobs; ++job)
+    {
+        int status = 0;
+        waitpid(workers[job], &status, 0);
+        const string file = _worker_result_file(job);
+        FILE *f = fopen_u(file.c_str(), "rb");
+        if (!WIFEXITED(status) || WEXITSTATUS(status) || !f
+            || !_merge_worker_results(f))
+        {
+            failures.emplace_back(file,
+                                  make_stringf("test worker %d failed", job));
+        }
+        if (f)
+            fclose(f);
+        unlink_u(file.c_str());
+    }
+}
+#endif
+
 static bool _has_test(const string& test)
 {
     if (crawl_state.script)
@@ -192,7 +303,22 @@ void run_tests()
         // reproducibility.
         sort(begin(tests), end(tests));
 
-        for_each(tests.begin(), tests.end(), run_test);
+#ifndef TARGET_OS_WINDOWS
+        if (SysEnv.map_gen_jobs > 1 && !crawl_state.test_list)
+        {
+            tests.erase(remove_if(begin(tests), end(tests),
+                                  [](const string &t)
+                                  { return !_is_test_selected(t); }),
+                        end(tests));
+            const int jobs = min<int>(SysEnv.map_gen_jobs, tests.size());
+            if (jobs > 1)
+                _run_tests_in_workers(tests, jobs);
+            else
+                for_each(tests.begin(), tests.end(), run_test);
+        }
+        else
+#endif
+            for_each(tests.begin(), tests.end(), run_test);
 
         if (failures.empty() && !ntests && crawl_state.script)
         {
@@ -9,6 +9,7 @@
 
 #include <cstdlib>
 #include <fcntl.h>
+#include <list>
 #include <sys/stat.h>
 #include <sys/types.h>
 #ifndef TARGET_COMPILER_VC
@@ -21,6 +22,7 @@
 #include "libutil.h"
 #include "options.h"
 #include "random.h"
+#include "state.h"
 #include "stringutil.h"
 #include "syscalls.h"
 #include "threads.h"
@@ -37,6 +39,8 @@ public:
     TextDB(TextDB *parent);
     ~TextDB() { shutdown(true); delete translation; }
     void init();
+    // Initialise on first use, unless databaseSystemInit() already did.
+    void ensure_init();
     void shutdown(bool recursive = false);
     DBM* get() { return _db; }
 
@@ -55,6 +59,7 @@ public:
     vector<string> _input_files;
     DBM* _db;
     string timestamp;
+    bool _initialised;
     TextDB *_parent;
     const char* lang() { return _parent ? Options.lang_name : 0; }
 public:
@@ -68,6 +73,8 @@ static void _store_text_db(const string &in, DBM *db);
 static string _query_database(TextDB &db, string key, bool canonicalise_key,
                               bool run_lua, bool untranslated = false);
 static void _add_entry(DBM *db, const string &k, string &v);
+static datum _database_fetch(DBM *database, const string &key);
+static void _clear_fetch_cache();
 
 static TextDB AllDBs[] =
 {
@@ -164,7 +171,8 @@ static string _db_cache_path(string db, const char *lang)
 
 TextDB::TextDB(const char* db_name, const char* dir, ...)
     : _db_name(db_name), _directory(dir),
-      _db(nullptr), timestamp(""), _parent(0), translation(0)
+      _db(nullptr), timestamp(""), _initialised(false), _parent(0),
+      translation(0)
 {
     va_list args;
     va_start(args, dir);
@@ -186,7 +194,8 @@ TextDB::TextDB(TextDB *parent)
     : _db_name(parent->_db_name),
       _directory(parent->_directory + Options.lang_name + "/"),
       _input_files(parent->_input_files), // FIXME: pointless copy
-      _db(nullptr), timestamp(""), _parent(parent), translation(nullptr)
+      _db(nullptr), timestamp(""), _initialised(false), _parent(parent),
+      translation(nullptr)
 {
 }
 
@@ -200,7 +209,10 @@ bool TextDB::open_db()
     if (!_db)
         return false;
 
-    timestamp = _query_database(*this, "TIMESTAMP", false, false, true);
+    // Not through _query_database(): this runs on the loader threads, and
+    // must stay clear of the fetch cache.
+    datum ts = _database_fetch(_db, "TIMESTAMP");
+    timestamp = ts.dsize > 0 ? string((const char *)ts.dptr, ts.dsize) : "";
     if (timestamp.empty())
         return false;
 
@@ -209,6 +221,8 @@ bool TextDB::open_db()
 
 void TextDB::init()
 {
+    _initialised = true;
+
     if (Options.lang_name && !_parent)
     {
         translation = new TextDB(this);
@@ -228,6 +242,16 @@ void TextDB::init()
     }
 }
 
+void TextDB::ensure_init()
+{
+    if (_initialised)
+        return;
+
+    init();
+    // A handle may have been reused by the newly opened DB.
+    _clear_fetch_cache();
+}
+
 void TextDB::shutdown(bool recursive)
 {
     if (_db)
@@ -347,6 +371,15 @@ void databaseSystemInit()
     // the current version ("git submodule sync;git submodule update --init").
     ASSERT(sqlite3_threadsafe());
 
+#ifdef DGAMELAUNCH
+    // On a server every game launch would pay for checking, and perhaps
+    // rebuilding, every DB here, even though most games only ever touch a
+    // few of them. The DBs are built once at install time with -builddb,
+    // so just open each on its first lookup.
+    if (!crawl_state.build_db)
+        return;
+#endif
+
     thread_t th[NUM_DB];
     for (unsigned int i = 0; i < NUM_DB; i++)
 // Using threads for loading on Windows at the moment seems to cause
@@ -369,6 +402,7 @@ void databaseSystemShutdown()
 {
     for (unsigned int i = 0; i < NUM_DB; i++)
         AllDBs[i].shutdown(true);
+    _clear_fetch_cache();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -391,6 +425,57 @@ static datum _database_fetch(DBM *database, const string &key)
     return result;
 }
 
+// Most lookups are for the same few dozen keys (monster speech and shouts
+// especially), so keep the most recent answers, misses included.
+#define FETCH_CACHE_SIZE 256
+
+typedef pair<DBM *, string> fetch_cache_key;
+typedef list<pair<fetch_cache_key, string> > fetch_cache_list;
+static fetch_cache_list _fetch_cache;
+static map<fetch_cache_key, fetch_cache_list::iterator> _fetch_cache_index;
+
+// Speech keys known to have no entry at all. Monster speech probes long
+// chains of prefixed and "default" keys, nearly all of which miss, so
+// remember those for good rather than letting them churn the fetch cache.
+static set<string> _speak_misses;
+
+static void _clear_fetch_cache()
+{
+    _fetch_cache.clear();
+    _fetch_cache_index.clear();
+    _speak_misses.clear();
+}
+
+// Like _database_fetch(), but cached, and returning "" for missing keys.
+static string _database_fetch_string(DBM *database, const string &key)
+{
+    if (!database)
+        return "";
+
+    const fetch_cache_key ckey(database, key);
+    auto found = _fetch_cache_index.find(ckey);
+    if (found != _fetch_cache_index.end())
+    {
+        _fetch_cache.splice(_fetch_cache.begin(), _fetch_cache,
+                            found->second);
+        return found->second->second;
+    }
+
+    datum result = _database_fetch(database, key);
+    string value;
+    if (result.dsize > 0)
+        value = string((const char *)result.dptr, result.dsize);
+
+    _fetch_cache.emplace_front(ckey, value);
+    _fetch_cache_index[ckey] = _fetch_cache.begin();
+    if (_fetch_cache.size() > FETCH_CACHE_SIZE)
+    {
+        _fetch_cache_index.erase(_fetch_cache.back().first);
+        _fetch_cache.pop_back();
+    }
+    return value;
+}
+
 static vector<string> _database_find_keys(DBM *database,
                                           const string &regex,
                                           bool ignore_case,
@@ -555,14 +640,20 @@ static void _store_text_db(const string &in, DBM *db)
     _parse_text_db(inf, db);
 }
 
-static string _chooseStrByWeight(string entry, int fixed_weight = -1)
+// A database entry split into its alternatives, each with the running total
+// of the weights up to and including it.
+struct weighted_entry
 {
     vector<string> parts;
     vector<int>    weights;
+    int            total_weight = 0;
+    const char    *error = nullptr;
+};
 
+static void _parse_weighted_entry(const string &entry, weighted_entry &parsed)
+{
     vector<string> lines = split_string("\n", entry, false, true);
 
-    int total_weight = 0;
     for (int i = 0, size = lines.size(); i < size; i++)
     {
         // Skip over multiple blank lines, and leading and trailing
@@ -580,12 +671,15 @@ static string _chooseStrByWeight(string entry, int fixed_weight = -1)
         {
             i++;
             if (i == size)
-                return "BUG, WEIGHT AT END OF ENTRY";
+            {
+                parsed.error = "BUG, WEIGHT AT END OF ENTRY";
+                return;
+            }
         }
         else
             weight = 10;
 
-        total_weight += weight;
+        parsed.total_weight += weight;
 
         while (i < size && !lines[i].empty())
         {
@@ -594,22 +688,48 @@ static string _chooseStrByWeight(string entry, int fixed_weight = -1)
         }
         trim_string(part);
 
-        parts.push_back(part);
-        weights.push_back(total_weight);
+        parsed.parts.push_back(part);
+        parsed.weights.push_back(parsed.total_weight);
     }
 
-    if (parts.empty())
-        return "BUG, EMPTY ENTRY";
+    if (parsed.parts.empty())
+        parsed.error = "BUG, EMPTY ENTRY";
+}
+
+// Randart names and speech pick from the same long entries over and over,
+// so keep them parsed. Keyed by the entry text itself, which can't go stale.
+#define WEIGHTED_CACHE_SIZE 256
+
+static const weighted_entry &_get_weighted_entry(const string &entry)
+{
+    static map<string, weighted_entry> cache;
+
+    auto found = cache.find(entry);
+    if (found != cache.end())
+        return found->second;
+
+    if (cache.size() >= WEIGHTED_CACHE_SIZE)
+        cache.clear();
+    weighted_entry &parsed = cache[entry];
+    _parse_weighted_entry(entry, parsed);
+    return parsed;
+}
+
+static string _chooseStrByWeight(const string &entry, int fixed_weight = -1)
+{
+    const weighted_entry &parsed = _get_weighted_entry(entry);
+    if (parsed.error)
+        return parsed.error;
 
     int choice = 0;
     if (fixed_weight != -1)
-        choice = fixed_weight % total_weight;
+        choice = fixed_weight % parsed.total_weight;
     else
-        choice = random2(total_weight);
+        choice = random2(parsed.total_weight);
 
-    for (int i = 0, size = parts.size(); i < size; i++)
-        if (choice < weights[i])
-            return parts[i];
+    for (int i = 0, size = parsed.parts.size(); i < size; i++)
+        if (choice < parsed.weights[i])
+            return parsed.parts[i];
 
     return "BUG, NO STRING CHOSEN";
 }
@@ -625,15 +745,17 @@ static string _getWeightedString(TextDB &db, const string &key,
     string canonical_key = key + suffix;
     lowercase(canonical_key);
 
+    db.ensure_init();
+
     // Query the DB.
-    datum result;
+    string str;
 
     if (db.translation)
-        result = _database_fetch(db.translation->get(), canonical_key);
-    if (result.dsize <= 0)
-        result = _database_fetch(db.get(), canonical_key);
+        str = _database_fetch_string(db.translation->get(), canonical_key);
+    if (str.empty())
+        str = _database_fetch_string(db.get(), canonical_key);
 
-    if (result.dsize <= 0)
+    if (str.empty())
     {
         // Try ignoring the suffix.
         canonical_key = key;
@@ -641,17 +763,14 @@ static string _getWeightedString(TextDB &db, const string &key,
 
         // Query the DB.
         if (db.translation)
-            result = _database_fetch(db.translation->get(), canonical_key);
-        if (result.dsize <= 0)
-            result = _database_fetch(db.get(), canonical_key);
+            str = _database_fetch_string(db.translation->get(), canonical_key);
+        if (str.empty())
+            str = _database_fetch_string(db.get(), canonical_key);
 
-        if (result.dsize <= 0)
+        if (str.empty())
             return "";
     }
 
-    // Cons up a (C++) string to return. The caller must release it.
-    string str = string((const char *)result.dptr, result.dsize);
-
     return _chooseStrByWeight(str, fixed_weight);
 }
 
@@ -739,19 +858,19 @@ static string _query_database(TextDB &db, string key, bool canonicalise_key,
         lowercase(key);
     }
 
+    db.ensure_init();
+
     // Query the DB.
-    datum result;
+    string str;
 
     if (db.translation && !untranslated)
-        result = _database_fetch(db.translation->get(), key);
-    if (result.dsize <= 0)
-        result = _database_fetch(db.get(), key);
+        str = _database_fetch_string(db.translation->get(), key);
+    if (str.empty())
+        str = _database_fetch_string(db.get(), key);
 
-    if (result.dsize <= 0)
+    if (str.empty())
         return "";
 
-    string str((const char *)result.dptr, result.dsize);
-
     // <foo> is an alias to key foo
     if (str[0] == '<' && str[str.size() - 2] == '>'
         && str.find('<', 1) == str.npos
@@ -786,6 +905,7 @@ string getLongDescription(const string &key)
 vector<string> getLongDescKeysByRegex(const string &regex,
                                       db_find_filter filter)
 {
+    DescriptionDB.ensure_init();
     if (!DescriptionDB.get())
     {
         vector<string> empty;
@@ -800,6 +920,7 @@ vector<string> getLongDescKeysByRegex(const string &regex,
 vector<string> getLongDescBodiesByRegex(const string &regex,
                                         db_find_filter filter)
 {
+    DescriptionDB.ensure_init();
     if (!DescriptionDB.get())
     {
         vector<string> empty;
@@ -840,6 +961,21 @@ string getSpeakString(const string &key)
 #ifdef DEBUG_MONSPEAK
     dprf(DIAG_SPEECH, "monster speech lookup for %s", key.c_str());
 #endif
+    if (_speak_misses.count(key))
+        return "";
+
+    // A missing key costs no random numbers, so skipping it later is safe.
+    string canonical_key = lowercase_string(key);
+    SpeakDB.ensure_init();
+    if ((!SpeakDB.translation
+         || _database_fetch_string(SpeakDB.translation->get(),
+                                   canonical_key).empty())
+        && _database_fetch_string(SpeakDB.get(), canonical_key).empty())
+    {
+        _speak_misses.insert(key);
+        return "";
+    }
+
     string txt = _getRandomisedStr(SpeakDB, key, "", num_replacements);
     _execute_embedded_lua(txt);
 
@@ -870,6 +1006,7 @@ string getHelpString(const string &topic)
 // FAQ DB specific functions.
 vector<string> getAllFAQKeys()
 {
+    FAQDB.ensure_init();
     if (!FAQDB.get())
     {
         vector<string> empty;
@@ -728,6 +728,11 @@ void do_crash_dump()
         fprintf(file, "%s\n", screenshot().c_str());
     }
 
+    fprintf(file, "clua memory: %ld bytes; %s\n", clua.memory_used,
+            clua.alloc_pool.stats().c_str());
+    fprintf(file, "dlua memory: %ld bytes; %s\n\n", dlua.memory_used,
+            dlua.alloc_pool.stats().c_str());
+
     // If anything has screwed up the Lua runtime stacks then trying to
     // print those stacks will likely crash, so do this after the others.
     fprintf(file, "clua stack:\n");
@@ -7,21 +7,42 @@
 
 #include "dbg-maps.h"
 
+#include <chrono>
+#ifndef TARGET_OS_WINDOWS
+# include <cerrno>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
 #include "branch.h"
 #include "chardump.h"
+#include "coordit.h"
 #include "crash.h"
 #include "dbg-objstat.h"
 #include "dungeon.h"
+#include "end.h"
 #include "env.h"
 #include "initfile.h"
+#include "items.h"
 #include "libutil.h"
+#include "los.h"
+#include "losglobal.h"
 #include "maps.h"
 #include "message.h"
+#include "mon-pathfind.h"
+#include "noise.h"
 #include "ng-init.h"
+#include "options.h"
 #include "player.h"
+#include "random.h"
 #include "shopping.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
+#include "tags.h"
+#include "terrain.h"
+#include "travel.h"
+#include "version.h"
 #include "view.h"
 
 #ifdef DEBUG_STATISTICS
@@ -46,10 +67,62 @@ static int build_attempts = 0, level_vetoes = 0;
 // Map from message to counts.
 static map<string, int> veto_messages;
 
+// Time spent building levels, by phase; and the time spent on builds that
+// were thrown away, by phase, by veto reason and by the vaults placed.
+struct build_cost
+{
+    int count = 0;
+    long long usecs = 0;
+};
+static const char *phase_names[] =
+{
+    "other", "layout", "primary vault", "minivaults", "connectivity",
+    "monsters", "items",
+};
+COMPILE_CHECK(ARRAYSZ(phase_names) == NUM_MAPSTAT_PHASES);
+static build_cost phase_costs[NUM_MAPSTAT_PHASES];
+static build_cost wasted_phase_costs[NUM_MAPSTAT_PHASES];
+static map<string, build_cost> veto_costs;
+static map<string, build_cost> vault_veto_costs;
+
+typedef chrono::steady_clock build_clock;
+static build_clock::time_point phase_start;
+static mapstat_phase current_phase = MSP_OTHER;
+static long long attempt_usecs[NUM_MAPSTAT_PHASES];
+static string attempt_veto;
+
+// Charge the time since the last phase change to the current phase.
+static void _charge_phase_time()
+{
+    const build_clock::time_point now = build_clock::now();
+    attempt_usecs[current_phase] +=
+        chrono::duration_cast<chrono::microseconds>(now - phase_start).count();
+    phase_start = now;
+}
+
+mapstat_phase_timer::mapstat_phase_timer(mapstat_phase phase)
+    : outer(current_phase)
+{
+    _charge_phase_time();
+    current_phase = phase;
+}
+
+mapstat_phase_timer::~mapstat_phase_timer()
+{
+    _charge_phase_time();
+    current_phase = outer;
+}
+
 void mapstat_report_map_build_start()
 {
     build_attempts++;
     map_builds[level_id::current()].first++;
+
+    for (long long &usecs : attempt_usecs)
+        usecs = 0;
+    attempt_veto.clear();
+    current_phase = MSP_OTHER;
+    phase_start = build_clock::now();
 }
 
 void mapstat_report_map_veto(const string &message)
@@ -57,6 +130,44 @@ void mapstat_report_map_veto(const string &message)
     level_vetoes++;
     ++veto_messages[message];
     map_builds[level_id::current()].second++;
+    attempt_veto = message;
+}
+
+// Called once builder() is done with an attempt. Failed attempts are
+// charged to their veto reason and to every vault they had placed.
+void mapstat_report_map_build_end(bool success)
+{
+    _charge_phase_time();
+
+    long long total = 0;
+    for (int i = 0; i < NUM_MAPSTAT_PHASES; ++i)
+    {
+        phase_costs[i].count++;
+        phase_costs[i].usecs += attempt_usecs[i];
+        if (!success)
+        {
+            wasted_phase_costs[i].count++;
+            wasted_phase_costs[i].usecs += attempt_usecs[i];
+        }
+        total += attempt_usecs[i];
+    }
+
+    if (success)
+        return;
+
+    build_cost &reason =
+        veto_costs[attempt_veto.empty() ? "invalid level" : attempt_veto];
+    reason.count++;
+    reason.usecs += total;
+
+    set<string> vaults;
+    for (const auto &vp : env.level_vaults)
+        vaults.insert(vp->map.name);
+    for (const string &vault : vaults)
+    {
+        vault_veto_costs[vault].count++;
+        vault_veto_costs[vault].usecs += total;
+    }
 }
 
 static bool _is_disconnected_level()
@@ -223,26 +334,18 @@ static bool _build_dungeon()
     return true;
 }
 
-/**
- * Build dungeon levels for mapstat or objstat.
- *
- * The exact branches/levels built and number of build iterations is set by the
- * command-line options for mapstat/objstat.
+// Levels are built from a fixed seed per iteration, so that iteration i
+// produces the same dungeon no matter which -jobs worker builds it.
+static uint32_t _iteration_seed(uint32_t base_seed, int iter)
+{
+    return base_seed + iter;
+}
 
- * @returns True if all iterations built successfully. For mapstat, this can
- * return false if an iteration produced a disconnected level, since for
- * diagnostic purposes we record the map in detail to a file and exit. For
- * objstat, this only returns false if the primary dungeon generation function
- * builder() fails, as the level may be in an invalid state and any object
- * statistics erroneous.
-*/
-bool mapstat_build_levels()
+static bool _build_iterations(uint32_t base_seed, int first, int last)
 {
-    if (!generated_levels.size())
-        _dungeon_places();
     printf("Iteration: ");
     fflush(stdout);
-    for (int i = 0; i < SysEnv.map_gen_iters; ++i)
+    for (int i = first; i < last; ++i)
     {
         clear_messages();
         mprf("On %d of %d; %d g, %d fail, %u err%s, %u uniq, "
@@ -254,10 +357,12 @@ bool mapstat_build_levels()
              build_attempts ? level_vetoes * 100.0 / build_attempts : 0.0);
         printf("%d..", i + 1);
         fflush(stdout);
+        seed_rng(_iteration_seed(base_seed, i));
         dlua.callfn("dgn_clear_data", "");
         you.uniq_map_tags.clear();
         you.uniq_map_names.clear();
         you.unique_creatures.reset();
+        you.unique_items.init(UNIQ_NOT_EXISTS);
         initialise_branch_depths();
         init_level_connectivity();
         if (!_build_dungeon())
@@ -270,6 +375,365 @@ bool mapstat_build_levels()
     return true;
 }
 
+void mapstat_write_string(FILE *f, const string &s)
+{
+    fprintf(f, "%u:", (unsigned int)s.length());
+    fwrite(s.data(), 1, s.length(), f);
+    fputc('\n', f);
+}
+
+bool mapstat_read_string(FILE *f, string &s)
+{
+    unsigned int len;
+    if (fscanf(f, "%u:", &len) != 1)
+        return false;
+    s.resize(len);
+    if (len && fread(&s[0], 1, len, f) != len)
+        return false;
+    return fgetc(f) == '\n';
+}
+
+void mapstat_write_level(FILE *f, const level_id &lid)
+{
+    fprintf(f, "%d %d\n", lid.branch, lid.depth);
+}
+
+bool mapstat_read_level(FILE *f, level_id &lid)
+{
+    int br, depth;
+    if (fscanf(f, "%d %d\n", &br, &depth) != 2)
+        return false;
+    lid = level_id(static_cast<branch_type>(br), depth);
+    return true;
+}
+
+static void _write_count_map(FILE *f, const map<string, int> &counts)
+{
+    fprintf(f, "%u\n", (unsigned int)counts.size());
+    for (const auto &entry : counts)
+    {
+        mapstat_write_string(f, entry.first);
+        fprintf(f, "%d\n", entry.second);
+    }
+}
+
+static void _write_cost(FILE *f, const build_cost &cost)
+{
+    fprintf(f, "%d %lld\n", cost.count, cost.usecs);
+}
+
+static bool _merge_cost(FILE *f, build_cost &cost)
+{
+    int count;
+    long long usecs;
+    if (fscanf(f, "%d %lld\n", &count, &usecs) != 2)
+        return false;
+    cost.count += count;
+    cost.usecs += usecs;
+    return true;
+}
+
+static void _write_cost_map(FILE *f, const map<string, build_cost> &costs)
+{
+    fprintf(f, "%u\n", (unsigned int)costs.size());
+    for (const auto &entry : costs)
+    {
+        mapstat_write_string(f, entry.first);
+        _write_cost(f, entry.second);
+    }
+}
+
+static bool _merge_cost_map(FILE *f, map<string, build_cost> &costs)
+{
+    unsigned int n;
+    if (fscanf(f, "%u\n", &n) != 1)
+        return false;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        string key;
+        if (!mapstat_read_string(f, key) || !_merge_cost(f, costs[key]))
+            return false;
+    }
+    return true;
+}
+
+static bool _merge_count_map(FILE *f, map<string, int> &counts)
+{
+    unsigned int n;
+    if (fscanf(f, "%u\n", &n) != 1)
+        return false;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        string key;
+        int count;
+        if (!mapstat_read_string(f, key) || fscanf(f, "%d\n", &count) != 1)
+            return false;
+        counts[key] += count;
+    }
+    return true;
+}
+
+// Dump everything a worker has tallied, for merging by the parent.
+static void _write_worker_stats(FILE *f, bool success)
+{
+    fprintf(f, "%d %d %d %d %d %d\n", success, levels_tried, levels_failed,
+            build_attempts, level_vetoes, (int)errors.size());
+    for (const auto &err : errors)
+    {
+        mapstat_write_string(f, err.first);
+        mapstat_write_string(f, err.second);
+    }
+    _write_count_map(f, try_count);
+    _write_count_map(f, use_count);
+    _write_count_map(f, success_count);
+    _write_count_map(f, veto_messages);
+
+    for (int i = 0; i < NUM_MAPSTAT_PHASES; ++i)
+    {
+        _write_cost(f, phase_costs[i]);
+        _write_cost(f, wasted_phase_costs[i]);
+    }
+    _write_cost_map(f, veto_costs);
+    _write_cost_map(f, vault_veto_costs);
+
+    fprintf(f, "%u\n", (unsigned int)level_mapcounts.size());
+    for (const auto &entry : level_mapcounts)
+    {
+        mapstat_write_level(f, entry.first);
+        fprintf(f, "%d\n", entry.second);
+    }
+
+    fprintf(f, "%u\n", (unsigned int)map_builds.size());
+    for (const auto &entry : map_builds)
+    {
+        mapstat_write_level(f, entry.first);
+        fprintf(f, "%d %d\n", entry.second.first, entry.second.second);
+    }
+
+    fprintf(f, "%u\n", (unsigned int)level_mapsused.size());
+    for (const auto &entry : level_mapsused)
+    {
+        mapstat_write_level(f, entry.first);
+        fprintf(f, "%u\n", (unsigned int)entry.second.size());
+        for (const string &name : entry.second)
+            mapstat_write_string(f, name);
+    }
+
+    fprintf(f, "%u\n", (unsigned int)map_levelsused.size());
+    for (const auto &entry : map_levelsused)
+    {
+        mapstat_write_string(f, entry.first);
+        fprintf(f, "%u\n", (unsigned int)entry.second.size());
+        for (const level_id &lid : entry.second)
+            mapstat_write_level(f, lid);
+    }
+
+    if (crawl_state.obj_stat_gen)
+        objstat_write_worker_stats(f);
+}
+
+// Fold a worker's dump into our own tallies. Sets success to whether that
+// worker built all its iterations.
+static bool _merge_worker_stats(FILE *f, bool &success)
+{
+    int ok, tried, failed, attempts, vetoes, nerrors;
+    if (fscanf(f, "%d %d %d %d %d %d\n", &ok, &tried, &failed, &attempts,
+               &vetoes, &nerrors) != 6)
+    {
+        return false;
+    }
+    success = ok;
+    levels_tried   += tried;
+    levels_failed  += failed;
+    build_attempts += attempts;
+    level_vetoes   += vetoes;
+    for (int i = 0; i < nerrors; ++i)
+    {
+        string name, err;
+        if (!mapstat_read_string(f, name) || !mapstat_read_string(f, err))
+            return false;
+        errors[name] = err;
+    }
+
+    if (!_merge_count_map(f, try_count)
+        || !_merge_count_map(f, use_count)
+        || !_merge_count_map(f, success_count)
+        || !_merge_count_map(f, veto_messages))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < NUM_MAPSTAT_PHASES; ++i)
+        if (!_merge_cost(f, phase_costs[i])
+            || !_merge_cost(f, wasted_phase_costs[i]))
+        {
+            return false;
+        }
+    if (!_merge_cost_map(f, veto_costs)
+        || !_merge_cost_map(f, vault_veto_costs))
+    {
+        return false;
+    }
+
+    unsigned int n, m;
+    level_id lid;
+    if (fscanf(f, "%u\n", &n) != 1)
+        return false;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        int count;
+        if (!mapstat_read_level(f, lid) || fscanf(f, "%d\n", &count) != 1)
+            return false;
+        level_mapcounts[lid] += count;
+    }
+
+    if (fscanf(f, "%u\n", &n) != 1)
+        return false;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        int builds, lvetoes;
+        if (!mapstat_read_level(f, lid)
+            || fscanf(f, "%d %d\n", &builds, &lvetoes) != 2)
+        {
+            return false;
+        }
+        map_builds[lid].first  += builds;
+        map_builds[lid].second += lvetoes;
+    }
+
+    if (fscanf(f, "%u\n", &n) != 1)
+        return false;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        if (!mapstat_read_level(f, lid) || fscanf(f, "%u\n", &m) != 1)
+            return false;
+        set<string> &maps = level_mapsused[lid];
+        for (unsigned int j = 0; j < m; ++j)
+        {
+            string name;
+            if (!mapstat_read_string(f, name))
+                return false;
+            maps.insert(name);
+        }
+    }
+
+    if (fscanf(f, "%u\n", &n) != 1)
+        return false;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        string name;
+        if (!mapstat_read_string(f, name) || fscanf(f, "%u\n", &m) != 1)
+            return false;
+        set<level_id> &levels = map_levelsused[name];
+        for (unsigned int j = 0; j < m; ++j)
+        {
+            if (!mapstat_read_level(f, lid))
+                return false;
+            levels.insert(lid);
+        }
+    }
+
+    return !crawl_state.obj_stat_gen || objstat_merge_worker_stats(f);
+}
+
+#ifndef TARGET_OS_WINDOWS
+static string _worker_stat_file(int job)
+{
+    return make_stringf("mapstat.worker%d.tmp", job);
+}
+
+// Split the iterations into contiguous blocks, build each block in a forked
+// worker and merge their tallies in worker order. Since every iteration has
+// its own seed, this gives the same totals as building them all here.
+static bool _build_iterations_in_workers(uint32_t base_seed, int jobs)
+{
+    const int iters = SysEnv.map_gen_iters;
+    vector<pid_t> workers;
+    fflush(stdout);
+    for (int job = 0; job < jobs; ++job)
+    {
+        const int first = iters * job / jobs;
+        const int last  = iters * (job + 1) / jobs;
+        const pid_t pid = fork();
+        if (pid == -1)
+        {
+            fprintf(stderr, "Couldn't fork mapstat worker: %s\n",
+                    strerror(errno));
+            end(1);
+        }
+        if (pid == 0)
+        {
+            const bool success = _build_iterations(base_seed, first, last);
+            FILE *f = fopen_u(_worker_stat_file(job).c_str(), "wb");
+            if (!f)
+                _exit(1);
+            _write_worker_stats(f, success);
+            _exit(fclose(f) ? 1 : 0);
+        }
+        workers.push_back(pid);
+    }
+
+    bool all_success = true;
+    for (int job = 0; job < jobs; ++job)
+    {
+        int status = 0;
+        waitpid(workers[job], &status, 0);
+        const string file = _worker_stat_file(job);
+        FILE *f = fopen_u(file.c_str(), "rb");
+        bool success = false;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) || !f
+            || !_merge_worker_stats(f, success))
+        {
+            fprintf(stderr, "Mapstat worker %d failed.\n", job);
+            success = false;
+        }
+        if (f)
+            fclose(f);
+        unlink_u(file.c_str());
+        all_success = all_success && success;
+    }
+    return all_success;
+}
+#endif
+
+/**
+ * Build dungeon levels for mapstat or objstat.
+ *
+ * The exact branches/levels built and number of build iterations is set by the
+ * command-line options for mapstat/objstat. With -jobs, the iterations are
+ * divided among that many worker processes and their results merged.
+
+ * @returns True if all iterations built successfully. For mapstat, this can
+ * return false if an iteration produced a disconnected level, since for
+ * diagnostic purposes we record the map in detail to a file and exit. For
+ * objstat, this only returns false if the primary dungeon generation function
+ * builder() fails, as the level may be in an invalid state and any object
+ * statistics erroneous.
+*/
+bool mapstat_build_levels()
+{
+    if (!generated_levels.size())
+        _dungeon_places();
+
+    // -seed fixes the whole seed list; otherwise pick a base at random.
+    const uint32_t base_seed = Options.seed ? Options.seed : get_uint32();
+    printf("Base seed: %x\n", base_seed);
+
+    bool success;
+#ifndef TARGET_OS_WINDOWS
+    const int jobs = min(SysEnv.map_gen_jobs, SysEnv.map_gen_iters);
+    if (jobs > 1)
+        success = _build_iterations_in_workers(base_seed, jobs);
+    else
+#endif
+        success = _build_iterations(base_seed, 0, SysEnv.map_gen_iters);
+
+    // Leave the RNG in the same state however the levels were built, as
+    // the reports that follow may use it.
+    seed_rng(_iteration_seed(base_seed, SysEnv.map_gen_iters));
+    return success;
+}
+
 void mapstat_report_map_try(const map_def &map)
 {
     try_count[map.name]++;
@@ -479,6 +943,49 @@ static void _write_map_stats()
     printf("\n");
 }
 
+static string _csv_field(const string &s)
+{
+    return "\"" + replace_all(s, "\"", "\"\"") + "\"";
+}
+
+static void _write_build_cost(FILE *outf, const char *kind,
+                              const string &name, const build_cost &cost)
+{
+    fprintf(outf, "%s,%s,%d,%.3f\n", kind, _csv_field(name).c_str(),
+            cost.count, cost.usecs / 1000.0);
+}
+
+// Where level build time went, and which vetoes and vaults wasted the
+// most of it, as CSV for sorting in a spreadsheet.
+static void _write_build_costs()
+{
+    const char *out_file = "mapstat-builds.csv";
+    FILE *outf = fopen(out_file, "w");
+    if (!outf)
+    {
+        fprintf(stderr, "Couldn't write %s.\n", out_file);
+        return;
+    }
+    printf("Writing level build costs to %s...", out_file);
+    fflush(stdout);
+
+    fprintf(outf, "kind,name,builds,ms\n");
+    for (int i = 0; i < NUM_MAPSTAT_PHASES; ++i)
+        _write_build_cost(outf, "phase", phase_names[i], phase_costs[i]);
+    for (int i = 0; i < NUM_MAPSTAT_PHASES; ++i)
+    {
+        _write_build_cost(outf, "wasted phase", phase_names[i],
+                          wasted_phase_costs[i]);
+    }
+    for (const auto &entry : veto_costs)
+        _write_build_cost(outf, "veto", entry.first, entry.second);
+    for (const auto &entry : vault_veto_costs)
+        _write_build_cost(outf, "vault", entry.first, entry.second);
+
+    fclose(outf);
+    printf("\n");
+}
+
 void mapstat_generate_stats()
 {
     // Warn assertions about possible oddities like the artefact list being
@@ -504,7 +1011,250 @@ void mapstat_generate_stats()
     // build.
     mapstat_build_levels();
     _write_map_stats();
+    _write_build_costs();
     printf("Map stats complete.\n");
 }
 
+// -bench: time the core kernels on fixed, seeded levels.
+
+// The level the LOS, pathfinding, noise and save kernels are timed on.
+static const branch_type BENCH_BRANCH = BRANCH_DUNGEON;
+static const int BENCH_DEPTH = 10;
+// How many cells of that level the kernels start from.
+static const int BENCH_SAMPLES = 256;
+
+struct bench_result
+{
+    string name;
+    string level;
+    long long calls = 0;
+    long long usecs = 0;
+};
+
+static vector<bench_result> bench_results;
+
+// Time calls to func, charging them to the named kernel.
+template<class F>
+static void _bench(const string &name, const string &level, long long calls,
+                   F func)
+{
+    const build_clock::time_point start = build_clock::now();
+    func();
+    const long long usecs = chrono::duration_cast<chrono::microseconds>(
+                                build_clock::now() - start).count();
+    for (bench_result &res : bench_results)
+        if (res.name == name && res.level == level)
+        {
+            res.calls += calls;
+            res.usecs += usecs;
+            return;
+        }
+    bench_result res;
+    res.name = name;
+    res.level = level;
+    res.calls = calls;
+    res.usecs = usecs;
+    bench_results.push_back(res);
+}
+
+static void _reset_dungeon_for_bench(uint32_t seed)
+{
+    seed_rng(seed);
+    dlua.callfn("dgn_clear_data", "");
+    you.uniq_map_tags.clear();
+    you.uniq_map_names.clear();
+    you.unique_creatures.reset();
+    you.unique_items.init(UNIQ_NOT_EXISTS);
+    initialise_branch_depths();
+    init_level_connectivity();
+}
+
+// Build the first chosen level of each branch, timing builder() alone.
+static void _bench_builder(uint32_t seed)
+{
+    _reset_dungeon_for_bench(seed);
+    branch_type last = NUM_BRANCHES;
+    for (const level_id lid : generated_levels)
+    {
+        if (lid.branch == last)
+            continue;
+        last = lid.branch;
+        you.where_are_you = lid.branch;
+        you.depth = lid.depth;
+        watchdog();
+        no_messages mx;
+        _bench("builder", lid.describe(), 1, [] { builder(); });
+    }
+}
+
+// Evenly spaced non-solid cells of the current level.
+static vector<coord_def> _bench_sample_cells()
+{
+    vector<coord_def> open;
+    for (rectangle_iterator ri(1); ri; ++ri)
+        if (!cell_is_solid(*ri))
+            open.push_back(*ri);
+    vector<coord_def> samples;
+    const size_t step = max<size_t>(1, open.size() / BENCH_SAMPLES);
+    for (size_t i = 0; i < open.size(); i += step)
+        samples.push_back(open[i]);
+    return samples;
+}
+
+static void _bench_kernels(uint32_t seed)
+{
+    _reset_dungeon_for_bench(seed);
+    you.where_are_you = BENCH_BRANCH;
+    you.depth = min(BENCH_DEPTH, brdepth[BENCH_BRANCH]);
+    {
+        no_messages mx;
+        if (!builder())
+        {
+            fprintf(stderr, "Couldn't build %s for benchmarking.\n",
+                    level_id::current().describe().c_str());
+            end(1);
+        }
+        unwind_bool wiz(you.wizard, true);
+        magic_mapping(1000, 100, true, true, false,
+                      coord_def(GXM/2, GYM/2));
+    }
+    const string level = level_id::current().describe();
+
+    const vector<coord_def> cells = _bench_sample_cells();
+    // Pairs of sample cells within LOS range of each other, and pairs
+    // across the level for the pathfinders.
+    vector<pair<coord_def, coord_def>> near, far;
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        for (size_t j = i + 1; j < cells.size(); ++j)
+            if ((cells[i] - cells[j]).rdist() <= LOS_RADIUS)
+                near.emplace_back(cells[i], cells[j]);
+        far.emplace_back(cells[i], cells[cells.size() - 1 - i]);
+    }
+
+    _bench("losight", level, cells.size(), [&] {
+        los_grid sh;
+        for (const coord_def &c : cells)
+            losight(sh, c);
+    });
+
+    invalidate_los();
+    _bench("cell_see_cell", level, near.size(), [&] {
+        for (const auto &p : near)
+            cell_see_cell(p.first, p.second, LOS_DEFAULT);
+    });
+
+    _bench("find_ray", level, near.size(), [&] {
+        ray_def ray;
+        for (const auto &p : near)
+            find_ray(p.first, p.second, ray, opc_solid_see);
+    });
+
+    _bench("monster_pathfind", level, far.size(), [&] {
+        for (const auto &p : far)
+        {
+            monster_pathfind mp;
+            mp.init_pathfind(p.first, p.second);
+        }
+    });
+
+    _bench("travel_pathfind", level, cells.size(), [&] {
+        for (const coord_def &c : cells)
+        {
+            travel_pathfind tp;
+            tp.set_floodseed(c);
+            tp.pathfind(RMODE_CONNECTIVITY);
+        }
+    });
+
+    _bench("propagate_noise", level, cells.size(), [&] {
+        for (const coord_def &c : cells)
+        {
+            noise_grid noise;
+            noise.register_noise(noise_t(c, "", 15 * 1000));
+            noise.propagate_noise();
+        }
+    });
+
+    fix_item_coordinates();
+    vector<unsigned char> buf;
+    _bench("tag_write_level", level, 1, [&] {
+        writer outf(&buf);
+        tag_write(TAG_LEVEL, outf);
+    });
+    _bench("tag_read_level", level, 1, [&] {
+        reader inf(buf, TAG_MINOR_VERSION);
+        crawl_state.minor_version = TAG_MINOR_VERSION;
+        tag_read(inf, TAG_LEVEL);
+    });
+}
+
+static void _write_bench_results(uint32_t base_seed)
+{
+    const char *out_file = "bench.json";
+    FILE *outf = fopen(out_file, "w");
+    if (!outf)
+    {
+        fprintf(stderr, "Couldn't write %s.\n", out_file);
+        return;
+    }
+    printf("Writing benchmark results to %s...", out_file);
+    fflush(stdout);
+
+    fprintf(outf, "{\n  \"version\": \"%s\",\n  \"seed\": %u,\n"
+            "  \"rounds\": %d,\n  \"kernels\": [",
+            Version::Long, base_seed, SysEnv.map_gen_iters);
+    for (size_t i = 0; i < bench_results.size(); ++i)
+    {
+        const bench_result &res = bench_results[i];
+        fprintf(outf, "%s\n    {\"name\": \"%s\", \"level\": \"%s\", "
+                "\"calls\": %lld, \"usecs\": %lld, \"ns_per_call\": %.1f}",
+                i ? "," : "", res.name.c_str(), res.level.c_str(), res.calls,
+                res.usecs,
+                res.calls ? res.usecs * 1000.0 / res.calls : 0.0);
+    }
+    fprintf(outf, "\n  ]\n}\n");
+
+    fclose(outf);
+    printf("\n");
+}
+
+/**
+ * Time the core kernels, writing the results to bench.json.
+ *
+ * Each of the -iters rounds builds the first chosen level of every branch
+ * (see -mapstat for the level syntax), then rebuilds D:10 and times LOS,
+ * rays, pathfinding, noise propagation and level save/load on it. Every
+ * round uses its own seed derived from the base seed, so runs with the same
+ * -seed time the same work.
+ */
+void mapstat_run_benchmarks()
+{
+    you.wizard = true;
+    you.species = SP_HUMAN;
+
+    initialise_item_descriptions();
+    initialise_branch_depths();
+    run_map_global_preludes();
+    run_map_local_preludes();
+
+    _dungeon_places();
+    clear_messages();
+
+    const uint32_t base_seed = Options.seed ? Options.seed : get_uint32();
+    printf("Benchmarking %d round(s) with base seed %x.\n",
+           SysEnv.map_gen_iters, base_seed);
+    printf("Round: ");
+    fflush(stdout);
+    for (int i = 0; i < SysEnv.map_gen_iters; ++i)
+    {
+        printf("%d..", i + 1);
+        fflush(stdout);
+        _bench_builder(_iteration_seed(base_seed, i));
+        _bench_kernels(_iteration_seed(base_seed, i));
+    }
+    printf("Finished.\n");
+    _write_bench_results(base_seed);
+}
+
 #endif // DEBUG_STATISTICS
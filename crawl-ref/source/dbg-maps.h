@@ -15,8 +15,42 @@ void mapstat_report_map_success(const string &map_name);
 void mapstat_report_error(const map_def &map, const string &err);
 void mapstat_report_map_build_start();
 void mapstat_report_map_veto(const string &message);
+void mapstat_report_map_build_end(bool success);
 void mapstat_generate_stats();
 bool mapstat_build_levels();
+void mapstat_run_benchmarks();
+
+// Helpers for passing stats back from -jobs worker processes.
+void mapstat_write_string(FILE *f, const string &s);
+bool mapstat_read_string(FILE *f, string &s);
+void mapstat_write_level(FILE *f, const level_id &lid);
+bool mapstat_read_level(FILE *f, level_id &lid);
+
+// The stages of a level build that mapstat times separately. Time not
+// spent inside any timed stage counts as MSP_OTHER.
+enum mapstat_phase
+{
+    MSP_OTHER,
+    MSP_LAYOUT,
+    MSP_PRIMARY_VAULT,
+    MSP_MINIVAULTS,
+    MSP_CONNECTIVITY,
+    MSP_MONSTERS,
+    MSP_ITEMS,
+    NUM_MAPSTAT_PHASES
+};
+
+// Charges the time until it goes out of scope to a build phase. Timers
+// nest: an inner timer's time is charged only to its own phase.
+class mapstat_phase_timer
+{
+public:
+    mapstat_phase_timer(mapstat_phase phase);
+    ~mapstat_phase_timer();
+
+private:
+    mapstat_phase outer;
+};
 #endif
 
 #endif
@@ -872,6 +872,121 @@ void objstat_iteration_stats()
     }
 }
 
+static void _write_stat_table(FILE *f, const map<string, double> &stats)
+{
+    fprintf(f, "%u\n", (unsigned int)stats.size());
+    for (const auto &entry : stats)
+    {
+        mapstat_write_string(f, entry.first);
+        // Hex floats round-trip exactly.
+        fprintf(f, "%a\n", entry.second);
+    }
+}
+
+// Min and max fields are folded as such; everything else is a running sum,
+// including the sums of squares behind the SD fields.
+static bool _merge_stat_table(FILE *f, map<string, double> &stats)
+{
+    unsigned int n;
+    if (fscanf(f, "%u\n", &n) != 1)
+        return false;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        string field;
+        double value;
+        if (!mapstat_read_string(f, field) || fscanf(f, "%la\n", &value) != 1)
+            return false;
+        if (ends_with(field, "Min"))
+            stats[field] = min(stats[field], value);
+        else if (ends_with(field, "Max"))
+            stats[field] = max(stats[field], value);
+        else
+            stats[field] += value;
+    }
+    return true;
+}
+
+static void _write_brand_records(FILE *f, const brand_records &brands)
+{
+    for (const auto &entry : brands)
+        for (const auto &sub : entry.second)
+            for (const auto &antiq : sub)
+                for (int count : antiq)
+                    fprintf(f, "%d\n", count);
+}
+
+static bool _merge_brand_records(FILE *f, brand_records &brands)
+{
+    for (auto &entry : brands)
+        for (auto &sub : entry.second)
+            for (auto &antiq : sub)
+                for (int &count : antiq)
+                {
+                    int value;
+                    if (fscanf(f, "%d\n", &value) != 1)
+                        return false;
+                    count += value;
+                }
+    return true;
+}
+
+/**
+ * Dump the tallies of a mapstat -jobs worker. Every worker is forked after
+ * _init_stats(), so all of them (and the parent) have tables of the same
+ * shape; only the values need to be passed back.
+ */
+void objstat_write_worker_stats(FILE *f)
+{
+    for (const auto &entry : item_recs)
+        for (const auto &base : entry.second)
+            for (const auto &sub : base)
+                _write_stat_table(f, sub);
+
+    _write_brand_records(f, weapon_brands);
+    _write_brand_records(f, armour_brands);
+
+    for (const auto &entry : missile_brands)
+        for (const auto &sub : entry.second)
+            for (int count : sub)
+                fprintf(f, "%d\n", count);
+
+    for (const auto &entry : monster_recs)
+        for (const auto &mons : entry.second)
+            _write_stat_table(f, mons.second);
+}
+
+bool objstat_merge_worker_stats(FILE *f)
+{
+    for (auto &entry : item_recs)
+        for (auto &base : entry.second)
+            for (auto &sub : base)
+                if (!_merge_stat_table(f, sub))
+                    return false;
+
+    if (!_merge_brand_records(f, weapon_brands)
+        || !_merge_brand_records(f, armour_brands))
+    {
+        return false;
+    }
+
+    for (auto &entry : missile_brands)
+        for (auto &sub : entry.second)
+            for (int &count : sub)
+            {
+                int value;
+                if (fscanf(f, "%d\n", &value) != 1)
+                    return false;
+                count += value;
+            }
+
+    for (auto &entry : monster_recs)
+        for (auto &mons : entry.second)
+            if (!_merge_stat_table(f, mons.second))
+                return false;
+
+    return true;
+}
+
 static void _write_stat_headers(const vector<string> &fields, bool items = true)
 {
     fprintf(stat_outf, "%s\tLevel", items ? "Item" : "Monster");
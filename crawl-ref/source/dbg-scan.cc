@@ -80,10 +80,19 @@ static void _dump_item(const char *name, int num, const item_def &item,
     crawl_state.cancel_cmd_repeat();
 }
 
-void debug_item_scan()
+static bool _thorough_scan(bool thorough)
 {
+#ifdef DEBUG
+    return true;
+#else
+    return thorough || you.wizard;
+#endif
+}
+
+void debug_item_scan(bool thorough)
+{
+    thorough = _thorough_scan(thorough);
     int   i;
-    char  name[256];
 
     FixedBitVector<MAX_ITEMS> visited;
 
@@ -147,19 +156,28 @@ void debug_item_scan()
         if (!mitm[i].defined())
             continue;
 
-        strlcpy(name, mitm[i].name(DESC_PLAIN).c_str(), sizeof(name));
+        // Only build the name if we need it.
+        string name_buf;
+        auto name = [&]() -> const char * {
+            if (name_buf.empty())
+                name_buf = mitm[i].name(DESC_PLAIN);
+            return name_buf.c_str();
+        };
 
         const monster* mon = mitm[i].holding_monster();
 
         // Don't check (-1, -1) player items or (-2, -2) monster items
         // (except to make sure that the monster is alive).
         if (mitm[i].pos.origin())
-            _dump_item(name, i, mitm[i], "Unlinked temporary item:");
+            _dump_item(name(), i, mitm[i], "Unlinked temporary item:");
         else if (mon != nullptr && mon->type == MONS_NO_MONSTER)
-            _dump_item(name, i, mitm[i], "Unlinked item held by dead monster:");
+        {
+            _dump_item(name(), i, mitm[i],
+                       "Unlinked item held by dead monster:");
+        }
         else if ((mitm[i].pos.x > 0 || mitm[i].pos.y > 0) && !visited[i])
         {
-            _dump_item(name, i, mitm[i], "Unlinked item:");
+            _dump_item(name(), i, mitm[i], "Unlinked item:");
 
             if (!in_bounds(mitm[i].pos))
             {
@@ -200,18 +218,19 @@ void debug_item_scan()
         //
         // Theoretically some of these could match random names.
         //
-        if (strstr(name, "questionable") != nullptr
-            || strstr(name, "eggplant") != nullptr
-            || strstr(name, "buggy") != nullptr
-            || strstr(name, "buggi") != nullptr)
+        if (thorough
+            && (strstr(name(), "questionable") != nullptr
+                || strstr(name(), "eggplant") != nullptr
+                || strstr(name(), "buggy") != nullptr
+                || strstr(name(), "buggi") != nullptr))
         {
-            _dump_item(name, i, mitm[i], "Bad item:");
+            _dump_item(name(), i, mitm[i], "Bad item:");
         }
         else if (abs(mitm[i].plus) > 30 &&
                     (mitm[i].base_type == OBJ_WEAPONS
                      || mitm[i].base_type == OBJ_ARMOUR))
         {
-            _dump_item(name, i, mitm[i], "Bad plus:");
+            _dump_item(name(), i, mitm[i], "Bad plus:");
         }
         else if (!is_artefact(mitm[i])
                  && (mitm[i].base_type == OBJ_WEAPONS
@@ -219,14 +238,14 @@ void debug_item_scan()
                      || mitm[i].base_type == OBJ_ARMOUR
                         && mitm[i].brand >= NUM_SPECIAL_ARMOURS))
         {
-            _dump_item(name, i, mitm[i], "Bad special value:");
+            _dump_item(name(), i, mitm[i], "Bad special value:");
         }
         else if (mitm[i].flags & ISFLAG_SUMMONED && in_bounds(mitm[i].pos))
-            _dump_item(name, i, mitm[i], "Summoned item on floor:");
+            _dump_item(name(), i, mitm[i], "Summoned item on floor:");
     }
 
     // Quickly scan monsters for "program bug"s.
-    for (i = 0; i < MAX_MONSTERS; ++i)
+    for (i = 0; thorough && i < MAX_MONSTERS; ++i)
     {
         const monster& mons = menv[i];
 
@@ -655,7 +674,7 @@ void debug_mons_scan()
  * valid, all branch exits are generated, and all portals generated at fixed
  * levels in the Depths are actually present.
  */
-void check_map_validity()
+void check_map_validity(bool thorough)
 {
 #ifdef ASSERTS
     dungeon_feature_type portal = DNGN_UNSEEN;
@@ -724,7 +743,7 @@ void check_map_validity()
     }
 
     // And just for good measure:
-    debug_item_scan();
+    debug_item_scan(thorough);
     debug_mons_scan();
 #endif
 }
@@ -6,8 +6,10 @@
 #ifndef DBGSCAN_H
 #define DBGSCAN_H
 
-void debug_item_scan();
+// Quick scans skip the checks that need item and monster names, which are
+// much the slowest part; anything wrong still gets reported by name.
+void debug_item_scan(bool thorough = true);
 void debug_mons_scan();
-void check_map_validity();
+void check_map_validity(bool thorough = true);
 
 #endif
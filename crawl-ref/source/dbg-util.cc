@@ -7,19 +7,26 @@
 
 #include "dbg-util.h"
 
+#ifdef DEBUG_PROFILE
+# include <chrono>
+#endif
+
 #include "artefact.h"
 #include "directn.h"
 #include "dungeon.h"
+#include "initfile.h"
 #include "libutil.h"
 #include "macro.h"
 #include "message.h"
 #include "options.h"
+#include "prompt.h"
 #include "religion.h"
 #include "shopping.h"
 #include "skills.h"
 #include "spl-util.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 
 monster_type debug_prompt_for_monster()
 {
@@ -479,3 +486,145 @@ void wizard_toggle_dprf()
     }
 }
 #endif
+
+#ifdef DEBUG_PROFILE
+static const char *prof_section_names[] =
+{
+    "world_reacts", "monsters", "noises", "clouds", "time", "update_level",
+    "view", "lua", "webtiles",
+};
+COMPILE_CHECK(ARRAYSZ(prof_section_names) == NUM_PROF_SECTIONS);
+
+struct prof_counter
+{
+    long long calls;
+    long long nsecs;
+    long long turn_nsecs;
+    long long max_turn_nsecs;
+};
+
+static prof_counter prof_counters[NUM_PROF_SECTIONS];
+static int prof_turns = 0;
+static prof_section prof_current = NUM_PROF_SECTIONS;
+static chrono::steady_clock::time_point prof_mark;
+
+// Charge the time since the last mark to the current section.
+static void _prof_charge()
+{
+    const auto now = chrono::steady_clock::now();
+    if (prof_current != NUM_PROF_SECTIONS)
+    {
+        const long long ns =
+            chrono::duration_cast<chrono::nanoseconds>(now - prof_mark).count();
+        prof_counters[prof_current].nsecs += ns;
+        prof_counters[prof_current].turn_nsecs += ns;
+    }
+    prof_mark = now;
+}
+
+prof_timer::prof_timer(prof_section section) : outer(prof_current)
+{
+    _prof_charge();
+    prof_current = section;
+    prof_counters[section].calls++;
+}
+
+prof_timer::~prof_timer()
+{
+    _prof_charge();
+    prof_current = outer;
+}
+
+void profile_turn_end()
+{
+    _prof_charge();
+    prof_turns++;
+    for (prof_counter &c : prof_counters)
+    {
+        c.max_turn_nsecs = max(c.max_turn_nsecs, c.turn_nsecs);
+        c.turn_nsecs = 0;
+    }
+}
+
+void profile_reset()
+{
+    for (prof_counter &c : prof_counters)
+        c = prof_counter();
+    prof_turns = 0;
+}
+
+static double _prof_ms(long long nsecs)
+{
+    return nsecs / 1e6;
+}
+
+string profile_csv()
+{
+    string out = "section,calls,total_ms,ms_per_turn,max_turn_ms\n";
+    for (int i = 0; i < NUM_PROF_SECTIONS; ++i)
+    {
+        const prof_counter &c = prof_counters[i];
+        out += make_stringf("%s,%lld,%.3f,%.4f,%.3f\n",
+                            prof_section_names[i], c.calls,
+                            _prof_ms(c.nsecs),
+                            prof_turns ? _prof_ms(c.nsecs) / prof_turns : 0.0,
+                            _prof_ms(c.max_turn_nsecs));
+    }
+    return out;
+}
+
+string profile_json()
+{
+    string out = make_stringf("{\"turns\":%d,\"sections\":{", prof_turns);
+    for (int i = 0; i < NUM_PROF_SECTIONS; ++i)
+    {
+        const prof_counter &c = prof_counters[i];
+        out += make_stringf("%s\"%s\":{\"calls\":%lld,\"total_ms\":%.3f,"
+                            "\"max_turn_ms\":%.3f}",
+                            i ? "," : "", prof_section_names[i], c.calls,
+                            _prof_ms(c.nsecs), _prof_ms(c.max_turn_nsecs));
+    }
+    return out + "}}";
+}
+
+// Write the counters to the -profile-out file, as JSON if its name ends in
+// .json and CSV otherwise.
+void profile_write_out()
+{
+    const string &file = SysEnv.profile_out_file;
+    if (file.empty())
+        return;
+
+    FILE *f = fopen_u(file.c_str(), "w");
+    if (!f)
+    {
+        fprintf(stderr, "Can't write %s\n", file.c_str());
+        return;
+    }
+    const bool json = ends_with(file, ".json");
+    fprintf(f, "%s%s", (json ? profile_json() : profile_csv()).c_str(),
+            json ? "\n" : "");
+    fclose(f);
+}
+
+void wizard_show_profile()
+{
+    mprf(MSGCH_DIAGNOSTICS, "Profile over %d turns:", prof_turns);
+    mprf(MSGCH_DIAGNOSTICS, "%-13s %9s %10s %8s %8s", "section", "calls",
+         "total ms", "ms/turn", "max ms");
+    for (int i = 0; i < NUM_PROF_SECTIONS; ++i)
+    {
+        const prof_counter &c = prof_counters[i];
+        mprf(MSGCH_DIAGNOSTICS, "%-13s %9lld %10.1f %8.3f %8.2f",
+             prof_section_names[i], c.calls, _prof_ms(c.nsecs),
+             prof_turns ? _prof_ms(c.nsecs) / prof_turns : 0.0,
+             _prof_ms(c.max_turn_nsecs));
+    }
+
+    if (yesno("Reset the counters?", true, 'n'))
+    {
+        profile_reset();
+        mpr("Profile counters reset.");
+    }
+}
+#endif
@@ -29,4 +29,46 @@ string debug_mon_str(const monster* mon);
 
 void wizard_toggle_dprf();
 
+// Per-turn subsystem timers, compiled in with DEBUG_PROFILE.
+#ifdef DEBUG_PROFILE
+enum prof_section
+{
+    PROF_WORLD_REACTS,  // whatever world_reacts() does outside the others
+    PROF_MONSTERS,
+    PROF_NOISES,
+    PROF_CLOUDS,
+    PROF_TIME,
+    PROF_UPDATE_LEVEL,
+    PROF_VIEW,
+    PROF_LUA,
+    PROF_WEBTILES,
+    NUM_PROF_SECTIONS
+};
+
+// Time spent while one of these is the innermost timer alive is charged to
+// its section, so nested sections don't count twice.
+class prof_timer
+{
+public:
+    prof_timer(prof_section section);
+    ~prof_timer();
+private:
+    prof_section outer;
+};
+
+# define PROF_CONCAT_(a, b) a##b
+# define PROF_CONCAT(a, b) PROF_CONCAT_(a, b)
+# define PROFILE_SECTION(section) \
+    prof_timer PROF_CONCAT(prof_timer_, __LINE__)(section)
+
+void profile_turn_end();
+void profile_reset();
+string profile_csv();
+string profile_json();
+void profile_write_out();
+void wizard_show_profile();
+#else
+# define PROFILE_SECTION(section)
+#endif
+
 #endif
@@ -19,6 +19,10 @@
 #include "syscalls.h"
 
 static struct stat mfilestat;
+// Set once the launcher has promised to tell us when messages arrive, after
+// which check_messages() only looks at the message file when told to.
+static bool messages_pushed = false;
+static bool messages_notified = false;
 
 static void _show_message_line(string line)
 {
@@ -125,17 +129,35 @@ static void _announce_messages()
     mprf(MSGCH_DGL_MESSAGE, "Beep! Your pager goes off! Use _ to check your messages.");
 }
 
+void set_messages_pushed(bool pushed)
+{
+    messages_pushed = pushed;
+}
+
+void notify_messages()
+{
+    messages_notified = true;
+}
+
 void check_messages()
 {
     if (!Options.messaging
         || SysEnv.have_messages
         || SysEnv.messagefile.empty()
-        || kbhit()
-        || (SysEnv.message_check_tick++ % DGL_MESSAGE_CHECK_INTERVAL))
+        || kbhit())
     {
         return;
     }
 
+    if (messages_pushed)
+    {
+        if (!messages_notified)
+            return;
+        messages_notified = false;
+    }
+    else if (SysEnv.message_check_tick++ % DGL_MESSAGE_CHECK_INTERVAL)
+        return;
+
     const bool had_messages = SysEnv.have_messages;
     struct stat st;
     if (stat(SysEnv.messagefile.c_str(), &st))
@@ -5,6 +5,10 @@
 
 void read_messages();
 void check_messages();
+// For launchers that tell us about new messages instead of leaving us to
+// poll the message file.
+void set_messages_pushed(bool pushed);
+void notify_messages();
 
 #endif
 
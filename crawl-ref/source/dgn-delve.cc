@@ -4,6 +4,7 @@
 
 #include <deque>
 
+#include "bitary.h"
 #include "coord.h"
 #include "coordit.h"
 #include "directn.h"
@@ -94,29 +95,62 @@ static inline bool _in_map(map_lines *map, coord_def c)
     return map ? map->in_map(c) : in_bounds(c);
 }
 
-static bool _diggable(map_lines *map, coord_def c)
+// The area being delved: either a map_lines, or the level grid if map is
+// null. Which cells are dug out and which may still be dug are mirrored in
+// bit grids, padded by one cell on each side, so the inner loops need not
+// look at glyphs or dungeon features. Only _digcell() changes the area
+// while delve() runs, and it keeps both grids in step.
+struct delve_area
 {
-    if (map)
-        return (*map)(c) == 'x';
-    return grd(c) == DNGN_ROCK_WALL && !map_masked(c, MMT_VAULT);
+    map_lines *map;
+    FixedBitArray<GXM + 2, GYM + 2> dug, diggable;
+
+    delve_area(map_lines *_map) : map(_map)
+    {
+        ASSERT(!map || map->width() <= GXM && map->height() <= GYM);
+        const int w = map ? map->width() : GXM;
+        const int h = map ? map->height() : GYM;
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+            {
+                const coord_def c(x, y);
+                if (map)
+                {
+                    const char glyph = (*map)(c);
+                    dug.set(x + 1, y + 1, strchr(traversable_glyphs, glyph));
+                    diggable.set(x + 1, y + 1, glyph == 'x');
+                }
+                else
+                {
+                    dug.set(x + 1, y + 1, grd(c) == DNGN_FLOOR);
+                    diggable.set(x + 1, y + 1, grd(c) == DNGN_ROCK_WALL
+                                               && !map_masked(c, MMT_VAULT));
+                }
+            }
+    }
+};
+
+static inline bool _diggable(const delve_area &area, coord_def c)
+{
+    return area.diggable(c.x + 1, c.y + 1);
 }
 
-static bool _dug(map_lines *map, coord_def c)
+static inline bool _dug(const delve_area &area, coord_def c)
 {
-    if (map)
-        return strchr(traversable_glyphs, (*map)(c));
-    return grd(c) == DNGN_FLOOR;
+    return area.dug(c.x + 1, c.y + 1);
 }
 
-static void _digcell(map_lines *map, store_type& store, coord_def c)
+static void _digcell(delve_area &area, store_type& store, coord_def c)
 {
-    ASSERT(_in_map(map, c));
-    if (!_diggable(map, c))
+    ASSERT(_in_map(area.map, c));
+    if (!_diggable(area, c))
         return;
-    if (map)
-        (*map)(c) = '.';
+    if (area.map)
+        (*area.map)(c) = '.';
     else
         grd(c) = DNGN_FLOOR;
+    area.dug.set(c.x + 1, c.y + 1);
+    area.diggable.set(c.x + 1, c.y + 1, false);
 
     int order[8] = {0, 1, 2, 3, 4, 5, 6, 7};
     for (unsigned int d = 8; d > 0; d--)
@@ -125,7 +159,7 @@ static void _digcell(map_lines *map, store_type& store, coord_def c)
         coord_def neigh = c + Compass[order[ornd]];
         order[ornd] = order[d - 1];
 
-        if (!_in_map(map, neigh) || !_diggable(map, neigh))
+        if (!_in_map(area.map, neigh) || !_diggable(area, neigh))
             continue;
 
         store.push_back(neigh);
@@ -133,30 +167,30 @@ static void _digcell(map_lines *map, store_type& store, coord_def c)
 }
 
 // Count dug out neighbours.
-static int ngb_count(map_lines *map, coord_def c)
+static int ngb_count(const delve_area &area, coord_def c)
 {
-    ASSERT(_in_map(map, c));
+    ASSERT(_in_map(area.map, c));
 
     int cnt = 0;
     for (unsigned int d = 0; d < 8; d++)
     {
         coord_def neigh = c + Compass[d];
-        if (_dug(map, neigh))
+        if (_dug(area, neigh))
             cnt++;
     }
     return cnt;
 }
 
 // Count disjoint groups of dug out neighbours.
-static int ngb_groups(map_lines *map, coord_def c)
+static int ngb_groups(const delve_area &area, coord_def c)
 {
-    ASSERT(_in_map(map, c));
+    ASSERT(_in_map(area.map, c));
 
-    bool prev2 = 0, prev = _dug(map, c + Compass[0]);
+    bool prev2 = 0, prev = _dug(area, c + Compass[0]);
     int cnt = 0;
     for (int d = 7; d >= 0; d--)
     {
-        bool cur = _dug(map, c + Compass[d]);
+        bool cur = _dug(area, c + Compass[d]);
         // Diagonal connectivity counts, too -- but only cardinal directions
         // (even Compass indices) can reach their predecessors.
         if (cur && !prev && (d&1 || !prev2))
@@ -182,24 +216,25 @@ static int cellnum_est(int world, int ngb_min, int ngb_max)
     return world / denom[ngb_min + ngb_max];
 }
 
-static bool _is_seed(map_lines *map, coord_def c)
+static bool _is_seed(const delve_area &area, coord_def c)
 {
     for (adjacent_iterator ai(c); ai; ++ai)
-        if (_dug(map, *ai))
+        if (_dug(area, *ai))
             return true;
     return false;
 }
 
 // Ensure there's something in the store.
-static int _make_seed(map_lines *map, store_type& store)
+static int _make_seed(const delve_area &area, store_type& store)
 {
-    rectangle_iterator rect = map ? map->get_iter() : rectangle_iterator(1);
+    rectangle_iterator rect = area.map ? area.map->get_iter()
+                                       : rectangle_iterator(1);
 
     int x = 0, y = 0, cnt = 0;
     for (rectangle_iterator ri = rect; ri; ++ri)
-        if (_diggable(map, *ri))
+        if (_diggable(area, *ri))
         {
-            if (_is_seed(map, *ri))
+            if (_is_seed(area, *ri))
                 store.push_back(*ri);
             x += ri->x;
             y += ri->y;
@@ -221,7 +256,7 @@ static int _make_seed(map_lines *map, store_type& store)
     coord_def best;
     int bdist = INT_MAX;
     for (rectangle_iterator ri = rect; ri; ++ri)
-        if (_diggable(map, *ri))
+        if (_diggable(area, *ri))
         {
             int dist = (*ri - center).abs();
             if (dist < bdist)
@@ -240,8 +275,9 @@ void delve(map_lines *map, int ngb_min, int ngb_max, int connchance, int cellnum
     ASSERT(ngb_max <= 8);
     ASSERT_RANGE(connchance, 0, 101);
 
+    delve_area area(map);
     store_type store;
-    int world = _make_seed(map, store);
+    int world = _make_seed(area, store);
 
     if (cellnum < 0)
         cellnum = cellnum_est(world, ngb_min, ngb_max);
@@ -267,12 +303,12 @@ retry:
         coord_def c = _rndpull(store, top);
         if (c.origin())
             break;
-        if (!_diggable(map, c))
+        if (!_diggable(area, c))
             continue;
 
         if ((c - center).abs() > 2
-            || ngb_count(map, c) > ngb_max
-            || (ngb_groups(map, c) > 1 && !x_chance_in_y(connchance, 100)))
+            || ngb_count(area, c) > ngb_max
+            || (ngb_groups(area, c) > 1 && !x_chance_in_y(connchance, 100)))
         {
             // Original algorithm:
             // * ignore ngb_min
@@ -284,7 +320,7 @@ retry:
             continue;
         }
 
-        _digcell(map, store, c);
+        _digcell(area, store, c);
         delved++;
     }
 
@@ -293,18 +329,18 @@ retry:
         coord_def c = _rndpull(store, top);
         if (c.origin())
             break;
-        if (!_diggable(map, c))
+        if (!_diggable(area, c))
             continue;
 
-        int ngbcount = ngb_count(map, c);
+        int ngbcount = ngb_count(area, c);
 
         if (ngbcount < ngb_min || ngbcount > ngb_max
-            || (ngb_groups(map, c) > 1 && !x_chance_in_y(connchance, 100)))
+            || (ngb_groups(area, c) > 1 && !x_chance_in_y(connchance, 100)))
         {
             continue;
         }
 
-        _digcell(map, store, c);
+        _digcell(area, store, c);
         delved++;
     }
 
@@ -312,7 +348,7 @@ retry:
     if (delved < cellnum && retries++ < 50)
     {
         dprf("delve() try %d: only %d/%d done", retries, delved, cellnum);
-        _make_seed(map, store);
+        _make_seed(area, store);
         goto retry;
     }
 }
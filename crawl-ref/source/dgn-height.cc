@@ -8,14 +8,12 @@
 #include "dgn-height.h"
 
 #include "coord.h"
-#include "coordit.h"
 #include "dungeon.h"
 
 void dgn_initialise_heightmap(int height)
 {
     env.heightmap.reset(new grid_heightmap);
-    for (rectangle_iterator ri(0); ri; ++ri)
-        dgn_height_at(*ri) = height;
+    env.heightmap->init(height);
 }
 
 void dgn_height_set_at(const coord_def &c, int height)
@@ -64,20 +62,25 @@ void dgn_smooth_height_at(coord_def c, int radius, int max_height)
         return;
 
     const int max_delta = radius * radius * 2 + 2;
+    // Clip the window to the map once rather than testing every cell.
+    // Heights are stored column-major, so walk each column contiguously.
+    const int x0 = max(c.x - radius, X_BOUND_1 + 1);
+    const int x1 = min(c.x + radius, X_BOUND_2 - 1);
+    const int y0 = max(c.y - radius, Y_BOUND_1 + 1);
+    const int y1 = min(c.y + radius, Y_BOUND_2 - 1);
+    const grid_heightmap &heights = *env.heightmap;
     int divisor = 0;
     int total = 0;
-    for (int y = c.y - radius; y <= c.y + radius; ++y)
+    for (int x = x0; x <= x1; ++x)
     {
-        for (int x = c.x - radius; x <= c.x + radius; ++x)
+        const grid_heightmap::Column &column = heights[x];
+        const int xweight = max_delta - (c.x - x) * (c.x - x);
+        for (int y = y0; y <= y1; ++y)
         {
-            const coord_def p(x, y);
-            if (!in_bounds(p))
-                continue;
-            const int nheight = dgn_height_at(p);
+            const int nheight = column[y];
             if (max_height != DGN_UNDEFINED_HEIGHT && nheight > max_height)
                 continue;
-            const coord_def off = c - p;
-            const int weight = max_delta - off.abs();
+            const int weight = xweight - (c.y - y) * (c.y - y);
             divisor += weight;
             total += nheight * weight;
         }
@@ -221,8 +221,7 @@ LevelLayout::LevelLayout(level_id id, uint32_t _seed, const ProceduralLayout &_l
 {
     if (!is_existing_level(id))
     {
-        for (rectangle_iterator ri(0); ri; ++ri)
-            grid(*ri) = DNGN_UNSEEN;
+        grid.init(DNGN_UNSEEN);
         return;
     }
     level_excursion le;
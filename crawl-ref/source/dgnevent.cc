@@ -23,6 +23,19 @@ void dgn_event_dispatcher::clear()
             grid_triggers[x][y].reset(nullptr);
 }
 
+bool dgn_event_dispatcher::has_listeners() const
+{
+    if (global_event_mask || !listeners.empty())
+        return true;
+
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+            if (grid_triggers[x][y])
+                return true;
+
+    return false;
+}
+
 void dgn_event_dispatcher::clear_listeners_at(const coord_def &pos)
 {
     grid_triggers[pos.x][pos.y].reset(nullptr);
@@ -53,8 +66,9 @@ bool dgn_event_dispatcher::fire_vetoable_position_event(
     dgn_square_alarm *alarm = grid_triggers[pos.x][pos.y].get();
     if (alarm && (alarm->eventmask & et.type))
     {
-        dgn_square_alarm alcopy(*alarm);
-        for (auto listener : alcopy.listeners)
+        // Listeners may unregister themselves while being notified.
+        const auto targets = alarm->listeners;
+        for (auto listener : targets)
             if (!listener->notify_dgn_event(et))
                 return false;
     }
@@ -74,8 +88,8 @@ void dgn_event_dispatcher::fire_position_event(
     dgn_square_alarm *alarm = grid_triggers[pos.x][pos.y].get();
     if (alarm && (alarm->eventmask & et.type))
     {
-        dgn_square_alarm alcopy = *alarm;
-        for (auto listener : alcopy.listeners)
+        const auto targets = alarm->listeners;
+        for (auto listener : targets)
             listener->notify_dgn_event(et);
     }
 }
@@ -84,10 +98,14 @@ void dgn_event_dispatcher::fire_event(const dgn_event &e)
 {
     if (global_event_mask & e.type)
     {
-        auto copy = listeners;
-        for (const auto &ldef : copy)
+        // Snapshot only the listeners that want this event; the list
+        // may change under us while they are being notified.
+        vector<dgn_event_listener*> targets;
+        for (const auto &ldef : listeners)
             if (ldef.eventmask & e.type)
-                ldef.listener->notify_dgn_event(e);
+                targets.push_back(ldef.listener);
+        for (auto listener : targets)
+            listener->notify_dgn_event(e);
     }
 }
 
@@ -20,6 +20,61 @@ static int dlua_compiled_chunk_writer(lua_State *ls, const void *p,
     return 0;
 }
 
+// Loaded chunk functions, keyed by their bytecode. The table has weak
+// values, so this only saves undumping a chunk that is loaded again before
+// the next garbage collection -- as vault Lua is over repeated placement
+// attempts -- without keeping every map's functions alive.
+static const char *DLUA_CHUNK_CACHE = "dlua_chunk_cache";
+
+static void _init_chunk_cache(lua_State *ls)
+{
+    lua_newtable(ls);
+    lua_newtable(ls);
+    lua_pushstring(ls, "v");
+    lua_setfield(ls, -2, "__mode");
+    lua_setmetatable(ls, -2);
+    lua_setfield(ls, LUA_REGISTRYINDEX, DLUA_CHUNK_CACHE);
+}
+
+// Push the cached function for the given bytecode, if there is one.
+static bool _push_cached_chunk(lua_State *ls, const string &compiled)
+{
+    lua_getfield(ls, LUA_REGISTRYINDEX, DLUA_CHUNK_CACHE);
+    if (!lua_istable(ls, -1))
+    {
+        lua_pop(ls, 1);
+        return false;
+    }
+
+    lua_pushlstring(ls, compiled.data(), compiled.length());
+    lua_rawget(ls, -2);
+    lua_remove(ls, -2);
+    if (!lua_isfunction(ls, -1))
+    {
+        lua_pop(ls, 1);
+        return false;
+    }
+
+    // Map chunks get their environment set each time they're run; a freshly
+    // loaded chunk would have the globals instead.
+    lua_pushvalue(ls, LUA_GLOBALSINDEX);
+    lua_setfenv(ls, -2);
+    return true;
+}
+
+// Cache the function on top of the stack under the given bytecode.
+static void _cache_chunk(lua_State *ls, const string &compiled)
+{
+    lua_getfield(ls, LUA_REGISTRYINDEX, DLUA_CHUNK_CACHE);
+    if (lua_istable(ls, -1))
+    {
+        lua_pushlstring(ls, compiled.data(), compiled.length());
+        lua_pushvalue(ls, -3);
+        lua_rawset(ls, -3);
+    }
+    lua_pop(ls, 1);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // dlua_chunk
 
@@ -150,9 +205,19 @@ int dlua_chunk::load(CLua &interp)
 {
     if (!compiled.empty())
     {
-        return check_op(interp,
-                         interp.loadbuffer(compiled.c_str(), compiled.length(),
-                                           context.c_str()));
+        if (_push_cached_chunk(interp, compiled))
+        {
+            error.clear();
+            return 0;
+        }
+
+        const int err = check_op(interp,
+                                 interp.loadbuffer(compiled.c_str(),
+                                                   compiled.length(),
+                                                   context.c_str()));
+        if (!err)
+            _cache_chunk(interp, compiled);
+        return err;
     }
 
     if (empty())
@@ -174,9 +239,22 @@ int dlua_chunk::load(CLua &interp)
         lua_pop(interp, 2);
     }
     compiled = out.str();
+    if (!err)
+        _cache_chunk(interp, compiled);
     return err;
 }
 
+// Compile the chunk's source to bytecode without running it, so that it is
+// stored compiled. A chunk that fails to compile is left as source.
+int dlua_chunk::compile(CLua &interp)
+{
+    if (!compiled.empty() || empty())
+        return 0;
+
+    lua_stack_cleaner clean(interp);
+    return load(interp);
+}
+
 int dlua_chunk::run(CLua &interp)
 {
     int err = load(interp);
@@ -312,4 +390,5 @@ void init_dungeon_lua()
     register_monslist(dlua);
 
     _dlua_register_constants(dlua);
+    _init_chunk_cache(dlua);
 }
@@ -80,8 +80,11 @@
 
 // DUNGEON BUILDERS
 static bool _build_level_vetoable(bool enable_random_maps,
-                                  dungeon_feature_type dest_stairs_type);
+                                  dungeon_feature_type dest_stairs_type,
+                                  bool resume);
 static void _build_dungeon_level(dungeon_feature_type dest_stairs_type);
+static void _build_dungeon_level_features(bool place_vaults,
+                                         dungeon_feature_type dest_stairs_type);
 static bool _valid_dungeon_level();
 
 static bool _builder_by_type();
@@ -230,6 +233,190 @@ static unique_ptr<dungeon_colour_grid> dgn_colour_grid;
 
 static string branch_epilogues[NUM_BRANCHES];
 
+// How many times a level build is retried from its checkpoint before
+// starting over from a blank level.
+#define LEVEL_CHECKPOINT_RETRIES 3
+
+// The state of a level being built, as it was once the layout and primary
+// vault were in place. A veto later in the build can then retry from here
+// instead of redoing the layout.
+struct level_build_checkpoint
+{
+    bool place_vaults;
+    int retries;
+
+    colour_t rock_colour, floor_colour;
+    FixedVector<item_def, MAX_ITEMS> item;
+    FixedVector<monster, MAX_MONSTERS+2> mons;
+    int mons_slots_used;
+    feature_grid grid;
+    FixedArray<terrain_property_t, GXM, GYM> pgrid;
+    FixedArray<unsigned short, GXM, GYM> mgrid;
+    FixedArray<int, GXM, GYM> igrid;
+    FixedArray<unsigned short, GXM, GYM> grid_colours;
+    map_mask level_map_mask, level_map_ids;
+    string_set level_uniq_maps, level_uniq_map_tags, level_layout_types;
+    string level_build_method;
+    vector<vault_placement> level_vaults;
+    unique_ptr<grid_heightmap> heightmap;
+    FixedArray<tile_flavour, GXM, GYM> tile_flv;
+    tile_flavour tile_default;
+    vector<string> tile_names;
+    cell_store<cloud_struct> cloud;
+    cell_store<shop_struct> shop;
+    cell_store<trap_def> trap;
+    FixedVector<monster_type, MAX_MONS_ALLOC> mons_alloc;
+    map_markers markers;
+    CrawlHashTable properties;
+    int spawn_random_rate, density, forest_awoken_until;
+    vector<pair<coord_def, int> > sunlight;
+    map<mid_t, unsigned short> mid_cache;
+
+    FixedBitVector<NUM_MONSTERS> unique_creatures;
+    FixedVector<unique_item_status_type, MAX_UNRANDARTS> unique_items;
+    set<string> uniq_map_tags, uniq_map_names;
+
+    vector<vault_placement> temp_vaults;
+    vector<string> you_vault_list;
+#ifdef DEBUG_STATISTICS
+    vector<string> you_all_vault_list;
+#endif
+    int zones;
+    vector<god_type> temple_altar_list;
+    CrawlHashTable *current_temple_hash;
+    unique_ptr<dungeon_colour_grid> colour_grid;
+};
+
+static unique_ptr<level_build_checkpoint> _level_checkpoint;
+
+template<class T>
+static void _checkpoint_field(T &saved, T &live, bool save)
+{
+    if (save)
+        saved = live;
+    else
+        live = saved;
+}
+
+template<class T>
+static void _checkpoint_field(unique_ptr<T> &saved, unique_ptr<T> &live,
+                              bool save)
+{
+    unique_ptr<T> &to = save ? saved : live;
+    const unique_ptr<T> &from = save ? live : saved;
+    to.reset(from ? new T(*from) : nullptr);
+}
+
+// Copy the level being built into the checkpoint, or back out of it.
+static void _copy_level_checkpoint(level_build_checkpoint &cp, bool save)
+{
+    _checkpoint_field(cp.rock_colour, env.rock_colour, save);
+    _checkpoint_field(cp.floor_colour, env.floor_colour, save);
+    _checkpoint_field(cp.item, env.item, save);
+    _checkpoint_field(cp.mons, env.mons, save);
+    _checkpoint_field(cp.mons_slots_used, env.mons_slots_used, save);
+    _checkpoint_field(cp.grid, env.grid, save);
+    _checkpoint_field(cp.pgrid, env.pgrid, save);
+    _checkpoint_field(cp.mgrid, env.mgrid, save);
+    _checkpoint_field(cp.igrid, env.igrid, save);
+    _checkpoint_field(cp.grid_colours, env.grid_colours, save);
+    _checkpoint_field(cp.level_map_mask, env.level_map_mask, save);
+    _checkpoint_field(cp.level_map_ids, env.level_map_ids, save);
+    _checkpoint_field(cp.level_uniq_maps, env.level_uniq_maps, save);
+    _checkpoint_field(cp.level_uniq_map_tags, env.level_uniq_map_tags, save);
+    _checkpoint_field(cp.level_layout_types, env.level_layout_types, save);
+    _checkpoint_field(cp.level_build_method, env.level_build_method, save);
+    _checkpoint_field(cp.heightmap, env.heightmap, save);
+    _checkpoint_field(cp.tile_flv, env.tile_flv, save);
+    _checkpoint_field(cp.tile_default, env.tile_default, save);
+    _checkpoint_field(cp.tile_names, env.tile_names, save);
+    _checkpoint_field(cp.cloud, env.cloud, save);
+    _checkpoint_field(cp.shop, env.shop, save);
+    _checkpoint_field(cp.trap, env.trap, save);
+    _checkpoint_field(cp.mons_alloc, env.mons_alloc, save);
+    _checkpoint_field(cp.markers, env.markers, save);
+    _checkpoint_field(cp.properties, env.properties, save);
+    _checkpoint_field(cp.spawn_random_rate, env.spawn_random_rate, save);
+    _checkpoint_field(cp.density, env.density, save);
+    _checkpoint_field(cp.forest_awoken_until, env.forest_awoken_until, save);
+    _checkpoint_field(cp.sunlight, env.sunlight, save);
+    _checkpoint_field(cp.mid_cache, env.mid_cache, save);
+
+    if (save)
+    {
+        cp.level_vaults.clear();
+        for (const auto &vp : env.level_vaults)
+            cp.level_vaults.push_back(*vp);
+    }
+    else
+    {
+        env.level_vaults.clear();
+        for (const vault_placement &vp : cp.level_vaults)
+            env.level_vaults.emplace_back(new vault_placement(vp));
+    }
+
+    _checkpoint_field(cp.unique_creatures, you.unique_creatures, save);
+    _checkpoint_field(cp.unique_items, you.unique_items, save);
+    _checkpoint_field(cp.uniq_map_tags, you.uniq_map_tags, save);
+    _checkpoint_field(cp.uniq_map_names, you.uniq_map_names, save);
+
+    _checkpoint_field(cp.temp_vaults, Temp_Vaults, save);
+    _checkpoint_field(cp.you_vault_list, _you_vault_list, save);
+#ifdef DEBUG_STATISTICS
+    _checkpoint_field(cp.you_all_vault_list, _you_all_vault_list, save);
+#endif
+    _checkpoint_field(cp.zones, dgn_zones, save);
+    _checkpoint_field(cp.temple_altar_list, _temple_altar_list, save);
+    _checkpoint_field(cp.current_temple_hash, _current_temple_hash, save);
+    _checkpoint_field(cp.colour_grid, dgn_colour_grid, save);
+}
+
+// Remember the level as it is now, if a later veto could return to it.
+// Vault Lua can register dungeon event listeners, which can't be copied,
+// so levels with any are always rebuilt from scratch.
+static void _save_level_checkpoint(bool place_vaults)
+{
+    if (!crawl_state.game_standard_levelgen() || !use_random_maps
+        || dungeon_events.has_listeners())
+    {
+        _level_checkpoint.reset();
+        return;
+    }
+
+    if (!_level_checkpoint)
+        _level_checkpoint.reset(new level_build_checkpoint);
+    _level_checkpoint->place_vaults = place_vaults;
+    _level_checkpoint->retries = 0;
+    _copy_level_checkpoint(*_level_checkpoint, true);
+}
+
+// Whether the next build attempt should resume from the checkpoint, counting
+// it as one of the checkpoint's retries if so.
+static bool _use_level_checkpoint(bool enable_random_maps)
+{
+    if (!_level_checkpoint)
+        return false;
+
+    if (!enable_random_maps
+        || _level_checkpoint->retries >= LEVEL_CHECKPOINT_RETRIES)
+    {
+        _level_checkpoint.reset();
+        return false;
+    }
+
+    ++_level_checkpoint->retries;
+    return true;
+}
+
+static void _restore_level_checkpoint()
+{
+    ASSERT(_level_checkpoint);
+    clear_subvault_stack();
+    dgn_check_connectivity = false;
+    _copy_level_checkpoint(*_level_checkpoint, false);
+    mons_index_rebuild();
+}
+
 static void _count_gold()
 {
     vector<item_def *> gold_piles;
@@ -305,8 +492,14 @@ bool builder(bool enable_random_maps, dungeon_feature_type dest_stairs_type)
 
         try
         {
-            if (_build_level_vetoable(enable_random_maps, dest_stairs_type))
+            const bool resume = _use_level_checkpoint(enable_random_maps);
+            if (_build_level_vetoable(enable_random_maps, dest_stairs_type,
+                                      resume))
             {
+#ifdef DEBUG_STATISTICS
+                mapstat_report_map_build_end(true);
+#endif
+                _level_checkpoint.reset();
                 for (monster_iterator mi; mi; ++mi)
                     gozag_set_bribe(*mi);
 
@@ -317,12 +510,17 @@ bool builder(bool enable_random_maps, dungeon_feature_type dest_stairs_type)
         {
             mprf(MSGCH_ERROR, "Failed to load map, reloading all maps (%s).",
                  mload.what());
+            _level_checkpoint.reset();
             reread_maps();
         }
+#ifdef DEBUG_STATISTICS
+        mapstat_report_map_build_end(false);
+#endif
 
         you.uniq_map_tags  = uniq_tags;
         you.uniq_map_names = uniq_names;
     }
+    _level_checkpoint.reset();
 
     if (!crawl_state.map_stat_gen && !crawl_state.obj_stat_gen)
     {
@@ -344,21 +542,36 @@ bool builder(bool enable_random_maps, dungeon_feature_type dest_stairs_type)
     return false;
 }
 
+// Build the level from scratch, or if resume is set, from where the
+// level checkpoint left off.
 static bool _build_level_vetoable(bool enable_random_maps,
-                                  dungeon_feature_type dest_stairs_type)
+                                  dungeon_feature_type dest_stairs_type,
+                                  bool resume)
 {
 #ifdef DEBUG_STATISTICS
     mapstat_report_map_build_start();
 #endif
 
-    dgn_reset_level(enable_random_maps);
+    if (resume)
+        _restore_level_checkpoint();
+    else
+    {
+        _level_checkpoint.reset();
+        dgn_reset_level(enable_random_maps);
 
-    if (player_in_branch(BRANCH_TEMPLE))
-        _setup_temple_altars(you.props);
+        if (player_in_branch(BRANCH_TEMPLE))
+            _setup_temple_altars(you.props);
+    }
 
     try
     {
-        _build_dungeon_level(dest_stairs_type);
+        if (resume)
+        {
+            _build_dungeon_level_features(_level_checkpoint->place_vaults,
+                                          dest_stairs_type);
+        }
+        else
+            _build_dungeon_level(dest_stairs_type);
     }
     catch (dgn_veto_exception& e)
     {
@@ -372,10 +585,15 @@ static bool _build_level_vetoable(bool enable_random_maps,
 
     _dgn_set_floor_colours();
 
-    if (crawl_state.game_standard_levelgen()
-        && !_valid_dungeon_level())
     {
-        return false;
+#ifdef DEBUG_STATISTICS
+        mapstat_phase_timer timer(MSP_CONNECTIVITY);
+#endif
+        if (crawl_state.game_standard_levelgen()
+            && !_valid_dungeon_level())
+        {
+            return false;
+        }
     }
 
 #ifdef DEBUG_MONS_SCAN
@@ -819,69 +1037,114 @@ static bool _is_exit_stair(const coord_def &c)
 //
 // If fill is non-zero, it fills any disconnected regions with fill.
 //
-static int _process_disconnected_zones(int x1, int y1, int x2, int y2,
-                                       bool choose_stairless,
-                                       dungeon_feature_type fill)
+// Union-find over map cells (indexed y * GXM + x), with -1 for impassable
+// ones. The root of each set is its first cell in scan order.
+static int _zone_root(vector<int> &parent, int i)
 {
-    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
-    int nzones = 0;
-    int ngood = 0;
-    for (int y = y1; y <= y2 ; ++y)
+    while (parent[i] != i)
     {
-        for (int x = x1; x <= x2; ++x)
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void _zone_union(vector<int> &parent, int a, int b)
+{
+    a = _zone_root(parent, a);
+    b = _zone_root(parent, b);
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+static int _process_disconnected_zones(bool choose_stairless,
+                                       dungeon_feature_type fill)
+{
+    // Label every zone in one sweep rather than flooding each in turn.
+    vector<int> parent(GXM * GYM, -1);
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
         {
-            if (!map_bounds(x, y)
-                || travel_point_distance[x][y]
-                || !_dgn_square_is_passable(coord_def(x, y)))
-            {
+            if (!_dgn_square_is_passable(coord_def(x, y)))
                 continue;
-            }
 
-            const bool found_exit_stair =
-                _dgn_fill_zone(coord_def(x, y), ++nzones,
-                               _dgn_point_record_stub,
-                               _dgn_square_is_passable,
-                               choose_stairless ? (at_branch_bottom() ?
-                                                   _is_upwards_exit_stair :
-                                                   _is_exit_stair) : nullptr);
-
-            // If we want only stairless zones, screen out zones that did
-            // have stairs.
-            if (choose_stairless && found_exit_stair)
-                ++ngood;
-            else if (fill)
+            const int i = y * GXM + x;
+            parent[i] = i;
+            // Join up with the neighbours already seen: W, NW, N and NE.
+            if (x > 0 && parent[i - 1] >= 0)
+                _zone_union(parent, i, i - 1);
+            if (y > 0)
             {
-                // Don't fill in areas connected to vaults.
-                // We want vaults to be accessible; if the area is disconneted
-                // from the rest of the level, this will cause the level to be
-                // vetoed later on.
-                bool veto = false;
-                vector<coord_def> coords;
-                for (int fy = y1; fy <= y2 ; ++fy)
+                for (int dx = -1; dx <= 1; ++dx)
                 {
-                    for (int fx = x1; fx <= x2; ++fx)
+                    if (x + dx >= 0 && x + dx < GXM
+                        && parent[i - GXM + dx] >= 0)
                     {
-                        if (travel_point_distance[fx][fy] == nzones)
-                        {
-                            if (map_masked(coord_def(fx, fy), MMT_VAULT))
-                            {
-                                veto = true;
-                                break;
-                            }
-                            else
-                                coords.emplace_back(fx, fy);
-                        }
+                        _zone_union(parent, i, i - GXM + dx);
                     }
-                    if (veto)
-                        break;
-                }
-                if (!veto)
-                {
-                    for (auto c : coords)
-                        _set_grd(c, fill);
                 }
             }
         }
+
+    bool (*iswanted)(const coord_def &) =
+        !choose_stairless ? nullptr :
+        at_branch_bottom() ? _is_upwards_exit_stair : _is_exit_stair;
+
+    // Zones are numbered from 1 in the order their first cells are met,
+    // and travel_point_distance is left holding each cell's zone.
+    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
+    vector<int> zone_of(GXM * GYM, 0);
+    vector<bool> has_exit(1, false), in_vault(1, false);
+    vector<vector<coord_def>> zone_cells(1);
+    int nzones = 0;
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+        {
+            const int i = y * GXM + x;
+            if (parent[i] < 0)
+                continue;
+
+            const int root = _zone_root(parent, i);
+            if (root == i)
+            {
+                zone_of[i] = ++nzones;
+                has_exit.push_back(false);
+                in_vault.push_back(false);
+                if (fill)
+                    zone_cells.emplace_back();
+            }
+            const int zone = zone_of[root];
+            const coord_def c(x, y);
+            travel_point_distance[x][y] = zone;
+
+            if (iswanted && !has_exit[zone] && iswanted(c))
+                has_exit[zone] = true;
+            if (fill)
+            {
+                if (map_masked(c, MMT_VAULT))
+                    in_vault[zone] = true;
+                zone_cells[zone].push_back(c);
+            }
+        }
+
+    int ngood = 0;
+    for (int zone = 1; zone <= nzones; ++zone)
+    {
+        // If we want only stairless zones, screen out zones that did
+        // have stairs.
+        if (choose_stairless && has_exit[zone])
+            ++ngood;
+        // Don't fill in areas connected to vaults.
+        // We want vaults to be accessible; if the area is disconneted
+        // from the rest of the level, this will cause the level to be
+        // vetoed later on.
+        else if (fill && !in_vault[zone])
+        {
+            for (auto c : zone_cells[zone])
+                _set_grd(c, fill);
+        }
     }
 
     return nzones - ngood;
@@ -890,8 +1153,7 @@ static int _process_disconnected_zones(int x1, int y1, int x2, int y2,
 int dgn_count_disconnected_zones(bool choose_stairless,
                                  dungeon_feature_type fill)
 {
-    return _process_disconnected_zones(0, 0, GXM-1, GYM-1, choose_stairless,
-                                       fill);
+    return _process_disconnected_zones(choose_stairless, fill);
 }
 
 static void _fixup_hell_stairs()
@@ -2199,11 +2461,27 @@ static void _post_vault_build()
 
 static void _build_dungeon_level(dungeon_feature_type dest_stairs_type)
 {
-    bool place_vaults = _builder_by_type();
+    bool place_vaults;
+    {
+#ifdef DEBUG_STATISTICS
+        mapstat_phase_timer timer(MSP_LAYOUT);
+#endif
+        place_vaults = _builder_by_type();
+    }
 
     if (player_in_branch(BRANCH_LABYRINTH))
         return;
 
+    _save_level_checkpoint(place_vaults);
+    _build_dungeon_level_features(place_vaults, dest_stairs_type);
+}
+
+// Everything after the layout and primary vault: secondary vaults,
+// monsters, items, and fixups.
+static void _build_dungeon_level_features(bool place_vaults,
+                                          dungeon_feature_type dest_stairs_type)
+{
+
     if (player_in_branch(BRANCH_SLIME))
         _slime_connectivity_fixup();
 
@@ -2228,43 +2506,68 @@ static void _build_dungeon_level(dungeon_feature_type dest_stairs_type)
     // no guarantees, seeing this is a minivault.
     if (crawl_state.game_standard_levelgen())
     {
-        if (place_vaults)
         {
-            // Moved branch entries to place first so there's a good
-            // chance of having room for a vault
-            _place_branch_entrances(true);
-            _place_chance_vaults();
-            _place_minivaults();
-            _place_extra_vaults();
+#ifdef DEBUG_STATISTICS
+            mapstat_phase_timer timer(MSP_MINIVAULTS);
+#endif
+            if (place_vaults)
+            {
+                // Moved branch entries to place first so there's a good
+                // chance of having room for a vault
+                _place_branch_entrances(true);
+                _place_chance_vaults();
+                _place_minivaults();
+                _place_extra_vaults();
+            }
+            else
+            {
+                // Place any branch entries vaultlessly
+                _place_branch_entrances(false);
+                // Still place chance vaults - important things like Abyss,
+                // Hell, Pan entries are placed this way
+                _place_chance_vaults();
+            }
+
+            // Ruination and plant clumps.
+            _post_vault_build();
         }
-        else
+
         {
-            // Place any branch entries vaultlessly
-            _place_branch_entrances(false);
-            // Still place chance vaults - important things like Abyss,
-            // Hell, Pan entries are placed this way
-            _place_chance_vaults();
+#ifdef DEBUG_STATISTICS
+            mapstat_phase_timer timer(MSP_MONSTERS);
+#endif
+            // XXX: Moved this here from builder_monsters so that
+            //      connectivity can be ensured
+            _place_uniques();
         }
 
-        // Ruination and plant clumps.
-        _post_vault_build();
-
-        // XXX: Moved this here from builder_monsters so that
-        //      connectivity can be ensured
-        _place_uniques();
-
         if (_mimic_at_level())
             _place_feature_mimics(dest_stairs_type);
 
         _place_traps();
 
-        // Any vault-placement activity must happen before this check.
-        _dgn_verify_connectivity(nvaults);
+        {
+#ifdef DEBUG_STATISTICS
+            mapstat_phase_timer timer(MSP_CONNECTIVITY);
+#endif
+            // Any vault-placement activity must happen before this check.
+            _dgn_verify_connectivity(nvaults);
+        }
 
-        _builder_monsters();
+        {
+#ifdef DEBUG_STATISTICS
+            mapstat_phase_timer timer(MSP_MONSTERS);
+#endif
+            _builder_monsters();
+        }
 
-        // Place items.
-        _builder_items();
+        {
+#ifdef DEBUG_STATISTICS
+            mapstat_phase_timer timer(MSP_ITEMS);
+#endif
+            // Place items.
+            _builder_items();
+        }
 
         _fixup_walls();
     }
@@ -3958,6 +4261,9 @@ static const vault_placement *_build_secondary_vault(const map_def *vault,
 //
 static const vault_placement *_build_primary_vault(const map_def *vault)
 {
+#ifdef DEBUG_STATISTICS
+    mapstat_phase_timer timer(MSP_PRIMARY_VAULT);
+#endif
     return _build_vault_impl(vault);
 }
 
@@ -4062,7 +4368,7 @@ static const vault_placement *_build_vault_impl(const map_def *vault,
     if (!build_only && (placed_vault_orientation != MAP_ENCOMPASS || is_layout)
         && player_in_branch(BRANCH_SWAMP))
     {
-        _process_disconnected_zones(0, 0, GXM-1, GYM-1, true, DNGN_TREE);
+        _process_disconnected_zones(true, DNGN_TREE);
     }
 
     if (!make_no_exits)
@@ -14,9 +14,11 @@
 #include "colour.h"
 #include "crash.h"
 #include "database.h"
+#include "dbg-util.h"
 #include "describe.h"
 #include "dungeon.h"
 #include "hints.h"
+#include "hiscores.h"
 #include "invent.h"
 #include "itemprop.h"
 #include "los.h"
@@ -142,6 +144,10 @@ NORETURN void end(int exit_code, bool print_error, const char *format, ...)
         tiles.shutdown();
 #endif
 
+#ifdef DEBUG_PROFILE
+        profile_write_out();
+#endif
+
         cio_cleanup();
         msg::deinitialise_mpr_streams();
         _clear_globals_on_exit();
@@ -172,6 +178,9 @@ NORETURN void end(int exit_code, bool print_error, const char *format, ...)
     UNUSED(need_pause);
 #endif
 
+    // Queued logfile and milestone lines must make it to disk.
+    flush_xlog_writes();
+
     CrawlIsExiting = true;
     if (exit_code)
         CrawlIsCrashing = true;
@@ -1,9 +1,11 @@
 #ifndef ENV_H
 #define ENV_H
 
+#include <deque>
 #include <set>
 #include <memory> // unique_ptr
 
+#include "coord.h"
 #include "map_knowledge.h"
 #include "monster.h"
 #include "trap_def.h"
@@ -18,6 +20,134 @@ typedef vector<unique_ptr<vault_placement>> vault_placement_refv;
 
 typedef FixedArray< map_cell, GXM, GYM > MapKnowledge;
 
+// Things that sit on single cells of a level, such as clouds, traps and
+// shops. Each lives in a slot of a pool whose slots never move, so a
+// reference to one survives others being added or removed; a grid of slot
+// indices gives lookup by position, and the list of slots in use gives
+// iteration over the live entries only. T needs a pos member.
+template<class T>
+class cell_store
+{
+public:
+    template<class Value, class Pool>
+    class basic_iterator
+    {
+    public:
+        basic_iterator(Pool &pool_, vector<int>::const_iterator slot_)
+            : pool(&pool_), slot(slot_)
+        {
+        }
+
+        Value &operator*() const { return (*pool)[*slot]; }
+        Value *operator->() const { return &(*pool)[*slot]; }
+        basic_iterator &operator++() { ++slot; return *this; }
+        bool operator==(const basic_iterator &other) const
+        {
+            return slot == other.slot;
+        }
+        bool operator!=(const basic_iterator &other) const
+        {
+            return slot != other.slot;
+        }
+
+    private:
+        Pool *pool;
+        vector<int>::const_iterator slot;
+    };
+
+    typedef basic_iterator<T, deque<T>> iterator;
+    typedef basic_iterator<const T, const deque<T>> const_iterator;
+
+    cell_store() : slots(), free_slots(), live(), live_index(), slot_at(-1)
+    {
+    }
+
+    T *find(const coord_def &pos)
+    {
+        if (!map_bounds(pos) || slot_at(pos) < 0)
+            return nullptr;
+        return &slots[slot_at(pos)];
+    }
+
+    const T *find(const coord_def &pos) const
+    {
+        if (!map_bounds(pos) || slot_at(pos) < 0)
+            return nullptr;
+        return &slots[slot_at(pos)];
+    }
+
+    // Returns the entry at pos, making an empty one there if there was none.
+    T &operator[](const coord_def &pos)
+    {
+        ASSERT(map_bounds(pos));
+        if (slot_at(pos) >= 0)
+            return slots[slot_at(pos)];
+
+        int slot;
+        if (!free_slots.empty())
+        {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+        else
+        {
+            slot = slots.size();
+            slots.emplace_back();
+            live_index.push_back(-1);
+        }
+
+        live_index[slot] = live.size();
+        live.push_back(slot);
+        slot_at(pos) = slot;
+        slots[slot].pos = pos;
+        return slots[slot];
+    }
+
+    void erase(const coord_def &pos)
+    {
+        if (!map_bounds(pos) || slot_at(pos) < 0)
+            return;
+
+        const int slot = slot_at(pos);
+        slot_at(pos) = -1;
+        slots[slot] = T();
+        free_slots.push_back(slot);
+
+        // Move the last live slot into this one's place.
+        const int moved = live.back();
+        live[live_index[slot]] = moved;
+        live_index[moved] = live_index[slot];
+        live.pop_back();
+        live_index[slot] = -1;
+    }
+
+    void clear()
+    {
+        slots.clear();
+        free_slots.clear();
+        live.clear();
+        live_index.clear();
+        slot_at.init(-1);
+    }
+
+    size_t size() const { return live.size(); }
+    bool empty() const { return live.empty(); }
+
+    // Adding or removing any entry invalidates iterators, so loops that do
+    // so should collect the entries first.
+    iterator begin() { return iterator(slots, live.begin()); }
+    iterator end() { return iterator(slots, live.end()); }
+    const_iterator begin() const { return const_iterator(slots, live.begin()); }
+    const_iterator end() const { return const_iterator(slots, live.end()); }
+
+private:
+    deque<T> slots;
+    vector<int> free_slots;
+    vector<int> live;       // slots in use
+    vector<int> live_index; // for each slot in use, its index in live
+    FixedArray<int, GXM, GYM> slot_at; // -1 where there's nothing
+};
+
 class final_effect;
 struct crawl_environment
 {
@@ -26,6 +156,9 @@ struct crawl_environment
 
     FixedVector< item_def, MAX_ITEMS >       item;  // item list
     FixedVector< monster, MAX_MONSTERS+2 >   mons;  // monster list, plus anon
+    // Every slot of mons at or above this has been unused since the level
+    // was last cleared, so per-turn scans can stop here.
+    int                                      mons_slots_used;
 
     feature_grid                             grid;  // terrain grid
     FixedArray<terrain_property_t, GXM, GYM> pgrid; // terrain properties
@@ -71,10 +204,10 @@ struct crawl_environment
     tile_flavour tile_default;
     vector<string> tile_names;
 
-    map<coord_def, cloud_struct> cloud;
+    cell_store<cloud_struct> cloud;
 
-    map<coord_def, shop_struct> shop; // shop list
-    map<coord_def, trap_def> trap; // trap list
+    cell_store<shop_struct> shop; // shop list
+    cell_store<trap_def> trap; // trap list
 
     FixedVector< monster_type, MAX_MONS_ALLOC > mons_alloc;
     map_markers                              markers;
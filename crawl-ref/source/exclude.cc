@@ -203,7 +203,7 @@ bool travel_exclude::in_bounds(const coord_def &p) const
 
 /////////////////////////////////////////////////////////////////////////
 
-exclude_set::exclude_set()
+exclude_set::exclude_set() : change_count(0)
 {
 }
 
@@ -211,6 +211,7 @@ void exclude_set::clear()
 {
     exclude_roots.clear();
     exclude_points.clear();
+    ++change_count;
 }
 
 void exclude_set::erase(const coord_def &p)
@@ -242,30 +243,33 @@ void exclude_set::add_exclude(const coord_def &p, int radius,
 
 void exclude_set::add_exclude_points(travel_exclude& ex)
 {
+    ++change_count;
+
     if (ex.radius == 0)
     {
         exclude_points.insert(ex.pos);
         return;
     }
 
+    // An exclusion's LOS only goes stale when a cell within its bounds
+    // changes, and update_exclusion_los marks it so.
     if (!ex.uptodate)
         ex.set_los();
-    else
-        ex.los.update();
 
     for (radius_iterator ri(ex.pos, ex.radius, C_SQUARE); ri; ++ri)
         if (ex.affects(*ri))
             exclude_points.insert(*ri);
 }
 
-void exclude_set::update_excluded_points(bool recompute_los)
+// Recompute the LOS of just the stale exclusions, then the points.
+void exclude_set::update_excluded_points()
 {
     for (iterator it = exclude_roots.begin(); it != exclude_roots.end(); ++it)
     {
         travel_exclude &ex = it->second;
         if (!ex.uptodate)
         {
-            recompute_excluded_points(recompute_los);
+            recompute_excluded_points();
             return;
         }
     }
@@ -274,6 +278,7 @@ void exclude_set::update_excluded_points(bool recompute_los)
 void exclude_set::recompute_excluded_points(bool recompute_los)
 {
     exclude_points.clear();
+    ++change_count;
     for (iterator it = exclude_roots.begin(); it != exclude_roots.end(); ++it)
     {
         travel_exclude &ex = it->second;
@@ -358,7 +363,7 @@ void update_exclusion_los(vector<coord_def> changed)
     for (coord_def c : changed)
         _mark_excludes_non_updated(c);
 
-    curr_excludes.update_excluded_points(true);
+    curr_excludes.update_excluded_points();
 }
 
 bool is_excluded(const coord_def &p, const exclude_set &exc)
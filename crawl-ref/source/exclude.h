@@ -66,7 +66,7 @@ public:
                      string desc = "",
                      bool vaultexcl = false);
 
-    void update_excluded_points(bool recompute_los = false);
+    void update_excluded_points();
     void recompute_excluded_points(bool recompute_los = false);
 
     travel_exclude* get_exclude_root(const coord_def &p);
@@ -78,6 +78,9 @@ public:
     size_t size()  const;
     bool   empty() const;
 
+    // Bumped whenever the set of excluded points may have changed.
+    unsigned int changes() const { return change_count; }
+
     const_iterator begin() const;
     const_iterator end() const;
 
@@ -89,6 +92,7 @@ private:
 
     exclmap exclude_roots;
     exclset exclude_points;
+    unsigned int change_count;
 
 private:
     void add_exclude_points(travel_exclude& ex);
@@ -502,6 +502,27 @@ class monster;
 // extend this in the future, so this should be easier than undoing the change.
 typedef uint32_t iflags_t;
 
+struct item_name_memo_entry;
+
+// Names recently built by item_def::name_aux(), each with the item state
+// it was built from, so that a stale entry is simply never matched.
+// Copying an item doesn't copy its memo.
+struct item_name_memo
+{
+    item_name_memo() : entries(nullptr) { }
+    item_name_memo(const item_name_memo &) : entries(nullptr) { }
+    ~item_name_memo() { clear(); }
+    item_name_memo &operator=(const item_name_memo &)
+    {
+        clear();
+        return *this;
+    }
+
+    void clear();
+
+    vector<item_name_memo_entry> *entries;
+};
+
 struct item_def
 {
     object_class_type base_type:8; ///< basic class (eg OBJ_WEAPON)
@@ -569,6 +590,8 @@ struct item_def
 
     CrawlHashTable props;
 
+    mutable item_name_memo name_memo;
+
 public:
     item_def() : base_type(OBJ_UNASSIGNED), sub_type(0), plus(0), plus2(0),
                  special(0), rnd(0), quantity(0), flags(0),
@@ -643,6 +666,9 @@ public:
 private:
     string name_aux(description_level_type desc, bool terse, bool ident,
                     bool with_inscription, iflags_t ignore_flags) const;
+    string build_name_aux(description_level_type desc, bool terse,
+                          bool ident, bool with_inscription,
+                          iflags_t ignore_flags) const;
 
     colour_t randart_colour() const;
 
@@ -824,6 +850,9 @@ private:
 
 private:
     dgn_marker_map markers;
+    // The same markers again, split up by type, so get_all(type) and
+    // find(type) needn't walk every marker on the level.
+    dgn_marker_map typed_markers[NUM_MAP_MARKER_TYPES];
     bool have_inactive_markers;
 };
 
@@ -44,6 +44,7 @@
 #include "godcompanions.h"
 #include "godpassive.h"
 #include "hints.h"
+#include "hiscores.h"
 #include "initfile.h"
 #include "items.h"
 #include "jobs.h"
@@ -86,12 +87,16 @@
 #endif
 
 static void _save_level(const level_id& lid);
+static void _restore_level(const string &name);
 
 static bool _ghost_version_compatible(reader &ghost_reader);
 
 static bool _restore_tagged_chunk(package *save, const string &name,
                                   tag_type tag, const char* complaint);
+static bool _restore_tagged_chunk(reader &inf, const string &name,
+                                  tag_type tag, const char* complaint);
 static bool _read_char_chunk(package *save);
+static bool _read_char_chunk(reader &inf);
 
 const short GHOST_SIGNATURE = short(0xDC55);
 
@@ -116,8 +121,8 @@ static bool is_save_file_name(const string &name)
     return !strcasecmp(name.c_str() + off, SAVE_SUFFIX);
 }
 
-// Returns the save_info from the save.
-static player_save_info _read_character_info(package *save)
+// Returns the save_info from a "chr" chunk.
+static player_save_info _read_character_info(reader &inf)
 {
     player_save_info fromfile;
 
@@ -127,7 +132,7 @@ static player_save_info _read_character_info(package *save)
 
     try // need a redundant try block just so we can restore the backup
     {   // (or risk an = operator on you getting misused)
-        fromfile.save_loadable = _read_char_chunk(save);
+        fromfile.save_loadable = _read_char_chunk(inf);
         fromfile = you;
     }
     catch (ext_fail_exception &E) {}
@@ -137,6 +142,13 @@ static player_save_info _read_character_info(package *save)
     return fromfile;
 }
 
+// Returns the save_info from the save.
+static player_save_info _read_character_info(package *save)
+{
+    reader inf(save, "chr");
+    return _read_character_info(inf);
+}
+
 // Returns a vector of files (including directories if requested) in
 // the given directory, recursively. All filenames returned are
 // relative to the start directory. If an extension is supplied, all
@@ -584,7 +596,25 @@ static bool _readln(chunk_reader &rd, char *buf)
     return true;
 }
 
-static void _fill_player_doll(player_save_info &p, package *save)
+// The same, reading from a copy of the chunk's contents.
+static bool _readln(const string &data, char *buf)
+{
+    size_t i = 0;
+    for (int space = LINEMAX - 1; space; space--, i++)
+    {
+        if (i >= data.size())
+            return false;
+        if (data[i] == '\n')
+            break;
+        buf[i] = data[i];
+    }
+    buf[i] = 0;
+    return true;
+}
+
+// Set p's doll from the parts line of its "tdl" chunk, or to the default
+// doll for its job if parts is null.
+static void _fill_player_doll(player_save_info &p, char *parts)
 {
     dolls_data equip_doll;
     for (unsigned int j = 0; j < TILEP_PART_MAX; ++j)
@@ -593,20 +623,12 @@ static void _fill_player_doll(player_save_info &p, package *save)
     equip_doll.parts[TILEP_PART_BASE]
         = tilep_species_to_base_tile(p.species, p.experience_level);
 
-    bool success = false;
-
-    chunk_reader fdoll(save, "tdl");
+    if (parts)
     {
-        char fbuf[LINEMAX];
-        if (_readln(fdoll,fbuf))
-        {
-            tilep_scan_parts(fbuf, equip_doll, p.species, p.experience_level);
-            tilep_race_default(p.species, p.experience_level, &equip_doll);
-            success = true;
-        }
+        tilep_scan_parts(parts, equip_doll, p.species, p.experience_level);
+        tilep_race_default(p.species, p.experience_level, &equip_doll);
     }
-
-    if (!success) // Use default doll instead.
+    else // Use default doll instead.
     {
         job_type job = get_job_by_name(p.class_name.c_str());
         if (job == JOB_UNKNOWN)
@@ -616,6 +638,111 @@ static void _fill_player_doll(player_save_info &p, package *save)
     }
     p.doll = equip_doll;
 }
+
+static void _fill_player_doll(player_save_info &p, package *save)
+{
+    chunk_reader fdoll(save, "tdl");
+    char fbuf[LINEMAX];
+    _fill_player_doll(p, _readln(fdoll, fbuf) ? fbuf : nullptr);
+}
+#endif
+
+#ifndef DISABLE_SAVEGAME_LISTS
+/*
+ * Each save that was closed normally gets a small sidecar file next to it,
+ * holding a copy of its "chr" chunk (and doll), so that listing saved
+ * characters doesn't have to open every package. The sidecar also records
+ * the save's size and modification time when it was written, and is only
+ * trusted while those still match: a save that was loaded again, or
+ * replaced, falls back to being read itself.
+ */
+#define SAVE_INFO_SUFFIX ".info"
+
+static bool _save_file_stamp(const string &savefile, int64_t &size,
+                             int64_t &mtime)
+{
+    struct stat st;
+    if (stat(savefile.c_str(), &st))
+        return false;
+    size = st.st_size;
+    mtime = st.st_mtime;
+    return true;
+}
+
+static void _write_save_info(const string &savefile)
+{
+    int64_t size, mtime;
+    if (!_save_file_stamp(savefile, size, mtime))
+        return;
+
+    const string infofile = savefile + SAVE_INFO_SUFFIX;
+    FILE *f = fopen_u(infofile.c_str(), "wb");
+    if (!f)
+        return;
+
+    bool ok;
+    {
+        writer outf(infofile, f, true);
+        marshallSigned(outf, size);
+        marshallSigned(outf, mtime);
+#ifdef USE_TILE
+        vector<unsigned char> doll;
+        writer dollf(&doll);
+        save_doll_file(dollf);
+        marshallBoolean(outf, true);
+        marshallString(outf, string(doll.begin(), doll.end()));
+#else
+        marshallBoolean(outf, false);
+        marshallString(outf, "");
+#endif
+        // The same layout as the "chr" chunk itself.
+        marshallUByte(outf, TAG_MAJOR_VERSION);
+        marshallUByte(outf, TAG_MINOR_VERSION);
+        tag_write(TAG_CHR, outf);
+        ok = outf.succeeded();
+    }
+    if (fclose(f) || !ok)
+        unlink_u(infofile.c_str());
+}
+
+// Fill p from savefile's sidecar, if it has an up to date one.
+static bool _read_save_info(const string &savefile, player_save_info &p)
+{
+    int64_t size, mtime;
+    if (!_save_file_stamp(savefile, size, mtime))
+        return false;
+
+    FILE *f = fopen_u((savefile + SAVE_INFO_SUFFIX).c_str(), "rb");
+    if (!f)
+        return false;
+
+    bool found = false;
+    try
+    {
+        reader inf(f);
+        if (unmarshallSigned(inf) == size && unmarshallSigned(inf) == mtime)
+        {
+            const bool has_doll = unmarshallBoolean(inf);
+            const string doll = unmarshallString(inf);
+            p = _read_character_info(inf);
+            found = !p.name.empty();
+#ifdef USE_TILE
+            if (found && Options.tile_menu_icons && has_doll)
+            {
+                char fbuf[LINEMAX];
+                _fill_player_doll(p, _readln(doll, fbuf) ? fbuf : nullptr);
+            }
+#else
+            UNUSED(has_doll);
+#endif
+        }
+    }
+    catch (short_read_exception &E)
+    {
+    }
+    fclose(f);
+    return found;
+}
 #endif
 
 /*
@@ -640,6 +767,14 @@ static vector<player_save_info> _find_saved_characters()
     {
         if (is_save_file_name(filename))
         {
+            player_save_info info;
+            if (_read_save_info(_get_savedir_path(filename), info))
+            {
+                info.filename = filename;
+                chars.push_back(info);
+                continue;
+            }
+
             try
             {
                 package save(_get_savedir_path(filename).c_str(), false);
@@ -1285,7 +1420,7 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     else
     {
         dprf("Loading old level '%s'.", level_name.c_str());
-        _restore_tagged_chunk(you.save, level_name, TAG_LEVEL, "Level file is invalid.");
+        _restore_level(level_name);
 
         _redraw_all();
     }
@@ -1498,6 +1633,43 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     return just_created_level;
 }
 
+// Uncompressed copies of the last few levels saved, most recent first, so
+// that going back to one of them (stair dancing, portal hopping) reads it
+// from memory instead of decompressing its chunk again. The chunks
+// themselves are still written to the save as before. Every write of a
+// level chunk goes through _save_level(), which keeps these in step.
+struct level_blob
+{
+    string name;
+    vector<unsigned char> data;
+};
+static const size_t MAX_LEVEL_BLOBS = 4;
+static deque<level_blob> _level_blobs;
+
+static deque<level_blob>::iterator _find_level_blob(const string &name)
+{
+    return find_if(_level_blobs.begin(), _level_blobs.end(),
+                   [&name](const level_blob &blob)
+                   { return blob.name == name; });
+}
+
+static void _forget_level_blob(const string &name)
+{
+    auto blob = _find_level_blob(name);
+    if (blob != _level_blobs.end())
+        _level_blobs.erase(blob);
+}
+
+static void _remember_level_blob(const string &name,
+                                 vector<unsigned char> &data)
+{
+    _forget_level_blob(name);
+    _level_blobs.push_front({name, vector<unsigned char>()});
+    _level_blobs.front().data.swap(data);
+    if (_level_blobs.size() > MAX_LEVEL_BLOBS)
+        _level_blobs.pop_back();
+}
+
 static void _save_level(const level_id& lid)
 {
     travel_cache.get_level_info(lid).update();
@@ -1505,7 +1677,43 @@ static void _save_level(const level_id& lid)
     // Nail all items to the ground.
     fix_item_coordinates();
 
-    _write_tagged_chunk(lid.describe(), TAG_LEVEL);
+    const string name = lid.describe();
+    vector<unsigned char> buf;
+    {
+        writer w(&buf);
+        marshallUByte(w, TAG_MAJOR_VERSION);
+        marshallUByte(w, TAG_MINOR_VERSION);
+        tag_write(TAG_LEVEL, w);
+    }
+    {
+        writer outf(you.save, name);
+        outf.write(&buf[0], buf.size());
+    }
+    _remember_level_blob(name, buf);
+}
+
+// Read a level saved by _save_level(), from memory if it was one of the
+// last few saved.
+static void _restore_level(const string &name)
+{
+    auto blob = _find_level_blob(name);
+    if (blob == _level_blobs.end())
+    {
+        _restore_tagged_chunk(you.save, name, TAG_LEVEL,
+                              "Level file is invalid.");
+        return;
+    }
+
+    // Take the bytes out while reading, in case reading saves a level.
+    vector<unsigned char> data;
+    data.swap(blob->data);
+    _level_blobs.erase(blob);
+    {
+        reader inf(data);
+        _restore_tagged_chunk(inf, name, TAG_LEVEL, "Level file is invalid.");
+    }
+    if (_find_level_blob(name) == _level_blobs.end())
+        _remember_level_blob(name, data);
 }
 
 #if TAG_MAJOR_VERSION == 34
@@ -1514,11 +1722,47 @@ static void _save_level(const level_id& lid)
 # define CHUNK(short, long) long
 #endif
 
-#define SAVEFILE(short, long, savefn)           \
-    do                                          \
-    {                                           \
-        writer w(you.save, CHUNK(short, long)); \
-        savefn(w);                              \
+// The bytes last written to each of the chunks below, so that one which has
+// not changed since the previous save is not compressed and written again.
+// Forgotten whenever a save is opened.
+static map<string, vector<unsigned char>> _saved_chunks;
+
+static void _write_chunk_if_changed(const string &chunkname,
+                                    vector<unsigned char> &buf)
+{
+    auto old = _saved_chunks.find(chunkname);
+    if (old != _saved_chunks.end() && old->second == buf
+        && you.save->has_chunk(chunkname))
+    {
+        return;
+    }
+
+    {
+        writer outf(you.save, chunkname);
+        if (!buf.empty())
+            outf.write(&buf[0], buf.size());
+    }
+    _saved_chunks[chunkname].swap(buf);
+}
+
+// Encoding into a buffer the size of the previous save of the chunk avoids
+// regrowing it byte by byte; these chunks rarely shrink or grow much.
+static size_t _last_chunk_size(const string &chunkname)
+{
+    auto old = _saved_chunks.find(chunkname);
+    return old == _saved_chunks.end() ? 0 : old->second.size();
+}
+
+#define SAVEFILE(short, long, savefn)                    \
+    do                                                   \
+    {                                                    \
+        vector<unsigned char> buf;                       \
+        buf.reserve(_last_chunk_size(CHUNK(short, long))); \
+        {                                                \
+            writer w(&buf);                              \
+            savefn(w);                                   \
+        }                                                \
+        _write_chunk_if_changed(CHUNK(short, long), buf); \
     } while (false)
 
 // Stack allocated string's go in separate function, so Valgrind doesn't
@@ -1540,6 +1784,7 @@ static void _save_game_base()
     SAVEFILE("tc", "travel_cache", travel_cache.save);
 
     /* notes */
+    save_note_blocks(you.save);
     SAVEFILE("nts", "notes", save_notes);
 
     /* tutorial/hints mode */
@@ -1556,7 +1801,64 @@ static void _save_game_base()
 #endif
 
     _write_tagged_chunk("you", TAG_YOU);
-    _write_tagged_chunk("chr", TAG_CHR);
+
+    // "chr" only changes with level, god, species and the like.
+    vector<unsigned char> chr;
+    {
+        writer outf(&chr);
+        marshallUByte(outf, TAG_MAJOR_VERSION);
+        marshallUByte(outf, TAG_MINOR_VERSION);
+        tag_write(TAG_CHR, outf);
+    }
+    _write_chunk_if_changed("chr", chr);
+}
+
+// Once this much of the save file is free space, it is rewritten compactly
+// when the game is saved and left.
+static const int COMPACT_SAVE_SLACK_PERCENT = 50;
+
+// Copy every chunk of the game save into a fresh file and move that over
+// the save, dropping its free space and fragmentation. The save stays open
+// and locked meanwhile and the rename is atomic, so anyone else only ever
+// sees one complete, committed save or the other.
+static void _compact_save()
+{
+    if (Options.no_save)
+        return;
+
+    you.save->commit();
+    const uint64_t slack = you.save->get_slack();
+    const uint64_t size = you.save->get_size();
+    if (slack * 100 < size * COMPACT_SAVE_SLACK_PERCENT)
+        return;
+
+    const string filename = get_savedir_filename(you.your_name);
+    const string tmpname = filename + ".tmp";
+    dprf("Compacting the save: %u of %u bytes unused.",
+         (unsigned int)slack, (unsigned int)size);
+    try
+    {
+        package compacted(tmpname.c_str(), true, true);
+        for (const string &chunk : you.save->list_chunks())
+        {
+            char buf[16384];
+
+            chunk_reader in(you.save, chunk);
+            chunk_writer out(&compacted, chunk);
+
+            while (plen_t len = in.read(buf, sizeof(buf)))
+                out.write(buf, len);
+        }
+    }
+    catch (ext_fail_exception &fe)
+    {
+        dprf("Save compaction failed: %s", fe.msg.c_str());
+        unlink_u(tmpname.c_str());
+        return;
+    }
+
+    if (rename_u(tmpname.c_str(), filename.c_str()))
+        unlink_u(tmpname.c_str());
 }
 
 // Stack allocated string's go in separate function, so Valgrind doesn't
@@ -1586,6 +1888,8 @@ static void _save_game_exit()
     tiles.send_exit_reason("saved");
 #endif
 
+    flush_xlog_writes();
+    _compact_save();
     delete you.save;
     you.save = 0;
 }
@@ -1624,6 +1928,9 @@ void save_game(bool leave_game, const char *farewellmsg)
     // Stack allocated string's go in separate function,
     // so Valgrind doesn't complain.
     _save_game_exit();
+#ifndef DISABLE_SAVEGAME_LISTS
+    _write_save_info(get_savedir_filename(you.your_name));
+#endif
 
     if (Options.restart_after_game && Options.restart_after_save
         && !crawl_state.seen_hups)
@@ -1654,19 +1961,25 @@ static string _make_ghost_filename()
 /**
  * Lists all bonefiles for the current level.
  *
+ * Bones files are only ever created by _make_bones_file(), which numbers
+ * them from 0 to GHOST_LIMIT - 1, so probe those names rather than reading
+ * the bones directory, which holds the files for every level.
+ *
  * @return A vector containing absolute paths to 0+ bonefiles.
  */
 static vector<string> _list_bones()
 {
     string bonefile_dir = _get_bonefile_directory();
     string base_filename = _make_ghost_filename();
-    string underscored_filename = base_filename + "_";
 
-    vector<string> filenames = get_dir_files(bonefile_dir);
     vector<string> bonefiles;
-    for (const auto &filename : filenames)
-        if (starts_with(filename, underscored_filename))
-            bonefiles.push_back(bonefile_dir + filename);
+    for (int i = 0; i < GHOST_LIMIT; i++)
+    {
+        const string bonefile = make_stringf("%s%s_%d", bonefile_dir.c_str(),
+                                             base_filename.c_str(), i);
+        if (access(bonefile.c_str(), F_OK) == 0)
+            bonefiles.push_back(bonefile);
+    }
 
     string old_bonefile = _get_old_bonefile_directory() + base_filename;
     if (access(old_bonefile.c_str(), F_OK) == 0)
@@ -1840,6 +2153,8 @@ static bool _restore_game(const string& filename)
         return false;
 
     you.save = new package((_get_savefile_directory() + filename).c_str(), true);
+    _saved_chunks.clear();
+    _level_blobs.clear();
 
     if (!_read_char_chunk(you.save))
     {
@@ -1874,6 +2189,8 @@ static bool _restore_game(const string& filename)
         }
     }
 
+    you.save->start_write_thread();
+
     _restore_tagged_chunk(you.save, "you", TAG_YOU, "Save data is invalid.");
 
     const int minorVersion = crawl_state.minor_version;
@@ -1910,7 +2227,7 @@ static bool _restore_game(const string& filename)
     if (you.save->has_chunk(CHUNK("nts", "notes")))
     {
         reader inf(you.save, CHUNK("nts", "notes"), minorVersion);
-        load_notes(inf);
+        load_notes(inf, you.save);
     }
 
     /* hints mode */
@@ -1981,6 +2298,7 @@ void delete_level(const level_id &level)
 
     if (you.save)
         you.save->delete_chunk(level.describe());
+    _forget_level_blob(level.describe());
     if (level.branch == BRANCH_ABYSS)
     {
         save_abyss_uniques();
@@ -2053,7 +2371,11 @@ bool get_save_version(reader &file, int &major, int &minor)
 static bool _read_char_chunk(package *save)
 {
     reader inf(save, "chr");
+    return _read_char_chunk(inf);
+}
 
+static bool _read_char_chunk(reader &inf)
+{
     try
     {
         uint8_t format, major, minor;
@@ -2152,6 +2474,12 @@ static bool _restore_tagged_chunk(package *save, const string &name,
                                   tag_type tag, const char* complaint)
 {
     reader inf(save, name);
+    return _restore_tagged_chunk(inf, name, tag, complaint);
+}
+
+static bool _restore_tagged_chunk(reader &inf, const string &name,
+                                  tag_type tag, const char* complaint)
+{
     string reason;
     if (!_tagged_chunk_version_compatible(inf, &reason))
     {
@@ -8,6 +8,8 @@
 
 #include "fineff.h"
 
+#include <typeinfo>
+
 #include "act-iter.h"
 #include "bloodspatter.h"
 #include "coordit.h"
@@ -36,7 +38,9 @@
 {
     for (auto fe : env.final_effects)
     {
-        if (fe->mergeable(*eff))
+        // Only effects of the same class ever merge, so compare classes
+        // before paying for a virtual call and a dynamic_cast.
+        if (typeid(*fe) == typeid(*eff) && fe->mergeable(*eff))
         {
             fe->merge(*eff);
             delete eff;
@@ -74,14 +74,21 @@ public:
         return mData[p.first][p.second];
     }
 
+    // The columns are packed end to end, so the whole array can also be
+    // treated as one flat block of WIDTH*HEIGHT elements, column by column.
+    TYPE* buffer() { return mData.buffer()[0].buffer(); }
+    const TYPE* buffer() const { return mData.buffer()[0].buffer(); }
+
     void init(const TYPE& def)
     {
-        for (auto &col : mData)
-            col.init(def);
+        fill(buffer(), buffer() + WIDTH * HEIGHT, def);
     }
 
 protected:
     FixedVector<Column, WIDTH> mData;
+
+    static_assert(sizeof(Column) == sizeof(TYPE) * HEIGHT,
+                  "FixedArray columns must be packed");
 };
 
 // A fixed array centered around the origin.
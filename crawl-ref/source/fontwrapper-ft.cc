@@ -182,8 +182,32 @@ bool FTFontWrapper::load_font(const char *font_name, unsigned int font_size,
     return true;
 }
 
+void FTFontWrapper::upload_glyph(unsigned int c,
+                                 unsigned char *glyph_pixels)
+{
+    bool success = m_tex.load_texture(glyph_pixels, charsz.x, charsz.y,
+                        MIPMAP_NONE,
+                        (c % GLYPHS_PER_ROWCOL) * charsz.x,
+                        (c / GLYPHS_PER_ROWCOL) * charsz.y);
+    ASSERT(success);
+}
+
 void FTFontWrapper::load_glyph(unsigned int c, ucs_t uchar)
 {
+    auto cached = m_rendered.find(uchar);
+    if (cached != m_rendered.end())
+    {
+        RenderedGlyph &glyph = cached->second;
+        m_glyphs[c].offset = glyph.offset;
+        m_glyphs[c].advance = glyph.advance;
+        m_glyphs[c].width = glyph.width;
+        m_glyphs[c].ascender = glyph.ascender;
+        m_glyphs[c].renderable = !glyph.pixels.empty();
+        if (m_glyphs[c].renderable)
+            upload_glyph(c, &glyph.pixels[0]);
+        return;
+    }
+
     // get on with rendering the new glyph
     FT_Error error;
     m_glyphs[c].offset  = 0;
@@ -277,12 +301,16 @@ void FTFontWrapper::load_glyph(unsigned int c, ucs_t uchar)
                     }
                 }
         }
-        bool success = m_tex.load_texture(pixels, charsz.x, charsz.y,
-                            MIPMAP_NONE,
-                            (c % GLYPHS_PER_ROWCOL) * charsz.x,
-                            (c / GLYPHS_PER_ROWCOL) * charsz.y);
-        ASSERT(success);
+        upload_glyph(c, pixels);
     }
+
+    RenderedGlyph &glyph = m_rendered[uchar];
+    glyph.offset = m_glyphs[c].offset;
+    glyph.advance = m_glyphs[c].advance;
+    glyph.width = m_glyphs[c].width;
+    glyph.ascender = m_glyphs[c].ascender;
+    if (m_glyphs[c].renderable)
+        glyph.pixels.assign(pixels, pixels + 4 * charsz.x * charsz.y);
 }
 
 unsigned int FTFontWrapper::map_unicode(ucs_t uchar)
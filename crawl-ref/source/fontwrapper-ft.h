@@ -81,6 +81,7 @@ protected:
     unsigned int map_unicode(ucs_t uchar, bool update);
     unsigned int map_unicode(ucs_t uchar);
     void load_glyph(unsigned int c, ucs_t uchar);
+    void upload_glyph(unsigned int c, unsigned char *glyph_pixels);
     void draw_m_buf(unsigned int x_pos, unsigned int y_pos, bool drop_shadow);
 
     struct GlyphInfo
@@ -117,6 +118,19 @@ protected:
     // index of last populated glyph until m_glyphs[] is full
     ucs_t m_glyphs_top;
 
+    // Every glyph FreeType has rendered for this font, so that one evicted
+    // from the texture can be uploaded again without rasterising it anew.
+    struct RenderedGlyph
+    {
+        int offset;
+        int advance;
+        int width;
+        int ascender;
+        // charsz.x * charsz.y RGBA pixels; empty if the glyph has none.
+        vector<unsigned char> pixels;
+    };
+    map<ucs_t, RenderedGlyph> m_rendered;
+
     // count of glyph loads in the current text block
     int n_subst;
 
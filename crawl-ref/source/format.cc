@@ -150,8 +150,13 @@ void formatted_string::parse_string1(const string &s, formatted_string &fs,
 
         if (s[tag] != '<' || tag >= length - 1)
         {
+            // Take the whole run of plain text up to the next tag at
+            // once, but stop where the check above would break it.
+            string::size_type run_end = min(s.find('<', tag + 1), length);
+            run_end = min(run_end, tag + (999 - currs.size()));
             if (!masked)
-                currs += s[tag];
+                currs.append(s, tag, run_end - tag);
+            tag = run_end - 1;
             continue;
         }
 
@@ -184,7 +189,7 @@ void formatted_string::parse_string1(const string &s, formatted_string &fs,
         if (tagtext[0] == '/')
         {
             revert_colour = true;
-            tagtext = tagtext.substr(1);
+            tagtext.erase(0, 1);
             tag++;
         }
 
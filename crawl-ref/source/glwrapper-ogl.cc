@@ -23,6 +23,8 @@
 #   include <GLES/gl.h>
 #  else
 #   include <SDL2/SDL_opengl.h>
+#   include <SDL2/SDL_video.h>
+#   define USE_GL_VBO
 #   if defined(__MACOSX__)
 #    include <OpenGL/glu.h>
 #   else
@@ -38,6 +40,30 @@
 # include <android/log.h>
 #endif
 
+#ifdef USE_GL_VBO
+// Buffer objects are core since OpenGL 1.5, but not every platform exports
+// the entry points, so they are looked up once a context exists. Without
+// them, OGLShapeBuffer falls back to drawing from client memory.
+static PFNGLGENBUFFERSPROC _glGenBuffers = nullptr;
+static PFNGLDELETEBUFFERSPROC _glDeleteBuffers = nullptr;
+static PFNGLBINDBUFFERPROC _glBindBuffer = nullptr;
+static PFNGLBUFFERDATAPROC _glBufferData = nullptr;
+
+static bool _have_vbos()
+{
+    return _glGenBuffers && _glDeleteBuffers && _glBindBuffer && _glBufferData;
+}
+
+static void _load_vbo_functions()
+{
+    _glGenBuffers = (PFNGLGENBUFFERSPROC)SDL_GL_GetProcAddress("glGenBuffers");
+    _glDeleteBuffers =
+        (PFNGLDELETEBUFFERSPROC)SDL_GL_GetProcAddress("glDeleteBuffers");
+    _glBindBuffer = (PFNGLBINDBUFFERPROC)SDL_GL_GetProcAddress("glBindBuffer");
+    _glBufferData = (PFNGLBUFFERDATAPROC)SDL_GL_GetProcAddress("glBufferData");
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 // Static functions from GLStateManager
 
@@ -78,6 +104,9 @@ OGLStateManager::OGLStateManager()
 #ifdef __ANDROID__
     m_last_tex = 0;
 #endif
+#ifdef USE_GL_VBO
+    _load_vbo_functions();
+#endif
 }
 
 void OGLStateManager::set(const GLState& state)
@@ -437,11 +466,22 @@ void OGLStateManager::glDebug(const char* msg)
 OGLShapeBuffer::OGLShapeBuffer(bool texture, bool colour, drawing_modes prim) :
     m_prim_type(prim),
     m_texture_verts(texture),
-    m_colour_verts(colour)
+    m_colour_verts(colour),
+    m_dirty(true),
+    m_have_vbos(false)
 {
     ASSERT(prim == GLW_RECTANGLE || prim == GLW_LINES);
 }
 
+OGLShapeBuffer::~OGLShapeBuffer()
+{
+#ifdef USE_GL_VBO
+    // Once the state manager is gone, so is the context the buffers were in.
+    if (m_have_vbos && glmanager)
+        _glDeleteBuffers(NUM_VBOS, (GLuint*)m_vbos);
+#endif
+}
+
 const char *OGLShapeBuffer::print_statistics() const
 {
     return nullptr;
@@ -454,6 +494,7 @@ unsigned int OGLShapeBuffer::size() const
 
 void OGLShapeBuffer::add(const GLWPrim &rect)
 {
+    m_dirty = true;
     switch (m_prim_type)
     {
     case GLW_RECTANGLE:
@@ -573,22 +614,50 @@ void OGLShapeBuffer::draw(const GLState &state)
 
     glmanager->set(state);
 
-    glVertexPointer(3, GL_FLOAT, 0, &m_position_buffer[0]);
+    const GLvoid *pos_ptr = &m_position_buffer[0];
+    const GLvoid *tex_ptr = m_texture_verts ? &m_texture_buffer[0] : nullptr;
+    const GLvoid *col_ptr = m_colour_verts ? &m_colour_buffer[0] : nullptr;
+    const GLvoid *ind_ptr = m_prim_type == GLW_RECTANGLE ? &m_ind_buffer[0]
+                                                         : nullptr;
+#ifdef USE_GL_VBO
+    const bool use_vbos = upload();
+    // With a buffer bound, the pointers are offsets into it.
+    if (use_vbos)
+    {
+        pos_ptr = tex_ptr = col_ptr = ind_ptr = nullptr;
+        _glBindBuffer(GL_ARRAY_BUFFER, m_vbos[VBO_POSITION]);
+    }
+#endif
+
+    glVertexPointer(3, GL_FLOAT, 0, pos_ptr);
     glDebug("glVertexPointer");
 
+#ifdef USE_GL_VBO
+    if (use_vbos)
+        _glBindBuffer(GL_ARRAY_BUFFER, m_vbos[VBO_TEXCOORD]);
+#endif
     if (state.array_texcoord && m_texture_verts)
-        glTexCoordPointer(2, GL_FLOAT, 0, &m_texture_buffer[0]);
+        glTexCoordPointer(2, GL_FLOAT, 0, tex_ptr);
     glDebug("glTexCoordPointer");
 
+#ifdef USE_GL_VBO
+    if (use_vbos)
+        _glBindBuffer(GL_ARRAY_BUFFER, m_vbos[VBO_COLOUR]);
+#endif
     if (state.array_colour && m_colour_verts)
-        glColorPointer(4, GL_UNSIGNED_BYTE, 0, &m_colour_buffer[0]);
+        glColorPointer(4, GL_UNSIGNED_BYTE, 0, col_ptr);
     glDebug("glColorPointer");
 
+#ifdef USE_GL_VBO
+    if (use_vbos)
+        _glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_vbos[VBO_INDEX]);
+#endif
+
     switch (m_prim_type)
     {
     case GLW_RECTANGLE:
         glDrawElements(GL_TRIANGLE_STRIP, m_ind_buffer.size(),
-                       GL_UNSIGNED_SHORT, &m_ind_buffer[0]);
+                       GL_UNSIGNED_SHORT, ind_ptr);
         break;
     case GLW_LINES:
         glDrawArrays(GL_LINES, 0, m_position_buffer.size());
@@ -598,10 +667,63 @@ void OGLShapeBuffer::draw(const GLState &state)
         break;
     }
     glDebug("glDrawElements");
+
+#ifdef USE_GL_VBO
+    if (use_vbos)
+    {
+        _glBindBuffer(GL_ARRAY_BUFFER, 0);
+        _glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+#endif
+}
+
+#ifdef USE_GL_VBO
+template <typename T>
+static void _buffer_data(GLenum target, GLuint buf, const vector<T> &data)
+{
+    _glBindBuffer(target, buf);
+    _glBufferData(target, data.size() * sizeof(T),
+                  data.empty() ? nullptr : &data[0], GL_DYNAMIC_DRAW);
+}
+#endif
+
+// Make sure the GL-side buffers hold the current contents, returning false
+// if buffer objects aren't available. Buffers that haven't changed since
+// they were last drawn aren't sent again.
+bool OGLShapeBuffer::upload()
+{
+#ifdef USE_GL_VBO
+    if (!m_have_vbos)
+    {
+        if (!_have_vbos())
+            return false;
+        _glGenBuffers(NUM_VBOS, (GLuint*)m_vbos);
+        glDebug("glGenBuffers");
+        m_have_vbos = true;
+        m_dirty = true;
+    }
+
+    if (!m_dirty)
+        return true;
+
+    _buffer_data(GL_ARRAY_BUFFER, m_vbos[VBO_POSITION], m_position_buffer);
+    _buffer_data(GL_ARRAY_BUFFER, m_vbos[VBO_TEXCOORD], m_texture_buffer);
+    _buffer_data(GL_ARRAY_BUFFER, m_vbos[VBO_COLOUR], m_colour_buffer);
+    _buffer_data(GL_ELEMENT_ARRAY_BUFFER, m_vbos[VBO_INDEX], m_ind_buffer);
+    _glBindBuffer(GL_ARRAY_BUFFER, 0);
+    _glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glDebug("glBufferData");
+
+    m_dirty = false;
+    return true;
+#else
+    return false;
+#endif
 }
 
 void OGLShapeBuffer::clear()
 {
+    m_dirty = true;
     m_position_buffer.clear();
     m_ind_buffer.clear();
     m_texture_buffer.clear();
@@ -47,6 +47,7 @@ class OGLShapeBuffer : public GLShapeBuffer
 public:
     OGLShapeBuffer(bool texture = false, bool colour = false,
                    drawing_modes prim = GLW_RECTANGLE);
+    virtual ~OGLShapeBuffer();
 
     virtual const char *print_statistics() const override;
     virtual unsigned int size() const override;
@@ -69,6 +70,14 @@ protected:
     vector<VColour> m_colour_buffer;
     vector<unsigned short int> m_ind_buffer;
 
+    // Buffer objects holding a copy of the above, when available.
+    enum { VBO_POSITION, VBO_TEXCOORD, VBO_COLOUR, VBO_INDEX, NUM_VBOS };
+    unsigned int m_vbos[NUM_VBOS];
+    bool m_dirty;
+    bool m_have_vbos;
+
+    bool upload();
+
 private:
     void glDebug(const char* msg);
 };
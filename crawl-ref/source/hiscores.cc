@@ -18,6 +18,7 @@
 #include <cctype>
 #include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <memory>
 #ifndef TARGET_COMPILER_VC
 #include <unistd.h>
@@ -47,6 +48,7 @@
 #include "state.h"
 #include "status.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #ifdef USE_TILE
  #include "tilepick.h"
 #endif
@@ -68,6 +70,8 @@ static int newest_entry = -1;
 static FILE *_hs_open(const char *mode, const string &filename);
 static void  _hs_close(FILE *handle, const string &filename);
 static bool  _hs_read(FILE *scores, scorefile_entry &dest);
+static bool  _hs_read_line(FILE *scores, string &line);
+static bool  _hs_line_score(const string &line, int &score);
 static void  _hs_write(FILE *scores, scorefile_entry &entry);
 static time_t _parse_time(const string &st);
 static string _xlog_escape(const string &s);
@@ -94,13 +98,118 @@ static string _log_file_name()
     return Options.shared_dir + "logfile" + crawl_state.game_type_qualifier();
 }
 
+// Logfile and milestone lines are appended to their (shared, on servers)
+// files by a thread of their own, so that waiting for another game to let go
+// of the lock doesn't hold up the turn. flush_xlog_writes() waits for
+// everything queued so far.
+#ifndef TARGET_OS_WINDOWS
+#define USE_XLOG_THREAD
+#include "threads.h"
+#endif
+
+struct pending_xlog_line
+{
+    string file;
+    string text;
+};
+
+// Runs on the writer thread, so it can't report failures with mpr().
+static void _append_xlog_line(const pending_xlog_line &entry)
+{
+    FILE *fp = fopen_u(entry.file.c_str(), "a");
+    if (!fp)
+        return;
+    if (lock_file_handle(fp, true))
+        fprintf(fp, "%s", entry.text.c_str());
+    lk_close(fp, entry.file);
+}
+
+#ifdef USE_XLOG_THREAD
+static bool xlog_thread_running = false;
+static bool xlog_busy = false;
+static deque<pending_xlog_line> xlog_queue;
+static thread_t xlog_thread;
+static mutex_t xlog_mutex;
+static cond_t xlog_wake;
+static cond_t xlog_done;
+
+static void *_xlog_write_thread(void *)
+{
+    mutex_lock(xlog_mutex);
+    while (true)
+    {
+        while (xlog_queue.empty())
+            cond_wait(xlog_wake, xlog_mutex);
+
+        pending_xlog_line entry = move(xlog_queue.front());
+        xlog_queue.pop_front();
+        xlog_busy = true;
+        mutex_unlock(xlog_mutex);
+
+        _append_xlog_line(entry);
+
+        mutex_lock(xlog_mutex);
+        xlog_busy = false;
+        cond_wake(xlog_done);
+    }
+    return nullptr;
+}
+
+static bool _start_xlog_thread()
+{
+    if (xlog_thread_running)
+        return true;
+
+    mutex_init(xlog_mutex);
+    cond_init(xlog_wake);
+    cond_init(xlog_done);
+    if (thread_create_joinable(&xlog_thread, _xlog_write_thread, nullptr))
+    {
+        cond_destroy(xlog_done);
+        cond_destroy(xlog_wake);
+        mutex_destroy(xlog_mutex);
+        return false;
+    }
+    xlog_thread_running = true;
+    return true;
+}
+#endif
+
+// Append text (whole lines) to the named file, usually without waiting.
+static void _queue_xlog_line(const string &file, const string &text)
+{
+#ifdef USE_XLOG_THREAD
+    if (_start_xlog_thread())
+    {
+        mutex_lock(xlog_mutex);
+        xlog_queue.push_back({file, text});
+        cond_wake(xlog_wake);
+        mutex_unlock(xlog_mutex);
+        return;
+    }
+#endif
+    _append_xlog_line({file, text});
+}
+
+void flush_xlog_writes()
+{
+#ifdef USE_XLOG_THREAD
+    if (!xlog_thread_running)
+        return;
+
+    mutex_lock(xlog_mutex);
+    while (!xlog_queue.empty() || xlog_busy)
+        cond_wait(xlog_done, xlog_mutex);
+    mutex_unlock(xlog_mutex);
+#endif
+}
+
 void hiscores_new_entry(const scorefile_entry &ne)
 {
     unwind_bool score_update(crawl_state.updating_scores, true);
 
     FILE *scores;
-    int i, total_entries;
-    bool inserted = false;
+    const int new_score = ne.get_score();
 
     // open highscore file (reading) -- nullptr is fatal!
     //
@@ -113,66 +222,68 @@ void hiscores_new_entry(const scorefile_entry &ne)
     // we're at the end of the file, seek back to beginning.
     fseek(scores, 0, SEEK_SET);
 
-    // read highscore file, inserting new entry at appropriate point,
+    // The file is sorted by score, so we only need each row's score to
+    // find where the new entry goes, and only the rows after that point
+    // have to be rewritten. This keeps the time spent holding the lock
+    // down to a quick scan, however full the file is.
+    vector<string> tail;
+    string line;
+    long offset = 0, insert_offset = -1;
+    bool unterminated = false;
+    int i, score;
     for (i = 0; i < SCORE_FILE_ENTRIES; i++)
     {
-        hs_list[i].reset(new scorefile_entry);
-        if (_hs_read(scores, *hs_list[i]) == false)
+        offset = ftell(scores);
+        if (!_hs_read_line(scores, line) || !_hs_line_score(line, score))
             break;
+        unterminated = line.back() != '\n';
 
-        // compare points..
-        if (!inserted && ne.get_score() >= hs_list[i]->get_score())
+        if (insert_offset == -1 && new_score >= score)
         {
             newest_entry = i;           // for later printing
-            inserted = true;
-            // copy read entry to i+1th position
-            // Fixed a nasty overflow bug here -- Sharp
-            if (i+1 < SCORE_FILE_ENTRIES)
-            {
-                hs_list[i + 1] = move(hs_list[i]);
-                hs_list[i].reset(new scorefile_entry(ne));
-                i++;
-            }
-            else
-                *hs_list[i] = ne; // copy new entry to current position
+            insert_offset = offset;
         }
+
+        // Keep room for the new entry.
+        if (insert_offset != -1 && i + 1 < SCORE_FILE_ENTRIES)
+            tail.push_back(line);
     }
 
     // special case: lowest score, with room
-    if (!inserted && i < SCORE_FILE_ENTRIES)
+    if (insert_offset == -1 && i < SCORE_FILE_ENTRIES)
     {
         newest_entry = i;
-        inserted = true;
-        // copy new entry
-        hs_list[i].reset(new scorefile_entry(ne));
-        i++;
+        insert_offset = offset;
     }
+    else
+        unterminated = false;
 
     // If we've still not inserted it, it's not a highscore.
-    if (!inserted)
+    if (insert_offset == -1)
     {
         newest_entry = -1; // This might not be the first game
         _hs_close(scores, _score_file_name());
         return;
     }
 
-    total_entries = i;
-
     // The old code closed and reopened the score file, leading to a
     // race condition where one Crawl process could overwrite the
     // other's highscore. Now we truncate and rewrite the file without
-    // closing it.
-    if (ftruncate(fileno(scores), 0))
+    // closing it. Since it is open for appending, writes land at the
+    // new end of the file.
+    if (ftruncate(fileno(scores), insert_offset))
         end(1, true, "unable to truncate scorefile");
 
-    rewind(scores);
+    fseek(scores, 0, SEEK_END);
 
-    // write scorefile entries.
-    for (i = 0; i < total_entries; i++)
-    {
-        _hs_write(scores, *hs_list[i]);
-        hs_list[i].reset(nullptr);
-    }
+    // write scorefile entries, not gluing the new one onto a last row
+    // that lacks its newline.
+    if (unterminated)
+        fputs("\n", scores);
+    scorefile_entry entry(ne);
+    _hs_write(scores, entry);
+    for (const string &row : tail)
+        fputs(row.c_str(), scores);
 
     // close scorefile.
     _hs_close(scores, _score_file_name());
@@ -182,21 +293,8 @@ void logfile_new_entry(const scorefile_entry &ne)
 {
     unwind_bool logfile_update(crawl_state.updating_scores, true);
 
-    FILE *logfile;
     scorefile_entry le = ne;
-
-    // open logfile (appending) -- nullptr *is* fatal here.
-    logfile = _hs_open("a", _log_file_name());
-    if (logfile == nullptr)
-    {
-        mprf(MSGCH_ERROR, "ERROR: failure writing to the logfile.");
-        return;
-    }
-
-    _hs_write(logfile, le);
-
-    // close logfile.
-    _hs_close(logfile, _log_file_name());
+    _queue_xlog_line(_log_file_name(), le.raw_string());
 }
 
 template <class t_printf>
@@ -581,6 +679,55 @@ static bool _hs_read(FILE *scores, scorefile_entry &dest)
     return dest.parse(inbuf);
 }
 
+// Reads a whole line, including its newline, without parsing it.
+static bool _hs_read_line(FILE *scores, string &line)
+{
+    char inbuf[1300];
+    line.clear();
+    if (!scores)
+        return false;
+
+    while (fgets(inbuf, sizeof inbuf, scores))
+    {
+        line += inbuf;
+        if (line.back() == '\n')
+            break;
+    }
+    return !line.empty();
+}
+
+// Picks the sc field out of an xlog line, treating it the way
+// scorefile_entry::parse() would without building the whole entry.
+static bool _hs_line_score(const string &line, int &score)
+{
+    if (line[0] == ':')
+        return false;
+
+    score = 0;
+    for (string::size_type pos = 0; pos < line.length(); ++pos)
+    {
+        if (!line.compare(pos, 3, "sc="))
+        {
+            score = atoi(line.c_str() + pos + 3);
+            return true;
+        }
+
+        // Skip to the start of the next field; :: is an escaped colon.
+        while (pos < line.length())
+        {
+            if (line[pos] == ':')
+            {
+                if (pos + 1 < line.length() && line[pos + 1] == ':')
+                    ++pos;
+                else
+                    break;
+            }
+            ++pos;
+        }
+    }
+    return true;
+}
+
 static int _val_char(char digit)
 {
     return digit - '0';
@@ -2911,12 +3058,10 @@ void mark_milestone(const string &type, const string &milestone,
                                     : se.get_death_time()).c_str());
     xl.add_field("type", "%s", type.c_str());
     xl.add_field("milestone", "%s", milestone.c_str());
-    const string xlog_line = xl.xlog_line();
-    if (FILE *fp = lk_open("a", milestone_file))
-    {
-        fprintf(fp, "%s\n", xlog_line.c_str());
-        lk_close(fp, milestone_file);
-    }
+    _queue_xlog_line(milestone_file, xl.xlog_line() + "\n");
+    // A crashing game may never get as far as draining the queue.
+    if (type == "crash")
+        flush_xlog_writes();
 #endif // DGL_MILESTONES
 }
 
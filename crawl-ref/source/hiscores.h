@@ -11,6 +11,7 @@ class scorefile_entry;
 void hiscores_new_entry(const scorefile_entry &se);
 
 void logfile_new_entry(const scorefile_entry &se);
+void flush_xlog_writes();
 
 void hiscores_print_list(int display_count = -1, int format = SCORE_TERSE);
 void hiscores_print_all(int display_count = -1, int format = SCORE_TERSE);
@@ -43,6 +43,7 @@
 #include "mon-util.h"
 #include "newgame.h"
 #include "options.h"
+#include "package.h"
 #include "playable.h"
 #include "player.h"
 #include "prompt.h"
@@ -681,6 +682,9 @@ void game_options::reset_options()
     basefilename = "unknown";
     line_num     = -1;
 
+    package::default_codec = CODEC_ZLIB;
+    pattern_sets_stale = true;
+
     set_default_activity_interrupts();
 
 #ifdef DEBUG_DIAGNOSTICS
@@ -837,6 +841,7 @@ void game_options::reset_options()
     rest_delay             = 0;
     show_travel_trail       = false;
 #endif
+    runrest_redraw_rate    = 0;
 
     travel_stair_cost      = 500;
 
@@ -846,6 +851,8 @@ void game_options::reset_options()
     arena_dump_msgs_all    = false;
     arena_list_eq          = false;
 
+    monster_sim_horizon    = 0;
+
     // Sort only pickup menus by default.
     sort_menus.clear();
     set_menu_sort("pickup: true");
@@ -932,6 +939,8 @@ void game_options::reset_options()
 
 #ifdef WIZARD
     fsim_rounds = 4000L;
+    fsim_jobs   = 1;
+    fsim_precision = 0;
     fsim_csv    = false;
     fsim_mons   = "";
     fsim_scale.clear();
@@ -1696,7 +1705,9 @@ void read_options(const string &s, bool runscript, bool clear_aliases)
 }
 
 game_options::game_options()
-    : seed(0), no_save(false), language(LANG_EN), lang_name(nullptr)
+    : seed(0), no_save(false), language(LANG_EN), lang_name(nullptr),
+      pattern_sets_stale(true), force_autopickup_patterns(64),
+      autoinscriptions_patterns(64), explore_stop_pickup_ignore_patterns(64)
 {
     reset_options();
 }
@@ -2460,6 +2471,10 @@ void game_options::read_option_line(const string &str, bool runscript)
         else                                                                   \
             _opt.push_back(_conv(part));                                       \
     }
+
+    // Any line may change one of the lists behind the pattern sets.
+    pattern_sets_stale = true;
+
     string key    = "";
     string subkey = "";
     string field  = "";
@@ -2534,31 +2549,22 @@ void game_options::read_option_line(const string &str, bool runscript)
     // Keep unlowercased field around
     const string orig_field = field;
 
-    if (key != "name" && key != "crawl_dir" && key != "macro_dir"
-        && key != "combo"
-        && key != "species" && key != "background" && key != "job"
-        && key != "race" && key != "class" && key != "ban_pickup"
-        && key != "autopickup_exceptions"
-        && key != "explore_stop_pickup_ignore"
-        && key != "stop_travel" && key != "sound"
-        && key != "force_more_message"
-        && key != "flash_screen_message"
-        && key != "confirm_action"
-        && key != "drop_filter" && key != "lua_file" && key != "terp_file"
-        && key != "note_items" && key != "autoinscribe"
-        && key != "note_monsters" && key != "note_messages"
-        && key != "display_char" && !starts_with(key, "cset") // compatibility
-        && key != "dungeon" && key != "feature"
-        && key != "mon_glyph" && key != "item_glyph"
-        && key != "fire_items_start"
-        && key != "opt" && key != "option"
-        && key != "menu_colour" && key != "menu_color"
-        && key != "message_colour" && key != "message_color"
-        && key != "levels" && key != "level" && key != "entries"
-        && key != "include" && key != "bindkey"
-        && key != "spell_slot"
-        && key != "item_slot"
-        && key != "ability_slot"
+    // Options whose values may need their capitals.
+    static const set<string> keep_case =
+    {
+        "name", "crawl_dir", "macro_dir", "combo", "species", "background",
+        "job", "race", "class", "ban_pickup", "autopickup_exceptions",
+        "explore_stop_pickup_ignore", "stop_travel", "sound",
+        "force_more_message", "flash_screen_message", "confirm_action",
+        "drop_filter", "lua_file", "terp_file", "note_items", "autoinscribe",
+        "note_monsters", "note_messages", "display_char", "dungeon",
+        "feature", "mon_glyph", "item_glyph", "fire_items_start", "opt",
+        "option", "menu_colour", "menu_color", "message_colour",
+        "message_color", "levels", "level", "entries", "include", "bindkey",
+        "spell_slot", "item_slot", "ability_slot",
+    };
+    if (!keep_case.count(key)
+        && !starts_with(key, "cset") // compatibility
         && key.find("font") == string::npos)
     {
         lowercase(field);
@@ -2873,6 +2879,17 @@ void game_options::read_option_line(const string &str, bool runscript)
 #if !defined(DGAMELAUNCH) || defined(DGL_REMEMBER_NAME)
     else BOOL_OPTION(remember_name);
 #endif
+    else if (key == "save_compression")
+    {
+        if (field == "zlib")
+            package::default_codec = CODEC_ZLIB;
+#ifdef USE_ZSTD
+        else if (field == "zstd")
+            package::default_codec = CODEC_ZSTD;
+#endif
+        else
+            report_error("Unknown save_compression: %s\n", field.c_str());
+    }
 #ifndef DGAMELAUNCH
     else if (key == "save_dir")
         save_dir = field;
@@ -3345,6 +3362,8 @@ void game_options::read_option_line(const string &str, bool runscript)
         if (fsim_rounds > 500000L)
             fsim_rounds = 500000L;
     }
+    else INT_OPTION(fsim_jobs, 1, 64);
+    else INT_OPTION(fsim_precision, 0, 100);
     else if (key == "fsim_mons")
         fsim_mons = field;
 #endif // WIZARD
@@ -3381,6 +3400,7 @@ void game_options::read_option_line(const string &str, bool runscript)
         if (rest_delay > 2000)
             rest_delay = 2000;
     }
+    else INT_OPTION(runrest_redraw_rate, 0, 2000);
     else BOOL_OPTION(show_travel_trail);
     else if (key == "level_map_cursor_step")
     {
@@ -3839,6 +3859,7 @@ void game_options::read_option_line(const string &str, bool runscript)
     else BOOL_OPTION(arena_dump_msgs);
     else BOOL_OPTION(arena_dump_msgs_all);
     else BOOL_OPTION(arena_list_eq);
+    else INT_OPTION(monster_sim_horizon, 0, GXM);
     else INT_OPTION(fail_severity_to_confirm, -1, 3);
 
     // Catch-all else, copies option into map
@@ -4212,7 +4233,14 @@ enum commandline_option_type
     CLO_MAPSTAT,
     CLO_OBJSTAT,
     CLO_ITERATIONS,
+    CLO_JOBS,
+    CLO_BENCH,
     CLO_ARENA,
+    CLO_ARENA_BATCH,
+    CLO_RECORD_KEYS,
+    CLO_REPLAY_BENCH,
+    CLO_PROFILE_OUT,
+    CLO_STARTUP_PROFILE,
     CLO_DUMP_MAPS,
     CLO_TEST,
     CLO_SCRIPT,
@@ -4238,8 +4266,10 @@ enum commandline_option_type
     CLO_PLAYABLE_JSON, // JSON metadata for species, jobs, combos.
 #ifdef USE_TILE_WEB
     CLO_WEBTILES_SOCKET,
+    CLO_WEBTILES_STREAM,
     CLO_AWAIT_CONNECTION,
     CLO_PRINT_WEBTILES_OPTIONS,
+    CLO_WEBTILES_RECORD,
 #endif
 
     CLO_NOPS
@@ -4249,14 +4279,17 @@ static const char *cmd_ops[] =
 {
     "scores", "name", "species", "background", "dir", "rc",
     "rcdir", "tscores", "vscores", "scorefile", "morgue", "macro",
-    "mapstat", "objstat", "iters", "arena", "dump-maps", "test", "script",
+    "mapstat", "objstat", "iters", "jobs", "bench", "arena",
+    "arena-batch", "record-keys", "replay-bench",
+    "profile-out", "startup-profile", "dump-maps", "test", "script",
     "builddb", "help", "version", "seed", "save-version", "sprint",
     "extra-opt-first", "extra-opt-last", "sprint-map", "edit-save",
     "print-charset", "tutorial", "wizard", "explore", "no-save",
     "gdb", "no-gdb", "nogdb", "throttle", "no-throttle",
     "playable-json",
 #ifdef USE_TILE_WEB
-    "webtiles-socket", "await-connection", "print-webtiles-options",
+    "webtiles-socket", "webtiles-stream", "await-connection",
+    "print-webtiles-options", "webtiles-record",
 #endif
 };
 
@@ -4494,11 +4527,14 @@ static void _edit_save(int argc, char **argv)
                 frag += cfrag;
                 int cclen = save.get_chunk_compressed_length(chunk);
 
-                char buf[16384];
-                chunk_reader in(&save, chunk);
                 plen_t clen = 0;
-                while (plen_t s = in.read(buf, sizeof(buf)))
-                    clen += s;
+                if (!save.get_chunk_length(chunk, clen))
+                {
+                    char buf[16384];
+                    chunk_reader in(&save, chunk);
+                    while (plen_t s = in.read(buf, sizeof(buf)))
+                        clen += s;
+                }
                 printf("%7d/%7d %3u %s\n", cclen, clen, cfrag, chunk.c_str());
             }
             // the directory is not a chunk visible from the outside
@@ -4684,6 +4720,7 @@ bool parse_args(int argc, char **argv, bool rc_only)
 
     SysEnv.rcdirs.clear();
     SysEnv.map_gen_iters = 0;
+    SysEnv.map_gen_jobs = 1;
 
     if (argc < 2)           // no args!
         return true;
@@ -4855,6 +4892,48 @@ bool parse_args(int argc, char **argv, bool rc_only)
 #endif
             break;
 
+        case CLO_JOBS:
+            if (!next_is_param || !isadigit(*next_arg))
+            {
+                fprintf(stderr, "Integer argument required for -%s\n", arg);
+                end(1);
+            }
+            else
+            {
+                SysEnv.map_gen_jobs = atoi(next_arg);
+                if (SysEnv.map_gen_jobs < 1)
+                    SysEnv.map_gen_jobs = 1;
+                else if (SysEnv.map_gen_jobs > 256)
+                    SysEnv.map_gen_jobs = 256;
+                nextUsed = true;
+            }
+            break;
+
+        case CLO_BENCH:
+#ifdef DEBUG_STATISTICS
+            // The level builder treats this as a mapstat run.
+            crawl_state.kernel_bench = true;
+            crawl_state.map_stat_gen = true;
+#ifdef USE_TILE_LOCAL
+            crawl_state.tiles_disabled = true;
+#endif
+
+            if (!SysEnv.map_gen_iters)
+                SysEnv.map_gen_iters = 10;
+            if (next_is_param)
+            {
+                SysEnv.map_gen_range.reset(new depth_ranges);
+                *SysEnv.map_gen_range =
+                    depth_ranges::parse_depth_ranges(next_arg);
+                nextUsed = true;
+            }
+            break;
+#else
+            fprintf(stderr, "bench is available only in DEBUG_STATISTICS "
+                    "builds.\n");
+            end(1);
+#endif
+
         case CLO_ARENA:
             if (!rc_only)
             {
@@ -4869,6 +4948,60 @@ bool parse_args(int argc, char **argv, bool rc_only)
             }
             break;
 
+        case CLO_ARENA_BATCH:
+            if (!next_is_param)
+            {
+                fprintf(stderr, "File name required for -%s\n", arg);
+                end(1);
+            }
+            if (!rc_only)
+            {
+                Options.game.type = GAME_TYPE_ARENA;
+                Options.restart_after_game = false;
+                SysEnv.arena_batch_file = next_arg;
+            }
+            nextUsed = true;
+            break;
+
+        case CLO_RECORD_KEYS:
+        case CLO_REPLAY_BENCH:
+            if (!next_is_param)
+            {
+                fprintf(stderr, "File name required for -%s\n", arg);
+                end(1);
+            }
+            if (!rc_only)
+            {
+                if (o == CLO_RECORD_KEYS)
+                    SysEnv.record_keys_file = next_arg;
+                else
+                    SysEnv.replay_bench_file = next_arg;
+            }
+            nextUsed = true;
+            break;
+
+        case CLO_PROFILE_OUT:
+#ifdef DEBUG_PROFILE
+            if (!next_is_param)
+            {
+                fprintf(stderr, "File name required for -%s\n", arg);
+                end(1);
+            }
+            if (!rc_only)
+                SysEnv.profile_out_file = next_arg;
+            nextUsed = true;
+#else
+            fprintf(stderr, "-profile-out is available only in DEBUG_PROFILE "
+                    "builds.\n");
+            end(1);
+#endif
+            break;
+
+        case CLO_STARTUP_PROFILE:
+            if (!rc_only)
+                SysEnv.startup_profile = true;
+            break;
+
         case CLO_DUMP_MAPS:
             crawl_state.dump_maps = true;
             break;
@@ -5068,6 +5201,10 @@ bool parse_args(int argc, char **argv, bool rc_only)
             tiles.m_sock_name = next_arg;
             break;
 
+        case CLO_WEBTILES_STREAM:
+            tiles.m_sock_stream = true;
+            break;
+
         case CLO_AWAIT_CONNECTION:
             tiles.m_await_connection = true;
             break;
@@ -5079,6 +5216,11 @@ bool parse_args(int argc, char **argv, bool rc_only)
                 end(0);
             }
             break;
+
+        case CLO_WEBTILES_RECORD:
+            nextUsed            = true;
+            tiles.m_record_name = next_arg;
+            break;
 #endif
 
         case CLO_PRINT_CHARSET:
@@ -5175,6 +5317,131 @@ int game_options::o_colour(const char *name, int def) const
     return col == -1? def : col;
 }
 
+void game_options::update_pattern_sets() const
+{
+    if (!pattern_sets_stale)
+        return;
+    pattern_sets_stale = false;
+
+    force_autopickup_patterns.clear();
+    for (const auto &entry : force_autopickup)
+        force_autopickup_patterns.add(entry.first);
+
+    note_messages_patterns.clear();
+    for (const text_pattern &pat : note_messages)
+        note_messages_patterns.add(pat);
+
+    autoinscriptions_patterns.clear();
+    for (const auto &entry : autoinscriptions)
+        autoinscriptions_patterns.add(entry.first);
+
+    explore_stop_pickup_ignore_patterns.clear();
+    for (const text_pattern &pat : explore_stop_pickup_ignore)
+        explore_stop_pickup_ignore_patterns.add(pat);
+
+    // Built per channel as messages arrive.
+    message_colour_sets.clear();
+    force_more_sets.clear();
+    flash_screen_sets.clear();
+}
+
+const text_pattern_set &game_options::force_autopickup_set() const
+{
+    update_pattern_sets();
+    return force_autopickup_patterns;
+}
+
+const text_pattern_set &game_options::note_messages_set() const
+{
+    update_pattern_sets();
+    return note_messages_patterns;
+}
+
+const text_pattern_set &game_options::autoinscriptions_set() const
+{
+    update_pattern_sets();
+    return autoinscriptions_patterns;
+}
+
+const text_pattern_set &game_options::explore_stop_pickup_ignore_set() const
+{
+    update_pattern_sets();
+    return explore_stop_pickup_ignore_patterns;
+}
+
+int game_options::message_colour_index(int channel,
+                                       const string &message) const
+{
+    update_pattern_sets();
+
+    auto found = message_colour_sets.find(channel);
+    if (found == message_colour_sets.end())
+    {
+        channel_colour_set &cs = message_colour_sets[channel];
+        for (unsigned int i = 0; i < message_colour_mappings.size(); ++i)
+        {
+            const message_filter &filter = message_colour_mappings[i].message;
+            if (filter.channel != channel && filter.channel != -1)
+                continue;
+            // Matches every message, so nothing after it is reached.
+            if (filter.pattern.empty())
+            {
+                cs.catch_all = i;
+                break;
+            }
+            cs.entries.push_back(i);
+            cs.patterns.add(filter.pattern);
+        }
+        found = message_colour_sets.find(channel);
+    }
+
+    const channel_colour_set &cs = found->second;
+    const int first = cs.patterns.first_match(message);
+    return first >= 0 ? cs.entries[first] : cs.catch_all;
+}
+
+bool game_options::filter_set_matches(map<int, channel_filter_set> &sets,
+                                      const vector<message_filter> &filters,
+                                      int channel, const string &message) const
+{
+    update_pattern_sets();
+
+    auto found = sets.find(channel);
+    if (found == sets.end())
+    {
+        channel_filter_set &fs = sets[channel];
+        for (const message_filter &filter : filters)
+        {
+            if (filter.channel != channel && filter.channel != -1)
+                continue;
+            if (filter.pattern.empty())
+            {
+                fs.catch_all = true;
+                break;
+            }
+            fs.patterns.add(filter.pattern);
+        }
+        found = sets.find(channel);
+    }
+
+    const channel_filter_set &fs = found->second;
+    return fs.catch_all || fs.patterns.first_match(message) >= 0;
+}
+
+bool game_options::force_more_matches(int channel,
+                                      const string &message) const
+{
+    return filter_set_matches(force_more_sets, force_more_message, channel,
+                              message);
+}
+
+bool game_options::flash_screen_matches(int channel,
+                                        const string &message) const
+{
+    return filter_set_matches(flash_screen_sets, flash_screen_message,
+                              channel, message);
+}
+
 ///////////////////////////////////////////////////////////////////////
 // system_environment
 
@@ -57,8 +57,16 @@ public:
     vector<string> cmd_args;
 
     int map_gen_iters;
+    int map_gen_jobs;
     unique_ptr<depth_ranges> map_gen_range;
 
+    string arena_batch_file;
+
+    string record_keys_file;       // Key log to write (-record-keys).
+    string replay_bench_file;      // Key log to replay (-replay-bench).
+    string profile_out_file;       // Where to dump the turn profile.
+    bool startup_profile;          // Report init stage timings.
+
     vector<string> extra_opts_first;
     vector<string> extra_opts_last;
 
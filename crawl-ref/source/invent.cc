@@ -649,11 +649,9 @@ struct menu_entry_comparator
     {
     }
 
-    bool operator () (const MenuEntry* a, const MenuEntry* b) const
+    bool operator () (const InvEntry* a, const InvEntry* b) const
     {
-        const InvEntry *ia = dynamic_cast<const InvEntry *>(a);
-        const InvEntry *ib = dynamic_cast<const InvEntry *>(b);
-        return _compare_invmenu_items(ia, ib, &cond->cmp);
+        return _compare_invmenu_items(a, b, &cond->cmp);
     }
 };
 
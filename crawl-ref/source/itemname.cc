@@ -1591,8 +1591,134 @@ static string _name_weapon(const item_def &weap, description_level_type desc,
 
 // Note that "terse" is only currently used for the "in hand" listing on
 // the game screen.
+// Bumped by forget_item_names() when something outside an item's own state
+// that its name depends on changes.
+static unsigned int _item_name_generation = 0;
+
+void forget_item_names()
+{
+    ++_item_name_generation;
+}
+
+unsigned int item_name_generation()
+{
+    return _item_name_generation;
+}
+
+// An item keeps only a few recent names: most callers ask for the same one
+// or two description levels of an item over and over.
+#define ITEM_NAME_MEMO_SIZE 4
+
+// Everything name_aux() depends on, and the name it built from it.
+struct item_name_memo_entry
+{
+    unsigned int           generation;
+    description_level_type desc;
+    bool                   terse;
+    bool                   ident;
+    bool                   with_inscription;
+    iflags_t               ignore_flags;
+
+    bool                   type_known;
+    bool                   show_uncursed;
+    maybe_bool             show_god_gift;
+    bool                   arena;
+
+    object_class_type      base_type;
+    uint8_t                sub_type;
+    short                  plus;
+    short                  plus2;
+    int                    special;
+    short                  quantity;
+    iflags_t               flags;
+    coord_def              pos;
+    short                  orig_monnum;
+    unsigned int           props_size;
+    string                 inscription;
+
+    string                 name;
+
+    bool same_state(const item_name_memo_entry &o) const
+    {
+        return generation == o.generation && desc == o.desc
+               && terse == o.terse && ident == o.ident
+               && with_inscription == o.with_inscription
+               && ignore_flags == o.ignore_flags
+               && type_known == o.type_known
+               && show_uncursed == o.show_uncursed
+               && show_god_gift == o.show_god_gift && arena == o.arena
+               && base_type == o.base_type && sub_type == o.sub_type
+               && plus == o.plus && plus2 == o.plus2
+               && special == o.special && quantity == o.quantity
+               && flags == o.flags && pos == o.pos
+               && orig_monnum == o.orig_monnum
+               && props_size == o.props_size
+               && inscription == o.inscription;
+    }
+};
+
+void item_name_memo::clear()
+{
+    delete entries;
+    entries = nullptr;
+}
+
 string item_def::name_aux(description_level_type desc, bool terse, bool ident,
                           bool with_inscription, iflags_t ignore_flags) const
+{
+    // Marking and drawing from a deck change card lists deep inside its
+    // props, which the memo doesn't look at.
+    if (base_type == OBJ_MISCELLANY && is_deck(*this))
+    {
+        return build_name_aux(desc, terse, ident, with_inscription,
+                              ignore_flags);
+    }
+
+    item_name_memo_entry key;
+    key.generation       = _item_name_generation;
+    key.desc             = desc;
+    key.terse            = terse;
+    key.ident            = ident;
+    key.with_inscription = with_inscription;
+    key.ignore_flags     = ignore_flags;
+    key.type_known       = item_type_known(*this);
+    key.show_uncursed    = Options.show_uncursed;
+    key.show_god_gift    = Options.show_god_gift;
+    key.arena            = crawl_state.game_is_arena();
+    key.base_type        = base_type;
+    key.sub_type         = sub_type;
+    key.plus             = plus;
+    key.plus2            = plus2;
+    key.special          = special;
+    key.quantity         = quantity;
+    key.flags            = flags;
+    key.pos              = pos;
+    key.orig_monnum      = orig_monnum;
+    key.props_size       = props.size();
+    key.inscription      = inscription;
+
+    if (name_memo.entries)
+    {
+        for (const item_name_memo_entry &entry : *name_memo.entries)
+            if (entry.same_state(key))
+                return entry.name;
+    }
+    else
+        name_memo.entries = new vector<item_name_memo_entry>;
+
+    key.name = build_name_aux(desc, terse, ident, with_inscription,
+                              ignore_flags);
+
+    vector<item_name_memo_entry> &entries = *name_memo.entries;
+    if (entries.size() >= ITEM_NAME_MEMO_SIZE)
+        entries.erase(entries.begin());
+    entries.push_back(key);
+    return key.name;
+}
+
+string item_def::build_name_aux(description_level_type desc, bool terse,
+                                bool ident, bool with_inscription,
+                                iflags_t ignore_flags) const
 {
     // Shortcuts
     const int item_typ   = sub_type;
@@ -2256,6 +2382,7 @@ bool set_ident_type(object_class_type basetype, int subtype, bool identify)
         return false;
 
     you.type_ids[basetype][subtype] = identify;
+    forget_item_names();
     request_autoinscribe();
 
     // Our item knowledge changed in a way that could possibly affect shop
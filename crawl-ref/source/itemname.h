@@ -143,6 +143,8 @@ string get_menu_colour_prefix_tags(const item_def &item,
                                    description_level_type desc);
 
 void            init_item_name_cache();
+void            forget_item_names();
+unsigned int    item_name_generation();
 item_kind item_kind_by_name(const string &name);
 
 vector<string> item_name_list_for_glyph(unsigned glyph);
@@ -2090,6 +2090,16 @@ static void _gozag_move_gold_to_top(const coord_def p)
 //
 // Returns false on error or level full - cases where you
 // keep the item.
+// Whether the floor item could stack with the given one, for walking big
+// piles: items of another base or sub type are ruled out without the full
+// items_stack() check.
+static bool _stacks_on_floor(const item_def &item, const item_def &floor_item)
+{
+    return floor_item.base_type == item.base_type
+           && floor_item.sub_type == item.sub_type
+           && items_stack(item, floor_item);
+}
+
 bool move_item_to_grid(int *const obj, const coord_def& p, bool silent)
 {
     ASSERT_IN_BOUNDS(p);
@@ -2126,7 +2136,7 @@ bool move_item_to_grid(int *const obj, const coord_def& p, bool silent)
             if (ob == si->index())
                 return false;
 
-            if (items_stack(item, *si))
+            if (_stacks_on_floor(item, *si))
             {
                 // Add quantity to item already here, and dispose
                 // of obj, while returning the found item. -- bwr
@@ -2244,7 +2254,7 @@ bool copy_item_to_grid(item_def &item, const coord_def& p,
     {
         for (stack_iterator si(p); si; ++si)
         {
-            if (items_stack(item, *si))
+            if (_stacks_on_floor(item, *si))
             {
                 item_def copy = item;
                 merge_item_stacks(copy, *si, quant_drop);
@@ -2661,9 +2671,14 @@ static void _autoinscribe_item(item_def& item)
 
     string iname = _autopickup_item_name(item);
 
-    for (const auto &ai_entry : Options.autoinscriptions)
+    // Every matching rule applies, so only the first one is found through
+    // the pattern set.
+    const int first = Options.autoinscriptions_set().first_match(iname);
+    for (int i = first; i >= 0 && i < (int) Options.autoinscriptions.size();
+         ++i)
     {
-        if (ai_entry.first.matches(iname))
+        const auto &ai_entry = Options.autoinscriptions[i];
+        if (i == first || ai_entry.first.matches(iname))
         {
             // Don't autoinscribe dropped items on ground with
             // "=g". If the item matches a rule which adds "=g",
@@ -2767,8 +2782,6 @@ static int _autopickup_subtype(const item_def &item)
 
 static bool _is_option_autopickup(const item_def &item, bool ignore_force)
 {
-    string iname = _autopickup_item_name(item);
-
     if (item.base_type < NUM_OBJECT_CLASSES)
     {
         const int force = you.force_autopickup[item.base_type][_autopickup_subtype(item)];
@@ -2778,6 +2791,10 @@ static bool _is_option_autopickup(const item_def &item, bool ignore_force)
     else
         return false;
 
+    // Only built once the \ menu settings haven't decided: it means a Lua
+    // annotation call and a full item name.
+    const string iname = _autopickup_item_name(item);
+
 #ifdef CLUA_BINDINGS
     maybe_bool res = clua.callmaybefn("ch_force_autopickup", "is",
                                       &item, iname.c_str());
@@ -2795,9 +2812,9 @@ static bool _is_option_autopickup(const item_def &item, bool ignore_force)
 #endif
 
     // Check for initial settings
-    for (const pair<text_pattern, bool>& option : Options.force_autopickup)
-        if (option.first.matches(iname))
-            return option.second;
+    const int force = Options.force_autopickup_set().first_match(iname);
+    if (force >= 0)
+        return Options.force_autopickup[force].second;
 
     return Options.autopickups[item.base_type];
 }
@@ -2940,15 +2957,9 @@ static bool _interesting_explore_pickup(const item_def& item)
         return true;
     }
 
-    vector<text_pattern> &ignores = Options.explore_stop_pickup_ignore;
-    if (!ignores.empty())
-    {
-        const string name = item.name(DESC_PLAIN);
-
-        for (const text_pattern &pat : ignores)
-            if (pat.matches(name))
-                return false;
-    }
+    const text_pattern_set &ignores = Options.explore_stop_pickup_ignore_set();
+    if (!ignores.empty() && ignores.first_match(item.name(DESC_PLAIN)) >= 0)
+        return false;
 
     if (!(Options.explore_stop & ES_GREEDY_PICKUP_SMART))
         return true;
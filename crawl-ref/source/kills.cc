@@ -101,14 +101,7 @@ int KillMaster::total_kills() const
 {
     int grandtotal = 0;
     for (int i = KC_YOU; i < KC_NCATEGORIES; ++i)
-    {
-        if (categorized_kills[i].empty())
-            continue;
-
-        vector<kill_exp> kills;
-        int count = categorized_kills[i].get_kills(kills);
-        grandtotal += count;
-    }
+        grandtotal += categorized_kills[i].total_kills();
     return grandtotal;
 }
 
@@ -304,6 +297,15 @@ void Kills::record_kill(const monster* mon)
         k = kill_def(mon);
 }
 
+// The same count get_kills() returns, without describing and sorting them.
+int Kills::total_kills() const
+{
+    int count = ghosts.size();
+    for (const auto &entry : kills)
+        count += entry.second.kills;
+    return count;
+}
+
 int Kills::get_kills(vector<kill_exp> &all_kills) const
 {
     int count = 0;
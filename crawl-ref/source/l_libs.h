@@ -83,5 +83,6 @@ int dgn_map_add_transform(lua_State *ls,
 
 struct monster_info;
 void lua_push_moninf(lua_State *ls, monster_info *mi);
+void clear_moninf_cache();
 
 #endif
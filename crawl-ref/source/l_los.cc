@@ -59,11 +59,32 @@ LUAFN(los_cell_see_cell)
     PLUARET(number, cell_see_cell(p, q, LOS_DEFAULT));
 }
 
+// Returns hits, misses, dirty tables cleared, local and full invalidations
+// of the global LOS cache since the last reset.
+LUAFN(los_get_cache_stats)
+{
+    const los_cache_stats &stats = get_los_cache_stats();
+    lua_pushnumber(ls, stats.hits);
+    lua_pushnumber(ls, stats.misses);
+    lua_pushnumber(ls, stats.tables_cleared);
+    lua_pushnumber(ls, stats.local_invalidations);
+    lua_pushnumber(ls, stats.full_invalidations);
+    return 5;
+}
+
+LUAFN(los_reset_cache_stats)
+{
+    reset_los_cache_stats();
+    return 0;
+}
+
 const struct luaL_reg los_dlib[] =
 {
     { "findray", los_find_ray },
     { "make_ray", los_make_ray },
     { "cell_see_cell", los_cell_see_cell },
+    { "cache_stats", los_get_cache_stats },
+    { "reset_cache_stats", los_reset_cache_stats },
     { nullptr, nullptr }
 };
 
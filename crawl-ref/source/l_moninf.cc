@@ -28,6 +28,39 @@ void lua_push_moninf(lua_State *ls, monster_info *mi)
     *miref = new monster_info(*mi);
 }
 
+// Registry key of the table of monster.info userdata handed out since the
+// cache was last cleared, keyed by mid.
+#define MONINF_CACHE "moninf_cache"
+
+static bool _moninf_cache_stale = true;
+static int _moninf_cache_time = -1;
+
+// Anything that can change monsters between two queries without game time
+// passing (a zero-time command, a Lua script processing keys) clears the
+// cache through process_command().
+void clear_moninf_cache()
+{
+    _moninf_cache_stale = true;
+}
+
+// Pushes the cache table, starting a fresh one if the old is out of date.
+static void _push_moninf_cache(lua_State *ls)
+{
+    if (!_moninf_cache_stale && _moninf_cache_time == you.elapsed_time)
+    {
+        lua_getfield(ls, LUA_REGISTRYINDEX, MONINF_CACHE);
+        if (lua_istable(ls, -1))
+            return;
+        lua_pop(ls, 1);
+    }
+
+    lua_newtable(ls);
+    lua_pushvalue(ls, -1);
+    lua_setfield(ls, LUA_REGISTRYINDEX, MONINF_CACHE);
+    _moninf_cache_stale = false;
+    _moninf_cache_time = you.elapsed_time;
+}
+
 #define MONINF(ls, n, var) \
     monster_info *var = *(monster_info **) \
         luaL_checkudata(ls, n, MONINF_METATABLE)
@@ -389,8 +422,30 @@ LUAFN(mi_get_monster_at)
     monster* m = &env.mons[env.mgrid(p)];
     if (!m->visible_to(&you))
         return 0;
-    monster_info mi(m);
-    lua_push_moninf(ls, &mi);
+
+    // Monsters may change at any moment while the world is reacting (for
+    // instance under a c_message hook), so only reuse userdata while the
+    // player is deciding what to do.
+    if (you.turn_is_over)
+    {
+        monster_info mi(m);
+        lua_push_moninf(ls, &mi);
+        return 1;
+    }
+
+    _push_moninf_cache(ls);
+    lua_pushnumber(ls, m->mid);
+    lua_rawget(ls, -2);
+    if (lua_isnil(ls, -1))
+    {
+        lua_pop(ls, 1);
+        monster_info mi(m);
+        lua_push_moninf(ls, &mi);
+        lua_pushnumber(ls, m->mid);
+        lua_pushvalue(ls, -2);
+        lua_rawset(ls, -4);
+    }
+    lua_remove(ls, -2);
     return 1;
 }
 
@@ -14,6 +14,7 @@
 #include "cio.h"
 #include "defines.h"
 #include "env.h"
+#include "macro.h"
 #include "message.h"
 #include "state.h"
 #include "terrain.h"
@@ -148,7 +149,10 @@ int num_to_lines(int num)
 
 int getch_ck()
 {
-    return tiles.getch_ck();
+    int c;
+    if (keylog_replay_key(c))
+        return c;
+    return keylog_record(tiles.getch_ck());
 }
 
 int getchk()
@@ -195,7 +199,7 @@ void update_screen()
 
 bool kbhit()
 {
-    if (crawl_state.tiles_disabled)
+    if (crawl_state.tiles_disabled || keylog_is_replaying())
         return false;
     // Look for the presence of any keyboard events in the queue.
     int count = wm->get_event_count(WME_KEYDOWN)
@@ -32,6 +32,7 @@
 
 #include "cio.h"
 #include "crash.h"
+#include "macro.h"
 #include "state.h"
 #include "unicode.h"
 #include "view.h"
@@ -207,21 +208,8 @@ static int proc_mouse_event(int c, const MEVENT *me)
 
 static int pending = 0;
 
-int getchk()
+static int _getchk_input()
 {
-#ifdef WATCHDOG
-    // If we have (or wait for) actual keyboard input, it's not an infinite
-    // loop.
-    watchdog();
-#endif
-
-    if (pending)
-    {
-        int c = pending;
-        pending = 0;
-        return c;
-    }
-
     wint_t c;
 
 #ifdef USE_TILE_WEB
@@ -249,6 +237,28 @@ int getchk()
     return -c;
 }
 
+int getchk()
+{
+#ifdef WATCHDOG
+    // If we have (or wait for) actual keyboard input, it's not an infinite
+    // loop.
+    watchdog();
+#endif
+
+    // A key kbhit() read ahead.
+    if (pending)
+    {
+        int c = pending;
+        pending = 0;
+        return keylog_record(c);
+    }
+
+    int c;
+    if (keylog_replay_key(c))
+        return c;
+    return keylog_record(_getchk_input());
+}
+
 int m_getch()
 {
     int c;
@@ -502,6 +512,41 @@ void putwch(ucs_t chr)
 #endif
 }
 
+// Write a run of cells that share a colour, as put_colour_ch() would one
+// at a time, but with one colour change and one string write.
+static void _put_colour_run(int colour, const screen_cell_t *cell, int len)
+{
+    textcolour(colour);
+
+    wchar_t buf[64];
+#ifdef USE_TILE_WEB
+    ucs_t wbuf[ARRAYSZ(buf) + 1];
+#endif
+    while (len > 0)
+    {
+        const int n = min(len, (int) ARRAYSZ(buf));
+#ifdef USE_TILE_WEB
+        int wn = 0;
+#endif
+        for (int i = 0; i < n; ++i)
+        {
+            buf[i] = cell[i].glyph ? cell[i].glyph : ' ';
+#ifdef USE_TILE_WEB
+            // putwch() sends nothing to the web console for a null glyph.
+            if (cell[i].glyph)
+                wbuf[wn++] = cell[i].glyph;
+#endif
+        }
+        addnwstr(buf, n);
+#ifdef USE_TILE_WEB
+        wbuf[wn] = 0;
+        tiles.put_ucs_string(wbuf);
+#endif
+        cell += n;
+        len -= n;
+    }
+}
+
 void puttext(int x1, int y1, const crawl_view_buffer &vbuf)
 {
     const screen_cell_t *cell = vbuf;
@@ -509,10 +554,14 @@ void puttext(int x1, int y1, const crawl_view_buffer &vbuf)
     for (int y = 0; y < size.y; ++y)
     {
         cgotoxy(x1, y1 + y);
-        for (int x = 0; x < size.x; ++x)
+        for (int x = 0; x < size.x;)
         {
-            put_colour_ch(cell->colour, cell->glyph);
-            cell++;
+            int run = 1;
+            while (x + run < size.x && cell[run].colour == cell->colour)
+                ++run;
+            _put_colour_run(cell->colour, cell, run);
+            cell += run;
+            x += run;
         }
     }
     update_screen();
@@ -841,6 +890,9 @@ bool kbhit()
     if (pending)
         return true;
 
+    if (keylog_is_replaying())
+        return false;
+
     wint_t c;
 #ifndef USE_TILE_WEB
     int i;
@@ -63,6 +63,7 @@
 #include "cio.h"
 #include "defines.h"
 #include "libutil.h"
+#include "macro.h"
 #include "options.h"
 #include "state.h"
 #include "unicode.h"
@@ -770,7 +771,7 @@ static int w32_proc_mouse_event(const MOUSE_EVENT_RECORD &mer)
     return 0;
 }
 
-int getch_ck()
+static int _getch_ck_console()
 {
     INPUT_RECORD ir;
     DWORD nread;
@@ -840,6 +841,14 @@ int getch_ck()
     return key;
 }
 
+int getch_ck()
+{
+    int c;
+    if (keylog_replay_key(c))
+        return c;
+    return keylog_record(_getch_ck_console());
+}
+
 int getchk()
 {
     int c = getch_ck();
@@ -851,6 +860,9 @@ bool kbhit()
     if (crawl_state.seen_hups)
         return 1;
 
+    if (keylog_is_replaying())
+        return 0;
+
     INPUT_RECORD ir[10];
     DWORD read_count = 0;
     PeekConsoleInputW(inbuf, ir, ARRAYSZ(ir), &read_count);
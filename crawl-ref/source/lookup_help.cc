@@ -151,39 +151,43 @@ private:
 
 
 
-static bool _compare_mon_names(MenuEntry *entry_a, MenuEntry* entry_b)
+// Sort keys for a monster menu entry, worked out once per sort rather than
+// once per comparison.
+struct mon_sort_key
 {
-    monster_info* a = static_cast<monster_info* >(entry_a->data);
-    monster_info* b = static_cast<monster_info* >(entry_b->data);
+    MenuEntry *entry;
+    monster_type type;
+    int toughness;
+    string name;
+
+    explicit mon_sort_key(MenuEntry *e)
+        : entry(e),
+          type(static_cast<monster_info* >(e->data)->type),
+          toughness(mons_avg_hp(type)),
+          name(lowercase_string(mons_type_name(type, DESC_PLAIN)))
+    {
+    }
+};
 
-    if (a->type == b->type)
+static bool _compare_mon_names(const mon_sort_key &a, const mon_sort_key &b)
+{
+    if (a.type == b.type)
         return false;
 
-    string a_name = mons_type_name(a->type, DESC_PLAIN);
-    string b_name = mons_type_name(b->type, DESC_PLAIN);
-    return lowercase(a_name) < lowercase(b_name);
+    return a.name < b.name;
 }
 
 // Compare monsters by location-independent level, or by hitdice if
 // levels are equal, or by name if both level and hitdice are equal.
-static bool _compare_mon_toughness(MenuEntry *entry_a, MenuEntry* entry_b)
+static bool _compare_mon_toughness(const mon_sort_key &a,
+                                   const mon_sort_key &b)
 {
-    monster_info* a = static_cast<monster_info* >(entry_a->data);
-    monster_info* b = static_cast<monster_info* >(entry_b->data);
-
-    if (a->type == b->type)
+    if (a.type == b.type)
         return false;
 
-    int a_toughness = mons_avg_hp(a->type);
-    int b_toughness = mons_avg_hp(b->type);
-
-    if (a_toughness == b_toughness)
-    {
-        string a_name = mons_type_name(a->type, DESC_PLAIN);
-        string b_name = mons_type_name(b->type, DESC_PLAIN);
-        return lowercase(a_name) < lowercase(b_name);
-    }
-    return a_toughness > b_toughness;
+    if (a.toughness == b.toughness)
+        return a.name < b.name;
+    return a.toughness > b.toughness;
 }
 
 class DescMenu : public Menu
@@ -223,15 +227,17 @@ public:
         if (!toggleable_sort)
             return;
 
+        vector<mon_sort_key> keys(items.begin(), items.end());
         if (sort_alpha)
-            ::sort(items.begin(), items.end(), _compare_mon_names);
+            ::sort(keys.begin(), keys.end(), _compare_mon_names);
         else
-            ::sort(items.begin(), items.end(), _compare_mon_toughness);
+            ::sort(keys.begin(), keys.end(), _compare_mon_toughness);
 
         for (unsigned int i = 0, size = items.size(); i < size; i++)
         {
             const char letter = index_to_letter(i);
 
+            items[i] = keys[i].entry;
             items[i]->hotkeys.clear();
             items[i]->add_hotkey(letter);
         }
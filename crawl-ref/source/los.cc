@@ -46,6 +46,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <typeinfo>
+#ifdef LOS_BITSET
+# include <cstdint>
+# ifdef __AVX2__
+#  include <immintrin.h>
+# endif
+#endif
 
 #include "areas.h"
 #include "coord.h"
@@ -89,6 +96,25 @@ static FixedArray<vector<cellray>, LOS_MAX_RANGE+1, LOS_MAX_RANGE+1> min_cellray
 static bit_vector *dead_rays     = nullptr;
 static bit_vector *smoke_rays    = nullptr;
 
+#ifdef LOS_BITSET
+// Packed alternative to the above, selected at build time: blockrays
+// for every quadrant cell stored back to back as 64-bit words, so a
+// whole quadrant is resolved with word-wide ORs over contiguous memory.
+// The word count is padded to a multiple of four so the AVX2 path can
+// always work on full 256-bit lanes.
+typedef uint64_t losword_t;
+static const int LOSWORD_BITS = 64;
+static int n_ray_words = 0;
+static vector<losword_t> packed_blockrays;
+static vector<losword_t> packed_dead_rays;
+static vector<losword_t> packed_smoke_rays;
+
+static inline const losword_t* _packed_blockrays(const coord_def& p)
+{
+    return &packed_blockrays[(p.x * (LOS_MAX_RANGE + 1) + p.y) * n_ray_words];
+}
+#endif
+
 class quadrant_iterator : public rectangle_iterator
 {
 public:
@@ -425,6 +451,23 @@ static void _create_blockrays()
     dead_rays  = new bit_vector(n_min_rays);
     smoke_rays = new bit_vector(n_min_rays);
 
+#ifdef LOS_BITSET
+    n_ray_words = (n_min_rays + LOSWORD_BITS - 1) / LOSWORD_BITS;
+    n_ray_words = (n_ray_words + 3) & ~3;
+    packed_blockrays.assign((LOS_MAX_RANGE + 1) * (LOS_MAX_RANGE + 1)
+                            * n_ray_words, 0);
+    for (quadrant_iterator qi; qi; ++qi)
+    {
+        losword_t *words = const_cast<losword_t*>(_packed_blockrays(*qi));
+        for (int i = 0; i < n_min_rays; ++i)
+            if (blockrays(*qi)->get(i))
+                words[i / LOSWORD_BITS] |= losword_t(1) << (i % LOSWORD_BITS);
+    }
+    // Padding rays past the end are permanently dead.
+    packed_dead_rays.assign(n_ray_words, 0);
+    packed_smoke_rays.assign(n_ray_words, 0);
+#endif
+
     dprf("Cellrays: %d Fullrays: %u Minimal cellrays: %u",
           n_cellrays, (unsigned int)fullrays.size(), n_min_rays);
 }
@@ -538,8 +581,9 @@ void cellray::calc_params()
 // Find ray in positive quadrant.
 // opc has been translated for this quadrant.
 // XXX: Allow finding ray of minimum opacity.
+template<class OPC>
 static bool _find_ray_se(const coord_def& target, ray_def& ray,
-                  const opacity_func& opc, int range, bool cycle)
+                  const OPC& opc, int range, bool cycle)
 {
     ASSERT(target.x >= 0);
     ASSERT(target.y >= 0);
@@ -552,9 +596,9 @@ static bool _find_ray_se(const coord_def& target, ray_def& ray,
     // Ensure the precalculations have been done.
     raycast();
 
+    // These are sorted best first, see _is_better.
     const vector<cellray> &min = min_cellrays(target);
     ASSERT(!min.empty());
-    cellray c = min[0]; // XXX: const cellray &c ?
     unsigned int index = 0;
 
     if (cycle)
@@ -568,36 +612,38 @@ static bool _find_ray_se(const coord_def& target, ray_def& ray,
          (blocked >= OPC_OPAQUE) && (i < start + min.size()); i++)
     {
         index = i % min.size();
-        c = min[index];
+        const cellray &c = min[index];
+        const coord_def *cells = &ray_coords[c.ray.start];
         blocked = OPC_CLEAR;
         // Check all inner points.
         for (unsigned int j = 0; j < c.end && blocked < OPC_OPAQUE; j++)
-            blocked += opc(c[j]);
+            blocked += opc(cells[j]);
     }
     if (blocked >= OPC_OPAQUE)
         return false;
 
-    ray = c.ray;
+    ray = min[index].ray;
     ray.cycle_idx = index;
 
     return true;
 }
 
 // Coordinate transformation so we can find_ray quadrant-by-quadrant.
-struct opacity_trans : public opacity_func
+// OPC is the concrete opacity type when the caller knows it, so that
+// the per-cell call can be inlined.
+template<class OPC>
+struct opacity_trans
 {
     const coord_def& source;
     int signx, signy;
-    const opacity_func& orig;
+    const OPC& orig;
 
-    opacity_trans(const opacity_func& opc, const coord_def& s, int sx, int sy)
+    opacity_trans(const OPC& opc, const coord_def& s, int sx, int sy)
         : source(s), signx(sx), signy(sy), orig(opc)
     {
     }
 
-    CLONE(opacity_trans)
-
-    opacity_type operator()(const coord_def &l) const override
+    opacity_type operator()(const coord_def &l) const
     {
         return orig(transform(l));
     }
@@ -608,26 +654,17 @@ struct opacity_trans : public opacity_func
     }
 };
 
-// Find a nonblocked ray from source to target. Return false if no
-// such ray could be found, otherwise return true and fill ray
-// appropriately.
-// if range is too great or all rays are blocked.
-// If cycle is false, find the first fitting ray. If it is true,
-// assume that ray is appropriately filled in, and look for the next
-// ray. We only ever use ray.cycle_idx.
-bool find_ray(const coord_def& source, const coord_def& target,
-              ray_def& ray, const opacity_func& opc, int range,
-              bool cycle)
+template<class OPC>
+static bool _find_ray(const coord_def& source, const coord_def& target,
+                      ray_def& ray, const OPC& opc, int range, bool cycle)
 {
-    if (target == source || !map_bounds(source) || !map_bounds(target))
-        return false;
 
     const int signx = ((target.x - source.x >= 0) ? 1 : -1);
     const int signy = ((target.y - source.y >= 0) ? 1 : -1);
     const int absx  = signx * (target.x - source.x);
     const int absy  = signy * (target.y - source.y);
     const coord_def abs = coord_def(absx, absy);
-    opacity_trans opc_trans = opacity_trans(opc, source, signx, signy);
+    opacity_trans<OPC> opc_trans(opc, source, signx, signy);
 
     if (!_find_ray_se(abs, ray, opc_trans, range, cycle))
         return false;
@@ -645,6 +682,50 @@ bool find_ray(const coord_def& source, const coord_def& target,
     return true;
 }
 
+// Find a nonblocked ray from source to target. Return false if no
+// such ray could be found, otherwise return true and fill ray
+// appropriately.
+// if range is too great or all rays are blocked.
+// If cycle is false, find the first fitting ray. If it is true,
+// assume that ray is appropriately filled in, and look for the next
+// ray. We only ever use ray.cycle_idx.
+bool find_ray(const coord_def& source, const coord_def& target,
+              ray_def& ray, const opacity_func& opc, int range,
+              bool cycle)
+{
+    if (target == source || !map_bounds(source) || !map_bounds(target))
+        return false;
+
+    // The common opacities are final, so calling them through their own
+    // type avoids a virtual call per cell of every candidate ray.
+    const type_info &type = typeid(opc);
+    if (type == typeid(opacity_default))
+    {
+        return _find_ray(source, target, ray,
+                         static_cast<const opacity_default&>(opc),
+                         range, cycle);
+    }
+    if (type == typeid(opacity_no_trans))
+    {
+        return _find_ray(source, target, ray,
+                         static_cast<const opacity_no_trans&>(opc),
+                         range, cycle);
+    }
+    if (type == typeid(opacity_fullyopaque))
+    {
+        return _find_ray(source, target, ray,
+                         static_cast<const opacity_fullyopaque&>(opc),
+                         range, cycle);
+    }
+    if (type == typeid(opacity_solid_see))
+    {
+        return _find_ray(source, target, ray,
+                         static_cast<const opacity_solid_see&>(opc),
+                         range, cycle);
+    }
+    return _find_ray(source, target, ray, opc, range, cycle);
+}
+
 bool exists_ray(const coord_def& source, const coord_def& target,
                 const opacity_func& opc, int range)
 {
@@ -785,7 +866,95 @@ bool cell_see_cell_nocache(const coord_def& p1, const coord_def& p2)
 // Smoke will now only block LOS after two cells of smoke. This is
 // done by updating with a second array.
 
-static void _losight_quadrant(los_grid& sh, const los_param& dat, int sx, int sy)
+#ifdef LOS_BITSET
+// dst |= src over n_ray_words words.
+static inline void _los_or(losword_t* dst, const losword_t* src)
+{
+#ifdef __AVX2__
+    for (int i = 0; i < n_ray_words; i += 4)
+    {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i m = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(d, m));
+    }
+#else
+    for (int i = 0; i < n_ray_words; ++i)
+        dst[i] |= src[i];
+#endif
+}
+
+// dead |= smoke & src; smoke |= src.
+static inline void _los_smoke(losword_t* dead, losword_t* smoke,
+                              const losword_t* src)
+{
+#ifdef __AVX2__
+    for (int i = 0; i < n_ray_words; i += 4)
+    {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dead + i));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(smoke + i));
+        __m256i m = _mm256_loadu_si256((const __m256i*)(src + i));
+        d = _mm256_or_si256(d, _mm256_and_si256(s, m));
+        _mm256_storeu_si256((__m256i*)(dead + i), d);
+        _mm256_storeu_si256((__m256i*)(smoke + i), _mm256_or_si256(s, m));
+    }
+#else
+    for (int i = 0; i < n_ray_words; ++i)
+    {
+        dead[i]  |= smoke[i] & src[i];
+        smoke[i] |= src[i];
+    }
+#endif
+}
+
+template<class PARAM>
+static void _losight_quadrant(los_grid& sh, const PARAM& dat, int sx, int sy)
+{
+    const int num_cellrays = cellray_ends.size();
+    losword_t *dead  = &packed_dead_rays[0];
+    losword_t *smoke = &packed_smoke_rays[0];
+
+    memset(dead, 0, n_ray_words * sizeof(losword_t));
+    memset(smoke, 0, n_ray_words * sizeof(losword_t));
+
+    for (quadrant_iterator qi; qi; ++qi)
+    {
+        coord_def p = coord_def(sx*(qi->x), sy*(qi->y));
+        if (!dat.los_bounds(p))
+            continue;
+
+        switch (dat.opacity(p))
+        {
+        case OPC_OPAQUE:
+            _los_or(dead, _packed_blockrays(*qi));
+            break;
+        case OPC_HALF:
+            _los_smoke(dead, smoke, _packed_blockrays(*qi));
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Only visit the rays that are still alive, a word at a time.
+    for (int w = 0; w * LOSWORD_BITS < num_cellrays; ++w)
+    {
+        losword_t alive = ~dead[w];
+        while (alive)
+        {
+            const int rayidx = w * LOSWORD_BITS + __builtin_ctzll(alive);
+            alive &= alive - 1;
+            if (rayidx >= num_cellrays)
+                break;
+            const coord_def p = coord_def(sx * cellray_ends[rayidx].x,
+                                          sy * cellray_ends[rayidx].y);
+            if (dat.los_bounds(p))
+                sh(p) = true;
+        }
+    }
+}
+#else
+template<class PARAM>
+static void _losight_quadrant(los_grid& sh, const PARAM& dat, int sx, int sy)
 {
     const unsigned int num_cellrays = cellray_ends.size();
 
@@ -829,15 +998,16 @@ static void _losight_quadrant(los_grid& sh, const los_param& dat, int sx, int sy
         }
     }
 }
+#endif
 
-struct los_param_funcs : public los_param
+template<class OPC>
+struct los_param_funcs final : public los_param
 {
     coord_def center;
-    const opacity_func& opc;
+    const OPC& opc;
     const circle_def& bounds;
 
-    los_param_funcs(const coord_def& c,
-                    const opacity_func& o, const circle_def& b)
+    los_param_funcs(const coord_def& c, const OPC& o, const circle_def& b)
         : center(c), opc(o), bounds(b)
     {
     }
@@ -853,10 +1023,11 @@ struct los_param_funcs : public los_param
     }
 };
 
-void losight(los_grid& sh, const coord_def& center,
-             const opacity_func& opc, const circle_def& bounds)
+template<class OPC>
+static void _losight(los_grid& sh, const coord_def& center,
+                     const OPC& opc, const circle_def& bounds)
 {
-    const los_param& dat = los_param_funcs(center, opc, bounds);
+    const los_param_funcs<OPC> dat(center, opc, bounds);
 
     sh.init(false);
 
@@ -873,6 +1044,32 @@ void losight(los_grid& sh, const coord_def& center,
     sh(o) = true;
 }
 
+void losight(los_grid& sh, const coord_def& center,
+             const opacity_func& opc, const circle_def& bounds)
+{
+    // As in find_ray, dispatch the common opacities by their own type.
+    const type_info &type = typeid(opc);
+    if (type == typeid(opacity_default))
+        _losight(sh, center, static_cast<const opacity_default&>(opc), bounds);
+    else if (type == typeid(opacity_no_trans))
+    {
+        _losight(sh, center, static_cast<const opacity_no_trans&>(opc),
+                 bounds);
+    }
+    else if (type == typeid(opacity_fullyopaque))
+    {
+        _losight(sh, center, static_cast<const opacity_fullyopaque&>(opc),
+                 bounds);
+    }
+    else if (type == typeid(opacity_solid_see))
+    {
+        _losight(sh, center, static_cast<const opacity_solid_see&>(opc),
+                 bounds);
+    }
+    else
+        _losight(sh, center, opc, bounds);
+}
+
 opacity_type mons_opacity(const monster* mon, los_type how)
 {
     // no regard for LOS_ARENA
@@ -17,6 +17,29 @@ typedef halflos_t globallos_t[GXM][GYM];
 
 static globallos_t globallos;
 
+// Each half-table is stamped with the generation it was last cleared in.
+// A table whose stamp doesn't match the current generation is dirty: its
+// contents are stale and it gets wiped the next time anything looks at it.
+// This makes invalidating the whole level O(1), and invalidating around a
+// cell only touches the owners within range of it, rather than memsetting
+// every affected table up front.
+typedef uint32_t losgen_t;
+static losgen_t globallos_gen[GXM][GYM];
+static losgen_t cur_los_gen = 1;
+
+static los_cache_stats los_stats;
+
+static halflos_t& _globallos_table(int x, int y)
+{
+    if (globallos_gen[x][y] != cur_los_gen)
+    {
+        memset(globallos[x][y], 0, sizeof(halflos_t));
+        globallos_gen[x][y] = cur_los_gen;
+        los_stats.tables_cleared++;
+    }
+    return globallos[x][y];
+}
+
 static losfield_t* _lookup_globallos(const coord_def& p, const coord_def& q)
 {
     COMPILE_CHECK(LOS_KNOWN * 2 <= sizeof(losfield_t) * 8);
@@ -28,9 +51,15 @@ static losfield_t* _lookup_globallos(const coord_def& p, const coord_def& q)
         return nullptr;
     // p < q iff p.x < q.x || p.x == q.x && p.y < q.y
     if (diff < coord_def(0, 0))
-        return &globallos[q.x][q.y][-diff.x + o_half_x][-diff.y + o_half_y];
+    {
+        halflos_t &table = _globallos_table(q.x, q.y);
+        return &table[-diff.x + o_half_x][-diff.y + o_half_y];
+    }
     else
-        return &globallos[p.x][p.y][ diff.x + o_half_x][ diff.y + o_half_y];
+    {
+        halflos_t &table = _globallos_table(p.x, p.y);
+        return &table[ diff.x + o_half_x][ diff.y + o_half_y];
+    }
 }
 
 static void _save_los(los_def* los, los_type l)
@@ -68,13 +97,29 @@ void invalidate_los_around(const coord_def& p)
     for (int y = y1; y <= y2; y++)
         for (int x = x1; x <= x2; x++)
             if (max(abs(p.x - x), abs(p.y - y)) <= LOS_MAX_RANGE)
-                memset(globallos[x][y], 0, sizeof(halflos_t));
+                globallos_gen[x][y] = 0; // never a current generation
+    los_stats.local_invalidations++;
 }
 
 void invalidate_los()
 {
-    for (rectangle_iterator ri(0); ri; ++ri)
-        memset(globallos[ri->x][ri->y], 0, sizeof(halflos_t));
+    if (++cur_los_gen == 0)
+    {
+        // Wrapped around; make sure no stale stamp can match again.
+        memset(globallos_gen, 0, sizeof(globallos_gen));
+        cur_los_gen = 1;
+    }
+    los_stats.full_invalidations++;
+}
+
+const los_cache_stats& get_los_cache_stats()
+{
+    return los_stats;
+}
+
+void reset_los_cache_stats()
+{
+    los_stats = los_cache_stats();
 }
 
 static void _update_globallos_at(const coord_def& p, los_type l)
@@ -124,8 +169,13 @@ bool cell_see_cell(const coord_def& p, const coord_def& q, los_type l)
     if (!flags)
         return false; // outside range
 
-    if (!(*flags & (l << LOS_KNOWN)))
+    if (*flags & (l << LOS_KNOWN))
+        los_stats.hits++;
+    else
+    {
+        los_stats.misses++;
         _update_globallos_at(p, l);
+    }
 
     //if (!(*flags & (l << LOS_KNOWN)))
     //    die("cell_see_cell %d,%d %d,%d", p.x,p.y,q.x,q.y);
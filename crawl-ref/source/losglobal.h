@@ -1,9 +1,27 @@
 #ifndef LOSGLOBAL_H
 #define LOSGLOBAL_H
 
+struct los_cache_stats
+{
+    uint64_t hits;                // cell_see_cell answered from the cache
+    uint64_t misses;              // ... that needed a field recomputed
+    uint64_t tables_cleared;      // dirty half-tables lazily wiped
+    uint64_t local_invalidations; // invalidate_los_around() calls
+    uint64_t full_invalidations;  // invalidate_los() calls
+
+    los_cache_stats()
+        : hits(0), misses(0), tables_cleared(0), local_invalidations(0),
+          full_invalidations(0)
+    {
+    }
+};
+
 void invalidate_los_around(const coord_def& p);
 void invalidate_los();
 
+const los_cache_stats& get_los_cache_stats();
+void reset_los_cache_stats();
+
 bool cell_see_cell(const coord_def& p, const coord_def& q, los_type l);
 
 #endif
@@ -32,7 +32,7 @@ public:
     }
 
 // Default LOS rules.
-class opacity_default : public opacity_func
+class opacity_default final : public opacity_func
 {
 public:
     CLONE(opacity_default)
@@ -43,7 +43,7 @@ extern const opacity_default opc_default;
 
 // Default LOS rules, but only consider fully opaque features blocking.
 // In particular, clouds don't affect the result.
-class opacity_fullyopaque : public opacity_func
+class opacity_fullyopaque final : public opacity_func
 {
 public:
     CLONE(opacity_fullyopaque)
@@ -55,7 +55,7 @@ extern const opacity_fullyopaque opc_fullyopaque;
 // Make transparent features block in addition to normal LOS.
 // * Translocations opacity: blink, apportation, portal projectile.
 // * Various "I feel safe"-related stuff.
-class opacity_no_trans : public opacity_func
+class opacity_no_trans final : public opacity_func
 {
 public:
     CLONE(opacity_no_trans)
@@ -86,7 +86,7 @@ public:
 extern const opacity_solid opc_solid;
 
 // Both line of sight and line of effect.
-class opacity_solid_see : public opacity_func
+class opacity_solid_see final : public opacity_func
 {
 public:
     CLONE(opacity_solid_see)
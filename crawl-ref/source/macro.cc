@@ -23,6 +23,7 @@
 #include "macro.h"
 
 #include <cctype>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <deque>
@@ -32,6 +33,7 @@
 #include <vector>
 
 #include "cio.h"
+#include "end.h"
 #include "files.h"
 #include "initfile.h"
 #include "libutil.h"
@@ -39,6 +41,8 @@
 #include "misc.h" // erase_val
 #include "options.h"
 #include "output.h"
+#include "player.h"
+#include "random.h"
 #include "state.h"
 #include "state.h"
 #include "stringutil.h"
@@ -1223,6 +1227,129 @@ int get_macro_buf_size()
     return Buffer.size();
 }
 
+///////////////////////////////////////////////////////////////
+// Key logs: recording the keys read from the frontend, and replaying them
+// to benchmark a whole game.
+//
+// The log is a short header followed by one key code per line. Only keys
+// that come from the keyboard (or webtiles client) are logged; keys sent by
+// Lua or macros are regenerated on replay from the same rc file.
+
+static FILE *keylog_out = nullptr;
+
+static struct
+{
+    string file;
+    deque<int> keys;
+    int replayed = 0;
+    bool started = false;
+    chrono::steady_clock::time_point start;
+    int start_turns = 0;
+    int start_time = 0;
+} keylog_replay;
+
+static bool keylog_replaying = false;
+
+void keylog_start_recording(const string &file)
+{
+    keylog_out = fopen_u(file.c_str(), "w");
+    if (!keylog_out)
+        end(1, true, "Can't write key log %s", file.c_str());
+
+    // A replay is only deterministic from a fixed seed.
+    if (!Options.seed)
+        Options.seed = get_uint32();
+
+    fprintf(keylog_out, "# %s key log\n", Version::Long);
+    fprintf(keylog_out, "seed %x\n", (unsigned int)Options.seed);
+    fprintf(keylog_out, "args %s\n",
+            comma_separated_line(SysEnv.cmd_args.begin(),
+                                 SysEnv.cmd_args.end(), " ", " ").c_str());
+    fprintf(keylog_out, "keys\n");
+    fflush(keylog_out);
+}
+
+void keylog_start_replay(const string &file)
+{
+    FILE *f = fopen_u(file.c_str(), "r");
+    if (!f)
+        end(1, true, "Can't read key log %s", file.c_str());
+
+    char line[1024];
+    bool in_keys = false;
+    while (fgets(line, sizeof line, f))
+    {
+        if (in_keys)
+            keylog_replay.keys.push_back(atoi(line));
+        else if (!strncmp(line, "seed ", 5))
+        {
+            unsigned int seed = 0;
+            sscanf(line + 5, "%x", &seed);
+            Options.seed = seed;
+        }
+        else if (!strcmp(line, "keys\n"))
+            in_keys = true;
+    }
+    fclose(f);
+
+    if (!in_keys)
+        end(1, false, "%s is not a key log", file.c_str());
+
+    keylog_replay.file = file;
+    keylog_replaying = true;
+    crawl_state.disables.set(DIS_DELAY);
+}
+
+int keylog_record(int key)
+{
+    if (keylog_out)
+    {
+        fprintf(keylog_out, "%d\n", key);
+        fflush(keylog_out);
+    }
+    return key;
+}
+
+static NORETURN void _keylog_finish_replay()
+{
+    const double ms = chrono::duration<double, milli>(
+        chrono::steady_clock::now() - keylog_replay.start).count();
+    const int turns = you.num_turns - keylog_replay.start_turns;
+    const int aut = you.elapsed_time - keylog_replay.start_time;
+    end(0, false, "Replayed %d keys from %s: %d turns (%d aut) in %.0f ms, "
+                  "%.3f ms/turn",
+        keylog_replay.replayed, keylog_replay.file.c_str(), turns, aut, ms,
+        turns ? ms / turns : 0.0);
+}
+
+bool keylog_replay_key(int &key)
+{
+    if (!keylog_replaying)
+        return false;
+
+    // Time from the first key the game asks for, not from startup.
+    if (!keylog_replay.started)
+    {
+        keylog_replay.started = true;
+        keylog_replay.start = chrono::steady_clock::now();
+        keylog_replay.start_turns = you.num_turns;
+        keylog_replay.start_time = you.elapsed_time;
+    }
+
+    if (keylog_replay.keys.empty())
+        _keylog_finish_replay();
+
+    key = keylog_replay.keys.front();
+    keylog_replay.keys.pop_front();
+    keylog_replay.replayed++;
+    return true;
+}
+
+bool keylog_is_replaying()
+{
+    return keylog_replaying;
+}
+
 ///////////////////////////////////////////////////////////////
 // Keybinding stuff
 
@@ -81,6 +81,13 @@ bool has_pending_input();
 
 int get_macro_buf_size();
 
+void keylog_start_recording(const string &file);
+void keylog_start_replay(const string &file);
+// Called by the frontends on every key they read.
+int keylog_record(int key);
+bool keylog_replay_key(int &key);
+bool keylog_is_replaying();
+
 ///////////////////////////////////////////////////////////////
 // Keybinding stuff
 
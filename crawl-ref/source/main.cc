@@ -90,6 +90,7 @@
 #include "items.h"
 #include "item_use.h"
 #include "jobs.h"
+#include "l_libs.h"
 #include "libutil.h"
 #include "luaterp.h"
 #include "lookup_help.h"
@@ -528,15 +529,34 @@ static void _show_commandline_options_help()
     puts("  -tscores [N]           terse highscore list");
     puts("  -vscores [N]           verbose highscore list");
     puts("  -scorefile <filename>  scorefile to report on");
+    puts("");
+    puts("Benchmarking options:");
+    puts("  -record-keys <file>    log the seed and every key read to <file>");
+    puts("  -replay-bench <file>   replay a key log without delays and report");
+    puts("                         the time per turn when it runs out");
+#ifdef DEBUG_PROFILE
+    puts("  -profile-out <file>    on exit, write the turn profile to <file>");
+    puts("                         (JSON if it ends in .json, else CSV)");
+#endif
     puts("");
     puts("Arena options: (Stage a tournament between various monsters.)");
     puts("  -arena \"<monster list> v <monster list> arena:<arena map>\"");
+    puts("  -arena-batch <file>    run each arena spec in <file> (one per line)");
+    puts("                         without display, writing arena-batch.csv");
+#ifndef TARGET_OS_WINDOWS
+    puts("  -jobs <num>            split -arena-batch rounds over <num> "
+         "worker processes");
+#endif
 #ifdef DEBUG_DIAGNOSTICS
     puts("");
     puts("Diagnostic options:");
     puts("  -test               run all test cases in test/ except test/big/");
     puts("  -test foo,bar       run only tests \"foo\" and \"bar\"");
     puts("  -test list          list available tests");
+#ifndef TARGET_OS_WINDOWS
+    puts("  -jobs <num>         For -test, split the Lua tests over <num> "
+         "worker processes");
+#endif
     puts("  -script <name>      run script matching <name> in ./scripts");
 #endif
 #ifdef DEBUG_STATISTICS
@@ -551,8 +571,17 @@ static void _show_commandline_options_help()
     puts("  -objstat [<levels>] run monster and item stats on the given range "
          "of levels");
     puts("      Defaults to entire dungeon; same level syntax as -mapstat.");
-    puts("  -iters <num>        For -mapstat and -objstat, set the number of "
-         "iterations");
+    puts("  -bench [<levels>]   time core kernels, writing bench.json; builds "
+         "the first");
+    puts("      of the given levels in each branch (same syntax as -mapstat)");
+    puts("  -iters <num>        For -mapstat, -objstat and -bench, set the "
+         "number of");
+    puts("                      iterations");
+#ifndef TARGET_OS_WINDOWS
+    puts("  -jobs <num>         For -mapstat and -objstat, split the "
+         "iterations over");
+    puts("                      <num> worker processes");
+#endif
 #endif
     puts("");
     puts("Miscellaneous options:");
@@ -854,7 +883,11 @@ static void _do_wizard_command(int wiz_command)
 
     case 'y': wizard_identify_all_items(); break;
     case 'Y': wizard_unidentify_all_items(); break;
+#ifdef DEBUG_PROFILE
+    case CONTROL('Y'): wizard_show_profile(); break;
+#else
     // case CONTROL('Y'): break;
+#endif
 
     case 'z': wizard_cast_spec_spell(); break;
     // case 'Z': break;
@@ -1991,6 +2024,7 @@ static void _do_list_gold()
 void process_command(command_type cmd)
 {
     you.apply_berserk_penalty = true;
+    clear_moninf_cache();
     switch (cmd)
     {
 #ifdef USE_TILE
@@ -2388,14 +2422,18 @@ static void _check_banished()
 
 static void _check_shafts()
 {
-    for (auto& entry : env.trap)
-    {
-        if (entry.second.type != TRAP_SHAFT)
-            continue;
+    // In order of position, as items falling may roll dice.
+    vector<coord_def> shafts;
+    for (const trap_def& trap : env.trap)
+        if (trap.type == TRAP_SHAFT)
+            shafts.push_back(trap.pos);
+    sort(shafts.begin(), shafts.end());
 
-        ASSERT_IN_BOUNDS(entry.first);
+    for (const coord_def &pos : shafts)
+    {
+        ASSERT_IN_BOUNDS(pos);
 
-        handle_items_on_shaft(entry.first, true);
+        handle_items_on_shaft(pos, true);
     }
 }
 
@@ -2479,6 +2517,8 @@ static void _update_golubria_traps()
 
 void world_reacts()
 {
+    PROFILE_SECTION(PROF_WORLD_REACTS);
+
     // All markers should be activated at this point.
     ASSERT(!env.markers.need_activate());
 
@@ -2523,7 +2563,10 @@ void world_reacts()
 
     abyss_morph();
     apply_noises();
-    handle_monsters(true);
+    {
+        PROFILE_SECTION(PROF_MONSTERS);
+        handle_monsters(true);
+    }
 
     _check_banished();
 
@@ -2548,8 +2591,14 @@ void world_reacts()
         ouch(INSTANT_DEATH, KILLED_BY_QUITTING);
     }
 
-    handle_time();
-    manage_clouds();
+    {
+        PROFILE_SECTION(PROF_TIME);
+        handle_time();
+    }
+    {
+        PROFILE_SECTION(PROF_CLOUDS);
+        manage_clouds();
+    }
     if (env.level_state & LSTATE_GLOW_MOLD)
         _update_mold();
     if (env.level_state & LSTATE_GOLUBRIA)
@@ -2590,6 +2639,10 @@ void world_reacts()
             save_game(false);
         }
     }
+
+#ifdef DEBUG_PROFILE
+    profile_turn_end();
+#endif
 }
 
 static command_type _get_next_cmd()
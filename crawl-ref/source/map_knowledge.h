@@ -83,7 +83,7 @@ struct map_cell
     {
         if (_cloud)
             delete _cloud;
-        if (!(flags & MAP_DETECTED_MONSTER) && _mons)
+        if (_mons)
             delete _mons;
         if (_item)
             delete _item;
@@ -200,6 +200,13 @@ struct map_cell
         _mons = new monster_info(mi);
     }
 
+    // Describe a visible monster here, building its info in place.
+    void set_monster(const ::monster* mons)
+    {
+        clear_monster();
+        _mons = new monster_info(mons);
+    }
+
     bool detected_monster() const
     {
         return !!(flags & MAP_DETECTED_MONSTER);
@@ -1494,6 +1494,21 @@ string map_lines::shuffle(string s)
     return result;
 }
 
+// Replace every glyph in the map through a 256-entry table, rather than
+// searching the glyph list for each square.
+void map_lines::translate_glyphs(const char (&table)[256])
+{
+    for (string &s : lines)
+        for (char &c : s)
+            c = table[static_cast<unsigned char>(c)];
+}
+
+static void _identity_glyph_table(char (&table)[256])
+{
+    for (int i = 0; i < 256; ++i)
+        table[i] = static_cast<char>(i);
+}
+
 void map_lines::resolve_shuffle(const string &shufflage)
 {
     string toshuffle = shufflage;
@@ -1502,28 +1517,21 @@ void map_lines::resolve_shuffle(const string &shufflage)
     if (toshuffle.empty() || shuffled.empty())
         return;
 
-    for (string &s : lines)
-    {
-        for (char &c : s)
-        {
-            string::size_type pos = toshuffle.find(c);
-            if (pos != string::npos)
-                c = shuffled[pos];
-        }
-    }
+    char table[256];
+    _identity_glyph_table(table);
+    // Backwards, so that the first occurrence of a repeated glyph wins.
+    for (int i = toshuffle.length() - 1; i >= 0; --i)
+        table[static_cast<unsigned char>(toshuffle[i])] = shuffled[i];
+    translate_glyphs(table);
 }
 
 void map_lines::clear(const string &clearchars)
 {
-    for (string &s : lines)
-    {
-        for (char &c : s)
-        {
-            string::size_type pos = clearchars.find(c);
-            if (pos != string::npos)
-                c = ' ';
-        }
-    }
+    char table[256];
+    _identity_glyph_table(table);
+    for (char c : clearchars)
+        table[static_cast<unsigned char>(c)] = ' ';
+    translate_glyphs(table);
 }
 
 void map_lines::normalise(char fillch)
@@ -1550,14 +1558,15 @@ void map_lines::rotate(bool clockwise)
               ye = clockwise? -1 : (int) lines.size(),
               yi = clockwise? -1 : 1;
 
+    newlines.reserve(map_width);
     for (int i = xs; i != xe; i += xi)
     {
-        string line;
+        newlines.emplace_back();
+        string &line = newlines.back();
+        line.reserve(lines.size());
 
         for (int j = ys; j != ye; j += yi)
             line += lines[j][i];
-
-        newlines.push_back(line);
     }
 
     if (overlay.get())
@@ -1570,7 +1579,7 @@ void map_lines::rotate(bool clockwise)
     }
 
     map_width = lines.size();
-    lines     = newlines;
+    lines.swap(newlines);
     rotate_markers(clockwise);
     solid_checked = false;
 }
@@ -1623,11 +1632,7 @@ void map_lines::vmirror()
     const int midpoint = vsize / 2;
 
     for (int i = 0; i < midpoint; ++i)
-    {
-        string temp = lines[i];
-        lines[i] = lines[vsize - 1 - i];
-        lines[vsize - 1 - i] = temp;
-    }
+        lines[i].swap(lines[vsize - 1 - i]);
 
     if (overlay.get())
     {
@@ -2145,6 +2150,17 @@ bool depth_ranges::is_usable_in(const level_id &lid) const
     return any_matched;
 }
 
+// The branch of every range that can allow a level, with NUM_BRANCHES for
+// ranges of absolute depth. No level outside these can be usable.
+vector<branch_type> depth_ranges::allowed_branches() const
+{
+    vector<branch_type> brs;
+    for (const level_range &lr : depths)
+        if (!lr.deny)
+            brs.push_back(lr.branch);
+    return brs;
+}
+
 void depth_ranges::add_depths(const depth_ranges &other_depths)
 {
     depths.insert(depths.end(),
@@ -2793,6 +2809,9 @@ string map_def::validate_map_def(const depth_ranges &default_depths)
     resolve();
     test_lua_validate(true);
     run_lua_epilogue(true);
+    // The veto isn't run here; compile it anyway so that the des cache
+    // holds only bytecode.
+    veto.compile(dlua);
 
     if (!has_depth() && !lc_default_depths.empty())
         depths.add_depths(lc_default_depths);
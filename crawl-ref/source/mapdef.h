@@ -446,6 +446,7 @@ private:
     void translate_marker(void (map_lines::*xform)(map_marker *, int par),
                           int par = 0);
 
+    void translate_glyphs(const char (&table)[256]);
     void resolve_shuffle(const string &shuffle);
     void clear(const string &clear);
     void subst(string &s, subst_spec &spec);
@@ -971,6 +972,7 @@ public:
     void clear() { depths.clear(); }
     bool empty() const { return depths.empty(); }
     bool is_usable_in(const level_id &lid) const;
+    vector<branch_type> allowed_branches() const;
     void add_depth(const level_range &range) { depths.push_back(range); }
     void add_depths(const depth_ranges &other_ranges);
     string describe() const;
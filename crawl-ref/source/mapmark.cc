@@ -10,7 +10,6 @@
 #include <algorithm>
 
 #include "cluautil.h"
-#include "coordit.h"
 #include "dlua.h"
 #include "end.h"
 #include "env.h"
@@ -1018,22 +1017,31 @@ void map_markers::activate_markers_at(coord_def p)
 void map_markers::add(map_marker *marker)
 {
     markers.insert(dgn_pos_marker(marker->pos, marker));
+    typed_markers[marker->get_type()].insert(
+        dgn_pos_marker(marker->pos, marker));
     have_inactive_markers = true;
 }
 
-void map_markers::unlink_marker(const map_marker *marker)
+static void _unlink_from(multimap<coord_def, map_marker *> &mmap,
+                         const map_marker *marker)
 {
-    auto els = markers.equal_range(marker->pos);
+    auto els = mmap.equal_range(marker->pos);
     for (auto i = els.first; i != els.second; ++i)
     {
         if (i->second == marker)
         {
-            markers.erase(i);
+            mmap.erase(i);
             break;
         }
     }
 }
 
+void map_markers::unlink_marker(const map_marker *marker)
+{
+    _unlink_from(markers, marker);
+    _unlink_from(typed_markers[marker->get_type()], marker);
+}
+
 void map_markers::check_empty()
 {
     if (markers.empty())
@@ -1054,10 +1062,12 @@ void map_markers::remove_markers_at(const coord_def &c,
     for (auto i = els.first; i != els.second;)
     {
         auto todel = i++;
-        if (type == MAT_ANY || todel->second->get_type() == type)
+        map_marker *marker = todel->second;
+        if (type == MAT_ANY || marker->get_type() == type)
         {
-            delete todel->second;
+            _unlink_from(typed_markers[marker->get_type()], marker);
             markers.erase(todel);
+            delete marker;
         }
     }
     check_empty();
@@ -1074,11 +1084,11 @@ map_marker *map_markers::find(const coord_def &c, map_marker_type type)
 
 map_marker *map_markers::find(map_marker_type type)
 {
-    for (const auto &entry : markers)
-        if (type == MAT_ANY || entry.second->get_type() == type)
-            return entry.second;
+    if (type == MAT_ANY)
+        return markers.empty() ? nullptr : markers.begin()->second;
 
-    return nullptr;
+    const dgn_marker_map &typed = typed_markers[type];
+    return typed.empty() ? nullptr : typed.begin()->second;
 }
 
 void map_markers::move(const coord_def &from, const coord_def &to)
@@ -1091,6 +1101,7 @@ void map_markers::move(const coord_def &from, const coord_def &to)
     {
         auto curr = i++;
         tmarkers.push_back(curr->second);
+        _unlink_from(typed_markers[curr->second->get_type()], curr->second);
         markers.erase(curr);
     }
 
@@ -1111,12 +1122,12 @@ void map_markers::move_marker(map_marker *marker, const coord_def &to)
 
 vector<map_marker*> map_markers::get_all(map_marker_type mat)
 {
+    const dgn_marker_map &mmap = mat == MAT_ANY ? markers
+                                                : typed_markers[mat];
     vector<map_marker*> rmarkers;
-    for (const auto &entry : markers)
-    {
-        if (mat == MAT_ANY || entry.second->get_type() == mat)
-            rmarkers.push_back(entry.second);
-    }
+    rmarkers.reserve(mmap.size());
+    for (const auto &entry : mmap)
+        rmarkers.push_back(entry.second);
     return rmarkers;
 }
 
@@ -1163,6 +1174,8 @@ void map_markers::clear()
     for (auto &entry : markers)
         delete entry.second;
     markers.clear();
+    for (dgn_marker_map &typed : typed_markers)
+        typed.clear();
     check_empty();
 }
 
@@ -1225,17 +1238,37 @@ coord_def find_marker_position_by_prop(const string &prop,
     return markers[0];
 }
 
+static bool _rectangle_order(const coord_def &a, const coord_def &b)
+{
+    return a.y < b.y || (a.y == b.y && a.x < b.x);
+}
+
+// The squares holding at least one marker, in the order a full-map
+// rectangle_iterator would visit them. Markers are few, so this is much
+// cheaper than looking up every square on the level.
+static vector<coord_def> _marker_squares()
+{
+    vector<coord_def> squares;
+    // get_all() returns markers sorted by position, so those on the same
+    // square are next to each other.
+    for (const map_marker *mark : env.markers.get_all())
+        if (squares.empty() || squares.back() != mark->pos)
+            squares.push_back(mark->pos);
+    sort(squares.begin(), squares.end(), _rectangle_order);
+    return squares;
+}
+
 vector<coord_def> find_marker_positions_by_prop(const string &prop,
                                                 const string &expected,
                                                 unsigned maxresults)
 {
     vector<coord_def> marker_positions;
-    for (rectangle_iterator i(0, 0); i; ++i)
+    for (const coord_def &i : _marker_squares())
     {
-        const string value = env.markers.property_at(*i, MAT_ANY, prop);
+        const string value = env.markers.property_at(i, MAT_ANY, prop);
         if (!value.empty() && (expected.empty() || value == expected))
         {
-            marker_positions.push_back(*i);
+            marker_positions.push_back(i);
             if (maxresults && marker_positions.size() >= maxresults)
                 return marker_positions;
         }
@@ -1248,9 +1281,9 @@ vector<map_marker*> find_markers_by_prop(const string &prop,
                                          unsigned maxresults)
 {
     vector<map_marker*> markers;
-    for (rectangle_iterator pos(0, 0); pos; ++pos)
+    for (const coord_def &pos : _marker_squares())
     {
-        for (map_marker *mark : env.markers.get_markers_at(*pos))
+        for (map_marker *mark : env.markers.get_markers_at(pos))
         {
             const string value(mark->property(prop));
             if (!value.empty() && (expected.empty() || value == expected))
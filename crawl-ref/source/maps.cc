@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <sys/param.h>
 #include <sys/types.h>
 #ifndef TARGET_COMPILER_VC
@@ -67,6 +68,93 @@ point_vector map_anchor_points;
 
 static map_vector vdefs;
 
+typedef vector<unsigned> vault_indices;
+
+// Indices into vdefs by what map selection filters on first, so that only
+// the maps that could possibly match need to be checked in full. Each list
+// is in vdefs order.
+struct vault_index
+{
+    vault_index() : built(false), place_in(), depth_in(), tagged() { }
+
+    bool built;
+    // Maps for which PLACE: or DEPTH: may allow some level of a branch;
+    // ranges of absolute depth are filed under NUM_BRANCHES.
+    FixedVector<vault_indices, NUM_BRANCHES + 1> place_in, depth_in;
+    map<string, vault_indices> tagged;
+};
+
+static vault_index vdef_index;
+
+static void _index_branches(const depth_ranges &ranges, unsigned map_idx,
+                            FixedVector<vault_indices, NUM_BRANCHES + 1> &lists)
+{
+    for (branch_type br : ranges.allowed_branches())
+    {
+        vault_indices &list = lists[br];
+        if (list.empty() || list.back() != map_idx)
+            list.push_back(map_idx);
+    }
+}
+
+static const vault_index &_vault_index()
+{
+    if (vdef_index.built)
+        return vdef_index;
+
+    vdef_index = vault_index();
+    for (unsigned i = 0, size = vdefs.size(); i < size; ++i)
+    {
+        const map_def &mapdef = vdefs[i];
+        _index_branches(mapdef.place, i, vdef_index.place_in);
+        _index_branches(mapdef.depths, i, vdef_index.depth_in);
+        for (const string &tag : mapdef.get_tags())
+        {
+            vault_indices &list = vdef_index.tagged[tag];
+            if (list.empty() || list.back() != i)
+                list.push_back(i);
+        }
+    }
+    vdef_index.built = true;
+    return vdef_index;
+}
+
+// Call whenever vdefs, or the places, depths or tags of its maps, change.
+static void _forget_vault_index()
+{
+    vdef_index.built = false;
+}
+
+// The maps that could be in the given branch by the given lists.
+static vault_indices _indexed_for_branch(
+    const FixedVector<vault_indices, NUM_BRANCHES + 1> &lists,
+    branch_type branch)
+{
+    const vault_indices &anywhere = lists[NUM_BRANCHES];
+    if (branch < 0 || branch >= NUM_BRANCHES)
+        return anywhere;
+
+    const vault_indices &in_branch = lists[branch];
+    vault_indices merged;
+    merged.reserve(in_branch.size() + anywhere.size());
+    set_union(in_branch.begin(), in_branch.end(),
+              anywhere.begin(), anywhere.end(), back_inserter(merged));
+    return merged;
+}
+
+// The maps that might have all of the space-separated tags in tag.
+static const vault_indices &_indexed_for_tag(const string &tag)
+{
+    static const vault_indices none;
+    const vector<string> tags = split_string(" ", tag);
+    if (tags.empty())
+        return none;
+
+    const vault_index &index = _vault_index();
+    auto list = index.tagged.find(tags[0]);
+    return list == index.tagged.end() ? none : list->second;
+}
+
 // Parameter array that vault code can use.
 string_vector map_parameters;
 
@@ -397,6 +485,71 @@ static bool _is_portal_place(const coord_def &c)
     return marker->property("portal") != "";
 }
 
+// The tags of a map that decide which cells it may be placed over.
+struct vault_place_rules
+{
+    bool water_ok;
+    bool overwrite_vaults;
+    bool replace_portals;
+
+    explicit vault_place_rules(const map_def &map)
+        : water_ok(map.has_tag("water_ok") || player_in_branch(BRANCH_SWAMP)),
+          overwrite_vaults(map.has_tag("overwrite_floor_cell")),
+          replace_portals(map.has_tag("replace_portal"))
+    {
+    }
+};
+
+// Whether a non-blank cell of a map may go at cp.
+static bool _map_safe_vault_cell(const vault_place_rules &rules,
+                                 const coord_def &cp)
+{
+    // Unconditionally allow portal placements to work.
+    if (rules.replace_portals && _is_portal_place(cp))
+        return true;
+
+    if (!rules.overwrite_vaults)
+    {
+        // Also check adjacent squares for collisions, because being next
+        // to another vault may block off one of this vault's exits.
+        for (adjacent_iterator ai(cp); ai; ++ai)
+        {
+            if (map_bounds(*ai) && (env.level_map_mask(*ai) & MMT_VAULT))
+                return false;
+        }
+    }
+    else if (grd(cp) != DNGN_FLOOR || env.pgrid(cp) & FPROP_NO_TELE_INTO)
+    {
+        // Don't place overwrite_floor_cell vaults on anything but floor or
+        // on squares that can't be teleported into, because
+        // overwrite_floor_cell is used for things that are expected to be
+        // connected.
+        return false;
+    }
+
+    // Don't overwrite features other than floor, rock wall, doors,
+    // nor water, if !water_ok.
+    if (!_may_overwrite_feature(cp, rules.water_ok))
+        return false;
+
+    // Don't overwrite monsters or items, either!
+    if (monster_at(cp) || igrd(cp) != NON_ITEM)
+        return false;
+
+    // If in Slime, don't let stairs end up next to minivaults,
+    // so that they don't possibly end up next to unsafe walls.
+    if (player_in_branch(BRANCH_SLIME))
+    {
+        for (adjacent_iterator ai(cp); ai; ++ai)
+        {
+            if (map_bounds(*ai) && feat_is_stair(grd(*ai)))
+                return false;
+        }
+    }
+
+    return true;
+}
+
 static bool _map_safe_vault_place(const map_def &map,
                                   const coord_def &c,
                                   const coord_def &size)
@@ -408,15 +561,7 @@ static bool _map_safe_vault_place(const map_def &map,
     if (map.is_overwritable_layout())
         return true;
 
-    const bool water_ok =
-        map.has_tag("water_ok") || player_in_branch(BRANCH_SWAMP);
-
-    const bool vault_can_overwrite_other_vaults =
-        map.has_tag("overwrite_floor_cell");
-
-    const bool vault_can_replace_portals =
-        map.has_tag("replace_portal");
-
+    const vault_place_rules rules(map);
     const vector<string> &lines = map.map.get_lines();
     for (rectangle_iterator ri(c, c + size - 1); ri; ++ri)
     {
@@ -426,53 +571,21 @@ static bool _map_safe_vault_place(const map_def &map,
         if (lines[dp.y][dp.x] == ' ')
             continue;
 
-        // Unconditionally allow portal placements to work.
-        if (vault_can_replace_portals && _is_portal_place(cp))
-            continue;
-
-        if (!vault_can_overwrite_other_vaults)
-        {
-            // Also check adjacent squares for collisions, because being next
-            // to another vault may block off one of this vault's exits.
-            for (adjacent_iterator ai(cp); ai; ++ai)
-            {
-                if (map_bounds(*ai) && (env.level_map_mask(*ai) & MMT_VAULT))
-                    return false;
-            }
-        }
-        else if (grd(cp) != DNGN_FLOOR || env.pgrid(cp) & FPROP_NO_TELE_INTO)
-        {
-            // Don't place overwrite_floor_cell vaults on anything but floor or
-            // on squares that can't be teleported into, because
-            // overwrite_floor_cell is used for things that are expected to be
-            // connected.
-            return false;
-        }
-
-        // Don't overwrite features other than floor, rock wall, doors,
-        // nor water, if !water_ok.
-        if (!_may_overwrite_feature(cp, water_ok))
-            return false;
-
-        // Don't overwrite monsters or items, either!
-        if (monster_at(cp) || igrd(cp) != NON_ITEM)
+        if (!_map_safe_vault_cell(rules, cp))
             return false;
-
-        // If in Slime, don't let stairs end up next to minivaults,
-        // so that they don't possibly end up next to unsafe walls.
-        if (player_in_branch(BRANCH_SLIME))
-        {
-            for (adjacent_iterator ai(cp); ai; ++ai)
-            {
-                if (map_bounds(*ai) && feat_is_stair(grd(*ai)))
-                    return false;
-            }
-        }
     }
 
     return true;
 }
 
+// Whether a non-blank cell of a map at ci would connect it to the level.
+static bool _connected_minivault_cell(const coord_def &ci,
+                                      bool replace_portals)
+{
+    return _may_overwrite_feature(ci, false, false)
+           || replace_portals && _is_portal_place(ci);
+}
+
 static bool _connected_minivault_place(const coord_def &c,
                                        const vault_placement &place)
 {
@@ -480,6 +593,7 @@ static bool _connected_minivault_place(const coord_def &c,
         return true;
 
     // Must not be completely isolated.
+    const bool replace_portals = place.map.has_tag("replace_portal");
     const vector<string> &lines = place.map.map.get_lines();
 
     for (rectangle_iterator ri(c, c + place.size - 1); ri; ++ri)
@@ -489,14 +603,50 @@ static bool _connected_minivault_place(const coord_def &c,
         if (lines[ci.y - c.y][ci.x - c.x] == ' ')
             continue;
 
-        if (_may_overwrite_feature(ci, false, false)
-            || (place.map.has_tag("replace_portal")
-                && _is_portal_place(ci)))
-        {
+        if (_connected_minivault_cell(ci, replace_portals))
             return true;
+    }
+
+    return false;
+}
+
+// A summed-area table of the level cells passing some test, giving how many
+// cells of any rectangle pass it in constant time.
+class cell_count_table
+{
+public:
+    template<class F> explicit cell_count_table(F test)
+    {
+        for (int x = 0; x <= GXM; ++x)
+            sums[0][x] = 0;
+        for (int y = 0; y < GYM; ++y)
+        {
+            int row = 0;
+            sums[y + 1][0] = 0;
+            for (int x = 0; x < GXM; ++x)
+            {
+                row += test(coord_def(x, y));
+                sums[y + 1][x + 1] = sums[y][x + 1] + row;
+            }
         }
     }
 
+    int count(const coord_def &c, const coord_def &size) const
+    {
+        const coord_def e = c + size;
+        return sums[e.y][e.x] - sums[c.y][e.x] - sums[e.y][c.x]
+               + sums[c.y][c.x];
+    }
+
+private:
+    int sums[GYM + 1][GXM + 1];
+};
+
+static bool _map_has_blank_cells(const map_def &map)
+{
+    for (const string &line : map.map.get_lines())
+        if (line.find(' ') != string::npos)
+            return true;
     return false;
 }
 
@@ -541,13 +691,55 @@ static coord_def _find_minivault_place(
     // The spotty connector in the Shoals needs one more space to work.
     const int margin = MAPGEN_BORDER * 2 + player_in_branch(BRANCH_SHOALS);
 
+    // Most places are found in a few tries. After that, tally up front
+    // which cells of the level fail the per-cell checks, so that a candidate
+    // that passes (or, when all of its cells are checked, fails) everywhere
+    // is settled without walking its cells again.
+    const int table_after_tries = 10;
+    const bool tables_usable = !place.size.zero()
+                               && !place.map.is_overwritable_layout();
+    const bool has_blanks = _map_has_blank_cells(place.map);
+    unique_ptr<cell_count_table> unsafe, connecting;
+
     // Find a target area which can be safely overwritten.
     for (int tries = 0; tries < 600; ++tries)
     {
         coord_def v1(random_range(margin, GXM - margin - place.size.x),
                      random_range(margin, GYM - margin - place.size.y));
 
-        if (check_place && !map_place_valid(place.map, v1, place.size))
+        if (tables_usable && tries == table_after_tries)
+        {
+            if (check_place && map_place_valid == _map_safe_vault_place)
+            {
+                const vault_place_rules rules(place.map);
+                unsafe.reset(new cell_count_table([&](const coord_def &p) {
+                    return !_map_safe_vault_cell(rules, p);
+                }));
+            }
+            const bool replace_portals = place.map.has_tag("replace_portal");
+            connecting.reset(new cell_count_table([&](const coord_def &p) {
+                return _connected_minivault_cell(p, replace_portals);
+            }));
+        }
+
+        const bool in_tables = v1.x >= 0 && v1.y >= 0
+                               && v1.x + place.size.x <= GXM
+                               && v1.y + place.size.y <= GYM;
+        bool safe = !check_place;
+        if (unsafe && in_tables)
+        {
+            const int bad = unsafe->count(v1, place.size);
+            if (!bad)
+                safe = true;
+            else if (!has_blanks)
+                safe = false;
+            else
+                safe = map_place_valid(place.map, v1, place.size);
+        }
+        else if (check_place)
+            safe = map_place_valid(place.map, v1, place.size);
+
+        if (!safe)
         {
 #ifdef DEBUG_MINIVAULT_PLACEMENT
             mprf(MSGCH_DIAGNOSTICS,
@@ -557,7 +749,21 @@ static coord_def _find_minivault_place(
             continue;
         }
 
-        if (!_connected_minivault_place(v1, place))
+        bool connected;
+        if (connecting && in_tables)
+        {
+            const int good = connecting->count(v1, place.size);
+            if (!good)
+                connected = false;
+            else if (!has_blanks)
+                connected = true;
+            else
+                connected = _connected_minivault_place(v1, place);
+        }
+        else
+            connected = _connected_minivault_place(v1, place);
+
+        if (!connected)
         {
 #ifdef DEBUG_MINIVAULT_PLACEMENT
             mprf(MSGCH_DIAGNOSTICS,
@@ -721,8 +927,9 @@ mapref_vector find_maps_for_tag(const string &tag,
     mapref_vector maps;
     level_id place = level_id::current();
 
-    for (const map_def &mapdef : vdefs)
+    for (unsigned i : _indexed_for_tag(tag))
     {
+        const map_def &mapdef = vdefs[i];
         if (mapdef.has_tag(tag)
             && !mapdef.has_tag("dummy")
             && (!check_depth || !mapdef.has_depth()
@@ -749,6 +956,7 @@ private:
 public:
     bool accept(const map_def &md) const;
     void announce(const map_def *map) const;
+    vault_indices candidates() const;
 
     bool valid() const
     {
@@ -928,7 +1136,23 @@ string vault_chance_tag(const map_def &map)
     return "";
 }
 
-typedef vector<unsigned> vault_indices;
+// The maps the selector might accept, by the vault index.
+vault_indices map_selector::candidates() const
+{
+    const vault_index &index = _vault_index();
+    switch (sel)
+    {
+    case PLACE:
+        return _indexed_for_branch(index.place_in, place.branch);
+    case DEPTH:
+    case DEPTH_AND_CHANCE:
+        return _indexed_for_branch(index.depth_in, place.branch);
+    case TAG:
+        return _indexed_for_tag(tag);
+    default:
+        return vault_indices();
+    }
+}
 
 static vault_indices _eligible_maps_for_selector(const map_selector &sel)
 {
@@ -936,7 +1160,7 @@ static vault_indices _eligible_maps_for_selector(const map_selector &sel)
 
     if (sel.valid())
     {
-        for (unsigned i = 0, size = vdefs.size(); i < size; ++i)
+        for (unsigned i : sel.candidates())
             if (sel.accept(vdefs[i]))
                 eligible.push_back(i);
     }
@@ -1218,19 +1442,16 @@ string get_descache_path(const string &file, const string &ext)
     return _des_cache_dir(basename);
 }
 
-static bool verify_file_version(const string &file, time_t mtime)
+// Reads the version header common to all des cache files, returning
+// whether it matches this Crawl and the given .des modification time.
+static bool _read_cache_header(reader &inf, time_t mtime, uint8_t &minor)
 {
-    FILE *fp = fopen_u(file.c_str(), "rb");
-    if (!fp)
-        return false;
     try
     {
-        reader inf(fp);
         const uint8_t major = unmarshallUByte(inf);
-        const uint8_t minor = unmarshallUByte(inf);
+        minor = unmarshallUByte(inf);
         const int8_t word = unmarshallByte(inf);
         const int64_t t = unmarshallSigned(inf);
-        fclose(fp);
         return major == TAG_MAJOR_VERSION
                && minor <= TAG_MINOR_VERSION
                && word == WORD_LEN
@@ -1238,14 +1459,21 @@ static bool verify_file_version(const string &file, time_t mtime)
     }
     catch (short_read_exception &E)
     {
-        fclose(fp);
         return false;
     }
 }
 
-static bool _verify_map_index(const string &base, time_t mtime)
+static bool verify_file_version(const string &file, time_t mtime)
 {
-    return verify_file_version(base + ".idx", mtime);
+    FILE *fp = fopen_u(file.c_str(), "rb");
+    if (!fp)
+        return false;
+
+    reader inf(fp);
+    uint8_t minor;
+    const bool ok = _read_cache_header(inf, mtime, minor);
+    fclose(fp);
+    return ok;
 }
 
 static bool _verify_map_full(const string &base, time_t mtime)
@@ -1253,53 +1481,52 @@ static bool _verify_map_full(const string &base, time_t mtime)
     return verify_file_version(base + ".dsc", mtime);
 }
 
+// Loads the maps from a .des file's cached index, returning false without
+// changing anything if the index is missing or outdated.
 static bool _load_map_index(const string& cache, const string &base,
                             time_t mtime)
 {
-    // If there's a global prelude, load that first.
+    uint8_t minor;
+
+    // If there's a global prelude, it gets loaded first.
+    dlua_chunk prelude("global_prelude");
+    bool have_prelude = false;
     if (FILE *fp = fopen_u((base + ".lux").c_str(), "rb"))
     {
         reader inf(fp, TAG_MINOR_VERSION);
-        uint8_t major = unmarshallUByte(inf);
-        uint8_t minor = unmarshallUByte(inf);
-        int8_t word = unmarshallByte(inf);
-        int64_t t = unmarshallSigned(inf);
-        if (major != TAG_MAJOR_VERSION || minor > TAG_MINOR_VERSION
-            || word != WORD_LEN || t != mtime)
-        {
-            return false;
-        }
-
-        lc_global_prelude.read(inf);
+        have_prelude = _read_cache_header(inf, mtime, minor);
+        if (have_prelude)
+            prelude.read(inf);
         fclose(fp);
-
-        global_preludes.push_back(lc_global_prelude);
+        if (!have_prelude)
+            return false;
     }
 
     FILE* fp = fopen_u((base + ".idx").c_str(), "rb");
     if (!fp)
-        end(1, true, "Unable to read %s", (base + ".idx").c_str());
+        return false;
 
     reader inf(fp, TAG_MINOR_VERSION);
-    // Re-check version, might have been modified in the meantime.
-    uint8_t major = unmarshallUByte(inf);
-    uint8_t minor = unmarshallUByte(inf);
-    int8_t word = unmarshallByte(inf);
-    int64_t t = unmarshallSigned(inf);
-    if (major != TAG_MAJOR_VERSION || minor > TAG_MINOR_VERSION
-        || word != WORD_LEN || t != mtime)
+    if (!_read_cache_header(inf, mtime, minor)
+#if TAG_MAJOR_VERSION == 34
+        // Throw out pre-ORDER: indices entirely.
+        || minor < TAG_MINOR_MAP_ORDER
+#endif
+        )
     {
+        fclose(fp);
         return false;
     }
 
-#if TAG_MAJOR_VERSION == 34
-    // Throw out pre-ORDER: indices entirely.
-    if (minor < TAG_MINOR_MAP_ORDER)
-        return false;
-#endif
+    if (have_prelude)
+    {
+        lc_global_prelude = prelude;
+        global_preludes.push_back(lc_global_prelude);
+    }
 
     const int nmaps = unmarshallShort(inf);
     const int nexist = vdefs.size();
+    _forget_vault_index();
     vdefs.resize(nexist + nmaps, map_def());
     for (int i = 0; i < nmaps; ++i)
     {
@@ -1324,16 +1551,12 @@ static bool _load_map_cache(const string &filename, const string &cachename)
 
     file_lock deslock(descache_base + ".lk", "rb", false);
 
-    time_t mtime = file_modtime(filename);
-    string file_idx = descache_base + ".idx";
-    string file_dsc = descache_base + ".dsc";
+    const time_t mtime = file_modtime(filename);
 
-    // What's the point in checking these twice (here and in load_ma_index)?
-    if (!_verify_map_index(descache_base, mtime)
-        || !_verify_map_full(descache_base, mtime))
-    {
+    // The index is checked as it is read; the bodies are only read when
+    // a map is used, so check them now.
+    if (!_verify_map_full(descache_base, mtime))
         return false;
-    }
 
     return _load_map_index(cachename, descache_base, mtime);
 }
@@ -1414,16 +1637,18 @@ static void _write_map_cache(const string &filename, size_t vs, size_t ve,
     _write_map_index(descache_base, vs, ve, mtime);
 }
 
-static void _parse_maps(const string &s)
+// Loads the maps in a .des file, from its cache if that is up to date.
+// Returns true if the file had to be parsed (and its Lua run).
+static bool _parse_maps(const string &s)
 {
     string cache_name = get_cache_name(s);
     if (map_files_read.count(cache_name))
-        return;
+        return false;
 
     map_files_read.insert(cache_name);
 
     if (_load_map_cache(s, cache_name))
-        return;
+        return false;
 
     FILE *dat = fopen_u(s.c_str(), "r");
     if (!dat)
@@ -1447,11 +1672,16 @@ static void _parse_maps(const string &s)
     global_preludes.push_back(lc_global_prelude);
 
     _write_map_cache(cache_name, file_start, vdefs.size(), mtime);
+    return true;
 }
 
 void read_map(const string &file)
 {
-    _parse_maps(lc_desfile = datafile_path(file));
+    // Loading from the cache runs no map Lua, so there is nothing to
+    // clean up afterwards.
+    if (!_parse_maps(lc_desfile = datafile_path(file)))
+        return;
+
     _dgn_flush_map_environments();
     // Force GC to prevent heap from swelling unnecessarily.
     dlua.gc();
@@ -1485,6 +1715,7 @@ void reread_maps()
 
     // BOOM!
     vdefs.clear();
+    _forget_vault_index();
     map_files_read.clear();
     read_maps();
 }
@@ -1500,10 +1731,9 @@ void dump_map(const map_def &map)
 
 void add_parsed_map(const map_def &md)
 {
-    map_def map = md;
-
-    map.fixup();
-    vdefs.push_back(map);
+    vdefs.push_back(md);
+    vdefs.back().fixup();
+    _forget_vault_index();
 }
 
 void run_map_global_preludes()
@@ -1520,6 +1750,8 @@ void run_map_global_preludes()
 
 void run_map_local_preludes()
 {
+    // Preludes may well change tags or depths.
+    _forget_vault_index();
     for (map_def &vdef : vdefs)
     {
         if (!vdef.prelude.empty())
@@ -54,6 +54,7 @@
  #include "travel.h"
 #endif
 #include "unicode.h"
+#include "unwind.h"
 
 #ifdef USE_TILE_LOCAL
 Popup::Popup(string prompt) : m_prompt(prompt), m_curr(0)
@@ -185,6 +186,9 @@ Menu::Menu(int _flags, const string& tagname, bool text_only)
 #ifdef USE_TILE_WEB
     _webtiles_section_start = -1;
     _webtiles_section_end = -1;
+    _webtiles_queue_updates = false;
+    _webtiles_update_start = -1;
+    _webtiles_update_end = -1;
 #endif
 }
 
@@ -1181,7 +1185,10 @@ void Menu::select_item_index(int idx, int qty, bool draw_cursor)
     items[idx]->select(qty);
     draw_item(idx);
 #ifdef USE_TILE_WEB
-    webtiles_update_item(idx);
+    if (_webtiles_queue_updates)
+        webtiles_queue_item_update(idx);
+    else
+        webtiles_update_item(idx);
 #endif
 
     if (draw_cursor)
@@ -1206,6 +1213,10 @@ void Menu::select_index(int index, int qty)
 {
     int si = index == -1 ? first_entry : index;
 
+#ifdef USE_TILE_WEB
+    unwind_bool queue_updates(_webtiles_queue_updates, true);
+#endif
+
     if (index == -1)
     {
         if (flags & MF_MULTISELECT)
@@ -1243,6 +1254,10 @@ void Menu::select_index(int index, int qty)
     {
         select_item_index(si, qty, (flags & MF_MULTISELECT));
     }
+
+#ifdef USE_TILE_WEB
+    webtiles_flush_item_updates();
+#endif
 }
 
 int Menu::get_entry_index(const MenuEntry *e) const
@@ -1576,6 +1591,27 @@ void Menu::webtiles_update_items(int start, int end) const
 }
 
 
+void Menu::webtiles_queue_item_update(int index)
+{
+    if (_webtiles_update_start != -1 && index == _webtiles_update_end + 1)
+    {
+        _webtiles_update_end = index;
+        return;
+    }
+
+    webtiles_flush_item_updates();
+    _webtiles_update_start = _webtiles_update_end = index;
+}
+
+void Menu::webtiles_flush_item_updates()
+{
+    if (_webtiles_update_start == -1)
+        return;
+
+    webtiles_update_items(_webtiles_update_start, _webtiles_update_end);
+    _webtiles_update_start = _webtiles_update_end = -1;
+}
+
 void Menu::webtiles_update_item(int index) const
 {
     webtiles_update_items(index, index);
@@ -447,9 +447,18 @@ protected:
 
     void webtiles_update_section_boundaries();
 
+    // Bulk selection sends its item updates as runs of adjacent items,
+    // rather than as one message per item.
+    void webtiles_queue_item_update(int index);
+    void webtiles_flush_item_updates();
+
     int _webtiles_section_start;
     int _webtiles_section_end;
 
+    bool _webtiles_queue_updates;
+    int _webtiles_update_start;
+    int _webtiles_update_end;
+
     bool _webtiles_title_changed;
     formatted_string _webtiles_title;
     formatted_string _webtiles_suffix;
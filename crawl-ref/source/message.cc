@@ -1151,23 +1151,14 @@ void dprf(diag_type param, const char *format, ...)
 
 static bool _updating_view = false;
 
-static bool _check_option(const string& line, msg_channel_type channel,
-                          const vector<message_filter>& option)
-{
-    return any_of(begin(option),
-                  end(option),
-                  bind(mem_fn(&message_filter::is_filtered),
-                       placeholders::_1, channel, line));
-}
-
 static bool _check_more(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.force_more_message);
+    return Options.force_more_matches(channel, line);
 }
 
 static bool _check_flash_screen(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.flash_screen_message);
+    return Options.flash_screen_matches(channel, line);
 }
 
 static bool _check_join(const string& line, msg_channel_type channel)
@@ -1448,25 +1439,22 @@ static void mpr_check_patterns(const string& message,
                                msg_channel_type channel,
                                int param)
 {
-    for (const text_pattern &pat : Options.note_messages)
+    if (channel != MSGCH_EQUIPMENT && channel != MSGCH_FLOOR_ITEMS
+        && channel != MSGCH_MULTITURN_ACTION
+        && channel != MSGCH_EXAMINE && channel != MSGCH_EXAMINE_FILTER
+        && channel != MSGCH_TUTORIAL && channel != MSGCH_DGL_MESSAGE
+        && Options.note_messages_set().first_match(message) >= 0)
     {
-        if (channel == MSGCH_EQUIPMENT || channel == MSGCH_FLOOR_ITEMS
-            || channel == MSGCH_MULTITURN_ACTION
-            || channel == MSGCH_EXAMINE || channel == MSGCH_EXAMINE_FILTER
-            || channel == MSGCH_TUTORIAL || channel == MSGCH_DGL_MESSAGE)
-        {
-            continue;
-        }
-
-        if (pat.matches(message))
-        {
-            take_note(Note(NOTE_MESSAGE, channel, param, message));
-            break;
-        }
+        take_note(Note(NOTE_MESSAGE, channel, param, message));
     }
 
-    if (channel != MSGCH_DIAGNOSTICS && channel != MSGCH_EQUIPMENT)
+    // Only a delay or a repeated command can be interrupted by a message;
+    // don't build the interrupt text for every message of a fight.
+    if (channel != MSGCH_DIAGNOSTICS && channel != MSGCH_EQUIPMENT
+        && (you_are_delayed() || crawl_state.is_repeating_cmd()))
+    {
         interrupt_activity(AI_MESSAGE, channel_to_str(channel) + ":" + message);
+    }
 
 #ifdef USE_SOUND
     for (const sound_mapping &sound : Options.sound_mappings)
@@ -1515,14 +1503,9 @@ static msg_colour_type prepare_message(const string& imsg,
     if (colour != MSGCOL_MUTED)
         mpr_check_patterns(imsg, channel, param);
 
-    for (const message_colour_mapping &mcm : Options.message_colour_mappings)
-    {
-        if (mcm.message.is_filtered(channel, imsg))
-        {
-            colour = mcm.colour;
-            break;
-        }
-    }
+    const int mapping = Options.message_colour_index(channel, imsg);
+    if (mapping >= 0)
+        colour = Options.message_colour_mappings[mapping].colour;
 
     return colour;
 }
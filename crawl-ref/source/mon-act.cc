@@ -2633,9 +2633,69 @@ static void _post_monster_move(monster* mons)
         monster_die(mons, KILL_MISC, NON_MONSTER);
 }
 
-priority_queue<pair<monster *, int>,
-               vector<pair<monster *, int> >,
-               MonsterActionQueueCompare> monster_queue;
+// The monsters waiting to act this round, each filed in a bucket for the
+// speed_increment it had when queued. The monster with the most energy acts
+// first; monsters queued with equal energy act in the order they were queued.
+class MonsterActionQueue
+{
+public:
+    MonsterActionQueue() : buckets(), highest(-1), count(0) { }
+
+    bool empty() const { return !count; }
+    size_t size() const { return count; }
+
+    void emplace(monster *mons, int energy)
+    {
+        // Monsters without action energy are skipped when popped anyway, so
+        // there's no need to keep negative energies apart.
+        const int slot = max(energy, 0);
+        if (slot >= (int) buckets.size())
+            buckets.resize(slot + 1);
+        buckets[slot].entries.emplace_back(mons, energy);
+        highest = max(highest, slot);
+        ++count;
+    }
+
+    const pair<monster *, int> &top() const
+    {
+        ASSERT(count);
+        const bucket &b = buckets[highest];
+        return b.entries[b.next];
+    }
+
+    void pop()
+    {
+        ASSERT(count);
+        bucket &b = buckets[highest];
+        if (++b.next == b.entries.size())
+        {
+            b.entries.clear();
+            b.next = 0;
+        }
+        if (!--count)
+            highest = -1;
+        else
+        {
+            while (buckets[highest].entries.empty())
+                --highest;
+        }
+    }
+
+private:
+    struct bucket
+    {
+        bucket() : entries(), next(0) { }
+
+        vector<pair<monster *, int>> entries;
+        size_t next; // entries before this have already been popped
+    };
+
+    vector<bucket> buckets;
+    int highest;      // highest non-empty bucket, or -1 if none
+    size_t count;
+};
+
+static MonsterActionQueue monster_queue;
 
 // Inserts a monster into the monster queue (needed to ensure that any monsters
 // given energy or an action by a effect can actually make use of that energy
@@ -2645,14 +2705,50 @@ void queue_monster_for_action(monster* mons)
     monster_queue.emplace(mons, mons->speed_increment);
 }
 
+// Under monster_sim_horizon, how often a distant idle monster gets a full
+// action; the rest of the time it just spends its energy.
+#define DISTANT_MONSTER_ACTION_INTERVAL 10
+
+/**
+ * Should this monster skip its action, being far away and idle?
+ *
+ * Only when monster_sim_horizon is set. Hostile monsters further than that
+ * from the player, out of sight, without enchantments, and either asleep or
+ * wandering without ever having been disturbed, only get a full action every
+ * DISTANT_MONSTER_ACTION_INTERVAL turns. Coming into view, or any behaviour
+ * event (noise included), returns them to acting every turn.
+ *
+ * @param mons  The monster about to act.
+ * @return      Whether it should just lose its move energy instead.
+ */
+static bool _skip_distant_monster(const monster* mons)
+{
+    const int horizon = Options.monster_sim_horizon;
+    if (!horizon
+        || mons->friendly()
+        || !mons->asleep() && (mons->behaviour != BEH_WANDER
+                               || mons->flags & MF_DISTURBED)
+        || !mons->enchantments.empty()
+        || mons->is_projectile()
+        || mons_is_tentacle_or_tentacle_segment(mons->type)
+        || grid_distance(you.pos(), mons->pos()) <= horizon
+        || you.see_cell(mons->pos()))
+    {
+        return false;
+    }
+
+    return (you.num_turns + mons->mindex())
+           % DISTANT_MONSTER_ACTION_INTERVAL != 0;
+}
+
 static void _clear_monster_flags()
 {
     // Clear any summoning flags so that lower indiced
     // monsters get their actions in the next round.
     // Also clear one-turn deep sleep flag.
     // XXX: MF_JUST_SLEPT only really works for player-cast hibernation.
-    for (auto &mons : menv)
-        mons.flags &= ~MF_JUST_SUMMONED & ~MF_JUST_SLEPT;
+    for (int i = 0; i < env.mons_slots_used; ++i)
+        menv[i].flags &= ~MF_JUST_SUMMONED & ~MF_JUST_SLEPT;
 }
 
 /**
@@ -2710,9 +2806,14 @@ void handle_monsters(bool with_noise)
         // the queue just after this.
         if (oldspeed == mon->speed_increment)
         {
-            handle_monster_move(mon);
-            _post_monster_move(mon);
-            fire_final_effects();
+            if (_skip_distant_monster(mon))
+                mon->lose_energy(EUT_MOVE);
+            else
+            {
+                handle_monster_move(mon);
+                _post_monster_move(mon);
+                fire_final_effects();
+            }
         }
 
         if (mon->has_action_energy())
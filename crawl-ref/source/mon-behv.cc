@@ -958,23 +958,50 @@ void set_nearest_monster_foe(monster* mon, bool near_player)
 
     while (true)
     {
-        for (int k = 1; k <= LOS_RADIUS; ++k)
+        // Only cells holding a monster (or the player, for an insane
+        // monster) can pass _mons_check_foe, so look at just those rather
+        // than every cell in the rings.
+        vector<coord_def> cells = monster_cells_near(center, LOS_RADIUS);
+        if (mon->has_ench(ENCH_INSANE)
+            && grid_distance(center, you.pos()) <= LOS_RADIUS)
         {
-            vector<coord_def> monster_pos;
-            for (int i = -k; i <= k; ++i)
-                for (int j = -k; j <= k; (abs(i) == k ? j++ : j += 2*k))
-                {
-                    const coord_def p = center + coord_def(i, j);
+            cells.push_back(you.pos());
+        }
 
-                    if (near_player && !you.see_cell(p))
-                        continue;
+        int best_ring = LOS_RADIUS + 1;
+        vector<coord_def> monster_pos;
+        for (const coord_def &p : cells)
+        {
+            const int k = grid_distance(center, p);
+            if (k < 1 || k > best_ring)
+                continue;
 
-                    if (_mons_check_foe(mon, p, friendly, neutral, second_pass))
-                        monster_pos.push_back(p);
-                }
-            if (monster_pos.empty())
+            if (near_player && !you.see_cell(p))
+                continue;
+
+            if (!_mons_check_foe(mon, p, friendly, neutral, second_pass))
                 continue;
 
+            if (k < best_ring)
+            {
+                best_ring = k;
+                monster_pos.clear();
+            }
+            monster_pos.push_back(p);
+        }
+
+        if (!monster_pos.empty())
+        {
+            // Pick from the nearest ring's foes in the order a scan of
+            // the ring, column by column, would have found them.
+            sort(monster_pos.begin(), monster_pos.end(),
+                 [](const coord_def &a, const coord_def &b)
+                 {
+                     return a.x != b.x ? a.x < b.x : a.y < b.y;
+                 });
+            monster_pos.erase(unique(monster_pos.begin(), monster_pos.end()),
+                              monster_pos.end());
+
             const coord_def mpos = monster_pos[random2(monster_pos.size())];
             if (mpos == you.pos())
                 mon->foe = MHITYOU;
@@ -1017,6 +1044,10 @@ void behaviour_event(monster* mon, mon_event_type event, const actor *src,
     if (mons_is_projectile(mon->type))
         return; // projectiles have no AI
 
+    // Anything that gets a monster's attention puts it back under full
+    // simulation; see monster_sim_horizon.
+    mon->flags |= MF_DISTURBED;
+
     const beh_type old_behaviour = mon->behaviour;
 
     bool isSmart          = (mons_intel(mon) >= I_HUMAN);
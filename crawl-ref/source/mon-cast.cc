@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <unordered_set>
 
 #include "act-iter.h"
@@ -3432,14 +3433,16 @@ bool scattershot_tracer(monster *caster, int pow, coord_def aim)
  */
 static spell_type _pick_spell_from_list(const monster_spells &spells,
                                         int flag,
-                                        mon_spell_slot_flags &slot_flags)
+                                        mon_spell_slot_flags &slot_flags,
+                                        function<bool(unsigned int)> useful)
 {
     spell_type spell_cast = SPELL_NO_SPELL;
     int weight = 0;
-    for (const mon_spell_slot &slot : spells)
+    for (unsigned int i = 0; i < spells.size(); i++)
     {
+        const mon_spell_slot &slot = spells[i];
         int flags = get_spell_flags(slot.spell);
-        if (!(flags & flag))
+        if (!(flags & flag) || !useful(i))
             continue;
 
         weight += slot.freq;
@@ -3627,6 +3630,11 @@ bool handle_mon_spell(monster* mons, bolt &beem)
 
     if (!finalAnswer)
     {
+        // Choosing a spell often fires the same tracer more than once
+        // (picking an ally, then checking the beam; or a second attempt),
+        // and nothing moves until we cast.
+        tracer_memo_scope tracer_memo;
+
         // If nothing found by now, safe friendlies and good
         // neutrals will rarely cast.
         if (mons->wont_attack() && !mon_enemies_around(mons)
@@ -3635,17 +3643,27 @@ bool handle_mon_spell(monster* mons, bolt &beem)
             return false;
         }
 
-        // Remove healing/invis/haste if we don't need them.
-        erase_if(hspell_pass, [&](const mon_spell_slot &t) {
-            return _ms_waste_of_time(mons, t)
-                // Should monster not have selected dig by now,
-                // it never will.
-                || t.spell == SPELL_DIG;
-        });
+        // Skip healing/invis/haste if we don't need them. Whether a slot
+        // is worth casting is only worked out once the selection below
+        // reaches it, since the checks can fire tracers and sweep the
+        // level for summons, and most of a big book is never rolled. Each
+        // slot's answer is independent of the others, so this picks with
+        // the same odds as filtering the whole book up front.
+        vector<int8_t> slot_useful(hspell_pass.size(), -1);
+        auto useful = [&](unsigned int i) {
+            if (slot_useful[i] < 0)
+            {
+                slot_useful[i] = !_ms_waste_of_time(mons, hspell_pass[i])
+                    // Should monster not have selected dig by now,
+                    // it never will.
+                    && hspell_pass[i].spell != SPELL_DIG;
+            }
+            return slot_useful[i] > 0;
+        };
 
-        // If no useful spells... cast no spell.
-        if (!hspell_pass.size())
-            return false;
+        // Cheap gates on range, shared by every slot this turn.
+        const bool short_range = _short_target_range(mons);
+        const bool long_range = _long_target_range(mons);
 
         const bolt orig_beem = beem;
 
@@ -3662,7 +3680,7 @@ bool handle_mon_spell(monster* mons, bolt &beem)
             {
                 spell_cast = _pick_spell_from_list(hspell_pass,
                                                    SPFLAG_SELFENCH,
-                                                   flags);
+                                                   flags, useful);
             }
             // Monsters that are fleeing or pacified and leaving the
             // level will always try to choose an emergency spell.
@@ -3670,7 +3688,7 @@ bool handle_mon_spell(monster* mons, bolt &beem)
             {
                 spell_cast = _pick_spell_from_list(hspell_pass,
                                                    SPFLAG_EMERGENCY,
-                                                   flags);
+                                                   flags, useful);
 
                 // Pacified monsters leaving the level will only
                 // try and cast escape spells.
@@ -3692,9 +3710,10 @@ bool handle_mon_spell(monster* mons, bolt &beem)
                     if ((hspell_pass[i].flags & MON_SPELL_EMERGENCY
                          && !emergency)
                         || (hspell_pass[i].flags & MON_SPELL_SHORT_RANGE
-                            && !_short_target_range(mons))
+                            && !short_range)
                         || (hspell_pass[i].flags & MON_SPELL_LONG_RANGE
-                            && !_long_target_range(mons)))
+                            && !long_range)
+                        || !useful(i))
                     {
                         continue;
                     }
@@ -119,6 +119,8 @@
 
 #define M_NOT_DANGEROUS (M_NO_EXP_GAIN | M_NO_THREAT)
 
+// Not const, unlike the other data tables: casting a player illusion
+// rewrites the holiness of its entry (see mon-clone.cc).
 static monsterentry mondata[] =
 {
 
@@ -263,23 +263,33 @@ static void _give_monster_experience(int experience, int killer_index)
 
 static void _beogh_spread_experience(int exp)
 {
+    if (exp <= 0)
+        return;
+
+    // Gather the followers in one sweep over LOS; awarding experience
+    // only changes the follower being awarded, so the others' levels
+    // (and thus their shares) are unaffected.
+    vector<monster*> followers;
     int total_hd = 0;
 
     for (monster_near_iterator mi(&you); mi; ++mi)
     {
         if (is_orcish_follower(*mi))
+        {
+            followers.push_back(*mi);
             total_hd += mi->get_experience_level();
+        }
     }
 
     if (total_hd <= 0)
         return;
 
-    for (monster_near_iterator mi(&you); mi; ++mi)
-        if (is_orcish_follower(*mi))
-        {
-            _give_monster_experience(exp * mi->get_experience_level() / total_hd,
-                                         mi->mindex());
-        }
+    for (monster *follower : followers)
+    {
+        _give_monster_experience(exp * follower->get_experience_level()
+                                     / total_hd,
+                                 follower->mindex());
+    }
 }
 
 static int _calc_player_experience(const monster* mons)
@@ -2116,13 +2116,22 @@ void monster::apply_enchantments()
     // We process an enchantment only if it existed both at the start of this
     // function and when getting to it in order; any enchantment can add, modify
     // or remove others -- or even itself.
-    FixedBitVector<NUM_ENCHANTMENTS> ec = ench_cache;
+    // The map is ordered by type, so this walks the same enchantments in the
+    // same order as a sweep over the whole enum would, without touching the
+    // hundred-odd types the monster doesn't have.
+    enchant_type pending[NUM_ENCHANTMENTS];
+    int num_pending = 0;
+    for (const auto &entry : enchantments)
+        pending[num_pending++] = entry.first;
 
     // The ordering in enchant_type makes sure that "super-enchantments"
     // like berserk time out before their parts.
-    for (int i = 0; i < NUM_ENCHANTMENTS; ++i)
-        if (ec[i] && has_ench(static_cast<enchant_type>(i)))
-            apply_enchantment(enchantments.find(static_cast<enchant_type>(i))->second);
+    for (int i = 0; i < num_pending; ++i)
+    {
+        auto it = enchantments.find(pending[i]);
+        if (it != enchantments.end())
+            apply_enchantment(it->second);
+    }
 }
 
 // Used to adjust time durations in calc_duration() for monster speed.
@@ -272,6 +272,8 @@ enum monster_flag_type : uint64_t
     MF_JUST_SLEPT         = BIT(37),
     /// possibly got piety with TSO
     MF_TSO_SEEN           = BIT(38),
+    /// has had a behaviour event; see monster_sim_horizon
+    MF_DISTURBED          = BIT(39),
 };
 DEF_BITFIELD(monster_flags_t, monster_flag_type);
 
@@ -31,6 +31,7 @@
 #include "mon-tentacle.h"
 #include "options.h"
 #include "religion.h"
+#include "show.h"
 #include "skills.h"
 #include "spl-goditem.h" // dispellable_enchantments
 #include "spl-summoning.h"
@@ -415,10 +416,9 @@ monster_info::monster_info(const monster* m, int milev)
 
     attitude = mons_attitude(m);
 
-    bool nomsg_wounds = false;
-
     type = m->type;
-    threat = mons_threat_level(m);
+    // Filled in below unless we only want the name, which doesn't need it.
+    threat = MTHRT_UNDEF;
 
     props.clear();
     // CrawlHashTable::begin() const can fail if the hash is empty.
@@ -442,12 +442,6 @@ monster_info::monster_info(const monster* m, int milev)
             ? ::draco_or_demonspawn_subspecies(m)
             : type;
 
-    if (!mons_can_display_wounds(m)
-        || !mons_class_can_display_wounds(type))
-    {
-        nomsg_wounds = true;
-    }
-
     base_type = m->base_monster;
     if (base_type == MONS_NO_MONSTER)
         base_type = type;
@@ -538,6 +532,11 @@ monster_info::monster_info(const monster* m, int milev)
         return;
     }
 
+    threat = mons_threat_level(m);
+
+    const bool nomsg_wounds = !mons_can_display_wounds(m)
+                              || !mons_class_can_display_wounds(type);
+
     holi = m->holiness();
 
     mintel = mons_intel(m);
@@ -1883,7 +1882,11 @@ void get_monster_info(vector<monster_info>& mons)
         if (mons_is_threatening(mon)
             || mon->is_child_tentacle())
         {
-            mons.emplace_back(mon);
+            // Reuse what the view update already built, if it's current.
+            if (const monster_info* mi = fresh_monster_info(mon))
+                mons.push_back(*mi);
+            else
+                mons.emplace_back(mon);
         }
     }
     sort(mons.begin(), mons.end(), monster_info::less_than_wrapper);
@@ -220,6 +220,18 @@ bool try_pathfind(monster* mon)
          mon->name(DESC_PLAIN).c_str(), mon->pos().x, mon->pos().y,
          targpos.x, targpos.y, range);
 #endif
+    // Hostiles after the player share one flood fill per movement class
+    // instead of each running a search of their own.
+    coord_def step;
+    if (targpos == you.pos() && player_flow_step(mon, range, step))
+    {
+        mon->travel_path.clear();
+        mon->travel_path.push_back(step);
+        mon->target = step;
+        mon->travel_target = MTRAV_FOE;
+        return true;
+    }
+
     monster_pathfind mp;
     if (range > 0)
         mp.set_range(range);
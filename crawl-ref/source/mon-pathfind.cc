@@ -2,9 +2,13 @@
 
 #include "mon-pathfind.h"
 
+#include <bitset>
+
+#include "coordit.h"
 #include "directn.h"
 #include "env.h"
 #include "los.h"
+#include "mapmark.h"
 #include "mon-movetarget.h"
 #include "mon-place.h"
 #include "religion.h"
@@ -28,6 +32,63 @@
 // then there's no path that matches the requirements fed into monster_pathfind.
 // (These requirements are usually preference of habitat of a specific monster
 // or a limit of the distance between start and any grid on the path.)
+//
+// The grids and the open set live in a pathfind_context, which is taken from
+// a pool when a monster_pathfind is constructed and handed back when it is
+// destroyed. Each search bumps the context's generation instead of clearing
+// the distance grid: a cell whose stamp is from an older search simply counts
+// as not yet visited. Updated positions are left in their old bucket and
+// skipped when popped, rather than searched for and erased.
+
+struct pathfind_context
+{
+    // Distance from start to any cell tried in this generation.
+    int dist[GXM][GYM];
+    // Direction to step back along the shortest path found so far.
+    int8_t prev[GXM][GYM];
+    // Search generation in which dist/prev at a cell were last written.
+    uint32_t stamp[GXM][GYM];
+    uint32_t generation;
+
+    // Bucket queue of positions, indexed by estimated total path length.
+    FixedVector<vector<coord_def>, GXM * GYM> open;
+    // Highest bucket that may be non-empty from the previous search.
+    int open_max;
+
+    pathfind_context() : generation(0), open_max(-1)
+    {
+        memset(stamp, 0, sizeof(stamp));
+    }
+
+    void new_search()
+    {
+        if (++generation == 0)
+        {
+            memset(stamp, 0, sizeof(stamp));
+            generation = 1;
+        }
+        for (int i = 0; i <= open_max; ++i)
+            open[i].clear();
+        open_max = -1;
+    }
+};
+
+static vector<pathfind_context*> _pathfind_pool;
+
+static pathfind_context* _borrow_pathfind_context()
+{
+    if (_pathfind_pool.empty())
+        return new pathfind_context;
+
+    pathfind_context* ctx = _pathfind_pool.back();
+    _pathfind_pool.pop_back();
+    return ctx;
+}
+
+static void _return_pathfind_context(pathfind_context* ctx)
+{
+    _pathfind_pool.push_back(ctx);
+}
 
 int mons_tracking_range(const monster* mon)
 {
@@ -68,12 +129,26 @@ int mons_tracking_range(const monster* mon)
 monster_pathfind::monster_pathfind()
     : mons(nullptr), start(), target(), pos(), allow_diagonals(true),
       traverse_unmapped(false), range(0), min_length(0), max_length(0),
-      dist(), prev(), hash()
+      ctx(_borrow_pathfind_context())
 {
 }
 
 monster_pathfind::~monster_pathfind()
 {
+    _return_pathfind_context(ctx);
+}
+
+int monster_pathfind::dist_at(const coord_def& p) const
+{
+    if (ctx->stamp[p.x][p.y] != ctx->generation)
+        return INFINITE_DISTANCE;
+    return ctx->dist[p.x][p.y];
+}
+
+void monster_pathfind::set_dist(const coord_def& p, int d)
+{
+    ctx->stamp[p.x][p.y] = ctx->generation;
+    ctx->dist[p.x][p.y] = d;
 }
 
 void monster_pathfind::set_range(int r)
@@ -89,7 +164,7 @@ void monster_pathfind::set_monster(const monster *mon)
 
 coord_def monster_pathfind::next_pos(const coord_def &c) const
 {
-    return c + Compass[prev[c.x][c.y]];
+    return c + Compass[ctx->prev[c.x][c.y]];
 }
 
 // The main method in the monster_pathfind class.
@@ -145,11 +220,8 @@ bool monster_pathfind::start_pathfind(bool msg)
     //       a wall.
 
     max_length = min_length = grid_distance(pos, target);
-    for (int i = 0; i < GXM; i++)
-        for (int j = 0; j < GYM; j++)
-            dist[i][j] = INFINITE_DISTANCE;
-
-    dist[pos.x][pos.y] = 0;
+    ctx->new_search();
+    set_dist(pos, 0);
 
     bool success = false;
     do
@@ -219,8 +291,8 @@ bool monster_pathfind::calc_path_to_neighbours()
         if (range && estimated_cost(npos) > range)
             continue;
 
-        distance = dist[pos.x][pos.y] + travel_cost(npos);
-        old_dist = dist[npos.x][npos.y];
+        distance = dist_at(pos) + travel_cost(npos);
+        old_dist = dist_at(npos);
 
         // Also bail out if this would make the path longer than twice the
         // allowed distance from the target. (This factor may need tuning.)
@@ -266,7 +338,7 @@ bool monster_pathfind::calc_path_to_neighbours()
             }
 
             // Update distance start->pos.
-            dist[npos.x][npos.y] = distance;
+            set_dist(npos, distance);
 
             // Set backtracking information.
             // Converts the Compass direction to its counterpart.
@@ -274,7 +346,7 @@ bool monster_pathfind::calc_path_to_neighbours()
             //      7  .  3   ==>   3  .  7       e.g. (3 + 4) % 8          = 7
             //      6  5  4         2  1  0            (7 + 4) % 8 = 11 % 8 = 3
 
-            prev[npos.x][npos.y] = (dir + 4) % 8;
+            ctx->prev[npos.x][npos.y] = (dir + 4) % 8;
 
             // Are we finished?
             if (npos == target)
@@ -290,21 +362,28 @@ bool monster_pathfind::calc_path_to_neighbours()
 }
 
 // Starting at known min_length (minimum total estimated path distance), check
-// the hash for existing vectors, then pick the last entry of the first vector
-// that matches. Update min_length, if necessary.
+// the open set for existing vectors, then pick the last live entry of the
+// first vector that has one. Update min_length, if necessary.
 bool monster_pathfind::get_best_position()
 {
     for (int i = min_length; i <= max_length; i++)
     {
-        if (!hash[i].empty())
+        vector<coord_def> &vec = ctx->open[i];
+        // Drop entries that were since improved into a lower bucket.
+        while (!vec.empty()
+               && dist_at(vec.back()) + estimated_cost(vec.back()) != i)
+        {
+            vec.pop_back();
+        }
+
+        if (!vec.empty())
         {
             if (i > min_length)
                 min_length = i;
 
-            vector<coord_def> &vec = hash[i];
             // Pick the last position pushed into the vector as it's most
             // likely to be close to the target.
-            pos = vec[vec.size()-1];
+            pos = vec.back();
             vec.pop_back();
 
 #ifdef DEBUG_PATHFIND
@@ -340,7 +419,7 @@ vector<coord_def> monster_pathfind::backtrack()
     int dir;
     do
     {
-        dir = prev[pos.x][pos.y];
+        dir = ctx->prev[pos.x][pos.y];
         pos = pos + Compass[dir];
         ASSERT_IN_BOUNDS(pos);
 #ifdef DEBUG_PATHFIND
@@ -506,24 +585,249 @@ int monster_pathfind::estimated_cost(coord_def p)
 
 void monster_pathfind::add_new_pos(coord_def npos, int total)
 {
-    hash[total].push_back(npos);
+    ctx->open[total].push_back(npos);
+    if (total > ctx->open_max)
+        ctx->open_max = total;
 }
 
 void monster_pathfind::update_pos(coord_def npos, int total)
 {
-    // Find hash position of old distance and delete it,
-    // then call_add_new_pos.
-    int old_total = dist[npos.x][npos.y] + estimated_cost(npos);
+    // The entry in the bucket of the old total is left where it is; as totals
+    // only ever decrease, get_best_position() recognises and drops it.
+    add_new_pos(npos, total);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Shared distance fields toward the player.
+//
+// Most hostiles that need a path need one to the player. Rather than each of
+// them running its own A* search, monsters that move the same way share a
+// single Dijkstra flood out from the player's position. A field is keyed on
+// the set of features its monsters can stand on plus how they deal with doors
+// and water, which in practice gives one field per habitat class (walking,
+// flying, swimming, amphibious). Fields are rebuilt lazily, at most once a
+// turn, or when the player moves or terrain changes.
+
+struct flow_signature
+{
+    bitset<NUM_FEATURES> habitable;
+    bool doors;     // can open, eat or smash closed doors
+    bool flounders; // water costs as much as a door to get through
 
-    vector<coord_def> &vec = hash[old_total];
-    for (unsigned int i = 0; i < vec.size(); i++)
+    bool operator==(const flow_signature &other) const
     {
-        if (vec[i] == npos)
+        return habitable == other.habitable && doors == other.doors
+               && flounders == other.flounders;
+    }
+};
+
+struct player_flow
+{
+    flow_signature sig;
+    level_id place;
+    coord_def origin;
+    int turn;
+    unsigned int terrain_gen;
+    int dist[GXM][GYM];
+};
+
+static const unsigned int MAX_PLAYER_FLOWS = 8;
+static vector<player_flow*> _player_flows;
+static unsigned int _flow_terrain_gen = 0;
+
+void invalidate_player_flow()
+{
+    ++_flow_terrain_gen;
+}
+
+static flow_signature _flow_signature(const monster* mon)
+{
+    flow_signature sig;
+    const monster_type mt = fixup_zombie_type(mon->type, mons_base_type(mon));
+    const bool flies = mon->airborne();
+    for (int f = 0; f < NUM_FEATURES; ++f)
+    {
+        sig.habitable[f] = monster_habitable_grid(mt, (dungeon_feature_type)f,
+                                                  DNGN_UNSEEN, flies);
+    }
+    sig.doors = mon->can_pass_through_feat(DNGN_FLOOR)
+                && (mons_itemuse(mon) >= MONUSE_OPEN_DOORS
+                    || mons_eats_items(mon)
+                    || mons_class_flag(mons_base_type(mon), M_CRASH_DOORS));
+    sig.flounders = !flies
+                    && mons_primary_habitat(mon) != HT_WATER
+                    && mons_habitat(mon, true) != HT_AMPHIBIOUS;
+    return sig;
+}
+
+// Cost of stepping onto p, or 0 if monsters with this signature can't.
+static int _flow_entry_cost(const flow_signature &sig, const coord_def &p)
+{
+    const dungeon_feature_type feat = grd(p);
+    if (feat == DNGN_CLOSED_DOOR || feat == DNGN_SEALED_DOOR)
+    {
+        if (!sig.doors
+            || env.markers.property_at(p, MAT_ANY, "door_restrict") == "veto")
         {
-            vec.erase(vec.begin() + i);
+            return 0;
+        }
+        return 2;
+    }
+
+    if (!sig.habitable[feat])
+        return 0;
+
+    // Monsters cannot travel over teleport traps or shafts.
+    const trap_def* ptrap = trap_at(p);
+    if (ptrap && (ptrap->type == TRAP_TELEPORT
+                  || ptrap->type == TRAP_TELEPORT_PERMANENT
+                  || ptrap->type == TRAP_SHAFT))
+    {
+        return 0;
+    }
+
+    return sig.flounders && feat_is_water(feat) ? 2 : 1;
+}
+
+static void _fill_player_flow(player_flow &flow)
+{
+    for (int x = 0; x < GXM; ++x)
+        for (int y = 0; y < GYM; ++y)
+            flow.dist[x][y] = INFINITE_DISTANCE;
+
+    flow.place = level_id::current();
+    flow.origin = you.pos();
+    flow.turn = you.num_turns;
+    flow.terrain_gen = _flow_terrain_gen;
+
+    // Entry costs are 1 or 2, so three rotating buckets are enough for an
+    // exact Dijkstra.
+    vector<coord_def> buckets[3];
+    int pending = 1;
+    flow.dist[you.pos().x][you.pos().y] = 0;
+    buckets[0].push_back(you.pos());
+
+    for (int d = 0; pending > 0; ++d)
+    {
+        vector<coord_def> &cur = buckets[d % 3];
+        while (!cur.empty())
+        {
+            const coord_def p = cur.back();
+            cur.pop_back();
+            --pending;
+            if (flow.dist[p.x][p.y] != d)
+                continue;
+
+            // Monsters adjacent to the player step onto (attack) its square.
+            const int cost = p == you.pos() ? 1 : _flow_entry_cost(flow.sig, p);
+            for (adjacent_iterator ai(p); ai; ++ai)
+            {
+                if (!in_bounds(*ai) || !_flow_entry_cost(flow.sig, *ai))
+                    continue;
+
+                const int nd = d + cost;
+                if (nd < flow.dist[ai->x][ai->y])
+                {
+                    flow.dist[ai->x][ai->y] = nd;
+                    buckets[nd % 3].push_back(*ai);
+                    ++pending;
+                }
+            }
+        }
+    }
+}
+
+static const player_flow& _get_player_flow(const flow_signature &sig)
+{
+    player_flow *flow = nullptr;
+    for (unsigned int i = 0; i < _player_flows.size(); ++i)
+    {
+        if (_player_flows[i]->sig == sig)
+        {
+            // Keep the most recently used fields at the front.
+            flow = _player_flows[i];
+            _player_flows.erase(_player_flows.begin() + i);
             break;
         }
     }
 
-    add_new_pos(npos, total);
+    if (!flow)
+    {
+        if (_player_flows.size() < MAX_PLAYER_FLOWS)
+            flow = new player_flow;
+        else
+        {
+            flow = _player_flows.back();
+            _player_flows.pop_back();
+        }
+        flow->sig = sig;
+        flow->turn = -1;
+    }
+    _player_flows.insert(_player_flows.begin(), flow);
+
+    if (flow->turn != you.num_turns || flow->origin != you.pos()
+        || flow->terrain_gen != _flow_terrain_gen
+        || flow->place != level_id::current())
+    {
+        _fill_player_flow(*flow);
+    }
+
+    return *flow;
+}
+
+// Picks the next step toward the player for a hostile monster from the shared
+// distance field of its movement class. Returns false if the field can't be
+// used for this monster, in which case the caller should do its own
+// pathfinding. As with monster_pathfind, a range of zero is unlimited and
+// paths longer than twice the range are not taken.
+bool player_flow_step(const monster* mon, int range, coord_def& step)
+{
+    if (mon->wont_attack() || mon->foe != MHITYOU
+        || mon->can_cling_to_walls() || !in_bounds(mon->pos()))
+    {
+        return false;
+    }
+
+    const flow_signature sig = _flow_signature(mon);
+    const player_flow &flow = _get_player_flow(sig);
+
+    const int here = flow.dist[mon->pos().x][mon->pos().y];
+    if (here == INFINITE_DISTANCE || range && here > range * 2)
+        return false;
+
+    int best = INFINITE_DISTANCE;
+    int ties = 0;
+    for (adjacent_iterator ai(mon->pos()); ai; ++ai)
+    {
+        if (!in_bounds(*ai))
+            continue;
+
+        const int there = flow.dist[ai->x][ai->y];
+        if (there == INFINITE_DISTANCE)
+            continue;
+
+        int total;
+        if (*ai == you.pos())
+            total = 1;
+        else
+        {
+            // The field was built for the whole class; make sure this
+            // particular monster can really go there.
+            if (!mons_can_traverse(mon, *ai) || opc_immob(*ai) == OPC_OPAQUE)
+                continue;
+            total = there + _flow_entry_cost(sig, *ai);
+        }
+
+        if (total < best)
+        {
+            best = total;
+            ties = 1;
+            step = *ai;
+        }
+        else if (total == best && one_chance_in(++ties))
+            step = *ai;
+    }
+
+    // Only trust the field if it actually leads somewhere from here.
+    return best <= here;
 }
@@ -2,14 +2,19 @@
 #define MON_PATHFIND_H
 
 class monster;
+struct pathfind_context;
 
 int mons_tracking_range(const monster* mon);
 
+bool player_flow_step(const monster* mon, int range, coord_def& step);
+void invalidate_player_flow();
+
 class monster_pathfind
 {
 public:
     monster_pathfind();
     virtual ~monster_pathfind();
+    DISALLOW_COPY_AND_ASSIGN(monster_pathfind);
 
     // public methods
     void set_range(int r);
@@ -35,6 +40,8 @@ protected:
     void add_new_pos(coord_def pos, int total);
     void update_pos(coord_def pos, int total);
     bool get_best_position();
+    int  dist_at(const coord_def& p) const;
+    void set_dist(const coord_def& p, int d);
 
     // The monster trying to find a path.
     const monster* mons;
@@ -61,12 +68,10 @@ protected:
     int min_length;
     int max_length;
 
-    // The array of distances from start to any already tried point.
-    int dist[GXM][GYM];
-    // An array to store where we came from on a given shortest path.
-    int prev[GXM][GYM];
-
-    FixedVector<vector<coord_def>, GXM * GYM> hash;
+    // Distance and backtracking grids plus the open set, borrowed from a
+    // pool for the lifetime of this object so that nothing level-sized
+    // has to be allocated or cleared per search.
+    pathfind_context *ctx;
 };
 
 #endif
@@ -1176,6 +1176,8 @@ monster* get_free_monster()
         if (mons.type == MONS_NO_MONSTER)
         {
             mons.reset();
+            env.mons_slots_used = max(env.mons_slots_used,
+                                      mons.mindex() + 1);
             return &mons;
         }
 
@@ -1240,20 +1242,29 @@ static monster* _place_monster_aux(const mgen_data &mg, const monster *leader,
     }
     else
     {
+        // Nothing changes while we look, so judge each cell of the box
+        // only the first time it is drawn: 1 if good, -1 if not.
+        int8_t judged[7][7] = {};
         int i;
         // We'll try 1000 times for a good spot.
         for (i = 0; i < 1000; ++i)
         {
             fpos = mg.pos + coord_def(random_range(-3, 3),
                                       random_range(-3, 3));
+            const coord_def delta = fpos - mg.pos;
+            int8_t &good = judged[delta.y + 3][delta.x + 3];
 
             // Place members within LOS_SOLID of their leader.
             // TODO nfm - allow placing around corners but not across walls.
-            if ((leader == 0 || cell_see_cell(fpos, leader->pos(), LOS_SOLID))
-                && _valid_monster_generation_location(mg, fpos))
+            if (!good)
             {
-                break;
+                good = (leader == 0
+                        || cell_see_cell(fpos, leader->pos(), LOS_SOLID))
+                       && _valid_monster_generation_location(mg, fpos)
+                       ? 1 : -1;
             }
+            if (good > 0)
+                break;
         }
 
         // Did we really try 1000 times?
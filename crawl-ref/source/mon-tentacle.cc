@@ -618,22 +618,48 @@ static void _collect_tentacles(monster* mons,
             tentacles.push_back(mi);
 }
 
-static void _purge_connectors(monster* tentacle)
+// Kill the given segments of the tentacle, in order, skipping any that are
+// already gone or no longer belong to it.
+static void _purge_connectors(monster* tentacle,
+                              const vector<monster*> &connectors)
 {
-    for (monster_iterator mi; mi; ++mi)
+    for (monster *seg : connectors)
     {
-        if (mi->is_child_tentacle_of(tentacle))
+        if (seg->alive() && seg->is_child_tentacle_of(tentacle))
         {
-            int hp = mi->hit_points;
+            int hp = seg->hit_points;
             if (hp > 0 && hp < tentacle->hit_points)
                 tentacle->hit_points = hp;
 
-            monster_die(*mi, KILL_MISC, NON_MONSTER, true);
+            monster_die(seg, KILL_MISC, NON_MONSTER, true);
         }
     }
     ASSERT(tentacle->alive());
 }
 
+static void _purge_connectors(monster* tentacle)
+{
+    vector<monster*> connectors;
+    for (monster_iterator mi; mi; ++mi)
+        if (mi->is_child_tentacle_of(tentacle))
+            connectors.push_back(*mi);
+    _purge_connectors(tentacle, connectors);
+}
+
+// Segments of every tentacle of a head, keyed by tentacle mid, each list in
+// monster index order. One pass instead of one per tentacle.
+static void _collect_connectors(const vector<monster_iterator> &tentacles,
+                                map<mid_t, vector<monster*> > &connectors)
+{
+    set<mid_t> tentacle_mids;
+    for (const monster_iterator &tent : tentacles)
+        tentacle_mids.insert(tent->mid);
+
+    for (monster_iterator mi; mi; ++mi)
+        if (tentacle_mids.count(mi->tentacle_connect))
+            connectors[mi->tentacle_connect].push_back(*mi);
+}
+
 struct complicated_sight_check
 {
     coord_def base_position;
@@ -976,6 +1002,8 @@ void move_child_tentacles(monster* mons)
     }
     vector<monster_iterator> tentacles;
     _collect_tentacles(mons, tentacles);
+    map<mid_t, vector<monster*> > connectors;
+    _collect_connectors(tentacles, connectors);
 
     // Move each tentacle in turn
     for (monster_iterator &tent_it : tentacles)
@@ -1025,7 +1053,10 @@ void move_child_tentacles(monster* mons)
             current_count++;
         }
 
-        _purge_connectors(tentacle);
+        if (tentacle == *tent_it)
+            _purge_connectors(tentacle, connectors[tentacle->mid]);
+        else
+            _purge_connectors(tentacle);
 
         if (no_foe
             && grid_distance(tentacle->pos(), mons->pos()) == 1)
@@ -226,9 +226,10 @@ void place_transiting_items()
     if (!transit)
         return;
 
-    i_transit_list keep;
-    for (item_def &item : *transit)
+    // Only unplaceable items are kept in the list.
+    for (auto i = transit->begin(); i != transit->end();)
     {
+        item_def &item = *i;
         coord_def pos = item.pos;
 
         if (!in_bounds(pos))
@@ -238,13 +239,11 @@ void place_transiting_items()
             dgn_find_nearby_stair(DNGN_ESCAPE_HATCH_DOWN,
                                   pos, true);
 
-        // List of items we couldn't place.
-        if (!copy_item_to_grid(item, where_to_go, -1, false, true))
-            keep.push_back(item);
+        if (copy_item_to_grid(item, where_to_go, -1, false, true))
+            i = transit->erase(i);
+        else
+            ++i;
     }
-
-    // Only unplaceable items are kept in list.
-    *transit = keep;
 }
 
 void apply_daction_to_transit(daction_type act)
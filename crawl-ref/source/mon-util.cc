@@ -388,7 +388,12 @@ resists_t get_mons_resists(const monster* mon)
 
     // This is set from here in case they're undead due to the
     // MF_FAKE_UNDEAD flag. See the comment in get_mons_class_resists.
-    return _apply_holiness_resists(resists, mon->holiness());
+    // Only the undead, nonliving and natural bits matter here, and beyond
+    // that flag monster::holiness() only adds holy and evil, so skip its
+    // priest and attack flavour checks.
+    const mon_holy_type holi = testbits(mon->flags, MF_FAKE_UNDEAD)
+                               ? MH_UNDEAD : mons_class_holiness(mon->type);
+    return _apply_holiness_resists(resists, holi);
 }
 
 int get_mons_resist(const monster* mon, mon_resist_flags res)
@@ -5163,6 +5168,8 @@ void reset_all_monsters()
         mons.reset();
     }
 
+    env.mons_slots_used = 0;
+    mons_index_clear();
     env.mid_cache.clear();
 }
 
@@ -143,7 +143,9 @@ void monster::reset()
 
     mons_remove_from_grid(this);
     target.reset();
+    const coord_def oldpos = position;
     position.reset();
+    mons_index_moved(this, oldpos);
     firing_pos.reset();
     patrol_point.reset();
     travel_target = MTRAV_NONE;
@@ -176,6 +178,7 @@ void monster::init_with(const monster& mon)
     speed             = mon.speed;
     speed_increment   = mon.speed_increment;
     position          = mon.position;
+    mons_index_moved(this, coord_def());
     target            = mon.target;
     firing_pos        = mon.firing_pos;
     patrol_point      = mon.patrol_point;
@@ -554,4 +554,5 @@ static void _setup_generic(const newgame_def& ng)
     else
         you.save = new package(get_savedir_filename(you.your_name).c_str(),
                                true, true);
+    you.save->start_write_thread();
 }
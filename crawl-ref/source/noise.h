@@ -82,6 +82,10 @@ struct noise_cell
     int noise_intensity_millis;
     int noise_travel_distance;
 
+    // The noise_grid generation this cell was last written in; cells from
+    // older generations are treated as silent.
+    uint32_t generation;
+
     noise_cell();
     bool can_apply_noise(int noise_intensity_millis) const;
     bool apply_noise(int noise_intensity_millis,
@@ -120,7 +124,8 @@ public:
     // Propagate noise from the noise sources registered.
     void propagate_noise();
 
-    // Clear all noise from the noise grid.
+    // Clear all noise from the noise grid. This only bumps the grid's
+    // generation, so it is cheap however much of the level was noisy.
     void reset();
 
     bool dirty() const { return !noises.empty(); }
@@ -132,6 +137,18 @@ public:
 #endif
 
 private:
+    noise_cell &cell_at(const coord_def &pos);
+    const noise_cell &cell_at(const coord_def &pos) const;
+
+    bool in_audible_box(const coord_def &pos) const
+    {
+        return pos.x >= audible_tl.x && pos.x <= audible_br.x
+               && pos.y >= audible_tl.y && pos.y <= audible_br.y;
+    }
+
+    void push_frontier(const coord_def &pos);
+    coord_def pop_frontier();
+
     bool propagate_noise_to_neighbour(int base_attenuation,
                                       int travel_distance,
                                       const noise_cell &cell,
@@ -150,6 +167,16 @@ private:
     FixedArray<noise_cell, GXM, GYM> cells;
     vector<noise_t> noises;
     int affected_actor_count;
+    uint32_t generation;
+
+    // Bounding box (inclusive, clipped to in_bounds()) of the squares that
+    // any registered noise could possibly reach.
+    coord_def audible_tl, audible_br;
+
+    // Ring buffer of squares still to propagate from. A square is queued at
+    // most once per step of travel distance, so two full steps always fit.
+    FixedVector<coord_def, 2 * X_WIDTH * Y_WIDTH> frontier;
+    int frontier_head, frontier_size;
 };
 
 #endif
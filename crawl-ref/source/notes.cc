@@ -17,6 +17,7 @@
 #include "message.h"
 #include "mutation.h"
 #include "options.h"
+#include "package.h"
 #include "religion.h"
 #include "skills.h"
 #include "spl-util.h"
@@ -26,6 +27,11 @@
 
 #define NOTES_VERSION_NUMBER 1002
 
+// Notes come in blocks of this many. Each full block is saved once, in a
+// chunk of its own, and the notes chunk proper only holds those after the
+// last full block.
+#define NOTE_BLOCK_SIZE 1024
+
 vector<Note> note_list;
 
 static bool _is_highest_skill(int skill)
@@ -462,26 +468,77 @@ void activate_notes(bool active)
     notes_active = active;
 }
 
+static string _note_block_chunk(int block)
+{
+    return make_stringf("nts%d", block);
+}
+
+static void _load_note_range(reader& inf, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        Note new_note;
+        new_note.load(inf);
+        note_list.push_back(new_note);
+    }
+}
+
+// Write out any full block of notes the save does not have yet. Notes are
+// only ever appended, so a block already in the save never changes.
+void save_note_blocks(package *save)
+{
+    const int blocks = note_list.size() / NOTE_BLOCK_SIZE;
+    for (int block = 0; block < blocks; ++block)
+    {
+        const string chunk = _note_block_chunk(block);
+        if (save->has_chunk(chunk))
+            continue;
+
+        writer outf(save, chunk);
+        // Blocks outlive the save they were written with, so each records
+        // the format its notes are in.
+        marshallUByte(outf, TAG_MINOR_VERSION);
+        for (int i = block * NOTE_BLOCK_SIZE; i < (block + 1) * NOTE_BLOCK_SIZE;
+             ++i)
+        {
+            note_list[i].save(outf);
+        }
+    }
+}
+
 void save_notes(writer& outf)
 {
     marshallInt(outf, NOTES_VERSION_NUMBER);
     marshallInt(outf, note_list.size());
-    for (const Note &note : note_list)
-        note.save(outf);
+    for (size_t i = note_list.size() / NOTE_BLOCK_SIZE * NOTE_BLOCK_SIZE;
+         i < note_list.size(); ++i)
+    {
+        note_list[i].save(outf);
+    }
 }
 
-void load_notes(reader& inf)
+void load_notes(reader& inf, package *save)
 {
     if (unmarshallInt(inf) != NOTES_VERSION_NUMBER)
         return;
 
     const int num_notes = unmarshallInt(inf);
-    for (int i = 0; i < num_notes; ++i)
+#if TAG_MAJOR_VERSION == 34
+    if (inf.getMinorVersion() < TAG_MINOR_NOTE_BLOCKS)
     {
-        Note new_note;
-        new_note.load(inf);
-        note_list.push_back(new_note);
+        _load_note_range(inf, num_notes);
+        return;
+    }
+#endif
+
+    const int blocks = num_notes / NOTE_BLOCK_SIZE;
+    for (int block = 0; block < blocks; ++block)
+    {
+        reader blockf(save, _note_block_chunk(block));
+        blockf.setMinorVersion(unmarshallUByte(blockf));
+        _load_note_range(blockf, NOTE_BLOCK_SIZE);
     }
+    _load_note_range(inf, num_notes - blocks * NOTE_BLOCK_SIZE);
 }
 
 void make_user_note()
@@ -14,6 +14,7 @@
 
 #define MAX_NOTE_PLACE_LEN 8
 
+class package;
 class reader;
 class writer;
 
@@ -84,8 +85,9 @@ extern vector<Note> note_list;
 void activate_notes(bool active);
 bool notes_are_active();
 void take_note(const Note& note, bool force = false);
+void save_note_blocks(package *save);
 void save_notes(writer&);
-void load_notes(reader&);
+void load_notes(reader&, package *save);
 void make_user_note();
 
 /**
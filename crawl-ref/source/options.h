@@ -289,6 +289,7 @@ public:
     int         travel_delay;   // How long to pause between travel moves
     int         explore_delay;  // How long to pause between explore moves
     int         rest_delay;     // How long to pause between rest moves
+    int         runrest_redraw_rate; // Min ms between redraws while running
 
     bool        show_travel_trail;
 
@@ -298,6 +299,8 @@ public:
     bool        arena_dump_msgs_all;
     bool        arena_list_eq;
 
+    int         monster_sim_horizon; // 0: every monster acts every turn
+
     vector<message_filter> force_more_message;
     vector<message_filter> flash_screen_message;
     vector<text_pattern> confirm_action;
@@ -434,6 +437,8 @@ public:
     string      fsim_mode;
     bool        fsim_csv;
     int         fsim_rounds;
+    int         fsim_jobs;
+    int         fsim_precision;
     string      fsim_mons;
     vector<string> fsim_scale;
     vector<string> fsim_kit;
@@ -539,6 +544,35 @@ private:
     set<string>    constants; // Variables that can't be changed
     set<string>    included;  // Files we've included already.
 
+    struct channel_colour_set
+    {
+        channel_colour_set() : catch_all(-1) { }
+
+        // The message_colour_mappings entries for this channel, up to the
+        // first with no pattern; patterns holds their patterns.
+        vector<int>      entries;
+        text_pattern_set patterns;
+        int              catch_all;
+    };
+
+    // The patterns of a message_filter list that apply to one channel.
+    struct channel_filter_set
+    {
+        channel_filter_set() : catch_all(false) { }
+
+        text_pattern_set patterns;
+        bool             catch_all;
+    };
+
+    mutable bool             pattern_sets_stale;
+    mutable text_pattern_set force_autopickup_patterns;
+    mutable text_pattern_set note_messages_patterns;
+    mutable text_pattern_set autoinscriptions_patterns;
+    mutable text_pattern_set explore_stop_pickup_ignore_patterns;
+    mutable map<int, channel_colour_set> message_colour_sets;
+    mutable map<int, channel_filter_set> force_more_sets;
+    mutable map<int, channel_filter_set> flash_screen_sets;
+
 public:
     // Convenience accessors for the second-class options in named_options.
     int         o_int(const char *name, int def = 0) const;
@@ -546,6 +580,20 @@ public:
     string      o_str(const char *name, const char *def = nullptr) const;
     int         o_colour(const char *name, int def = LIGHTGREY) const;
 
+    // Pattern lists compiled for matching, rebuilt on first use after an
+    // option line has been read.
+    const text_pattern_set &force_autopickup_set() const;
+    const text_pattern_set &note_messages_set() const;
+    const text_pattern_set &autoinscriptions_set() const;
+    const text_pattern_set &explore_stop_pickup_ignore_set() const;
+    // The first message_colour_mappings entry that applies to a message on
+    // the given channel, or -1 if none does.
+    int message_colour_index(int channel, const string &message) const;
+    // Whether a message on the given channel matches force_more_message
+    // or flash_screen_message.
+    bool force_more_matches(int channel, const string &message) const;
+    bool flash_screen_matches(int channel, const string &message) const;
+
     // Fix option values if necessary, specifically file paths.
     void fixup_options();
 
@@ -560,6 +608,10 @@ private:
     void add_feature_override(const string &, bool prepend);
     void remove_feature_override(const string &, bool prepend);
 
+    void update_pattern_sets() const;
+    bool filter_set_matches(map<int, channel_filter_set> &sets,
+                            const vector<message_filter> &filters,
+                            int channel, const string &message) const;
     void add_message_colour_mappings(const string &, bool, bool);
     void add_message_colour_mapping(const string &, bool, bool);
     message_filter parse_message_filter(const string &s);
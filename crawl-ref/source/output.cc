@@ -1225,6 +1225,19 @@ static void _redraw_title()
     textcolour(LIGHTGREY);
 }
 
+// What the experience and gold lines were last drawn with. Their redraw
+// flags get set far more often than what they show changes, so print_stats
+// compares these instead. draw_border() clears the screen, and so resets
+// them; -1 means the line has not been drawn since.
+struct drawn_stat_lines
+{
+    int xl = -1;
+    int exp_progress = -1;
+    int gold = -1;
+    bool gold_aura = false;
+};
+static drawn_stat_lines _drawn_lines;
+
 void print_stats()
 {
 #if TAG_MAJOR_VERSION == 34
@@ -1312,7 +1325,11 @@ void print_stats()
         }
     you.redraw_stats.init(false);
 
-    if (you.redraw_experience)
+    const int exp_progress = you.experience_level >= you.get_max_xl()
+                             ? -1 : get_exp_progress();
+    if (you.redraw_experience
+        && (_drawn_lines.xl != you.experience_level
+            || _drawn_lines.exp_progress != exp_progress))
     {
 #if TAG_MAJOR_VERSION == 34
         CGOTOXY(1, 8 + temp, GOTO_STAT);
@@ -1323,17 +1340,19 @@ void print_stats()
         CPRINTF("XL: ");
         textcolour(HUD_VALUE_COLOUR);
         CPRINTF("%2d ", you.experience_level);
-        if (you.experience_level >= you.get_max_xl())
+        if (exp_progress < 0)
             CPRINTF("%10s", "");
         else
         {
             textcolour(Options.status_caption_colour);
             CPRINTF("Next: ");
             textcolour(HUD_VALUE_COLOUR);
-            CPRINTF("%2d%% ", get_exp_progress());
+            CPRINTF("%2d%% ", exp_progress);
         }
-        you.redraw_experience = false;
+        _drawn_lines.xl = you.experience_level;
+        _drawn_lines.exp_progress = exp_progress;
     }
+    you.redraw_experience = false;
 
 #if TAG_MAJOR_VERSION == 34
     int yhack = temp;
@@ -1348,12 +1367,16 @@ void print_stats()
     {
         // Increase y-value for all following lines.
         yhack++;
-        CGOTOXY(1+6, 8 + yhack, GOTO_STAT);
-        if (you.duration[DUR_GOZAG_GOLD_AURA])
-            textcolour(LIGHTBLUE);
-        else
-            textcolour(HUD_VALUE_COLOUR);
-        CPRINTF("%-6d", you.gold);
+        const bool gold_aura = you.duration[DUR_GOZAG_GOLD_AURA];
+        if (_drawn_lines.gold != you.gold
+            || _drawn_lines.gold_aura != gold_aura)
+        {
+            CGOTOXY(1+6, 8 + yhack, GOTO_STAT);
+            textcolour(gold_aura ? LIGHTBLUE : HUD_VALUE_COLOUR);
+            CPRINTF("%-6d", you.gold);
+            _drawn_lines.gold = you.gold;
+            _drawn_lines.gold_aura = gold_aura;
+        }
     }
 
     if (you.wield_change)
@@ -1434,6 +1457,7 @@ void draw_border()
 {
     textcolour(HUD_CAPTION_COLOUR);
     clrscr();
+    _drawn_lines = drawn_stat_lines();
 
     textcolour(Options.status_caption_colour);
 
@@ -27,6 +27,9 @@ Notes:
 #include <cstring>
 #include <sstream>
 #include <fcntl.h>
+#ifdef USE_MMAP
+#include <sys/mman.h>
+#endif
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -56,9 +59,12 @@ static plen_t htole(plen_t x)
 #define dprintf(...) do {} while (0)
 #endif
 
-#define PACKAGE_VERSION 1
+#define PACKAGE_VERSION 3
 #define PACKAGE_MAGIC   0x53534344 /* "DCSS" */
 
+// Faster than zlib's default and still a bit smaller.
+#define ZSTD_SAVE_LEVEL 1
+
 struct file_header
 {
     uint32_t magic;
@@ -73,6 +79,18 @@ struct block_header
     plen_t next;
 };
 
+chunk_codec package::default_codec = CODEC_ZLIB;
+
+// Keeps the write thread off the file and block lists while it's alive.
+class io_guard
+{
+public:
+    io_guard(package *p) : pkg(p) { pkg->lock_io(); }
+    ~io_guard() { pkg->unlock_io(); }
+private:
+    package *pkg;
+};
+
 typedef map<string, plen_t> directory_t;
 typedef pair<plen_t, plen_t> bm_p;
 typedef map<plen_t, bm_p> bm_t;
@@ -83,6 +101,12 @@ package::package(const char* file, bool writeable, bool empty)
 #ifdef DO_FSYNC
     , tmp(false)
 #endif
+#ifdef USE_MMAP
+    , mapping(nullptr), mapping_len(0)
+#endif
+#ifdef USE_SAVE_THREAD
+    , background(false)
+#endif
 {
     dprintf("package: initializing file=\"%s\" rw=%d\n", file, writeable);
     ASSERT(writeable || !empty);
@@ -130,6 +154,12 @@ package::package()
 #ifdef DO_FSYNC
     , tmp(true)
 #endif
+#ifdef USE_MMAP
+    , mapping(nullptr), mapping_len(0)
+#endif
+#ifdef USE_SAVE_THREAD
+    , background(false)
+#endif
 {
     dprintf("package: initializing tmp file\n");
     filename = "[tmp]";
@@ -174,12 +204,72 @@ void package::load()
     if (len == -1)
         sysfail("save file (%s) is not seekable", filename.c_str());
     file_len = len;
+#ifdef USE_MMAP
+    if (!rw)
+        map_file();
+#endif
     read_directory(htole(head.start), head.version);
 
     if (rw)
         load_traces();
 }
 
+#ifdef USE_MMAP
+// A read-only package never changes the file under us, so the whole of it
+// can be mapped once and blocks served straight from the page cache.
+// Failure isn't fatal: we just keep using read().
+void package::map_file()
+{
+    ASSERT(!rw);
+    if (!file_len)
+        return;
+    void *m = mmap(nullptr, file_len, PROT_READ, MAP_SHARED, fd, 0);
+    if (m == MAP_FAILED)
+    {
+        dprintf("package: mmap failed, falling back to read()\n");
+        return;
+    }
+    mapping = (const char*)m;
+    mapping_len = file_len;
+}
+
+const char *package::map_span(plen_t at, plen_t len) const
+{
+    ASSERT(mapping);
+    if (at > mapping_len || len > mapping_len - at)
+        corrupted("save file corrupted -- block past eof");
+    return mapping + at;
+}
+#endif
+
+void package::read_raw(plen_t at, void *data, plen_t len)
+{
+    io_guard guard(this);
+#ifdef USE_MMAP
+    if (mapping)
+    {
+        memcpy(data, map_span(at, len), len);
+        return;
+    }
+#endif
+#ifdef TARGET_OS_WINDOWS
+    seek(at);
+    ssize_t res = ::read(fd, data, len);
+#else
+    // Every write seeks first, so reads need not move the file offset;
+    // pread() halves the syscalls of walking block headers in
+    // load_traces().
+    ASSERT(!aborted);
+    if (at > file_len)
+        corrupted("save file corrupted -- invalid offset");
+    ssize_t res = ::pread(fd, data, len, at);
+#endif
+    if (res < 0)
+        sysfail("error reading the save file");
+    if ((plen_t)res != len)
+        corrupted("save file corrupted -- block past eof");
+}
+
 void package::load_traces()
 {
     ASSERT(!dirty);
@@ -208,6 +298,12 @@ package::~package()
         // catching missing manual deletes. The C++ exit handler is the
         // only place that can be legitimately call things in wrong order.
 
+#ifdef USE_SAVE_THREAD
+    // Everything queued goes to disk before the final commit below.
+    if (background)
+        stop_write_thread();
+#endif
+
     if (rw && !aborted)
     {
         commit();
@@ -215,6 +311,11 @@ package::~package()
             sysfail("failed to update save file");
     }
 
+#ifdef USE_MMAP
+    if (mapping)
+        munmap((void*)mapping, mapping_len);
+#endif
+
     // all errors here should be cached write errors
     if (fd != -1)
         if (close(fd) && !aborted)
@@ -226,6 +327,25 @@ package::~package()
 }
 
 void package::commit()
+{
+    ASSERT(rw);
+#ifdef USE_SAVE_THREAD
+    if (background)
+    {
+        // Only one commit may be in flight, so a crash can't lose more
+        // than the latest one -- the same as when committing in place.
+        wait_write_thread(false);
+        pending_chunk job;
+        job.codec = CODEC_ZLIB;
+        job.commit = true;
+        queue_job(move(job));
+        return;
+    }
+#endif
+    commit_now();
+}
+
+void package::commit_now()
 {
     ASSERT(rw);
     if (!dirty)
@@ -263,6 +383,168 @@ void package::commit()
 #endif
 }
 
+// Hands chunk compression, writes and commits to a thread of their own, so
+// the game doesn't wait for deflate and fsync on every level change. Only
+// the game save does this; it's fine for everything else to block.
+void package::start_write_thread()
+{
+#ifdef USE_SAVE_THREAD
+    ASSERT(rw);
+    ASSERT(!n_users);
+    if (background)
+        return;
+
+    bg_quit = false;
+    bg_busy = false;
+    bg_commits = 0;
+    mutex_init(bg_mutex);
+    mutex_init(io_mutex);
+    cond_init(bg_wake);
+    cond_init(bg_done);
+    background = true;
+    if (thread_create_joinable(&bg_thread, write_thread, this))
+    {
+        // if thread creation fails, keep writing in place
+        background = false;
+        cond_destroy(bg_done);
+        cond_destroy(bg_wake);
+        mutex_destroy(io_mutex);
+        mutex_destroy(bg_mutex);
+    }
+#endif
+}
+
+// Waits until everything queued so far is on disk (or, at least, written
+// and committed as far as fsync gets us).
+void package::sync()
+{
+#ifdef USE_SAVE_THREAD
+    if (background)
+        wait_write_thread(true);
+#endif
+}
+
+void package::lock_io()
+{
+#ifdef USE_SAVE_THREAD
+    if (background)
+        mutex_lock(io_mutex);
+#endif
+}
+
+void package::unlock_io()
+{
+#ifdef USE_SAVE_THREAD
+    if (background)
+        mutex_unlock(io_mutex);
+#endif
+}
+
+#ifdef USE_SAVE_THREAD
+void *package::write_thread(void *pkg)
+{
+    static_cast<package*>(pkg)->run_write_thread();
+    return nullptr;
+}
+
+void package::run_write_thread()
+{
+    mutex_lock(bg_mutex);
+    while (true)
+    {
+        while (bg_queue.empty() && !bg_quit)
+            cond_wait(bg_wake, bg_mutex);
+        if (bg_queue.empty())
+            break;
+
+        pending_chunk job = move(bg_queue.front());
+        bg_queue.pop_front();
+        bg_busy = true;
+        // After a failure, drop the rest until the game thread notices.
+        const bool failed = !bg_error.empty();
+        mutex_unlock(bg_mutex);
+
+        string error;
+        if (!failed)
+        {
+            mutex_lock(io_mutex);
+            try
+            {
+                if (job.commit)
+                    commit_now();
+                else
+                {
+                    chunk_writer w(this, job.name, job.codec, false);
+                    if (!job.data.empty())
+                        w.write(&job.data[0], job.data.size());
+                }
+            }
+            catch (ext_fail_exception &fe)
+            {
+                error = fe.msg;
+            }
+            mutex_unlock(io_mutex);
+        }
+
+        mutex_lock(bg_mutex);
+        if (!error.empty())
+            bg_error = error;
+        if (job.commit)
+            bg_commits--;
+        bg_busy = false;
+        cond_wake(bg_done);
+    }
+    mutex_unlock(bg_mutex);
+}
+
+void package::queue_job(pending_chunk &&job)
+{
+    mutex_lock(bg_mutex);
+    if (job.commit)
+        bg_commits++;
+    bg_queue.push_back(move(job));
+    cond_wake(bg_wake);
+    mutex_unlock(bg_mutex);
+}
+
+// Blocks until either the whole queue or just the pending commit is done,
+// then passes on any error the write thread ran into.
+void package::wait_write_thread(bool everything)
+{
+    mutex_lock(bg_mutex);
+    while (everything ? !bg_queue.empty() || bg_busy : bg_commits > 0)
+        cond_wait(bg_done, bg_mutex);
+    string error;
+    swap(error, bg_error);
+    mutex_unlock(bg_mutex);
+
+    if (!error.empty())
+        fail("%s", error.c_str());
+}
+
+void package::stop_write_thread()
+{
+    string error;
+    mutex_lock(bg_mutex);
+    while (!bg_queue.empty() || bg_busy)
+        cond_wait(bg_done, bg_mutex);
+    swap(error, bg_error);
+    bg_quit = true;
+    cond_wake(bg_wake);
+    mutex_unlock(bg_mutex);
+    thread_join(bg_thread);
+
+    background = false;
+    cond_destroy(bg_done);
+    cond_destroy(bg_wake);
+    mutex_destroy(io_mutex);
+    mutex_destroy(bg_mutex);
+
+    if (!error.empty() && !aborted)
+        fail("%s", error.c_str());
+}
+#endif
+
 void package::seek(plen_t to)
 {
     ASSERT(!aborted);
@@ -275,11 +557,19 @@ void package::seek(plen_t to)
 
 chunk_writer* package::writer(const string &name)
 {
-    return new chunk_writer(this, name);
+    return new chunk_writer(this, name,
+                            name.empty() ? CODEC_ZLIB : default_codec,
+#ifdef USE_SAVE_THREAD
+                            background
+#else
+                            false
+#endif
+                            );
 }
 
 chunk_reader* package::reader(const string &name)
 {
+    sync();
     if (plen_t *ch = map_find(directory, name))
         return new chunk_reader(this, *ch);
     return 0;
@@ -353,10 +643,16 @@ plen_t package::alloc_block(plen_t &size)
     return at;
 }
 
-void package::finish_chunk(const string &name, plen_t at)
+void package::finish_chunk(const string &name, plen_t at, plen_t len,
+                           chunk_codec codec)
 {
     free_chunk(name);
     directory[name] = at;
+    chunk_lengths[name] = len;
+    if (codec == CODEC_ZLIB)
+        chunk_codecs.erase(name);
+    else
+        chunk_codecs[name] = codec;
     new_chunks.insert(at);
     dirty = true;
 }
@@ -377,14 +673,22 @@ void package::free_chunk(const string &name)
 }
 
 void package::delete_chunk(const string &name)
+{
+    sync();
+    erase_chunk(name);
+}
+
+void package::erase_chunk(const string &name)
 {
     free_chunk(name);
     directory.erase(name);
+    chunk_lengths.erase(name);
+    chunk_codecs.erase(name);
 }
 
 plen_t package::write_directory()
 {
-    delete_chunk("");
+    erase_chunk("");
 
     stringstream dir;
     for (const auto &entry : directory)
@@ -394,6 +698,13 @@ plen_t package::write_directory()
         dir.write(&entry.first[0], entry.first.length());
         plen_t start = htole(entry.second);
         dir.write((const char*)&start, sizeof(plen_t));
+        // Chunks carried over from an old directory have no known length;
+        // they get rewritten on the next save anyway.
+        const plen_t *len = map_find(chunk_lengths, entry.first);
+        plen_t raw_len = htole(len ? *len : (plen_t)-1);
+        dir.write((const char*)&raw_len, sizeof(plen_t));
+        uint8_t codec = get_chunk_codec(entry.first);
+        dir.write((const char*)&codec, sizeof(codec));
     }
 
     ASSERT(dir.str().size());
@@ -534,8 +845,10 @@ void package::read_directory(plen_t start, uint8_t version)
         }
         break;
     case 1:
-        uint8_t name_len;
-        plen_t bstart;
+    case 2:
+    case 3:
+        uint8_t name_len, codec;
+        plen_t bstart, blen;
         while (plen_t res = rd.read(&name_len, sizeof(name_len)))
         {
             if (res != sizeof(name_len))
@@ -547,6 +860,25 @@ void package::read_directory(plen_t start, uint8_t version)
             if (rd.read(&bstart, sizeof(bstart)) != sizeof(bstart))
                 corrupted("save file corrupted -- truncated directory");
             directory[chname] = htole(bstart);
+            if (version >= 2)
+            {
+                if (rd.read(&blen, sizeof(blen)) != sizeof(blen))
+                    corrupted("save file corrupted -- truncated directory");
+                if (htole(blen) != (plen_t)-1)
+                    chunk_lengths[chname] = htole(blen);
+            }
+            if (version >= 3)
+            {
+                if (rd.read(&codec, sizeof(codec)) != sizeof(codec))
+                    corrupted("save file corrupted -- truncated directory");
+                if (codec >= NUM_CHUNK_CODECS)
+                {
+                    corrupted("save file (%s) uses an unknown compression %u",
+                              filename.c_str(), codec);
+                }
+                if (codec != CODEC_ZLIB)
+                    chunk_codecs[chname] = (chunk_codec)codec;
+            }
             dprintf("* %s\n", chname.c_str());
         }
         break;
@@ -556,13 +888,31 @@ void package::read_directory(plen_t start, uint8_t version)
     }
 }
 
+// The uncompressed length of a chunk, if the directory recorded it.
+bool package::get_chunk_length(const string &name, plen_t &len) const
+{
+    const plen_t *l = map_find(chunk_lengths, name);
+    if (!l)
+        return false;
+    len = *l;
+    return true;
+}
+
+chunk_codec package::get_chunk_codec(const string &name) const
+{
+    const chunk_codec *c = map_find(chunk_codecs, name);
+    return c ? *c : CODEC_ZLIB;
+}
+
 bool package::has_chunk(const string &name)
 {
+    sync();
     return !name.empty() && directory.count(name);
 }
 
 vector<string> package::list_chunks()
 {
+    sync();
     vector<string> list;
     list.reserve(directory.size());
     for (const auto &entry : directory)
@@ -577,12 +927,7 @@ void package::trace_chunk(plen_t start)
     while (start)
     {
         block_header bl;
-        seek(start);
-        ssize_t res = ::read(fd, &bl, sizeof(block_header));
-        if (res < 0)
-            sysfail("error reading the save file");
-        if (res != sizeof(block_header))
-            corrupted("save file corrupted -- block past eof");
+        read_raw(start, &bl, sizeof(block_header));
 
         plen_t len  = htole(bl.len);
         plen_t next = htole(bl.next);
@@ -613,6 +958,18 @@ void package::abort()
     // Disable any further operations, allow a shutdown. All errors past
     // this point are ignored (assuming we already failed). All writes since
     // the last commit() are lost.
+#ifdef USE_SAVE_THREAD
+    if (background)
+    {
+        mutex_lock(bg_mutex);
+        bg_queue.clear();
+        while (bg_busy)
+            cond_wait(bg_done, bg_mutex);
+        bg_commits = 0;
+        bg_error.clear();
+        mutex_unlock(bg_mutex);
+    }
+#endif
     aborted = true;
 }
 
@@ -627,6 +984,7 @@ void package::unlink()
 // the amount of free space not at the end of file
 plen_t package::get_slack()
 {
+    sync();
     load_traces();
 
     plen_t slack = 0;
@@ -637,6 +995,7 @@ plen_t package::get_slack()
 
 plen_t package::get_chunk_fragmentation(const string &name)
 {
+    sync();
     load_traces();
     ASSERT(directory.count(name)); // not has_chunk(), "" is valid
     plen_t frags = 0;
@@ -653,6 +1012,7 @@ plen_t package::get_chunk_fragmentation(const string &name)
 
 plen_t package::get_chunk_compressed_length(const string &name)
 {
+    sync();
     load_traces();
     ASSERT(directory.count(name)); // not has_chunk(), "" is valid
     plen_t len = 0;
@@ -668,7 +1028,16 @@ plen_t package::get_chunk_compressed_length(const string &name)
 }
 
 chunk_writer::chunk_writer(package *parent, const string &_name)
-    : first_block(0), cur_block(0), block_len(0)
+    // the directory is read before we know any codecs
+    : chunk_writer(parent, _name,
+                   _name.empty() ? CODEC_ZLIB : package::default_codec, false)
+{
+}
+
+chunk_writer::chunk_writer(package *parent, const string &_name,
+                           chunk_codec _codec, bool _deferred)
+    : first_block(0), cur_block(0), block_len(0), raw_len(0),
+      codec(_codec), deferred(_deferred)
 {
     ASSERT(parent);
     ASSERT(!parent->aborted);
@@ -679,18 +1048,41 @@ chunk_writer::chunk_writer(package *parent, const string &_name)
 
     dprintf("chunk_writer(%s): starting\n", _name.c_str());
     pkg = parent;
-    pkg->n_users++;
     name = _name;
+    if (deferred)
+        return;
+    pkg->n_users++;
 
 #ifdef USE_ZLIB
+#define ZB_SIZE 32768
+    z_buffer = (Bytef*)malloc(ZB_SIZE);
+#ifdef USE_ZSTD
+    zcs = nullptr;
+    if (codec == CODEC_ZSTD)
+    {
+        zcs = ZSTD_createCStream();
+        if (!zcs)
+            fail("save file compression failed during init");
+        size_t res = ZSTD_initCStream(zcs, ZSTD_SAVE_LEVEL);
+        if (ZSTD_isError(res))
+        {
+            fail("save file compression failed during init: %s",
+                 ZSTD_getErrorName(res));
+        }
+        zout.dst  = z_buffer;
+        zout.size = ZB_SIZE;
+        zout.pos  = 0;
+        return;
+    }
+#endif
+    ASSERT(codec == CODEC_ZLIB);
     zs.data_type = Z_BINARY;
     zs.zalloc    = 0;
     zs.zfree     = 0;
     zs.opaque    = Z_NULL;
     if (deflateInit(&zs, Z_DEFAULT_COMPRESSION))
         fail("save file compression failed during init: %s", zs.msg);
-#define ZB_SIZE 32768
-    zs.next_out  = z_buffer = (Bytef*)malloc(ZB_SIZE);
+    zs.next_out  = z_buffer;
     zs.avail_out = ZB_SIZE;
 #endif
 }
@@ -699,37 +1091,72 @@ chunk_writer::~chunk_writer()
 {
     dprintf("chunk_writer(%s): closing\n", name.c_str());
 
+    if (deferred)
+    {
+#ifdef USE_SAVE_THREAD
+        if (!pkg->aborted)
+            pkg->queue_job({name, codec, move(pending), false});
+#endif
+        return;
+    }
+
     ASSERT(pkg->n_users > 0);
     pkg->n_users--;
     if (pkg->aborted)
     {
 #ifdef USE_ZLIB
         // ignore errors, they're not relevant anymore
+#ifdef USE_ZSTD
+        if (codec == CODEC_ZSTD)
+            ZSTD_freeCStream(zcs);
+        else
+#endif
         deflateEnd(&zs);
         free(z_buffer);
 #endif
         return;
     }
 
+#ifdef USE_ZSTD
+    if (codec == CODEC_ZSTD)
+    {
+        size_t left;
+        do
+        {
+            left = ZSTD_endStream(zcs, &zout);
+            if (ZSTD_isError(left))
+            {
+                fail("save file compression failed: %s",
+                     ZSTD_getErrorName(left));
+            }
+            raw_write(z_buffer, zout.pos);
+            zout.pos = 0;
+        } while (left);
+        ZSTD_freeCStream(zcs);
+    }
+    else
+#endif
 #ifdef USE_ZLIB
-    zs.avail_in = 0;
-    int res;
-    do
     {
-        res = deflate(&zs, Z_FINISH);
-        if (res != Z_STREAM_END && res != Z_OK && res != Z_BUF_ERROR)
-            fail("save file compression failed: %s", zs.msg);
-        raw_write(z_buffer, zs.next_out - z_buffer);
-        zs.next_out = z_buffer;
-        zs.avail_out = ZB_SIZE;
-    } while (res != Z_STREAM_END);
-    if (deflateEnd(&zs) != Z_OK)
-        fail("save file compression failed during clean-up: %s", zs.msg);
+        zs.avail_in = 0;
+        int res;
+        do
+        {
+            res = deflate(&zs, Z_FINISH);
+            if (res != Z_STREAM_END && res != Z_OK && res != Z_BUF_ERROR)
+                fail("save file compression failed: %s", zs.msg);
+            raw_write(z_buffer, zs.next_out - z_buffer);
+            zs.next_out = z_buffer;
+            zs.avail_out = ZB_SIZE;
+        } while (res != Z_STREAM_END);
+        if (deflateEnd(&zs) != Z_OK)
+            fail("save file compression failed during clean-up: %s", zs.msg);
+    }
     free(z_buffer);
 #endif
     if (cur_block)
         finish_block(0);
-    pkg->finish_chunk(name, first_block);
+    pkg->finish_chunk(name, first_block, raw_len, codec);
 }
 
 void chunk_writer::raw_write(const void *data, plen_t len)
@@ -775,7 +1202,35 @@ void chunk_writer::write(const void *data, plen_t len)
 {
     ASSERT(data);
     ASSERT(!pkg->aborted);
+    if (deferred)
+    {
+        pending.insert(pending.end(), (const char*)data,
+                       (const char*)data + len);
+        return;
+    }
+    raw_len += len;
 
+#ifdef USE_ZSTD
+    if (codec == CODEC_ZSTD)
+    {
+        ZSTD_inBuffer in = { data, len, 0 };
+        while (in.pos < in.size)
+        {
+            if (zout.pos == zout.size)
+            {
+                raw_write(z_buffer, zout.pos);
+                zout.pos = 0;
+            }
+            size_t res = ZSTD_compressStream(zcs, &zout, &in);
+            if (ZSTD_isError(res))
+            {
+                fail("save file compression failed: %s",
+                     ZSTD_getErrorName(res));
+            }
+        }
+        return;
+    }
+#endif
 #ifdef USE_ZLIB
     zs.next_in  = (Bytef*)data;
     zs.avail_in = len;
@@ -796,17 +1251,47 @@ void chunk_writer::write(const void *data, plen_t len)
 #endif
 }
 
-void chunk_reader::init(plen_t start)
+void chunk_reader::init(plen_t start, chunk_codec _codec)
 {
     ASSERT(!pkg->aborted);
-    pkg->n_users++;
-    pkg->reader_count[start]++;
+    {
+        io_guard guard(pkg);
+        pkg->n_users++;
+        pkg->reader_count[start]++;
+    }
     first_block = next_block = start;
     block_left = 0;
+    has_len = false;
+    raw_len = 0;
+    codec = _codec;
 
 #ifdef USE_ZLIB
     if (!start)
         corrupted("save file corrupted -- zlib header missing");
+    eof = false;
+
+#ifdef USE_ZSTD
+    zds = nullptr;
+    if (codec == CODEC_ZSTD)
+    {
+        zds = ZSTD_createDStream();
+        if (!zds)
+            fail("save file decompression failed during init");
+        size_t res = ZSTD_initDStream(zds);
+        if (ZSTD_isError(res))
+        {
+            fail("save file decompression failed during init: %s",
+                 ZSTD_getErrorName(res));
+        }
+        zin.src  = nullptr;
+        zin.size = 0;
+        zin.pos  = 0;
+        return;
+    }
+#else
+    if (codec == CODEC_ZSTD)
+        fail("This save uses zstd compression, which this build lacks.");
+#endif
 
     zs.zalloc    = 0;
     zs.zfree     = 0;
@@ -815,7 +1300,6 @@ void chunk_reader::init(plen_t start)
     zs.avail_in  = 0;
     if (inflateInit(&zs))
         fail("save file decompression failed during init: %s", zs.msg);
-    eof = false;
 #endif
 }
 
@@ -824,7 +1308,7 @@ chunk_reader::chunk_reader(package *parent, plen_t start)
     ASSERT(parent);
     dprintf("chunk_reader[%u]: starting\n", start);
     pkg = parent;
-    init(start);
+    init(start, CODEC_ZLIB);
 }
 
 chunk_reader::chunk_reader(package *parent, const string &_name)
@@ -834,17 +1318,24 @@ chunk_reader::chunk_reader(package *parent, const string &_name)
         corrupted("save file corrupted -- chunk \"%s\" missing", _name.c_str());
     dprintf("chunk_reader(%s): starting\n", _name.c_str());
     pkg = parent;
-    init(parent->directory[_name]);
+    init(parent->directory[_name], parent->get_chunk_codec(_name));
+    has_len = parent->get_chunk_length(_name, raw_len);
 }
 
 chunk_reader::~chunk_reader()
 {
     dprintf("chunk_reader: closing\n");
 
+#ifdef USE_ZSTD
+    if (codec == CODEC_ZSTD)
+        ZSTD_freeDStream(zds);
+    else
+#endif
 #ifdef USE_ZLIB
     if (inflateEnd(&zs) != Z_OK)
         fail("save file decompression failed during clean-up: %s", zs.msg);
 #endif
+    io_guard guard(pkg);
     ASSERT(pkg->reader_count[first_block] > 0);
     if (!--pkg->reader_count[first_block])
         pkg->reader_count.erase(first_block);
@@ -852,42 +1343,36 @@ chunk_reader::~chunk_reader()
     pkg->n_users--;
 }
 
+// Steps onto the next block of the chain; false if there are no more.
+bool chunk_reader::next_block_header()
+{
+    if (!next_block)
+        return false;
+
+    block_header bl;
+    pkg->read_raw(next_block, &bl, sizeof(block_header));
+
+    off = next_block + sizeof(block_header);
+    block_left = htole(bl.len);
+    next_block = htole(bl.next);
+    // This reeks of on-disk corruption (zeroed data).
+    if (!block_left)
+        corrupted("save file corrupted -- empty block");
+    return true;
+}
+
 plen_t chunk_reader::raw_read(void *data, plen_t len)
 {
     void *buf = data;
     while (len)
     {
-        if (!block_left)
-        {
-            if (!next_block)
-                return (char*)buf - (char*)data;
-
-            block_header bl;
-            pkg->seek(next_block);
-            ssize_t res = ::read(pkg->fd, &bl, sizeof(block_header));
-            if (res < 0)
-                sysfail("error reading the save file");
-            if (res != sizeof(block_header))
-                corrupted("save file corrupted -- block past eof");
-
-            off = next_block + sizeof(block_header);
-            block_left = htole(bl.len);
-            next_block = htole(bl.next);
-            // This reeks of on-disk corruption (zeroed data).
-            if (!block_left)
-                corrupted("save file corrupted -- empty block");
-        }
-        else
-            pkg->seek(off);
+        if (!block_left && !next_block_header())
+            return (char*)buf - (char*)data;
 
         plen_t s = len;
         if (s > block_left)
             s = block_left;
-        ssize_t res = ::read(pkg->fd, buf, s);
-        if (res < 0)
-            sysfail("error reading the save file");
-        if ((plen_t)res != s)
-            corrupted("save file corrupted -- block past eof");
+        pkg->read_raw(off, buf, s);
 
         buf = (char*)buf + s;
         off += s;
@@ -898,12 +1383,77 @@ plen_t chunk_reader::raw_read(void *data, plen_t len)
     return (char*)buf - (char*)data;
 }
 
+#ifdef USE_MMAP
+// Hands out the rest of the current block in place, without copying.
+plen_t chunk_reader::raw_span(const void **data)
+{
+    if (!block_left && !next_block_header())
+        return 0;
+
+    plen_t s = block_left;
+    *data = pkg->map_span(off, s);
+    off += s;
+    block_left = 0;
+    return s;
+}
+#endif
+
+#ifdef USE_ZLIB
+// Fetches the next run of compressed input: the mapped block itself if
+// there is a mapping, otherwise a copy in z_buffer.
+plen_t chunk_reader::next_input(const void **data)
+{
+#ifdef USE_MMAP
+    if (pkg->mapping)
+        return raw_span(data);
+#endif
+    *data = z_buffer;
+    return raw_read(z_buffer, sizeof(z_buffer));
+}
+#endif
+
+#ifdef USE_ZSTD
+plen_t chunk_reader::read_zstd(void *data, plen_t len)
+{
+    if (!len || eof)
+        return 0;
+
+    ZSTD_outBuffer out = { data, len, 0 };
+    while (out.pos < out.size)
+    {
+        if (zin.pos == zin.size)
+        {
+            zin.size = next_input(&zin.src);
+            zin.pos  = 0;
+            if (!zin.size)
+                corrupted("save file corrupted -- block truncated");
+        }
+        size_t res = ZSTD_decompressStream(zds, &out, &zin);
+        if (ZSTD_isError(res))
+        {
+            corrupted("save file decompression failed: %s",
+                      ZSTD_getErrorName(res));
+        }
+        if (!res)
+        {
+            eof = true;
+            break;
+        }
+    }
+    return out.pos;
+}
+#endif
+
 plen_t chunk_reader::read(void *data, plen_t len)
 {
     ASSERT(data);
     if (pkg->aborted)
         return 0;
 
+#ifdef USE_ZSTD
+    if (codec == CODEC_ZSTD)
+        return read_zstd(data, len);
+#endif
 #ifdef USE_ZLIB
     if (!len)
         return 0;
@@ -916,8 +1466,9 @@ plen_t chunk_reader::read(void *data, plen_t len)
     {
         if (!zs.avail_in)
         {
-            zs.next_in  = z_buffer;
-            zs.avail_in = raw_read(z_buffer, sizeof(z_buffer));
+            const void *in = nullptr;
+            zs.avail_in = next_input(&in);
+            zs.next_in  = (Bytef*)in;
             if (!zs.avail_in)
                 corrupted("save file corrupted -- block truncated");
         }
@@ -938,6 +1489,21 @@ plen_t chunk_reader::read(void *data, plen_t len)
 
 void chunk_reader::read_all(vector<char> &data)
 {
+    // With the length known from the directory, inflate straight into a
+    // buffer of the right size.
+    if (has_len)
+    {
+        const plen_t len = raw_len;
+        plen_t at = data.size();
+        data.resize(at + len);
+        if (len && read(&data[at], len) != len)
+            corrupted("save file corrupted -- chunk shorter than recorded");
+        char dummy;
+        if (read(&dummy, 1))
+            corrupted("save file corrupted -- chunk longer than recorded");
+        return;
+    }
+
 #define SPACE 1024
     plen_t s, at;
     do
@@ -3,21 +3,51 @@
 
 #define USE_ZLIB
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
 #ifdef USE_ZLIB
 #include <zlib.h>
 #endif
+// zstd is optional and only used for chunks written while the
+// save_compression option asks for it; zlib chunks stay readable.
+#ifdef USE_ZSTD
+#ifndef USE_ZLIB
+#error "USE_ZSTD needs USE_ZLIB"
+#endif
+#include <zstd.h>
+#endif
 
 #if !defined(DGAMELAUNCH) && !defined(__ANDROID__) && !defined(DEBUG_DIAGNOSTICS)
 #define DO_FSYNC
 #endif
 
+// Read-only packages map the whole file instead of seeking and reading
+// block by block.
+#ifndef TARGET_OS_WINDOWS
+#define USE_MMAP
+#endif
+
+// The game save can compress, write and commit chunks on a thread of its
+// own; see package::start_write_thread().
+#ifndef TARGET_OS_WINDOWS
+#define USE_SAVE_THREAD
+#include "threads.h"
+#endif
+
 #define MAX_CHUNK_NAME_LENGTH 255
 
 typedef uint32_t plen_t;
 
+// Stored per chunk in the directory; don't reorder.
+enum chunk_codec
+{
+    CODEC_ZLIB,
+    CODEC_ZSTD,
+    NUM_CHUNK_CODECS
+};
+
 class package;
 
 class chunk_writer
@@ -28,10 +58,22 @@ private:
     plen_t first_block;
     plen_t cur_block;
     plen_t block_len;
+    plen_t raw_len;
+    chunk_codec codec;
 #ifdef USE_ZLIB
     z_stream zs;
     Bytef *z_buffer;
 #endif
+#ifdef USE_ZSTD
+    ZSTD_CStream *zcs;
+    ZSTD_outBuffer zout;
+#endif
+    // Deferred writers only collect the data; the package's write thread
+    // compresses and stores it once the writer is closed.
+    bool deferred;
+    vector<char> pending;
+    chunk_writer(package *parent, const string &_name, chunk_codec _codec,
+                 bool _deferred);
     void raw_write(const void *data, plen_t len);
     void finish_block(plen_t next);
 public:
@@ -45,16 +87,31 @@ class chunk_reader
 {
 private:
     chunk_reader(package *parent, plen_t start);
-    void init(plen_t start);
+    void init(plen_t start, chunk_codec _codec);
     package *pkg;
     plen_t first_block, next_block;
     plen_t off, block_left;
+    bool has_len;
+    plen_t raw_len;
+    chunk_codec codec;
 #ifdef USE_ZLIB
     bool eof;
     z_stream zs;
     Bytef z_buffer[32768];
 #endif
+#ifdef USE_ZSTD
+    ZSTD_DStream *zds;
+    ZSTD_inBuffer zin;
+    plen_t read_zstd(void *data, plen_t len);
+#endif
+    bool next_block_header();
     plen_t raw_read(void *data, plen_t len);
+#ifdef USE_MMAP
+    plen_t raw_span(const void **data);
+#endif
+#ifdef USE_ZLIB
+    plen_t next_input(const void **data);
+#endif
 public:
     chunk_reader(package *parent, const string &_name);
     ~chunk_reader();
@@ -72,6 +129,8 @@ public:
     chunk_writer* writer(const string &name);
     chunk_reader* reader(const string &name);
     void commit();
+    void start_write_thread();
+    void sync();
     void delete_chunk(const string &name);
     bool has_chunk(const string &name);
     vector<string> list_chunks();
@@ -83,6 +142,11 @@ public:
     plen_t get_size() const { return file_len; };
     plen_t get_chunk_fragmentation(const string &name);
     plen_t get_chunk_compressed_length(const string &name);
+    bool get_chunk_length(const string &name, plen_t &len) const;
+    chunk_codec get_chunk_codec(const string &name) const;
+
+    // codec for chunks written from now on
+    static chunk_codec default_codec;
 private:
     string filename;
     bool rw;
@@ -95,6 +159,39 @@ private:
     bool tmp;
 #endif
     map<string, plen_t> directory;
+    // Uncompressed lengths; missing for chunks from pre-v2 directories.
+    map<string, plen_t> chunk_lengths;
+    // Missing entries mean zlib.
+    map<string, chunk_codec> chunk_codecs;
+#ifdef USE_MMAP
+    const char *mapping;
+    plen_t mapping_len;
+#endif
+#ifdef USE_SAVE_THREAD
+    struct pending_chunk
+    {
+        string name;
+        chunk_codec codec;
+        vector<char> data;
+        bool commit;
+    };
+    bool background;
+    bool bg_quit;
+    bool bg_busy;
+    int bg_commits;
+    string bg_error;
+    deque<pending_chunk> bg_queue;
+    thread_t bg_thread;
+    mutex_t bg_mutex;  // guards the bg_ fields
+    mutex_t io_mutex;  // held by whoever touches the file or block lists
+    cond_t bg_wake;
+    cond_t bg_done;
+    static void *write_thread(void *pkg);
+    void run_write_thread();
+    void queue_job(pending_chunk &&job);
+    void stop_write_thread();
+    void wait_write_thread(bool everything);
+#endif
     map<plen_t, plen_t> free_blocks;
     vector<plen_t> unlinked_blocks;
     map<plen_t, pair<plen_t, plen_t> > block_map;
@@ -102,13 +199,23 @@ private:
     map<plen_t, uint32_t> reader_count;
     plen_t extend_block(plen_t at, plen_t size, plen_t by);
     plen_t alloc_block(plen_t &size);
-    void finish_chunk(const string &name, plen_t at);
+    void finish_chunk(const string &name, plen_t at, plen_t len,
+                      chunk_codec codec);
     void free_chunk(const string &name);
+    void erase_chunk(const string &name);
+    void commit_now();
     plen_t write_directory();
     void collect_blocks();
     void free_block_chain(plen_t at);
     void free_block(plen_t at, plen_t size);
     void seek(plen_t to);
+    void read_raw(plen_t at, void *data, plen_t len);
+    void lock_io();
+    void unlock_io();
+#ifdef USE_MMAP
+    void map_file();
+    const char *map_span(plen_t at, plen_t len) const;
+#endif
     void fsck();
     void read_directory(plen_t start, uint8_t version);
     void trace_chunk(plen_t start);
@@ -116,6 +223,7 @@ private:
     void load_traces();
     friend class chunk_writer;
     friend class chunk_reader;
+    friend class io_guard;
 };
 
 #endif
@@ -62,6 +62,50 @@ static pattern_match _pattern_match_location(void *compiled_pattern,
         return pattern_match::failed(string(text));
 }
 
+// Each pattern in a combined set carries its own case flag.
+static const bool _inline_case_flags = true;
+
+static string _group_pattern(const string &pattern, bool icase)
+{
+    return (icase ? "((?i)" : "(") + pattern + ")";
+}
+
+static int _capture_count(void *compiled_pattern)
+{
+    int count = 0;
+    pcre_fullinfo(static_cast<pcre *>(compiled_pattern), nullptr,
+                  PCRE_INFO_CAPTURECOUNT, &count);
+    return count;
+}
+
+static void *_study_pattern(void *compiled_pattern)
+{
+    const char *error;
+    return pcre_study(static_cast<pcre *>(compiled_pattern), 0, &error);
+}
+
+static void _free_study(void *extra)
+{
+    if (extra)
+        pcre_free_study(static_cast<pcre_extra *>(extra));
+}
+
+// The lowest numbered group that took part in the match, or -1 if there
+// was no match.
+static int _pattern_match_group(void *compiled_pattern, void *extra,
+                                const char *text, int length, int groups)
+{
+    vector<int> ovector((groups + 1) * 3);
+    int pcre_rc = pcre_exec(static_cast<pcre *>(compiled_pattern),
+                            static_cast<pcre_extra *>(extra),
+                            text, length, 0, 0,
+                            &ovector[0], ovector.size());
+    for (int group = 1; group < pcre_rc; ++group)
+        if (ovector[group * 2] >= 0)
+            return group;
+    return -1;
+}
+
 ////////////////////////////////////////////////////////////////////
 #else
 ////////////////////////////////////////////////////////////////////
@@ -113,6 +157,41 @@ static pattern_match _pattern_match_location(void *compiled_pattern,
         return pattern_match::failed(string(text));
 }
 
+// There are no inline flags, so a combined set has to share one.
+static const bool _inline_case_flags = false;
+
+static string _group_pattern(const string &pattern, bool)
+{
+    return "(" + pattern + ")";
+}
+
+static int _capture_count(void *compiled_pattern)
+{
+    return static_cast<regex_t *>(compiled_pattern)->re_nsub;
+}
+
+static void *_study_pattern(void *)
+{
+    return nullptr;
+}
+
+static void _free_study(void *)
+{
+}
+
+static int _pattern_match_group(void *compiled_pattern, void *,
+                                const char *text, int, int groups)
+{
+    vector<regmatch_t> match(groups + 1);
+    regex_t *re = static_cast<regex_t *>(compiled_pattern);
+    if (regexec(re, text, match.size(), &match[0], 0))
+        return -1;
+    for (int group = 1; group <= groups; ++group)
+        if (match[group].rm_so != -1)
+            return group;
+    return -1;
+}
+
 ////////////////////////////////////////////////////////////////////
 #endif
 
@@ -191,6 +270,199 @@ pattern_match text_pattern::match_location(const char *s, int length) const
         return pattern_match::failed(string(s));
 }
 
+text_pattern_set::text_pattern_set(int _cache_size)
+    : patterns(), built(false), linear(false), combined(nullptr),
+      combined_extra(nullptr), groups(), num_groups(0),
+      cache_size(_cache_size)
+{
+}
+
+text_pattern_set::text_pattern_set(const text_pattern_set &other)
+    : patterns(other.patterns), built(false), linear(false),
+      combined(nullptr), combined_extra(nullptr), groups(), num_groups(0),
+      cache_size(other.cache_size)
+{
+}
+
+text_pattern_set::~text_pattern_set()
+{
+    free_combined();
+}
+
+const text_pattern_set &text_pattern_set::operator= (
+    const text_pattern_set &other)
+{
+    if (this == &other)
+        return *this;
+
+    clear();
+    patterns   = other.patterns;
+    cache_size = other.cache_size;
+    return *this;
+}
+
+void text_pattern_set::free_combined() const
+{
+    _free_study(combined_extra);
+    _free_compiled_pattern(combined);
+    combined_extra = nullptr;
+    combined = nullptr;
+}
+
+void text_pattern_set::clear()
+{
+    patterns.clear();
+    free_combined();
+    built = false;
+    cache.clear();
+    cache_index.clear();
+}
+
+void text_pattern_set::add(const text_pattern &pat)
+{
+    patterns.push_back(pat);
+    free_combined();
+    built = false;
+    cache.clear();
+    cache_index.clear();
+}
+
+// Constructs that refer to other groups by number or position, or that
+// reach past the end of their group, change meaning once the pattern is
+// wrapped in a group next to others.
+static bool _can_group(const string &pattern)
+{
+    for (size_t i = 0; i + 1 < pattern.size(); ++i)
+    {
+        const char next = pattern[i + 1];
+        if (pattern[i] == '\\')
+        {
+            if (isadigit(next) && next != '0' || strchr("gkQ", next))
+                return false;
+            ++i;
+        }
+        else if (pattern[i] == '(' && next == '*')
+            return false;
+        else if (pattern[i] == '(' && next == '?' && i + 2 < pattern.size())
+        {
+            const char kind = pattern[i + 2];
+            if (strchr("P|R&+", kind) || isadigit(kind)
+                || kind == '-' && i + 3 < pattern.size()
+                   && isadigit(pattern[i + 3]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void text_pattern_set::build() const
+{
+    built = true;
+    linear = false;
+    free_combined();
+    groups.assign(patterns.size(), -1);
+    num_groups = 0;
+
+    string alternatives;
+    const text_pattern *first = nullptr;
+    for (unsigned int i = 0; i < patterns.size(); ++i)
+    {
+        const text_pattern &pat = patterns[i];
+        // Invalid patterns never match, so they can be left out.
+        if (!pat.valid())
+            continue;
+
+        if (!_can_group(pat.pattern)
+            || !_inline_case_flags && first
+               && pat.ignore_case != first->ignore_case)
+        {
+            linear = true;
+            return;
+        }
+        if (!first)
+            first = &pat;
+
+        groups[i] = num_groups + 1;
+        num_groups += 1 + _capture_count(pat.compiled_pattern);
+        if (!alternatives.empty())
+            alternatives += "|";
+        alternatives += _group_pattern(pat.pattern, pat.ignore_case);
+    }
+
+    if (!first)
+        return;
+
+    const bool icase = !_inline_case_flags && first->ignore_case;
+    combined = _compile_pattern(alternatives.c_str(), icase);
+    if (!combined || _capture_count(combined) != num_groups)
+    {
+        free_combined();
+        linear = true;
+        return;
+    }
+    combined_extra = _study_pattern(combined);
+}
+
+int text_pattern_set::search(const string &s) const
+{
+    if (!built)
+        build();
+
+    if (linear)
+    {
+        for (unsigned int i = 0; i < patterns.size(); ++i)
+            if (patterns[i].matches(s))
+                return i;
+        return -1;
+    }
+
+    if (!combined)
+        return -1;
+
+    const int group = _pattern_match_group(combined, combined_extra,
+                                           s.c_str(), s.length(), num_groups);
+    if (group < 0)
+        return -1;
+
+    // The group that matched is a pattern that matches, but an earlier
+    // one may match further along the string.
+    for (unsigned int i = 0; i < patterns.size(); ++i)
+    {
+        if (groups[i] == group)
+            return i;
+        if (groups[i] > 0 && patterns[i].matches(s))
+            return i;
+    }
+    return -1;
+}
+
+int text_pattern_set::first_match(const string &s) const
+{
+    if (patterns.empty())
+        return -1;
+    if (!cache_size)
+        return search(s);
+
+    auto cached = cache_index.find(s);
+    if (cached != cache_index.end())
+    {
+        cache.splice(cache.begin(), cache, cached->second);
+        return cached->second->second;
+    }
+
+    const int result = search(s);
+    cache.emplace_front(s, result);
+    cache_index[s] = cache.begin();
+    if ((int) cache.size() > cache_size)
+    {
+        cache_index.erase(cache.back().first);
+        cache.pop_back();
+    }
+    return result;
+}
+
 const plaintext_pattern &plaintext_pattern::operator= (const string &spattern)
 {
     if (pattern == spattern)
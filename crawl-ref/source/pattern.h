@@ -117,13 +117,62 @@ public:
         return pattern;
     }
 
+    bool case_insensitive() const { return ignore_case; }
+
 private:
+    friend class text_pattern_set;
+
     string pattern;
     mutable void *compiled_pattern;
     mutable bool isvalid;
     bool ignore_case;
 };
 
+// A list of text_patterns that finds the first one matching a string.
+// The patterns are combined into one regex, each in its own group, so a
+// string that matches none of them (the usual case) is rejected in a
+// single search; one that does match only needs the patterns before the
+// group that matched checked one by one. Patterns that can't safely be
+// combined (back-references and the like) make the set fall back to
+// trying each in turn.
+class text_pattern_set
+{
+public:
+    text_pattern_set(int cache_size = 0);
+    text_pattern_set(const text_pattern_set &other);
+    ~text_pattern_set();
+    const text_pattern_set &operator= (const text_pattern_set &other);
+
+    void clear();
+    void add(const text_pattern &pat);
+    bool empty() const { return patterns.empty(); }
+
+    // The index of the first pattern matching s, or -1 if none does.
+    int first_match(const string &s) const;
+
+private:
+    void build() const;
+    void free_combined() const;
+    int search(const string &s) const;
+
+private:
+    vector<text_pattern> patterns;
+
+    mutable bool built;
+    mutable bool linear;
+    mutable void *combined;
+    mutable void *combined_extra;
+    // The regex group holding each pattern, when combined.
+    mutable vector<int> groups;
+    mutable int num_groups;
+
+    // Recent results, most recent first, for sets that are mostly asked
+    // about the same few strings (item names).
+    int cache_size;
+    mutable list<pair<string, int>> cache;
+    mutable map<string, list<pair<string, int>>::iterator> cache_index;
+};
+
 class plaintext_pattern : public base_pattern
 {
 public:
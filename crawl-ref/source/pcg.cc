@@ -10,12 +10,14 @@
 
 #include "pcg.h"
 
+static const uint64_t PCG_MULTIPLIER = 6364136223846793005ULL;
+
 uint32_t
 PcgRNG::get_uint32()
 {
     uint64_t oldstate = state_;
     // Advance internal state
-    state_ = oldstate * 6364136223846793005ULL + (inc_|1);
+    state_ = oldstate * PCG_MULTIPLIER + (inc_|1);
     // Calculate output function (XSH RR), uses old state for max ILP
     uint32_t xorshifted = ((oldstate >> 18u) ^ oldstate) >> 27u;
     uint32_t rot = oldstate >> 59u;
@@ -46,3 +48,38 @@ PcgRNG::PcgRNG(uint64_t init_key[], int key_length)
     else
         inc_ ^= get_uint32();
 }
+
+PcgRNG PcgRNG::substream(uint64_t stream) const
+{
+    // The same seeding as O'Neill's pcg32_srandom_r, with our current state
+    // as the initial state.
+    PcgRNG sub;
+    sub.state_ = 0;
+    sub.inc_ = (stream << 1) | 1;
+    sub.get_uint32();
+    sub.state_ += state_;
+    sub.get_uint32();
+    return sub;
+}
+
+// Brown, "Random Number Generation with Arbitrary Stride": the effect of
+// delta steps is itself an affine map of the state, built up by squaring.
+void PcgRNG::advance(uint64_t delta)
+{
+    uint64_t cur_mult = PCG_MULTIPLIER;
+    uint64_t cur_plus = inc_ | 1;
+    uint64_t acc_mult = 1;
+    uint64_t acc_plus = 0;
+    while (delta > 0)
+    {
+        if (delta & 1)
+        {
+            acc_mult *= cur_mult;
+            acc_plus = acc_plus * cur_mult + cur_plus;
+        }
+        cur_plus = (cur_mult + 1) * cur_plus;
+        cur_mult *= cur_mult;
+        delta >>= 1;
+    }
+    state_ = acc_mult * state_ + acc_plus;
+}
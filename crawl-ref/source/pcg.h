@@ -10,6 +10,13 @@ class PcgRNG
         uint64_t get_uint64();
         uint32_t operator()() { return get_uint32(); }
 
+        // A generator on a different stream, seeded from this one's state
+        // without advancing it. Streams differing only in the top bit are
+        // the same stream.
+        PcgRNG substream(uint64_t stream) const;
+        // Skip ahead as if get_uint32() had been called delta times.
+        void advance(uint64_t delta);
+
         typedef uint32_t result_type;
         static constexpr uint32_t min() { return 0; }
         static constexpr uint32_t max() { return 0xffffffffU; }
@@ -437,7 +437,10 @@ namespace perlin
         double zi = z;
         for (uint32_t octave = 0; octave < octaves; ++octave)
         {
-            value += noise(xi / divisor, yi / divisor, zi / divisor) / divisor;
+            // divisor is a power of two, so multiplying by its reciprocal
+            // gives exactly the same result as dividing, without the cost.
+            const double scale = 1.0 / divisor;
+            value += noise(xi * scale, yi * scale, zi * scale) * scale;
             norm += 1 / divisor;
             divisor *= 2;
             double xt = yi * sin(1.41421356) + cos(1.41421356);
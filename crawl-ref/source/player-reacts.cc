@@ -491,6 +491,27 @@ static void _decrement_simple_duration(duration_type dur, int delay)
 
 
 
+/**
+ * Which durations tick down simply over time?
+ *
+ * @return  Every duration for which duration_decrements_normally() holds,
+ *          in order, paired with whether it rolls a midpoint offset.
+ */
+static const vector<pair<duration_type, bool>>& _simple_durations()
+{
+    static vector<pair<duration_type, bool>> durs;
+    if (durs.empty())
+    {
+        for (int i = 0; i < NUM_DURATIONS; ++i)
+        {
+            const duration_type dur = static_cast<duration_type>(i);
+            if (duration_decrements_normally(dur))
+                durs.emplace_back(dur, duration_has_mid_offset(dur));
+        }
+    }
+    return durs;
+}
+
 /**
  * Decrement player durations based on how long the player's turn lasted in aut.
  */
@@ -774,9 +795,16 @@ static void _decrement_durations()
         process_sunlights();
 
     // these should be after decr_ambrosia, transforms, liquefying, etc.
-    for (int i = 0; i < NUM_DURATIONS; ++i)
-        if (duration_decrements_normally((duration_type) i))
-            _decrement_simple_duration((duration_type) i, delay);
+    for (const auto &entry : _simple_durations())
+    {
+        const duration_type dur = entry.first;
+        if (you.duration[dur])
+            _decrement_simple_duration(dur, delay);
+        // An inactive duration has nothing to do, but the roll for its
+        // midpoint fuzz has always been made anyway; keep making it.
+        else if (entry.second)
+            duration_mid_offset(dur);
+    }
 }
 
 
@@ -2525,6 +2525,21 @@ void forget_map(bool rot)
     const int radius = (rot_resist ? 200 : 100);
 
     const int scalar = 0xFF;
+
+    // The chance of remembering a cell depends only on its distance, so
+    // work it out once per distance rather than calling pow() per cell.
+    int keep_chance[GXM > GYM ? GXM : GYM];
+    if (rot)
+    {
+        for (int dist = 0; dist < (int)ARRAYSZ(keep_chance); ++dist)
+        {
+            keep_chance[dist] = pow(geometric_chance,
+                                    max(1, (dist * dist - radius) / 40))
+                                * scalar;
+        }
+    }
+
+    MapKnowledge *forgotten = env.map_forgotten.get();
     for (rectangle_iterator ri(0); ri; ++ri)
     {
         const coord_def &p = *ri;
@@ -2534,18 +2549,13 @@ void forget_map(bool rot)
         if (rot)
         {
             const int dist = grid_distance(you.pos(), p);
-            int chance = pow(geometric_chance,
-                             max(1, (dist * dist - radius) / 40)) * scalar;
-            if (x_chance_in_y(chance, scalar))
+            if (x_chance_in_y(keep_chance[dist], scalar))
                 continue;
         }
 
-        if (you.see_cell(p))
-            continue;
-
         env.map_knowledge(p).clear();
-        if (env.map_forgotten.get())
-            (*env.map_forgotten.get())(p).clear();
+        if (forgotten)
+            (*forgotten)(p).clear();
         StashTrack.update_stash(p);
 #ifdef USE_TILE
         tile_forget_map(p);
@@ -5456,6 +5466,8 @@ void player::init_skills()
     skill_order.init(MAX_SKILL_ORDER);
     exercises.clear();
     exercises_all.clear();
+    exercise_count.init(0);
+    exercise_all_count.init(0);
 }
 
 player_save_info& player_save_info::operator=(const player& rhs)
@@ -183,6 +183,10 @@ public:
     bool auto_training;
     list<skill_type> exercises;     ///< recent practise events
     list<skill_type> exercises_all; ///< also include events for disabled skills
+    /// how many times each skill is in exercises, kept by the skill code
+    FixedVector<unsigned int, NUM_SKILLS> exercise_count;
+    /// and in exercises_all
+    FixedVector<unsigned int, NUM_SKILLS> exercise_all_count;
     set<skill_type> stop_train;     ///< need to check if we can still train
     set<skill_type> start_train;    ///< we can resume training
 
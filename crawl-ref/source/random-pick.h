@@ -6,6 +6,9 @@
 #ifndef RANDOMPICK_H
 #define RANDOMPICK_H
 
+#include <map>
+#include <vector>
+
 #include "random.h"
 
 enum distrib_type
@@ -37,6 +40,15 @@ public:
     int rarity_at(const random_pick_entry<T> *pop,
                   int depth);
     virtual bool veto(T val) { return false; }
+
+private:
+    struct pick_entry
+    {
+        T value;
+        int rarity;
+    };
+    const vector<pick_entry> &_entries_at(
+        const random_pick_entry<T> *weights, int level);
 };
 
 template <typename T, int max>
@@ -44,29 +56,51 @@ random_picker<T, max>::~random_picker()
 {
 }
 
+// The entries of a (static) weight list that are in range at the given
+// level, with their rarities there, in list order. Built on first use and
+// kept, since most lists cover many levels and are picked from very often.
 template <typename T, int max>
-T random_picker<T, max>::pick(const random_pick_entry<T> *weights, int level,
-                              T none)
+const vector<typename random_picker<T, max>::pick_entry> &
+random_picker<T, max>::_entries_at(const random_pick_entry<T> *weights,
+                                   int level)
 {
-    struct { T value; int rarity; } valid[max];
-    int nvalid = 0;
-    int totalrar = 0;
+    static map<pair<const random_pick_entry<T> *, int>,
+               vector<pick_entry>> cache;
+
+    auto it = cache.find(make_pair(weights, level));
+    if (it != cache.end())
+        return it->second;
 
+    vector<pick_entry> &entries = cache[make_pair(weights, level)];
     for (const random_pick_entry<T> *pop = weights; pop->rarity; pop++)
     {
         if (level < pop->minr || level > pop->maxr)
             continue;
 
-        if (veto(pop->value))
-            continue;
-
         int rar = rarity_at(pop, level);
         ASSERTM(rar > 0, "Rarity %d: %d at level %d", rar, pop->value, level);
 
-        valid[nvalid].value = pop->value;
-        valid[nvalid].rarity = rar;
-        totalrar += rar;
-        nvalid++;
+        entries.push_back({pop->value, rar});
+    }
+    return entries;
+}
+
+template <typename T, int max>
+T random_picker<T, max>::pick(const random_pick_entry<T> *weights, int level,
+                              T none)
+{
+    const vector<pick_entry> &entries = _entries_at(weights, level);
+    const pick_entry *valid[max];
+    int nvalid = 0;
+    int totalrar = 0;
+
+    for (const pick_entry &entry : entries)
+    {
+        if (veto(entry.value))
+            continue;
+
+        valid[nvalid++] = &entry;
+        totalrar += entry.rarity;
     }
 
     if (!nvalid)
@@ -75,8 +109,8 @@ T random_picker<T, max>::pick(const random_pick_entry<T> *weights, int level,
     totalrar = random2(totalrar); // the roll!
 
     for (int i = 0; i < nvalid; i++)
-        if ((totalrar -= valid[i].rarity) < 0)
-            return valid[i].value;
+        if ((totalrar -= valid[i]->rarity) < 0)
+            return valid[i]->value;
 
     die("random_pick roll out of range");
 }
@@ -13,15 +13,41 @@
 #include "syscalls.h"
 
 static FixedVector<PcgRNG, NUM_RNGS> rngs;
+// Where this thread's gameplay rolls come from, if an rng_substream has
+// replaced the shared generator.
+static thread_local PcgRNG *gameplay_override = nullptr;
+
+static PcgRNG &_rng(int generator)
+{
+    if (generator == RNG_GAMEPLAY && gameplay_override)
+        return *gameplay_override;
+    return rngs[generator];
+}
 
 uint32_t get_uint32(int generator)
 {
-    return rngs[generator].get_uint32();
+    return _rng(generator).get_uint32();
 }
 
 uint64_t get_uint64(int generator)
 {
-    return rngs[generator].get_uint64();
+    return _rng(generator).get_uint64();
+}
+
+PcgRNG gameplay_substream(uint64_t stream)
+{
+    return _rng(RNG_GAMEPLAY).substream(stream);
+}
+
+rng_substream::rng_substream(const PcgRNG &rng)
+    : generator(rng), previous(gameplay_override)
+{
+    gameplay_override = &generator;
+}
+
+rng_substream::~rng_substream()
+{
+    gameplay_override = previous;
 }
 
 static void _seed_rng(uint64_t seed_array[], int seed_len)
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "hash.h"
+#include "pcg.h"
 
 void seed_rng();
 void seed_rng(uint32_t seed);
@@ -14,6 +15,27 @@ void seed_rng(uint64_t[], int);
 
 uint32_t get_uint32(int generator = RNG_GAMEPLAY);
 uint64_t get_uint64(int generator = RNG_GAMEPLAY);
+
+// A generator for background work with its own deterministic stream,
+// derived from the gameplay generator without consuming any of its rolls.
+// Call this from the thread that owns the gameplay generator.
+PcgRNG gameplay_substream(uint64_t stream);
+
+// While one of these exists, gameplay rolls made on the thread that created
+// it (random2(), x_chance_in_y() and so on) come from its own generator
+// rather than the shared one. They nest; other threads are unaffected.
+class rng_substream
+{
+public:
+    explicit rng_substream(const PcgRNG &rng);
+    ~rng_substream();
+    rng_substream(const rng_substream &) = delete;
+    rng_substream &operator=(const rng_substream &) = delete;
+
+private:
+    PcgRNG generator;
+    PcgRNG *previous;
+};
 bool coinflip();
 int div_rand_round(int num, int den);
 int div_round_up(int num, int den);
@@ -167,14 +167,15 @@ static bool _item_needs_rot_check(const item_def &item)
     if (!item.defined())
         return false;
 
-    if (item.props.exists(CORPSE_NEVER_DECAYS))
+    // Check the type before looking in the props: most items can't rot.
+    if (!is_perishable_stack(item)
+        && (item.base_type != OBJ_CORPSES
+            || item.sub_type > CORPSE_SKELETON)) // XXX: is this needed?
+    {
         return false;
+    }
 
-    if (is_perishable_stack(item))
-        return true;
-
-    return item.base_type == OBJ_CORPSES
-           && item.sub_type <= CORPSE_SKELETON; // XXX: is this needed?
+    return !item.props.exists(CORPSE_NEVER_DECAYS);
 }
 
 /**
@@ -319,7 +320,7 @@ void rot_floor_items(int elapsedTime)
     {
         item_def &it = mitm[mitm_index];
 
-        if (is_shop_item(it) || !_item_needs_rot_check(it))
+        if (!_item_needs_rot_check(it) || is_shop_item(it))
             continue;
 
         if (it.base_type == OBJ_CORPSES)
@@ -1677,12 +1677,12 @@ shop_struct *shop_at(const coord_def& where)
     if (grd(where) != DNGN_ENTER_SHOP)
         return nullptr;
 
-    auto it = env.shop.find(where);
-    ASSERT(it != env.shop.end());
-    ASSERT(it->second.pos == where);
-    ASSERT(it->second.type != SHOP_UNASSIGNED);
+    shop_struct *shop = env.shop.find(where);
+    ASSERT(shop);
+    ASSERT(shop->pos == where);
+    ASSERT(shop->type != SHOP_UNASSIGNED);
 
-    return &it->second;
+    return shop;
 }
 
 string shop_type_name(shop_type type)
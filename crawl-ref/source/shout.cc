@@ -14,7 +14,9 @@
 #include "artefact.h"
 #include "art-enum.h"
 #include "branch.h"
+#include "coordit.h"
 #include "database.h"
+#include "dbg-util.h"
 #include "directn.h"
 #include "english.h"
 #include "env.h"
@@ -36,7 +38,10 @@
 #include "terrain.h"
 #include "view.h"
 
-static noise_grid _noise_grid;
+// Noises are registered on the active grid while the other one propagates,
+// since waking monsters can make noises of their own.
+static noise_grid _noise_grids[2];
+static noise_grid *_noise_grid = &_noise_grids[0];
 static void _actor_apply_noise(actor *act,
                                const coord_def &apparent_source,
                                int noise_intensity_millis,
@@ -235,7 +240,22 @@ void handle_monster_shouts(monster* mons, bool force)
         learned_something_new(HINT_MONSTER_SHOUT, mons->pos());
 }
 
-bool check_awaken(monster* mons, int stealth)
+player_stealth_info::player_stealth_info(int _stealth)
+    : stealth(_stealth),
+      always_noticed(you.berserk() || player_mutation_level(MUT_NO_STEALTH)),
+      invisible(you.invisible())
+{
+}
+
+// As you.visible_to(mons), with the player's invisibility already known.
+static bool _mons_sees_player(const monster* mons, bool you_invisible)
+{
+    return mons->friendly()
+        || (!mons->has_ench(ENCH_BLIND)
+            && (!you_invisible || mons->can_see_invisible()));
+}
+
+bool check_awaken(monster* mons, const player_stealth_info &you_info)
 {
     // Usually redundant because we iterate over player LOS,
     // but e.g. for you.xray_vision.
@@ -247,12 +267,9 @@ bool check_awaken(monster* mons, int stealth)
     if (mons_just_slept(mons))
         return false;
 
-    // Berserkers aren't really concerned about stealth.
-    if (you.berserk())
-        return true;
-
-    // If you've sacrificed stealth, you always alert monsters.
-    if (player_mutation_level(MUT_NO_STEALTH))
+    // Berserkers aren't really concerned about stealth, and if you've
+    // sacrificed stealth, you always alert monsters.
+    if (you_info.always_noticed)
         return true;
 
 
@@ -267,7 +284,7 @@ bool check_awaken(monster* mons, int stealth)
     if (mons_is_wandering(mons) && mons->foe == MHITYOU)
         mons_perc += 15;
 
-    if (!you.visible_to(mons))
+    if (!_mons_sees_player(mons, you_info.invisible))
     {
         mons_perc -= 75;
         unnatural_stealthy = true;
@@ -293,7 +310,7 @@ bool check_awaken(monster* mons, int stealth)
     if (mons_perc < 4)
         mons_perc = 4;
 
-    if (x_chance_in_y(mons_perc + 1, stealth))
+    if (x_chance_in_y(mons_perc + 1, you_info.stealth))
         return true; // Oops, the monster wakes up!
 
     // You didn't wake the monster!
@@ -705,16 +722,17 @@ void yell(const actor* mon)
 
 void apply_noises()
 {
-    // [ds] This copying isn't awesome, but we cannot otherwise handle
-    // the case where one set of noises wakes up monsters who then let
-    // out yips of their own, modifying _noise_grid while it is in the
-    // middle of propagate_noise().
-    if (_noise_grid.dirty())
+    PROFILE_SECTION(PROF_NOISES);
+
+    // One set of noises may wake up monsters who then let out yips of
+    // their own, so switch new noises over to the other (already clear)
+    // grid before propagating this one.
+    if (_noise_grid->dirty())
     {
-        noise_grid copy = _noise_grid;
-        // Reset the main grid.
-        _noise_grid.reset();
-        copy.propagate_noise();
+        noise_grid &grid(*_noise_grid);
+        _noise_grid = &_noise_grids[_noise_grid == &_noise_grids[0]];
+        grid.propagate_noise();
+        grid.reset();
     }
 }
 
@@ -754,7 +772,7 @@ bool noisy(int original_loudness, const coord_def& where,
     // Add +1 to scaled_loudness so that all squares adjacent to a
     // sound of loudness 1 will hear the sound.
     const string noise_msg(msg? msg : "");
-    _noise_grid.register_noise(
+    _noise_grid->register_noise(
         noise_t(where, noise_msg, (scaled_loudness + 1) * 1000, who, flags));
 
     // Some users of noisy() want an immediate answer to whether the
@@ -787,22 +805,50 @@ bool fake_noisy(int loudness, const coord_def& where)
     return noisy(loudness, where, nullptr, MID_NOBODY, NF_NONE, true);
 }
 
+// The living monsters within range of where, in the order a
+// monster_iterator would visit them. When the square to search is smaller
+// than the monster table, look the monsters up on the grid instead.
+static vector<monster*> _monsters_near(const coord_def &where, int range)
+{
+    vector<monster*> mons;
+    const int side = 2 * range + 1;
+    if (range >= 0 && side * side < MAX_MONSTERS)
+    {
+        for (rectangle_iterator ri(where, range, true); ri; ++ri)
+        {
+            monster *mon = monster_at(*ri);
+            if (mon && mon->mindex() < MAX_MONSTERS && mon->alive())
+                mons.push_back(mon);
+        }
+        // menv is an array, so address order is index order.
+        sort(mons.begin(), mons.end());
+    }
+    else
+    {
+        for (monster_iterator mi; mi; ++mi)
+            if (grid_distance(mi->pos(), where) <= range)
+                mons.push_back(*mi);
+    }
+    return mons;
+}
+
 void check_monsters_sense(sense_type sense, int range, const coord_def& where)
 {
-    for (monster_iterator mi; mi; ++mi)
+    for (monster *mon : _monsters_near(where, range))
     {
-        if (grid_distance(mi->pos(), where) > range)
+        // An earlier reaction may have changed things.
+        if (!mon->alive() || grid_distance(mon->pos(), where) > range)
             continue;
 
         switch (sense)
         {
         case SENSE_SMELL_BLOOD:
-            if (!mons_class_flag(mi->type, M_BLOOD_SCENT))
+            if (!mons_class_flag(mon->type, M_BLOOD_SCENT))
                 break;
 
             // Let sleeping hounds lie.
-            if (mi->asleep()
-                && mons_species(mi->type) != MONS_VAMPIRE)
+            if (mon->asleep()
+                && mons_species(mon->type) != MONS_VAMPIRE)
             {
                 // 33% chance of sleeping on
                 // 33% of being disturbed (start BEH_WANDER)
@@ -812,21 +858,21 @@ void check_monsters_sense(sense_type sense, int range, const coord_def& where)
                     if (coinflip())
                     {
                         dprf(DIAG_NOISE, "disturbing %s (%d, %d)",
-                             mi->name(DESC_PLAIN).c_str(),
-                             mi->pos().x, mi->pos().y);
-                        behaviour_event(*mi, ME_DISTURB, 0, where);
+                             mon->name(DESC_PLAIN).c_str(),
+                             mon->pos().x, mon->pos().y);
+                        behaviour_event(mon, ME_DISTURB, 0, where);
                     }
                     break;
                 }
             }
             dprf(DIAG_NOISE, "alerting %s (%d, %d)",
-                            mi->name(DESC_PLAIN).c_str(),
-                            mi->pos().x, mi->pos().y);
-            behaviour_event(*mi, ME_ALERT, 0, where);
+                            mon->name(DESC_PLAIN).c_str(),
+                            mon->pos().x, mon->pos().y);
+            behaviour_event(mon, ME_ALERT, 0, where);
             break;
 
         case SENSE_WEB_VIBRATION:
-            if (!mons_class_flag(mi->type, M_WEB_SENSE))
+            if (!mons_class_flag(mon->type, M_WEB_SENSE))
                 break;
 
             if (!one_chance_in(4))
@@ -834,16 +880,16 @@ void check_monsters_sense(sense_type sense, int range, const coord_def& where)
                 if (coinflip())
                 {
                     dprf(DIAG_NOISE, "disturbing %s (%d, %d)",
-                         mi->name(DESC_PLAIN).c_str(),
-                         mi->pos().x, mi->pos().y);
-                    behaviour_event(*mi, ME_DISTURB, 0, where);
+                         mon->name(DESC_PLAIN).c_str(),
+                         mon->pos().x, mon->pos().y);
+                    behaviour_event(mon, ME_DISTURB, 0, where);
                 }
                 else
                 {
                     dprf(DIAG_NOISE, "alerting %s (%d, %d)",
-                         mi->name(DESC_PLAIN).c_str(),
-                         mi->pos().x, mi->pos().y);
-                    behaviour_event(*mi, ME_ALERT, 0, where);
+                         mon->name(DESC_PLAIN).c_str(),
+                         mon->pos().x, mon->pos().y);
+                    behaviour_event(mon, ME_ALERT, 0, where);
                 }
             }
             break;
@@ -882,7 +928,7 @@ static int _noise_attenuation_millis(const coord_def &pos)
 
 noise_cell::noise_cell()
     : neighbour_delta(0, 0), noise_id(-1), noise_intensity_millis(0),
-      noise_travel_distance(0)
+      noise_travel_distance(0), generation(0)
 {
 }
 
@@ -925,29 +971,83 @@ int noise_cell::turn_angle(const coord_def &next_delta) const
 }
 
 noise_grid::noise_grid()
-    : cells(), noises(), affected_actor_count(0)
+    : cells(), noises(), affected_actor_count(0), generation(1),
+      audible_tl(GXM, GYM), audible_br(-1, -1), frontier(),
+      frontier_head(0), frontier_size(0)
 {
 }
 
 void noise_grid::reset()
 {
-    cells.init(noise_cell());
+    // Only on wraparound do we have to actually wipe the cells.
+    if (!++generation)
+    {
+        cells.init(noise_cell());
+        generation = 1;
+    }
     noises.clear();
     affected_actor_count = 0;
+    audible_tl = coord_def(GXM, GYM);
+    audible_br = coord_def(-1, -1);
+}
+
+noise_cell &noise_grid::cell_at(const coord_def &pos)
+{
+    noise_cell &cell(cells(pos));
+    if (cell.generation != generation)
+    {
+        cell = noise_cell();
+        cell.generation = generation;
+    }
+    return cell;
+}
+
+const noise_cell &noise_grid::cell_at(const coord_def &pos) const
+{
+    static const noise_cell silence;
+    const noise_cell &cell(cells(pos));
+    return cell.generation == generation ? cell : silence;
+}
+
+void noise_grid::push_frontier(const coord_def &pos)
+{
+    ASSERT(frontier_size < (int) frontier.size());
+    frontier[(frontier_head + frontier_size++) % frontier.size()] = pos;
+}
+
+coord_def noise_grid::pop_frontier()
+{
+    ASSERT(frontier_size > 0);
+    const coord_def pos = frontier[frontier_head];
+    frontier_head = (frontier_head + 1) % frontier.size();
+    --frontier_size;
+    return pos;
 }
 
 void noise_grid::register_noise(const noise_t &noise)
 {
-    noise_cell &target_cell(cells(noise.noise_source));
+    noise_cell &target_cell(cell_at(noise.noise_source));
     if (target_cell.can_apply_noise(noise.noise_intensity_millis))
     {
         const int noise_index = noises.size();
         noises.push_back(noise);
         noises[noise_index].noise_id = noise_index;
-        cells(noise.noise_source).apply_noise(noise.noise_intensity_millis,
-                                              noise_index,
-                                              0,
-                                              coord_def(0, 0));
+        target_cell.apply_noise(noise.noise_intensity_millis,
+                                noise_index,
+                                0,
+                                coord_def(0, 0));
+
+        // Every step costs at least the base attenuation, so this is as far
+        // as the noise can possibly be heard.
+        const int reach =
+            max(0, (noise.noise_intensity_millis
+                    - LOWEST_AUDIBLE_NOISE_INTENSITY_MILLIS)
+                   / BASE_NOISE_ATTENUATION_MILLIS);
+        const coord_def &src(noise.noise_source);
+        audible_tl.x = max(X_BOUND_1 + 1, min(audible_tl.x, src.x - reach));
+        audible_tl.y = max(Y_BOUND_1 + 1, min(audible_tl.y, src.y - reach));
+        audible_br.x = min(X_BOUND_2 - 1, max(audible_br.x, src.x + reach));
+        audible_br.y = min(Y_BOUND_2 - 1, max(audible_br.y, src.y + reach));
     }
 }
 
@@ -960,21 +1060,22 @@ void noise_grid::propagate_noise()
     dprf(DIAG_NOISE, "noise_grid: %u noises to apply",
          (unsigned int)noises.size());
 #endif
-    vector<coord_def> noise_perimeter[2];
-    int circ_index = 0;
+    frontier_head = frontier_size = 0;
 
+    // Louder noises registered later at the same square replace quieter
+    // ones, so only queue each source square once.
     for (const noise_t &noise : noises)
-        noise_perimeter[circ_index].push_back(noise.noise_source);
+        if (cell_at(noise.noise_source).noise_id == noise.noise_id)
+            push_frontier(noise.noise_source);
 
     int travel_distance = 0;
-    while (!noise_perimeter[circ_index].empty())
+    while (frontier_size)
     {
-        const vector<coord_def> &perimeter(noise_perimeter[circ_index]);
-        vector<coord_def> &next_perimeter(noise_perimeter[!circ_index]);
         ++travel_distance;
-        for (const coord_def p : perimeter)
+        for (int left = frontier_size; left > 0; --left)
         {
-            const noise_cell &cell(cells(p));
+            const coord_def p = pop_frontier();
+            const noise_cell &cell(cell_at(p));
 
             if (!cell.silent())
             {
@@ -997,7 +1098,7 @@ void noise_grid::propagate_noise()
                             {
                                 const coord_def next_position(p.x + xi,
                                                               p.y + yi);
-                                if (in_bounds(next_position)
+                                if (in_audible_box(next_position)
                                     && !silenced(next_position))
                                 {
                                     if (propagate_noise_to_neighbour(
@@ -1006,7 +1107,7 @@ void noise_grid::propagate_noise()
                                             cell, p,
                                             next_position))
                                     {
-                                        next_perimeter.push_back(next_position);
+                                        push_frontier(next_position);
                                     }
                                 }
                             }
@@ -1015,9 +1116,6 @@ void noise_grid::propagate_noise()
                 }
             }
         }
-
-        noise_perimeter[circ_index].clear();
-        circ_index = !circ_index;
     }
 
 #ifdef DEBUG_NOISE_PROPAGATION
@@ -1036,7 +1134,7 @@ bool noise_grid::propagate_noise_to_neighbour(int base_attenuation,
                                               const coord_def &current_pos,
                                               const coord_def &next_pos)
 {
-    noise_cell &neighbour(cells(next_pos));
+    noise_cell &neighbour(cell_at(next_pos));
     if (!neighbour.can_apply_noise(cell.noise_intensity_millis
                                    - base_attenuation))
     {
@@ -1119,7 +1217,8 @@ coord_def noise_grid::noise_perceived_position(actor *act,
                                                const coord_def &affected_pos,
                                                const noise_t &noise) const
 {
-    const int noise_travel_distance = cells(affected_pos).noise_travel_distance;
+    const int noise_travel_distance =
+        cell_at(affected_pos).noise_travel_distance;
     if (!noise_travel_distance)
         return noise.noise_source;
 
@@ -1230,7 +1329,7 @@ static void _write_noise_grid_css(FILE *outf)
 
 void noise_grid::write_cell(FILE *outf, coord_def p, int ch) const
 {
-    const int intensity = min(25, cells(p).noise_intensity_millis / 1000);
+    const int intensity = min(25, cell_at(p).noise_intensity_millis / 1000);
     if (intensity)
         fprintf(outf, "<span class='i%d'>&#%d;</span>", intensity, ch);
     else
@@ -19,7 +19,18 @@ void check_monsters_sense(sense_type sense, int range, const coord_def& where);
 
 void blood_smell(int strength, const coord_def& where);
 void handle_monster_shouts(monster* mons, bool force = false);
-bool check_awaken(monster* mons, int stealth);
+
+// What check_awaken needs to know about the player. It is the same for every
+// monster looked at in a turn, so callers work it out once for all of them.
+struct player_stealth_info
+{
+    explicit player_stealth_info(int stealth);
+
+    int stealth;
+    bool always_noticed; // berserk, or no stealth at all
+    bool invisible;
+};
+bool check_awaken(monster* mons, const player_stealth_info &you_info);
 
 void apply_noises();
 
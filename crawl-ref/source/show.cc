@@ -16,6 +16,9 @@
 #include "dungeon.h"
 #include "itemprop.h"
 #include "libutil.h"
+#include "los.h"
+#include "losglobal.h"
+#include "misc.h"
 #include "mon-place.h"
 #include "options.h"
 #include "state.h"
@@ -339,6 +342,10 @@ static bool _valid_invisible_spot(const coord_def &where, const monster* mons)
     return false;
 }
 
+// Cells given MAP_INVISIBLE_UPDATE since the last show_init(), so that it
+// can clear just those rather than walking LOS a second time.
+static vector<coord_def> _invisible_updates;
+
 static int _hashed_rand(const monster* mons, uint32_t id, uint32_t die)
 {
     if (die <= 1)
@@ -371,6 +378,8 @@ static void _mark_invisible_at(const coord_def &where,
                                bool do_tiles_draw = false)
 {
     env.map_knowledge(where).set_invisible_monster();
+    if (!(env.map_knowledge(where).flags & MAP_INVISIBLE_UPDATE))
+        _invisible_updates.push_back(where);
     env.map_knowledge(where).flags |= MAP_INVISIBLE_UPDATE;
 
     if (do_tiles_draw)
@@ -443,8 +452,7 @@ static void _update_monster(monster* mons)
     if (mons->visible_to(&you))
     {
         mons->ensure_has_client_id();
-        monster_info mi(mons);
-        env.map_knowledge(gp).set_monster(mi);
+        env.map_knowledge(gp).set_monster(mons);
         return;
     }
 
@@ -559,19 +567,29 @@ void show_init(layers_type layers)
             // Invis indicators and update flags not used in Arena.
             env.map_knowledge(*ri).flags &= ~MAP_INVISIBLE_UPDATE;
         }
+        _invisible_updates.clear();
         return;
     }
 
-    vector <coord_def> update_locs;
-    for (radius_iterator ri(you.pos(), you.xray_vision ? LOS_NONE : LOS_DEFAULT); ri; ++ri)
-    {
+    const los_type los = you.xray_vision ? LOS_NONE : LOS_DEFAULT;
+    for (radius_iterator ri(you.pos(), los); ri; ++ri)
         show_update_at(*ri, layers);
-        update_locs.push_back(*ri);
-    }
 
-    // Need to clear these update flags now so they don't persist.
-    for (coord_def loc : update_locs)
-        env.map_knowledge(loc).flags &= ~MAP_INVISIBLE_UPDATE;
+    // Need to clear these update flags now so they don't persist. Only
+    // cells the loop above covered are cleared; a mark left elsewhere
+    // stays until that cell is back in view, as it always has.
+    erase_if(_invisible_updates, [&](const coord_def &loc) {
+        map_cell &cell = env.map_knowledge(loc);
+        if (!(cell.flags & MAP_INVISIBLE_UPDATE))
+            return true;
+        if ((loc - you.pos()).rdist() > los_radius
+            || los != LOS_NONE && !cell_see_cell(you.pos(), loc, los))
+        {
+            return false;
+        }
+        cell.flags &= ~MAP_INVISIBLE_UPDATE;
+        return true;
+    });
 }
 
 // Emphasis may change while off-level. This catches up.
@@ -588,3 +606,33 @@ void show_update_emphasis()
         if (stair.destination.is_valid())
             env.map_knowledge(stair.position).flags &= ~MAP_EMPHASIZE;
 }
+
+static bool _monster_info_fresh = false;
+
+fresh_monster_info_scope::fresh_monster_info_scope(bool fresh)
+    : was_fresh(_monster_info_fresh)
+{
+    _monster_info_fresh = fresh;
+}
+
+fresh_monster_info_scope::~fresh_monster_info_scope()
+{
+    _monster_info_fresh = was_fresh;
+}
+
+const monster_info* fresh_monster_info(const monster* mons)
+{
+    if (!_monster_info_fresh || crawl_state.game_is_arena()
+        || !in_bounds(mons->pos()))
+    {
+        return nullptr;
+    }
+
+    const monster_info* mi = env.map_knowledge(mons->pos()).monsterinfo();
+    if (!mi || mi->pos != mons->pos() || mi->type != mons->type
+        || !mi->client_id || mi->client_id != mons->get_client_id())
+    {
+        return nullptr;
+    }
+    return mi;
+}
@@ -88,4 +88,18 @@ void update_item_at(const coord_def &gp, bool detected = false);
 void show_update_at(const coord_def &gp, layers_type layers = LAYERS_ALL);
 void show_update_emphasis();
 
+// While one of these is alive, the monster_info that show_init() left in
+// map_knowledge for each visible monster describes the current state, and
+// fresh_monster_info() will hand it out instead of having it rebuilt.
+class fresh_monster_info_scope
+{
+public:
+    fresh_monster_info_scope(bool fresh);
+    ~fresh_monster_info_scope();
+private:
+    bool was_fresh;
+};
+
+const monster_info* fresh_monster_info(const monster* mons);
+
 #endif
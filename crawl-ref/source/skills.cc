@@ -376,9 +376,12 @@ void check_skill_level_change(skill_type sk, bool do_level_up)
 
 // Fill a queue in random order with the values of the array.
 template <typename T, int SIZE>
-static void _init_queue(list<skill_type> &queue, FixedVector<T, SIZE> &array)
+static void _init_queue(list<skill_type> &queue,
+                        FixedVector<unsigned int, NUM_SKILLS> &count,
+                        FixedVector<T, SIZE> &array)
 {
     ASSERT(queue.empty());
+    count.init(0);
 
     while (1)
     {
@@ -386,12 +389,39 @@ static void _init_queue(list<skill_type> &queue, FixedVector<T, SIZE> &array)
         if (is_invalid_skill(sk))
             break;
         queue.push_back(sk);
+        ++count[sk];
         --array[sk];
     }
 
     ASSERT(queue.size() == (unsigned)EXERCISE_QUEUE_SIZE);
 }
 
+// Push sk onto the back of an exercise queue, dropping the oldest event.
+static void _push_exercise(list<skill_type> &queue,
+                           FixedVector<unsigned int, NUM_SKILLS> &count,
+                           skill_type sk)
+{
+    queue.push_back(sk);
+    ++count[sk];
+    --count[queue.front()];
+    queue.pop_front();
+}
+
+/*
+ * Recount the exercise queues, for when they are filled directly (as when
+ * loading a save).
+ */
+void count_exercises()
+{
+    you.exercise_count.init(0);
+    for (auto sk : you.exercises)
+        ++you.exercise_count[sk];
+
+    you.exercise_all_count.init(0);
+    for (auto sk : you.exercises_all)
+        ++you.exercise_all_count[sk];
+}
+
 static void _erase_from_stop_train(const skill_set &can_train)
 {
     for (skill_type sk : can_train)
@@ -653,13 +683,13 @@ void init_training()
             skills[i] = sqr(you.skill_points[i]);
 
     _scale_array(skills, EXERCISE_QUEUE_SIZE, true);
-    _init_queue(you.exercises, skills);
+    _init_queue(you.exercises, you.exercise_count, skills);
 
     for (int i = 0; i < NUM_SKILLS; ++i)
         skills[i] = sqr(you.skill_points[i]);
 
     _scale_array(skills, EXERCISE_QUEUE_SIZE, true);
-    _init_queue(you.exercises_all, skills);
+    _init_queue(you.exercises_all, you.exercise_all_count, skills);
 
     reset_training();
 }
@@ -728,29 +758,24 @@ void reset_training()
             you.training[i] = you.train[i];
 
     bool empty = true;
-    // In automatic mode, we fill the array with the content of the queue.
+    // In automatic mode, we fill the array with the content of the queue,
+    // using the per-skill counts rather than walking it.
     if (you.auto_training)
     {
-        for (auto sk : you.exercises)
-            if (skill_trained(sk))
-            {
-                you.training[sk] += you.train[sk];
-                empty = false;
-            }
+        for (int sk = 0; sk < NUM_SKILLS; ++sk)
+        {
+            if (!skill_trained(sk))
+                continue;
 
-        // We count the practise events in the other queue.
-        FixedVector<unsigned int, NUM_SKILLS> exer_all;
-        exer_all.init(0);
-        for (auto sk : you.exercises_all)
-            if (skill_trained(sk))
+            // We keep the highest of the 2 queues' practise events.
+            const unsigned int events = max(you.exercise_count[sk],
+                                            you.exercise_all_count[sk]);
+            if (events)
             {
-                exer_all[sk] += you.train[sk];
+                you.training[sk] += events * you.train[sk];
                 empty = false;
             }
-
-        // We keep the highest of the 2 numbers.
-        for (int sk = 0; sk < NUM_SKILLS; ++sk)
-            you.training[sk] = max(you.training[sk], exer_all[sk]);
+        }
 
         // The selected skills have not been exercised recently. Give them all
         // a default weight of 1 (or 2 for focus skills).
@@ -781,12 +806,8 @@ void exercise(skill_type exsk, int deg)
     while (deg > 0)
     {
         if (skill_trained(exsk))
-        {
-            you.exercises.push_back(exsk);
-            you.exercises.pop_front();
-        }
-        you.exercises_all.push_back(exsk);
-        you.exercises_all.pop_front();
+            _push_exercise(you.exercises, you.exercise_count, exsk);
+        _push_exercise(you.exercises_all, you.exercise_all_count, exsk);
         deg--;
     }
     reset_training();
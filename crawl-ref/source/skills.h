@@ -48,6 +48,7 @@ bool check_selected_skills();
 void init_train();
 void init_can_train();
 void init_training();
+void count_exercises();
 void update_can_train();
 void reset_training();
 void check_skill_level_change(skill_type sk, bool do_level_up = true);
@@ -540,37 +540,56 @@ bool has_spells_to_memorise(bool silent, spell_type current_spell)
                          (spell_type) current_spell);
 }
 
-static bool _sort_mem_spells(spell_type a, spell_type b)
+// What the memorisation list is sorted by, worked out once per spell rather
+// than on every comparison: failure rates are costly to compute.
+struct mem_spell_key
+{
+    spell_type spell;
+    bool offering;
+    bool fits;
+    int fail_rate;
+    int difficulty;
+};
+
+static bool _mem_spell_key_less(const mem_spell_key &a,
+                                const mem_spell_key &b)
 {
     // List the Vehumet gifts at the very top.
-    bool offering_a = vehumet_is_offering(a);
-    bool offering_b = vehumet_is_offering(b);
-    if (offering_a != offering_b)
-        return offering_a;
+    if (a.offering != b.offering)
+        return a.offering;
 
     // List spells we can memorize right away first.
-    if (player_spell_levels() >= spell_levels_required(a)
-        && player_spell_levels() < spell_levels_required(b))
-    {
-        return true;
-    }
-    else if (player_spell_levels() < spell_levels_required(a)
-             && player_spell_levels() >= spell_levels_required(b))
-    {
-        return false;
-    }
+    if (a.fits != b.fits)
+        return a.fits;
 
     // Don't sort by failure rate beyond what the player can see in the
     // success descriptions.
-    const int fail_rate_a = failure_rate_to_int(raw_spell_fail(a));
-    const int fail_rate_b = failure_rate_to_int(raw_spell_fail(b));
-    if (fail_rate_a != fail_rate_b)
-        return fail_rate_a < fail_rate_b;
+    if (a.fail_rate != b.fail_rate)
+        return a.fail_rate < b.fail_rate;
+
+    if (a.difficulty != b.difficulty)
+        return a.difficulty < b.difficulty;
+
+    return strcasecmp(spell_title(a.spell), spell_title(b.spell)) < 0;
+}
+
+static void _sort_mem_spells(spell_list &spells)
+{
+    const int levels = player_spell_levels();
+    vector<mem_spell_key> keys;
+    keys.reserve(spells.size());
+    for (spell_type spell : spells)
+    {
+        keys.push_back({spell, vehumet_is_offering(spell),
+                        levels >= spell_levels_required(spell),
+                        failure_rate_to_int(raw_spell_fail(spell)),
+                        spell_difficulty(spell)});
+    }
 
-    if (spell_difficulty(a) != spell_difficulty(b))
-        return spell_difficulty(a) < spell_difficulty(b);
+    sort(keys.begin(), keys.end(), _mem_spell_key_less);
 
-    return strcasecmp(spell_title(a), spell_title(b)) < 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+        spells[i] = keys[i].spell;
 }
 
 vector<spell_type> get_mem_spell_list(vector<int> &books)
@@ -584,7 +603,7 @@ vector<spell_type> get_mem_spell_list(vector<int> &books)
     if (!_get_mem_list(mem_spells, book_hash, num_misc))
         return spells;
 
-    sort(mem_spells.begin(), mem_spells.end(), _sort_mem_spells);
+    _sort_mem_spells(mem_spells);
 
     for (spell_type spell : mem_spells)
     {
@@ -599,7 +618,7 @@ static spell_type _choose_mem_spell(spell_list &spells,
                                     spells_to_books &book_hash,
                                     unsigned int num_misc)
 {
-    sort(spells.begin(), spells.end(), _sort_mem_spells);
+    _sort_mem_spells(spells);
 
 #ifdef USE_TILE_LOCAL
     const bool text_only = false;
@@ -3466,14 +3466,15 @@ void summoned_monster(const monster *mons, const actor *caster,
     int count = 1;
     for (monster_iterator mi; mi; ++mi)
     {
-        if (mons == *mi)
+        // Most monsters on the level aren't this caster's; rule them out
+        // before looking at their enchantments.
+        if (mons == *mi || mi->summoner != caster->mid)
             continue;
 
         int duration = 0;
         int stype    = 0;
         const bool summoned = mi->is_summoned(&duration, &stype);
-        if (summoned && stype == spell && caster->mid == mi->summoner
-            && mons_aligned(caster, *mi))
+        if (summoned && stype == spell && mons_aligned(caster, *mi))
         {
             // Count large abominations and tentacled monstrosities separately
             if (spell == SPELL_SUMMON_HORRIBLE_THINGS && mi->type != mons->type)
@@ -3513,13 +3514,12 @@ int count_summons(const actor *summoner, spell_type spell)
     int count = 0;
     for (monster_iterator mi; mi; ++mi)
     {
-        if (summoner == *mi)
+        if (summoner == *mi || mi->summoner != summoner->mid)
             continue;
 
         int stype    = 0;
         const bool summoned = mi->is_summoned(nullptr, &stype);
-        if (summoned && stype == spell && summoner->mid == mi->summoner
-            && mons_aligned(summoner, *mi))
+        if (summoned && stype == spell && mons_aligned(summoner, *mi))
         {
             count++;
         }
@@ -269,20 +269,30 @@ void tornado_damage(actor *caster, int dur)
     vector<coord_def>     move_avail; // legal destinations
     map<mid_t, coord_def> move_dest;  // chosen destination
     int rdurs[TORNADO_RADIUS+1];           // durations at radii
+    int ring_open[TORNADO_RADIUS+1] = {}; // wind-reachable cells per radius
+    int ring_all[TORNADO_RADIUS+1]  = {}; // in-bounds cells per radius
     int cnt_open = 0;
     int cnt_all  = 0;
 
-    distance_iterator count_i(org, false);
+    // A plain scan of the square gives the same per-ring cell sets as a
+    // distance_iterator, without building its ring lists.
+    for (int dx = -TORNADO_RADIUS; dx <= TORNADO_RADIUS; dx++)
+        for (int dy = -TORNADO_RADIUS; dy <= TORNADO_RADIUS; dy++)
+        {
+            const coord_def c = org + coord_def(dx, dy);
+            const int r = max(abs(dx), abs(dy));
+            if (!r || !in_bounds(c))
+                continue;
+            ring_all[r]++;
+            if (winds.has_wind(c))
+                ring_open[r]++;
+        }
+
     distance_iterator dam_i(org, true);
     for (int r = 1; r <= TORNADO_RADIUS; r++)
     {
-        while (count_i && count_i.radius() == r)
-        {
-            if (winds.has_wind(*count_i))
-                cnt_open++;
-            ++cnt_all;
-            ++count_i;
-        }
+        cnt_open += ring_open[r];
+        cnt_all  += ring_all[r];
         // effective age at radius r
         int rage = age - _age_needed(r);
         /* Not just "portion of time affected":
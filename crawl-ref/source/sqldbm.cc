@@ -128,6 +128,20 @@ From SQLite's documentation:
 
 int SQL_DBM::init_schema()
 {
+    // The game's own databases are only ever read: the table is there
+    // already, and trying to create it would just fail.
+    if (readonly)
+    {
+#ifndef ANCIENT_SQLITE
+        // Read pages straight out of a mapping of the file instead of
+        // copying them through SQLite's page cache. Older libraries
+        // silently ignore the pragma.
+        sqlite3_exec(db, "PRAGMA mmap_size=67108864;", nullptr, nullptr,
+                     nullptr);
+#endif
+        return ec(SQLITE_OK);
+    }
+
     int err = ec(sqlite3_exec(
                   db,
                   "CREATE TABLE dbm (key STRING UNIQUE PRIMARY KEY,"
@@ -137,13 +151,9 @@ int SQL_DBM::init_schema()
                   nullptr));
 
     // Turn off auto-commit
-    if (!readonly)
-    {
-        for (sqlite_retry_iterator ri; ri;
-             ri.check(ec(sqlite3_exec(db, "BEGIN;", nullptr, nullptr,
-                                      nullptr))))
-        {}
-    }
+    for (sqlite_retry_iterator ri; ri;
+         ri.check(ec(sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr))))
+    {}
     return err;
 }
 
@@ -231,7 +241,9 @@ int SQL_DBM::do_query(const string &key, string *result)
     if (init_query() != SQLITE_OK)
         return errc;
 
-    if (ec(sqlite3_bind_text(s_query, 1, key.c_str(), -1, SQLITE_TRANSIENT))
+    // The key outlives the statement's use of it, so needn't be copied.
+    if (ec(sqlite3_bind_text(s_query, 1, key.c_str(), key.length(),
+                             SQLITE_STATIC))
         != SQLITE_OK)
     {
         return errc;
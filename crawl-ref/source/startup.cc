@@ -7,6 +7,11 @@
 
 #include "startup.h"
 
+#include <chrono>
+#ifdef TARGET_OS_LINUX
+#include <unistd.h>
+#endif
+
 #include "abyss.h"
 #include "arena.h"
 #include "branch.h"
@@ -66,9 +71,92 @@
 
 static void _cio_init();
 
+// Timings and resident memory growth of the stages of _initialize(), for
+// -startup-profile.
+struct startup_stage
+{
+    const char *name;
+    chrono::steady_clock::duration elapsed;
+    long rss_kb;
+};
+static vector<startup_stage> _startup_stages;
+static chrono::steady_clock::time_point _stage_mark;
+static long _stage_rss_mark;
+
+// The resident set size of the process in kilobytes, or -1 if unknown.
+static long _resident_kb()
+{
+#ifdef TARGET_OS_LINUX
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return -1;
+    long pages_total, pages_resident;
+    const bool ok = fscanf(statm, "%ld %ld", &pages_total,
+                           &pages_resident) == 2;
+    fclose(statm);
+    return ok ? pages_resident * (sysconf(_SC_PAGESIZE) / 1024) : -1;
+#else
+    return -1;
+#endif
+}
+
+// Charge the time and memory since the previous mark to the named stage.
+static void _stage_done(const char *name)
+{
+    if (!SysEnv.startup_profile)
+        return;
+
+    const auto now = chrono::steady_clock::now();
+    const long rss = _resident_kb();
+    _startup_stages.push_back({name, now - _stage_mark,
+                               rss < 0 || _stage_rss_mark < 0
+                                   ? -1 : rss - _stage_rss_mark});
+    _stage_mark = now;
+    _stage_rss_mark = rss;
+}
+
+static void _report_startup_profile()
+{
+    if (!SysEnv.startup_profile)
+        return;
+
+    chrono::steady_clock::duration total(0);
+    for (const startup_stage &stage : _startup_stages)
+        total += stage.elapsed;
+
+    const double total_ms =
+        chrono::duration<double, milli>(total).count();
+    fprintf(stderr, "Startup profile:\n");
+    for (const startup_stage &stage : _startup_stages)
+    {
+        const double ms =
+            chrono::duration<double, milli>(stage.elapsed).count();
+        fprintf(stderr, "  %-28s %9.2f ms %5.1f%%", stage.name, ms,
+                total_ms > 0 ? 100.0 * ms / total_ms : 0.0);
+        if (stage.rss_kb >= 0)
+            fprintf(stderr, " %+8ld KB", stage.rss_kb);
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "  %-28s %9.2f ms", "total", total_ms);
+    if (_stage_rss_mark >= 0)
+        fprintf(stderr, "       %9ld KB resident", _stage_rss_mark);
+    fprintf(stderr, "\n");
+    _startup_stages.clear();
+}
+
 // Initialise a whole lot of stuff...
+//
+// The glyph tables and item name cache depend on the player's glyph
+// options, and the databases on their language; the spell and monster
+// indexes, dungeon Lua and maps are the same for every game of this
+// version. Only that second group could be shared by a resident
+// pre-initialised launcher without reading the rc file first.
 static void _initialize()
 {
+    _stage_mark = chrono::steady_clock::now();
+    if (SysEnv.startup_profile)
+        _stage_rss_mark = _resident_kb();
+
     Options.fixup_options();
 
     you.symbol = MONS_PLAYER;
@@ -78,18 +166,22 @@ static void _initialize()
     init_char_table(Options.char_set);
     init_show_table();
     init_monster_symbols();
+    _stage_done("glyph tables");
     init_spell_descs();        // This needs to be way up top. {dlb}
     init_zap_index();
     init_mut_index();
     init_sac_index();
     init_duration_index();
+    _stage_done("spell and effect indexes");
     init_mon_name_cache();
     init_mons_spells();
+    _stage_done("monster caches");
 
     // init_item_name_cache() needs to be redone after init_char_table()
     // and init_show_table() have been called, so that the glyphs will
     // be set to use with item_names_by_glyph_cache.
     init_item_name_cache();
+    _stage_done("item name cache");
 
     msg::initialise_mpr_streams();
 
@@ -107,9 +199,11 @@ static void _initialize()
 
     you.unique_creatures.reset();
     you.unique_items.init(UNIQ_NOT_EXISTS);
+    _stage_done("item and monster arrays");
 
     // Set up the Lua interpreter for the dungeon builder.
     init_dungeon_lua();
+    _stage_done("dungeon Lua");
 
 #ifdef USE_TILE_LOCAL
     // Draw the splash screen before the database gets initialised as that
@@ -124,6 +218,7 @@ static void _initialize()
 
     // Initialise internal databases.
     databaseSystemInit();
+    _stage_done("databases");
 #ifdef USE_TILE_LOCAL
     if (!crawl_state.tiles_disabled && crawl_state.title_screen)
         tiles.update_title_msg("Loading spells and features...");
@@ -132,6 +227,7 @@ static void _initialize()
     init_feat_desc_cache();
     init_spell_name_cache();
     init_spell_rarities();
+    _stage_done("feature and spell caches");
 #ifdef USE_TILE_LOCAL
     if (!crawl_state.tiles_disabled && crawl_state.title_screen)
         tiles.update_title_msg("Loading maps...");
@@ -139,7 +235,10 @@ static void _initialize()
 
     // Read special levels and vaults.
     read_maps();
+    _stage_done("maps");
     run_map_global_preludes();
+    _stage_done("map preludes");
+    _report_startup_profile();
 
     if (crawl_state.build_db)
         end(0);
@@ -154,11 +253,23 @@ static void _initialize()
     }
 #endif
 
+    // Either may set Options.seed.
+    if (!SysEnv.replay_bench_file.empty())
+        keylog_start_replay(SysEnv.replay_bench_file);
+    else if (!SysEnv.record_keys_file.empty())
+        keylog_start_recording(SysEnv.record_keys_file);
+
     if (Options.seed)
         seed_rng(Options.seed);
 
 #ifdef DEBUG_STATISTICS
-    if (crawl_state.map_stat_gen)
+    if (crawl_state.kernel_bench)
+    {
+        release_cli_signals();
+        mapstat_run_benchmarks();
+        end(0, false);
+    }
+    else if (crawl_state.map_stat_gen)
     {
         release_cli_signals();
         mapstat_generate_stats();
@@ -172,6 +283,12 @@ static void _initialize()
     }
 #endif
 
+    if (!SysEnv.arena_batch_file.empty())
+    {
+        release_cli_signals();
+        run_arena_batch(SysEnv.arena_batch_file);
+    }
+
     if (!crawl_state.test_list)
     {
         if (!crawl_state.io_inited)
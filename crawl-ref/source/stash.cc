@@ -165,7 +165,8 @@ static void _fully_identify_item(item_def *item)
 // Stash
 // ----------------------------------------------------------------------
 
-Stash::Stash(coord_def pos_) : items()
+Stash::Stash(coord_def pos_)
+    : items(), search_words(), search_words_stale(true)
 {
     // First, fix what square we're interested in
     if (pos_.origin())
@@ -254,6 +255,8 @@ bool Stash::unmark_trapping_nets()
     for (auto &item : items)
         if (item_is_stationary_net(item))
             item.net_placed = false, changed = true;
+    if (changed)
+        search_words_stale = true;
     return changed;
 }
 
@@ -272,16 +275,19 @@ void Stash::update()
             feat = DNGN_FLOOR, trap = TRAP_UNASSIGNED;
     }
 
+    const string old_feat_desc = feat_desc;
     if (feat == DNGN_FLOOR)
         feat_desc = "";
     else
         feat_desc = feature_description_at(pos, false, DESC_A, false);
+    if (feat_desc != old_feat_desc)
+        search_words_stale = true;
 
     // If this is your position, you know what's on this square
     if (pos == you.pos())
     {
         // Zap existing items
-        items.clear();
+        clear_items();
 
         // Now, grab all items on that square and fill our vector
         for (stack_iterator si(pos, true); si; ++si)
@@ -295,7 +301,7 @@ void Stash::update()
     {
         if (!_grid_has_perceived_item(pos))
         {
-            items.clear();
+            clear_items();
             verified = true;
             return;
         }
@@ -309,7 +315,7 @@ void Stash::update()
         const item_def& item = *pitem;
 
         if (!_grid_has_perceived_multiple_items(pos))
-            items.clear();
+            clear_items();
 
         // We knew of nothing on this square, so we'll assume this is the
         // only item here, but mark it as unverified unless we can see nothing
@@ -360,7 +366,10 @@ void Stash::update()
             // If this is unverified, forget last item on stack. This isn't
             // terribly clever, but it prevents the vector swelling forever.
             if (!verified)
+            {
                 items.pop_back();
+                search_words_stale = true;
+            }
 
             // Items are different. We'll put this item in the front of our
             // vector, and mark this as unverified
@@ -495,6 +504,8 @@ void Stash::_update_corpses(int rot_time)
             continue;
 
         int new_rot = static_cast<int>(item.stash_freshness) - rot_time;
+        // The name may have gained a "(skeletalised by now)".
+        search_words_stale = true;
 
         if (new_rot <= _min_rot(item))
         {
@@ -509,8 +520,9 @@ void Stash::_update_identification()
 {
     for (int i = items.size() - 1; i >= 0; i--)
     {
-        god_id_item(items[i]);
-        maybe_identify_base_type(items[i]);
+        const bool god_ided = god_id_item(items[i]);
+        if (maybe_identify_base_type(items[i]) || god_ided)
+            search_words_stale = true;
     }
 }
 
@@ -523,6 +535,7 @@ void Stash::add_item(const item_def &item, bool add_to_front)
         items.insert(items.begin(), item);
     else
         items.push_back(item);
+    search_words_stale = true;
 
     seen_item(item);
 
@@ -535,6 +548,50 @@ void Stash::add_item(const item_def &item, bool add_to_front)
     it.stash_freshness     = it.freshness;
 }
 
+void Stash::clear_items()
+{
+    if (!items.empty())
+        search_words_stale = true;
+    items.clear();
+}
+
+static void _add_search_words(const string &text, set<string> &words)
+{
+    string::size_type start = 0;
+    while (start < text.length())
+    {
+        if (isspace(static_cast<unsigned char>(text[start])))
+        {
+            ++start;
+            continue;
+        }
+        string::size_type end = start;
+        while (end < text.length()
+               && !isspace(static_cast<unsigned char>(text[end])))
+        {
+            ++end;
+        }
+        words.insert(lowercase_string(text.substr(start, end - start)));
+        start = end;
+    }
+}
+
+// The words that matches_search() can see, save for the level prefix.
+vector<string> Stash::search_text_words() const
+{
+    set<string> words;
+    for (const item_def &item : items)
+    {
+        _add_search_words(stash_item_name(item), words);
+        _add_search_words(stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE,
+                                              &item), words);
+        if (is_dumpable_artefact(item))
+            _add_search_words(chardump_desc(item), words);
+    }
+    _add_search_words(feature_description(), words);
+    return vector<string>(words.begin(), words.end());
+}
+
 void Stash::write(FILE *f, coord_def refpos, string place, bool identify) const
 {
     if (items.empty() && verified)
@@ -627,6 +684,7 @@ void Stash::load(reader& inf)
 
     // Zap out item vector, in case it's in use (however unlikely)
     items.clear();
+    search_words_stale = true;
     // Read in the items
     for (int i = 0; i < count; ++i)
     {
@@ -747,7 +805,9 @@ void ShopInfo::write(FILE *f, bool identify) const
 LevelStashes::LevelStashes()
     : m_place(level_id::current()),
       m_stashes(),
-      m_shops()
+      m_shops(),
+      m_search_index(),
+      m_search_generation(item_name_generation())
 {
 }
 
@@ -849,6 +909,8 @@ void LevelStashes::move_stash(const coord_def& from, const coord_def& to)
         return;
 
     coord_def old_pos = s->pos;
+    _unindex_stash(*s);
+    s->search_words_stale = true;
     s->pos = to;
     m_stashes[s->pos] = *s;
     m_stashes.erase(old_pos);
@@ -857,9 +919,47 @@ void LevelStashes::move_stash(const coord_def& from, const coord_def& to)
 // Removes a Stash from the level.
 void LevelStashes::kill_stash(const Stash &s)
 {
+    _unindex_stash(s);
     m_stashes.erase(s.pos);
 }
 
+// Drops the stash from the search index and marks it for re-indexing.
+void LevelStashes::_unindex_stash(const Stash &s)
+{
+    for (const string &word : s.search_words)
+    {
+        auto entry = m_search_index.find(word);
+        if (entry == m_search_index.end())
+            continue;
+        entry->second.erase(s.pos);
+        if (entry->second.empty())
+            m_search_index.erase(entry);
+    }
+}
+
+// Re-files every stash whose searchable text may have changed since it was
+// last indexed. Item names depend on what the player has identified, so a
+// new identification refiles the whole level.
+void LevelStashes::_update_search_index()
+{
+    const unsigned int generation = item_name_generation();
+    const bool refile_all = generation != m_search_generation;
+    m_search_generation = generation;
+
+    for (auto &entry : m_stashes)
+    {
+        Stash &s = entry.second;
+        if (!s.search_words_stale && !refile_all)
+            continue;
+
+        _unindex_stash(s);
+        s.search_words = s.search_text_words();
+        for (const string &word : s.search_words)
+            m_search_index[word].insert(s.pos);
+        s.search_words_stale = false;
+    }
+}
+
 void LevelStashes::add_stash(coord_def p)
 {
     Stash *s = find_stash(p);
@@ -911,9 +1011,13 @@ void LevelStashes::_waypoint_search(
     }
 }
 
+// If search_key is non-empty, it is a lowercased space-free piece of text
+// that every match of search must contain, and only stashes filed under a
+// word containing it are tried. Otherwise each stash is tried in turn.
 void LevelStashes::get_matching_stashes(
         const base_pattern &search,
-        vector<stash_search_result> &results) const
+        vector<stash_search_result> &results,
+        const string &search_key) const
 {
     string lplace = "{" + m_place.describe() + "}";
 
@@ -931,14 +1035,41 @@ void LevelStashes::get_matching_stashes(
         return;
     }
 
-    for (const auto &entry : m_stashes)
+    // The level name and the autopickup annotation aren't indexed.
+    if (search_key.empty()
+        || lowercase_string(lplace).find(search_key) != string::npos
+        || string("{autopickup}").find(search_key) != string::npos)
     {
-        vector<stash_search_result> new_results =
-            entry.second.matches_search(lplace, search);
-        for (auto &res : new_results)
+        for (const auto &entry : m_stashes)
         {
-            res.pos.id = m_place;
-            results.push_back(res);
+            vector<stash_search_result> new_results =
+                entry.second.matches_search(lplace, search);
+            for (auto &res : new_results)
+            {
+                res.pos.id = m_place;
+                results.push_back(res);
+            }
+        }
+    }
+    else
+    {
+        set<coord_def> candidates;
+        for (const auto &entry : m_search_index)
+            if (entry.first.find(search_key) != string::npos)
+                candidates.insert(entry.second.begin(), entry.second.end());
+
+        for (const coord_def &c : candidates)
+        {
+            const Stash *stash = find_stash(c);
+            if (!stash)
+                continue;
+            vector<stash_search_result> new_results =
+                stash->matches_search(lplace, search);
+            for (auto &res : new_results)
+            {
+                res.pos.id = m_place;
+                results.push_back(res);
+            }
         }
     }
 
@@ -1301,12 +1432,24 @@ static vector<stash_search_result> _inventory_search(const base_pattern &search)
     return results;
 }
 
+// The longest whitespace-free piece of literal search text, lowercased.
+// Any text matching the search would have to contain it within one word.
+static string _stash_search_key(const string &text)
+{
+    string key;
+    for (const string &piece : split_string(" ", lowercase_string(text)))
+        if (piece.length() > key.length())
+            key = piece;
+    return key;
+}
+
 void StashTracker::search_stashes()
 {
     char buf[400];
 
     update_corpses();
     update_identification();
+    update_search_index();
 
     stash_search_reader reader(buf, sizeof buf);
 
@@ -1349,6 +1492,9 @@ void StashTracker::search_stashes()
     }
 
     base_pattern *search = nullptr;
+    // Text every match must contain, if we can tell; see
+    // _stash_search_key().
+    string key_text;
 
     lua_text_pattern ltpat(csearch);
     text_pattern tpat(csearch, true);
@@ -1364,6 +1510,8 @@ void StashTracker::search_stashes()
             csearch.erase(0, 1);
         tpat = csearch;
         search = &tpat;
+        if (csearch.find_first_of("\\^$.|?*+()[]{}") == string::npos)
+            key_text = csearch;
     }
     else
     {
@@ -1371,6 +1519,7 @@ void StashTracker::search_stashes()
             csearch.erase(0, 1);
         ptpat = csearch;
         search = &ptpat;
+        key_text = csearch;
     }
 
     if (!search->valid() && csearch != "*")
@@ -1384,7 +1533,8 @@ void StashTracker::search_stashes()
     vector<stash_search_result> results;
     if (!curr_lev)
         results = _inventory_search(*search);
-    get_matching_stashes(*search, results, curr_lev);
+    get_matching_stashes(*search, results, curr_lev,
+                         _stash_search_key(key_text));
 
     if (results.empty())
     {
@@ -1421,7 +1571,8 @@ void StashTracker::search_stashes()
 void StashTracker::get_matching_stashes(
         const base_pattern &search,
         vector<stash_search_result> &results,
-        bool curr_lev)
+        bool curr_lev,
+        const string &search_key)
     const
 {
     level_id curr = level_id::current();
@@ -1429,7 +1580,7 @@ void StashTracker::get_matching_stashes(
     {
         if (curr_lev && curr != entry.first)
             continue;
-        entry.second.get_matching_stashes(search, results);
+        entry.second.get_matching_stashes(search, results, search_key);
         if (results.size() > SEARCH_SPAM_THRESHOLD)
             return;
     }
@@ -1679,6 +1830,12 @@ void StashTracker::update_identification()
         entry.second._update_identification();
 }
 
+void StashTracker::update_search_index()
+{
+    for (auto &entry : levels)
+        entry.second._update_search_index();
+}
+
 //////////////////////////////////////////////
 
 ST_ItemIterator::ST_ItemIterator()
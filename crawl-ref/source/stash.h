@@ -7,6 +7,7 @@
 #define STASH_H
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -68,6 +69,8 @@ private:
     void _update_corpses(int rot_time);
     void _update_identification();
     void add_item(const item_def &item, bool add_to_front = false);
+    void clear_items();
+    vector<string> search_text_words() const;
 
 private:
     bool verified;      // Is this correct to the best of our knowledge?
@@ -78,6 +81,11 @@ private:
 
     vector<item_def> items;
 
+    // The words this stash was last filed under in its level's search index,
+    // and whether they may have changed since.
+    vector<string> search_words;
+    bool search_words_stale;
+
     static bool are_items_same(const item_def &, const item_def &,
                                bool exact = false);
 
@@ -174,7 +182,8 @@ public:
     level_id where() const;
 
     void get_matching_stashes(const base_pattern &search,
-                              vector<stash_search_result> &results) const;
+                              vector<stash_search_result> &results,
+                              const string &search_key = "") const;
 
     // Update stash at (x,y).
     bool  update_stash(const coord_def& c);
@@ -215,16 +224,24 @@ public:
 private:
     void _update_corpses(int rot_time);
     void _update_identification();
+    void _update_search_index();
+    void _unindex_stash(const Stash &s);
     void _waypoint_search(int n, vector<stash_search_result> &results) const;
 
     typedef map<coord_def, Stash> stashes_t;
     typedef vector<ShopInfo> shops_t;
+    // Lowercased word -> stashes whose search text contains it.
+    typedef map<string, set<coord_def>> search_index_t;
 
     // which level
     level_id m_place;
     stashes_t m_stashes;
     shops_t m_shops;
 
+    search_index_t m_search_index;
+    // item_name_generation() when m_search_index was last brought up to date.
+    unsigned int m_search_generation;
+
     friend class StashTracker;
     friend class ST_ItemIterator;
 };
@@ -251,6 +268,7 @@ public:
 
     void update_corpses();
     void update_identification();
+    void update_search_index();
 
     void update_visible_stashes();
 
@@ -275,7 +293,8 @@ public:
 private:
     void get_matching_stashes(const base_pattern &search,
                               vector<stash_search_result> &results,
-                              bool curr_lev = false) const;
+                              bool curr_lev = false,
+                              const string &search_key = "") const;
     bool display_search_results(vector<stash_search_result> &results,
                                 bool& sort_by_dist,
                                 bool& filter_useless,
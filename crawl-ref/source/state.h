@@ -52,6 +52,7 @@ struct game_state
 
     bool map_stat_gen;      // Set if we're generating stats on maps.
     bool obj_stat_gen;      // Set if we're generating object stats.
+    bool kernel_bench;      // Set if we're timing core kernels (-bench).
 
     game_type type;
     game_type last_type;
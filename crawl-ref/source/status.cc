@@ -1044,6 +1044,18 @@ int duration_mid_offset(duration_type dur)
     return _lookup_duration(dur)->decr.mid_msg.offset();
 }
 
+/**
+ * Does duration_mid_offset() roll for this duration, rather than always
+ * returning 0?
+ *
+ * @param dur   The duration in question (e.g. DUR_PETRIFICATION).
+ * @return      Whether the duration's midpoint message has a max offset.
+ */
+bool duration_has_mid_offset(duration_type dur)
+{
+    return _lookup_duration(dur)->decr.mid_msg.max_offset != 0;
+}
+
 /**
  * What channel should the duration messages be printed in?
  *
@@ -74,6 +74,7 @@ const char *duration_end_message(duration_type dur);
 void duration_end_effect(duration_type dur);
 const char *duration_mid_message(duration_type dur);
 int duration_mid_offset(duration_type dur);
+bool duration_has_mid_offset(duration_type dur);
 msg_channel_type duration_mid_chan(duration_type dur);
 
 #endif
@@ -1249,6 +1249,14 @@ CrawlHashTable::CrawlHashTable(const CrawlHashTable& other)
     hash_map = new hash_map_type(*(other.hash_map));
 }
 
+// Moving just hands the map over, so clearing or shuffling items (whose
+// props live here) doesn't copy and free every table.
+CrawlHashTable::CrawlHashTable(CrawlHashTable&& other) noexcept
+    : hash_map(other.hash_map)
+{
+    other.hash_map = nullptr;
+}
+
 CrawlHashTable::~CrawlHashTable()
 {
     // NOTE: Not using unique_ptr because making hash_map an unique_ptr
@@ -1262,17 +1270,31 @@ CrawlHashTable::~CrawlHashTable()
 
 CrawlHashTable &CrawlHashTable::operator = (const CrawlHashTable &other)
 {
-    if (hash_map != nullptr)
-        delete hash_map;
+    if (this == &other)
+        return *this;
 
     if (other.hash_map == nullptr)
     {
+        delete hash_map;
         hash_map = nullptr;
-        return *this;
     }
+    // Reuse the map we already have rather than reallocating it.
+    else if (hash_map != nullptr)
+        *hash_map = *other.hash_map;
+    else
+        hash_map = new hash_map_type(*(other.hash_map));
 
-    hash_map = new hash_map_type(*(other.hash_map));
+    return *this;
+}
 
+CrawlHashTable &CrawlHashTable::operator = (CrawlHashTable &&other) noexcept
+{
+    if (this != &other)
+    {
+        delete hash_map;
+        hash_map = other.hash_map;
+        other.hash_map = nullptr;
+    }
     return *this;
 }
 
@@ -1350,6 +1372,17 @@ bool CrawlHashTable::exists(const string &key) const
     return hash_map->find(key) != hash_map->end();
 }
 
+// Most props tables are empty, and most lookups are literals; don't build
+// a string just to miss.
+bool CrawlHashTable::exists(const char *key) const
+{
+#ifndef DEBUG_PROPS
+    if (!hash_map || hash_map->empty())
+        return false;
+#endif
+    return exists(string(key));
+}
+
 void CrawlHashTable::assert_validity() const
 {
 #ifdef DEBUG
@@ -1462,8 +1495,10 @@ bool CrawlHashTable::empty() const
 
 void CrawlHashTable::erase(const string& key)
 {
+    if (!hash_map)
+        return;
+
     ASSERT_VALIDITY();
-    init_hash_map();
 
     ACCESS(key);
     iterator i = hash_map->find(key);
@@ -1479,6 +1514,15 @@ void CrawlHashTable::erase(const string& key)
     }
 }
 
+void CrawlHashTable::erase(const char *key)
+{
+#ifndef DEBUG_PROPS
+    if (!hash_map || hash_map->empty())
+        return;
+#endif
+    erase(string(key));
+}
+
 void CrawlHashTable::clear()
 {
     ASSERT_VALIDITY();
@@ -252,6 +252,7 @@ class CrawlHashTable
 public:
     CrawlHashTable();
     CrawlHashTable(const CrawlHashTable& other);
+    CrawlHashTable(CrawlHashTable&& other) noexcept;
 
     ~CrawlHashTable();
 
@@ -270,11 +271,13 @@ protected:
 
 public:
     CrawlHashTable &operator = (const CrawlHashTable &other);
+    CrawlHashTable &operator = (CrawlHashTable &&other) noexcept;
 
     void write(writer &) const;
     void read(reader &);
 
     bool exists(const string &key) const;
+    bool exists(const char *key) const;
     void assert_validity() const;
 
     // NOTE: If the const versions of get_value() or [] are given a
@@ -307,7 +310,7 @@ public:
     bool      empty() const;
 
     void      erase(const string& key);
-    void      erase(const char *key) { erase(string(key)); }
+    void      erase(const char *key);
     void      clear();
 
     const_iterator begin() const;
@@ -21,6 +21,7 @@
 # include <fcntl.h>
 # include <sys/types.h>
 # include <sys/stat.h>
+# include <sys/time.h>
 #endif
 
 #include "files.h"
@@ -118,6 +119,19 @@ bool read_urandom(char *buf, int len)
 #endif
 }
 
+// A wall-clock millisecond counter, for measuring intervals only: it wraps.
+unsigned int get_milliseconds()
+{
+#ifdef TARGET_OS_WINDOWS
+    return GetTickCount();
+#else
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    return ((unsigned int) tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
 #ifdef TARGET_OS_WINDOWS
 # ifndef UNIX
 // should check the presence of alarm() instead
@@ -15,6 +15,8 @@ bool unlock_file(int fd);
 
 bool read_urandom(char *buf, int len);
 
+unsigned int get_milliseconds();
+
 #ifdef TARGET_OS_WINDOWS
 # ifndef UNIX
 void alarm(unsigned int seconds);
@@ -184,6 +184,9 @@ enum tag_minor_version
     TAG_MINOR_UNSHOPINFO,          // Fixup after revert of previous
     TAG_MINOR_UNUNSHOPINFO,        // Restoration of the tag two before
     TAG_MINOR_MESSAGE_REPEATS,     // Rewrite the way message repeats work
+    TAG_MINOR_LEVEL_COLUMNS,       // Run-length encode level grids by column
+    TAG_MINOR_DETECTED_MONS_TYPE,  // Save detected monsters as just a type
+    TAG_MINOR_NOTE_BLOCKS,         // Save full blocks of notes once each
 #endif
     NUM_TAG_MINORS,
     TAG_MINOR_VERSION = NUM_TAG_MINORS - 1
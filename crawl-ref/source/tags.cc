@@ -98,7 +98,8 @@ extern abyss_state abyssal_state;
 
 reader::reader(const string &_read_filename, int minorVersion)
     : _filename(_read_filename), _chunk(0), _pbuf(nullptr), _read_offset(0),
-      _minorVersion(minorVersion), _safe_read(false)
+      _staged_pos(0), _staged_len(0), _minorVersion(minorVersion),
+      _safe_read(false)
 {
     _file       = fopen_u(_filename.c_str(), "rb");
     opened_file = !!_file;
@@ -106,7 +107,8 @@ reader::reader(const string &_read_filename, int minorVersion)
 
 reader::reader(package *save, const string &chunkname, int minorVersion)
     : _file(0), _chunk(0), opened_file(false), _pbuf(0), _read_offset(0),
-     _minorVersion(minorVersion), _safe_read(false)
+      _staged_pos(0), _staged_len(0), _minorVersion(minorVersion),
+      _safe_read(false)
 {
     ASSERT(save);
     _chunk = new chunk_reader(save, chunkname);
@@ -126,18 +128,6 @@ void reader::close()
     _file = nullptr;
 }
 
-void reader::advance(size_t offset)
-{
-    char junk[128];
-
-    while (offset)
-    {
-        const size_t junklen = min(sizeof(junk), offset);
-        offset -= junklen;
-        read(junk, junklen);
-    }
-}
-
 bool reader::valid() const
 {
     return (_file && !feof(_file)) ||
@@ -153,8 +143,42 @@ static NORETURN void _short_read(bool safe_read)
     die_noline("short read while reading save");
 }
 
-// Reads input in network byte order, from a file or buffer.
-unsigned char reader::readByte()
+void reader::advance(size_t offset)
+{
+    // Files and buffers can just be skipped over; a lazily loaded map can
+    // sit far into its .dsc cache, and reading through everything before
+    // it would drag the whole file in.
+    if (_file)
+    {
+        if (fseek(_file, (long)offset, SEEK_CUR))
+            _short_read(_safe_read);
+        return;
+    }
+    if (_pbuf)
+    {
+        read(nullptr, offset);
+        return;
+    }
+
+    char junk[128];
+
+    while (offset)
+    {
+        const size_t junklen = min(sizeof(junk), offset);
+        offset -= junklen;
+        read(junk, junklen);
+    }
+}
+
+void reader::refill_staged()
+{
+    _staged_pos = 0;
+    _staged_len = _chunk->read(_staged, sizeof(_staged));
+}
+
+// Reads input in network byte order, from a file or buffer. readByte()
+// only gets here once the staged chunk input runs out.
+unsigned char reader::get_byte()
 {
     if (_file)
     {
@@ -165,10 +189,10 @@ unsigned char reader::readByte()
     }
     else if (_chunk)
     {
-        unsigned char buf;
-        if (_chunk->read(&buf, 1) != 1)
+        refill_staged();
+        if (!_staged_len)
             _short_read(_safe_read);
-        return buf;
+        return _staged[_staged_pos++];
     }
     else
     {
@@ -192,8 +216,28 @@ void reader::read(void *data, size_t size)
     }
     else if (_chunk)
     {
-        if (_chunk->read(data, size) != size)
-            _short_read(_safe_read);
+        unsigned char *out = static_cast<unsigned char *>(data);
+        while (size)
+        {
+            if (_staged_pos == _staged_len)
+            {
+                // Big reads bypass the staging buffer.
+                if (size >= sizeof(_staged))
+                {
+                    if (_chunk->read(out, size) != size)
+                        _short_read(_safe_read);
+                    return;
+                }
+                refill_staged();
+                if (!_staged_len)
+                    _short_read(_safe_read);
+            }
+            const size_t n = min(size, _staged_len - _staged_pos);
+            memcpy(out, _staged + _staged_pos, n);
+            _staged_pos += n;
+            out += n;
+            size -= n;
+        }
     }
     else
     {
@@ -220,7 +264,7 @@ void reader::setMinorVersion(int minorVersion)
 void reader::fail_if_not_eof(const string &name)
 {
     char dummy;
-    if (_chunk ? _chunk->read(&dummy, 1) :
+    if (_chunk ? _staged_pos < _staged_len || _chunk->read(&dummy, 1) :
         _file ? (fgetc(_file) != EOF) :
         _read_offset >= _pbuf->size())
     {
@@ -238,13 +282,33 @@ void writer::check_ok(bool ok)
     }
 }
 
-void writer::writeByte(unsigned char ch)
+writer::~writer()
+{
+    if (_chunk)
+    {
+        flush_staged();
+        delete _chunk;
+    }
+}
+
+void writer::flush_staged()
+{
+    if (_staged_len)
+        _chunk->write(_staged, _staged_len);
+    _staged_len = 0;
+}
+
+// writeByte() only gets here when there is no staging buffer, or it is full.
+void writer::put_byte(unsigned char ch)
 {
     if (failed)
         return;
 
     if (_chunk)
-        _chunk->write(&ch, 1);
+    {
+        flush_staged();
+        _staged[_staged_len++] = ch;
+    }
     else if (_file)
         check_ok(fputc(ch, _file) != EOF);
     else
@@ -257,7 +321,18 @@ void writer::write(const void *data, size_t size)
         return;
 
     if (_chunk)
-        _chunk->write(data, size);
+    {
+        if (_staged_len + size > _staged_cap)
+            flush_staged();
+        // Big writes bypass the staging buffer.
+        if (size >= _staged_cap)
+            _chunk->write(data, size);
+        else
+        {
+            memcpy(_staged + _staged_len, data, size);
+            _staged_len += size;
+        }
+    }
     else if (_file)
         check_ok(fwrite(data, 1, size, _file) == size);
     else
@@ -329,6 +404,8 @@ static void marshallMonsterInfo (writer &, const monster_info &);
 static void unmarshallMonsterInfo (reader &, monster_info &mi);
 static void marshallMapCell (writer &, const map_cell &);
 static void unmarshallMapCell (reader &, map_cell& cell);
+static void _marshall_map_knowledge(writer &th, const MapKnowledge &mk);
+static void _unmarshall_map_knowledge(reader &th, MapKnowledge &mk);
 
 template<typename T, typename T_iter, typename T_marshal>
 static void marshall_iterator(writer &th, T_iter beg, T_iter end,
@@ -367,18 +444,20 @@ uint8_t unmarshallUByte(reader &th)
 void marshallShort(writer &th, short data)
 {
     CHECK_INITIALIZED(data);
-    const char b2 = (char)(data & 0x00FF);
-    const char b1 = (char)((data & 0xFF00) >> 8);
-    th.writeByte(b1);
-    th.writeByte(b2);
+    const unsigned char b[2] =
+    {
+        (unsigned char)((data & 0xFF00) >> 8),
+        (unsigned char)(data & 0x00FF),
+    };
+    th.write(b, sizeof(b));
 }
 
 // Unmarshall 2 byte short in network order.
 int16_t unmarshallShort(reader &th)
 {
-    int16_t b1 = th.readByte();
-    int16_t b2 = th.readByte();
-    int16_t data = (b1 << 8) | (b2 & 0x00FF);
+    unsigned char b[2];
+    th.read(b, sizeof(b));
+    int16_t data = (b[0] << 8) | b[1];
     return data;
 }
 
@@ -386,27 +465,23 @@ int16_t unmarshallShort(reader &th)
 void marshallInt(writer &th, int32_t data)
 {
     CHECK_INITIALIZED(data);
-    char b4 = (char) (data & 0x000000FF);
-    char b3 = (char)((data & 0x0000FF00) >> 8);
-    char b2 = (char)((data & 0x00FF0000) >> 16);
-    char b1 = (char)((data & 0xFF000000) >> 24);
-
-    th.writeByte(b1);
-    th.writeByte(b2);
-    th.writeByte(b3);
-    th.writeByte(b4);
+    const unsigned char b[4] =
+    {
+        (unsigned char)((data & 0xFF000000) >> 24),
+        (unsigned char)((data & 0x00FF0000) >> 16),
+        (unsigned char)((data & 0x0000FF00) >> 8),
+        (unsigned char) (data & 0x000000FF),
+    };
+    th.write(b, sizeof(b));
 }
 
 // Unmarshall 4 byte signed int in network order.
 int32_t unmarshallInt(reader &th)
 {
-    int32_t b1 = th.readByte();
-    int32_t b2 = th.readByte();
-    int32_t b3 = th.readByte();
-    int32_t b4 = th.readByte();
-
-    int32_t data = (b1 << 24) | ((b2 & 0x000000FF) << 16);
-    data |= ((b3 & 0x000000FF) << 8) | (b4 & 0x000000FF);
+    unsigned char b[4];
+    th.read(b, sizeof(b));
+    int32_t data = ((uint32_t)b[0] << 24) | (b[1] << 16);
+    data |= (b[2] << 8) | b[3];
     return data;
 }
 
@@ -743,17 +818,21 @@ static void _unmarshall_constriction(reader &th, actor *who)
         who->constricting = new actor::constricting_t(cmap);
 }
 
-template <typename marshall, typename grid>
-static void _run_length_encode(writer &th, marshall m, const grid &g,
-                               int width, int height)
+// Run-length encodes get(x, y) over a width by height area, row by row:
+// each run is a count byte followed by the value, written with m.
+template <typename marshall, typename getter>
+static void _run_length_encode_by(writer &th, marshall m, getter get,
+                                  int width, int height)
 {
-    int last = 0, nlast = 0;
+    auto last = get(0, 0);
+    int nlast = 0;
     for (int y = 0; y < height; ++y)
         for (int x = 0; x < width; ++x)
         {
+            const auto value = get(x, y);
             if (!nlast)
-                last = g[x][y];
-            if (last == g[x][y] && nlast < 255)
+                last = value;
+            if (last == value && nlast < 255)
             {
                 nlast++;
                 continue;
@@ -762,7 +841,7 @@ static void _run_length_encode(writer &th, marshall m, const grid &g,
             marshallByte(th, nlast);
             m(th, last);
 
-            last = g[x][y];
+            last = value;
             nlast = 1;
         }
 
@@ -770,27 +849,46 @@ static void _run_length_encode(writer &th, marshall m, const grid &g,
     m(th, last);
 }
 
-template <typename unmarshall, typename grid>
-static void _run_length_decode(reader &th, unmarshall um, grid &g,
-                               int width, int height)
+// The reverse of _run_length_encode_by: calls set(x, y, value) for each
+// cell, with values read by um.
+template <typename unmarshall, typename setter>
+static void _run_length_decode_by(reader &th, unmarshall um, setter set,
+                                  int width, int height)
 {
     const int end = width * height;
     int offset = 0;
     while (offset < end)
     {
         const int run = unmarshallUByte(th);
-        const int value = um(th);
+        const auto value = um(th);
 
         for (int i = 0; i < run; ++i)
         {
             const int y = offset / width;
             const int x = offset % width;
-            g[x][y] = value;
+            set(x, y, value);
             ++offset;
         }
     }
 }
 
+template <typename marshall, typename grid>
+static void _run_length_encode(writer &th, marshall m, const grid &g,
+                               int width, int height)
+{
+    _run_length_encode_by(th, m, [&g](int x, int y) { return (int)g[x][y]; },
+                          width, height);
+}
+
+template <typename unmarshall, typename grid>
+static void _run_length_decode(reader &th, unmarshall um, grid &g,
+                               int width, int height)
+{
+    _run_length_decode_by(th, [um](reader &r) { return (int)um(r); },
+                          [&g](int x, int y, int v) { g[x][y] = v; },
+                          width, height);
+}
+
 union float_marshall_kludge
 {
     // [ds] Does ANSI C guarantee that sizeof(float) == sizeof(long)?
@@ -1246,6 +1344,7 @@ void tag_read(reader &inf, tag_type tag_id)
         _add_missing_branches();
 #endif
         _shunt_monsters_out_of_walls();
+        mons_index_rebuild();
         // The Abyss needs to visit other levels during level gen, before
         // all cells have been filled. We mustn't crash when it returns
         // from those excursions, and generate_abyss will check_map_validity
@@ -1260,12 +1359,12 @@ void tag_read(reader &inf, tag_type tag_id)
         // We can't do this when we unmarshall shops, since we haven't
         // unmarshalled items yet...
         if (th.getMinorVersion() < TAG_MINOR_SHOP_HACK)
-            for (auto& entry : env.shop)
+            for (shop_struct& shop : env.shop)
             {
                 // Shop items were heaped up at this cell.
-                for (stack_iterator si(coord_def(0, entry.second.num+5)); si; ++si)
+                for (stack_iterator si(coord_def(0, shop.num+5)); si; ++si)
                 {
-                    entry.second.stock.push_back(*si);
+                    shop.stock.push_back(*si);
                     dec_mitm_item_quantity(si.index(), si->quantity);
                 }
             }
@@ -2526,6 +2625,7 @@ static void tag_read_you(reader &th)
     count = unmarshallByte(th);
     for (int i = 0; i < count; i++)
         you.exercises_all.push_back((skill_type)unmarshallInt(th));
+    count_exercises();
 
     you.skill_menu_do = static_cast<skill_menu_state>(unmarshallByte(th));
     you.skill_menu_view = static_cast<skill_menu_state>(unmarshallByte(th));
@@ -3887,19 +3987,16 @@ static void tag_construct_level(writer &th)
 
     CANARY;
 
-    for (int count_x = 0; count_x < GXM; count_x++)
-        for (int count_y = 0; count_y < GYM; count_y++)
-        {
-            marshallByte(th, grd[count_x][count_y]);
-            marshallMapCell(th, env.map_knowledge[count_x][count_y]);
-            marshallInt(th, env.pgrid[count_x][count_y]);
-        }
+    _run_length_encode_by(th, marshallUByte,
+                          [](int x, int y) { return grd[x][y]; }, GXM, GYM);
+    _marshall_map_knowledge(th, env.map_knowledge);
+    _run_length_encode_by(th, marshallUnsigned,
+                          [](int x, int y) { return env.pgrid[x][y]; },
+                          GXM, GYM);
 
     marshallBoolean(th, !!env.map_forgotten.get());
     if (env.map_forgotten.get())
-        for (int x = 0; x < GXM; x++)
-            for (int y = 0; y < GYM; y++)
-                marshallMapCell(th, (*env.map_forgotten)[x][y]);
+        _marshall_map_knowledge(th, *env.map_forgotten);
 
     _run_length_encode(th, marshallByte, env.grid_colours, GXM, GYM);
 
@@ -3907,9 +4004,8 @@ static void tag_construct_level(writer &th)
 
     // how many clouds?
     marshallShort(th, env.cloud.size());
-    for (const auto& entry : env.cloud)
+    for (const cloud_struct& cloud : env.cloud)
     {
-        const cloud_struct& cloud = entry.second;
         marshallByte(th, cloud.type);
         ASSERT(cloud.type != CLOUD_NONE);
         ASSERT_IN_BOUNDS(cloud.pos);
@@ -3930,8 +4026,8 @@ static void tag_construct_level(writer &th)
 
     // how many shops?
     marshallShort(th, env.shop.size());
-    for (const auto& entry : env.shop)
-        marshall_shop(th, entry.second);
+    for (const shop_struct& shop : env.shop)
+        marshall_shop(th, shop);
 
     CANARY;
 
@@ -4499,6 +4595,8 @@ void unmarshallItem(reader &th, item_def &item)
 #define MAP_SERIALIZE_ITEM 0x10
 #define MAP_SERIALIZE_CLOUD 0x20
 #define MAP_SERIALIZE_MONSTER 0x40
+// A detected monster, which is nothing but the base type it was sensed as.
+#define MAP_SERIALIZE_DETECTED_MONSTER 0x80
 
 void marshallMapCell(writer &th, const map_cell &cell)
 {
@@ -4523,7 +4621,9 @@ void marshallMapCell(writer &th, const map_cell &cell)
     if (cell.item())
         flags |= MAP_SERIALIZE_ITEM;
 
-    if (cell.monster() != MONS_NO_MONSTER)
+    if (cell.detected_monster() && cell.monster() == MONS_SENSED)
+        flags |= MAP_SERIALIZE_DETECTED_MONSTER;
+    else if (cell.monster() != MONS_NO_MONSTER)
         flags |= MAP_SERIALIZE_MONSTER;
 
     marshallUnsigned(th, flags);
@@ -4569,6 +4669,8 @@ void marshallMapCell(writer &th, const map_cell &cell)
 
     if (flags & MAP_SERIALIZE_MONSTER)
         marshallMonsterInfo(th, *cell.monsterinfo());
+    else if (flags & MAP_SERIALIZE_DETECTED_MONSTER)
+        marshallShort(th, cell.monsterinfo()->base_type);
 }
 
 void unmarshallMapCell(reader &th, map_cell& cell)
@@ -4663,18 +4765,115 @@ void unmarshallMapCell(reader &th, map_cell& cell)
         unmarshallMonsterInfo(th, mi);
         cell.set_monster(mi);
     }
+    else if (flags & MAP_SERIALIZE_DETECTED_MONSTER)
+        cell.set_detected_monster(unmarshallMonType(th));
 
     // set this last so the other sets don't override this
     cell.flags = cell_flags;
 }
 
+// Applies the terrain fixups older saves need, to a feature read from the
+// level's grid or map knowledge.
+static dungeon_feature_type _fixup_level_feature(reader &th,
+                                                 dungeon_feature_type feat)
+{
+#if TAG_MAJOR_VERSION == 34
+    if (feat == DNGN_SEALED_DOOR && th.getMinorVersion() < TAG_MINOR_0_12)
+        return DNGN_CLOSED_DOOR;
+    if (feat == DNGN_BADLY_SEALED_DOOR)
+        return DNGN_SEALED_DOOR;
+    if (feat == DNGN_ESCAPE_HATCH_UP && player_in_branch(BRANCH_LABYRINTH))
+        return DNGN_EXIT_LABYRINTH;
+    if (feat == DNGN_DEEP_WATER && player_in_branch(BRANCH_SHOALS)
+        && th.getMinorVersion() < TAG_MINOR_SHOALS_LITE)
+    {
+        return DNGN_SHALLOW_WATER;
+    }
+#else
+    UNUSED(th);
+#endif
+    return feat;
+}
+
+// Cells whose knowledge goes beyond flags, feature and colour.
+static bool _map_cell_has_details(const map_cell &cell)
+{
+    return feat_is_trap(cell.feat()) || cell.cloud() != CLOUD_NONE
+           || cell.item() || cell.monster() != MONS_NO_MONSTER;
+}
+
+// Map knowledge is written as run-length encoded flag, feature and colour
+// columns, since most of a level is long runs of the same rock or floor.
+// The few cells that also remember a trap, cloud, item or monster follow
+// in full.
+static void _marshall_map_knowledge(writer &th, const MapKnowledge &mk)
+{
+    _run_length_encode_by(th, marshallUnsigned,
+                          [&mk](int x, int y) { return mk[x][y].flags; },
+                          GXM, GYM);
+    _run_length_encode_by(th, marshallUnsigned,
+                          [&mk](int x, int y) { return mk[x][y].feat(); },
+                          GXM, GYM);
+    _run_length_encode_by(th, marshallUnsigned,
+                          [&mk](int x, int y)
+                          { return mk[x][y].feat_colour(); },
+                          GXM, GYM);
+
+    vector<coord_def> detailed;
+    for (rectangle_iterator ri(0); ri; ++ri)
+        if (_map_cell_has_details(mk(*ri)))
+            detailed.push_back(*ri);
+
+    marshallShort(th, detailed.size());
+    for (const coord_def &c : detailed)
+    {
+        marshallCoord(th, c);
+        marshallMapCell(th, mk(c));
+    }
+}
+
+static void _unmarshall_map_knowledge(reader &th, MapKnowledge &mk)
+{
+    for (rectangle_iterator ri(0); ri; ++ri)
+        mk(*ri).clear();
+
+    _run_length_decode_by(th,
+        [](reader &r) { return (uint32_t)unmarshallUnsigned(r); },
+        [&mk](int x, int y, uint32_t f) { mk[x][y].flags = f; },
+        GXM, GYM);
+    _run_length_decode_by(th,
+        [](reader &r)
+        {
+#if TAG_MAJOR_VERSION == 34
+            return _fixup_level_feature(r, unmarshallFeatureType_Info(r));
+#else
+            return (dungeon_feature_type)unmarshallUnsigned(r);
+#endif
+        },
+        [&mk](int x, int y, dungeon_feature_type f)
+        { mk[x][y].set_feature(f); },
+        GXM, GYM);
+    _run_length_decode_by(th,
+        [](reader &r) { return (unsigned)unmarshallUnsigned(r); },
+        [&mk](int x, int y, unsigned c)
+        { mk[x][y].set_feature(mk[x][y].feat(), c); },
+        GXM, GYM);
+
+    const int detailed = unmarshallShort(th);
+    for (int i = 0; i < detailed; ++i)
+    {
+        const coord_def c = unmarshallCoord(th);
+        ASSERT(map_bounds(c));
+        unmarshallMapCell(th, mk(c));
+    }
+}
+
 static void tag_construct_level_items(writer &th)
 {
     // how many traps?
     marshallShort(th, env.trap.size());
-    for (const auto& entry : env.trap)
+    for (const trap_def& trap : env.trap)
     {
-        const trap_def& trap = entry.second;
         marshallByte(th, trap.type);
         marshallCoord(th, trap.pos);
         marshallShort(th, trap.ammo_qty);
@@ -5302,31 +5501,38 @@ static void tag_read_level(reader &th)
 
     EAT_CANARY;
 
-    env.map_seen.reset();
-    for (int i = 0; i < gx; i++)
-        for (int j = 0; j < gy; j++)
-        {
-            dungeon_feature_type feat = unmarshallFeatureType(th);
-            grd[i][j] = feat;
-            ASSERT(feat < NUM_FEATURES);
-#if TAG_MAJOR_VERSION == 34
-            if (feat == DNGN_SEALED_DOOR && th.getMinorVersion() < TAG_MINOR_0_12)
-                grd[i][j] = DNGN_CLOSED_DOOR;
-            if (feat == DNGN_BADLY_SEALED_DOOR)
-                grd[i][j] = DNGN_SEALED_DOOR;
-            if (feat == DNGN_ESCAPE_HATCH_UP
-                && player_in_branch(BRANCH_LABYRINTH))
-            {
-                grd[i][j] = DNGN_EXIT_LABYRINTH;
-            }
-            if (feat == DNGN_DEEP_WATER && player_in_branch(BRANCH_SHOALS)
-                && th.getMinorVersion() < TAG_MINOR_SHOALS_LITE)
+#if TAG_MAJOR_VERSION == 34
+    if (th.getMinorVersion() < TAG_MINOR_LEVEL_COLUMNS)
+    {
+        for (int i = 0; i < gx; i++)
+            for (int j = 0; j < gy; j++)
             {
-                grd[i][j] = DNGN_SHALLOW_WATER;
+                grd[i][j] = _fixup_level_feature(th,
+                                                 unmarshallFeatureType(th));
+                unmarshallMapCell(th, env.map_knowledge[i][j]);
+                env.pgrid[i][j] = unmarshallInt(th);
             }
+    }
+    else
 #endif
+    {
+        _run_length_decode_by(th,
+            [](reader &r) { return _fixup_level_feature(r,
+                                        unmarshallFeatureType(r)); },
+            [](int x, int y, dungeon_feature_type f) { grd[x][y] = f; },
+            GXM, GYM);
+        _unmarshall_map_knowledge(th, env.map_knowledge);
+        _run_length_decode_by(th,
+            [](reader &r) { return (terrain_property_t)unmarshallUnsigned(r); },
+            [](int x, int y, terrain_property_t p) { env.pgrid[x][y] = p; },
+            GXM, GYM);
+    }
 
-            unmarshallMapCell(th, env.map_knowledge[i][j]);
+    env.map_seen.reset();
+    for (int i = 0; i < gx; i++)
+        for (int j = 0; j < gy; j++)
+        {
+            ASSERT(grd[i][j] < NUM_FEATURES);
             // Fixup positions
             if (env.map_knowledge[i][j].monsterinfo())
                 env.map_knowledge[i][j].monsterinfo()->pos = coord_def(i, j);
@@ -5336,7 +5542,6 @@ static void tag_read_level(reader &th)
             env.map_knowledge[i][j].flags &= ~MAP_VISIBLE_FLAG;
             if (env.map_knowledge[i][j].seen())
                 env.map_seen.set(i, j);
-            env.pgrid[i][j] = unmarshallInt(th);
 
             mgrd[i][j] = NON_MONSTER;
         }
@@ -5349,9 +5554,16 @@ static void tag_read_level(reader &th)
     if (unmarshallBoolean(th))
     {
         MapKnowledge *f = new MapKnowledge();
-        for (int x = 0; x < GXM; x++)
-            for (int y = 0; y < GYM; y++)
-                unmarshallMapCell(th, (*f)[x][y]);
+#if TAG_MAJOR_VERSION == 34
+        if (th.getMinorVersion() < TAG_MINOR_LEVEL_COLUMNS)
+        {
+            for (int x = 0; x < GXM; x++)
+                for (int y = 0; y < GYM; y++)
+                    unmarshallMapCell(th, (*f)[x][y]);
+        }
+        else
+#endif
+        _unmarshall_map_knowledge(th, *f);
         env.map_forgotten.reset(f);
     }
     else
@@ -5514,7 +5726,7 @@ static void tag_read_level_items(reader &th)
         for (int j = 0; j < GYM; j++)
         {
             coord_def pos(i, j);
-            if (feat_is_trap(grd(pos), true) && !map_find(env.trap, pos))
+            if (feat_is_trap(grd(pos), true) && !env.trap.find(pos))
                 grd(pos) = DNGN_FLOOR;
         }
 #endif
@@ -5972,6 +6184,7 @@ static void tag_read_level_monsters(reader &th)
     // how many monsters?
     count = unmarshallShort(th);
     ASSERT_RANGE(count, 0, MAX_MONSTERS + 1);
+    env.mons_slots_used = count;
 
     for (int i = 0; i < count; i++)
     {
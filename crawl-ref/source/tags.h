@@ -37,24 +37,34 @@ class writer
 public:
     writer(const string &filename, FILE* output, bool ignore_errors = false)
         : _filename(filename), _file(output), _chunk(0),
-          _ignore_errors(ignore_errors), _pbuf(0), failed(false)
+          _ignore_errors(ignore_errors), _pbuf(0), _staged_len(0),
+          _staged_cap(0), failed(false)
     {
         ASSERT(output);
     }
     writer(vector<unsigned char>* poutput)
         : _filename(), _file(0), _chunk(0), _ignore_errors(false),
-          _pbuf(poutput), failed(false) { ASSERT(poutput); }
+          _pbuf(poutput), _staged_len(0), _staged_cap(0), failed(false)
+    {
+        ASSERT(poutput);
+    }
     writer(package *save, const string &chunkname)
         : _filename(), _file(0), _chunk(0), _ignore_errors(false),
-          failed(false)
+          _staged_len(0), _staged_cap(sizeof(_staged)), failed(false)
     {
         ASSERT(save);
         _chunk = save->writer(chunkname);
     }
 
-    ~writer() { if (_chunk) delete _chunk; }
+    ~writer();
 
-    void writeByte(unsigned char byte);
+    void writeByte(unsigned char byte)
+    {
+        if (_staged_len < _staged_cap)
+            _staged[_staged_len++] = byte;
+        else
+            put_byte(byte);
+    }
     void write(const void *data, size_t size);
     long tell();
 
@@ -62,6 +72,8 @@ public:
 
 private:
     void check_ok(bool ok);
+    void put_byte(unsigned char byte);
+    void flush_staged();
 
 private:
     string _filename;
@@ -71,6 +83,12 @@ private:
 
     vector<unsigned char>* _pbuf;
 
+    // Chunk output is collected here and handed to the compressor in
+    // large blocks. _staged_cap is 0 for file and buffer writers.
+    unsigned char _staged[8192];
+    size_t _staged_len;
+    size_t _staged_cap;
+
     bool failed;
 };
 
@@ -99,16 +117,23 @@ public:
     reader(const string &filename, int minorVersion = TAG_MINOR_INVALID);
     reader(FILE* input, int minorVersion = TAG_MINOR_INVALID)
         : _file(input), _chunk(0), opened_file(false), _pbuf(0),
-          _read_offset(0), _minorVersion(minorVersion), _safe_read(false) {}
+          _read_offset(0), _staged_pos(0), _staged_len(0),
+          _minorVersion(minorVersion), _safe_read(false) {}
     reader(const vector<unsigned char>& input,
            int minorVersion = TAG_MINOR_INVALID)
         : _file(0), _chunk(0), opened_file(false), _pbuf(&input),
-          _read_offset(0), _minorVersion(minorVersion), _safe_read(false) {}
+          _read_offset(0), _staged_pos(0), _staged_len(0),
+          _minorVersion(minorVersion), _safe_read(false) {}
     reader(package *save, const string &chunkname,
            int minorVersion = TAG_MINOR_INVALID);
     ~reader();
 
-    unsigned char readByte();
+    unsigned char readByte()
+    {
+        if (_staged_pos < _staged_len)
+            return _staged[_staged_pos++];
+        return get_byte();
+    }
     void read(void *data, size_t size);
     void advance(size_t size);
     int getMinorVersion() const;
@@ -121,6 +146,10 @@ public:
 
     void set_safe_read(bool setting) { _safe_read = setting; }
 
+private:
+    unsigned char get_byte();
+    void refill_staged();
+
 private:
     string _filename;
     FILE* _file;
@@ -128,6 +157,11 @@ private:
     bool  opened_file;
     const vector<unsigned char>* _pbuf;
     unsigned int _read_offset;
+    // Chunk input is decompressed into here in large blocks; only used
+    // when reading from a chunk.
+    unsigned char _staged[8192];
+    size_t _staged_pos;
+    size_t _staged_len;
     int _minorVersion;
     // always throw an exception rather than dying when reading past EOF
     bool _safe_read;
@@ -105,7 +105,7 @@ bool targetter_beam::set_aim(coord_def a)
     tempbeam.target = aim;
     tempbeam.path_taken.clear();
     tempbeam.fire();
-    path_taken = tempbeam.path_taken;
+    set_path(tempbeam.path_taken);
 
     if (max_expl_rad > 0)
         set_explosion_aim(beam);
@@ -113,6 +113,59 @@ bool targetter_beam::set_aim(coord_def a)
     return true;
 }
 
+// Walk the path once, recording how each cell on it is affected, so that
+// is_affected() is a lookup rather than a walk per cell of the view.
+void targetter_beam::set_path(const vector<coord_def> &path)
+{
+    path_taken = path;
+    path_aff.clear();
+    path_end = coord_def();
+
+    aff_type current = AFF_YES;
+    for (auto pc : path_taken)
+    {
+        const bool solid = cell_is_solid(pc);
+        if (max_expl_rad > 0)
+        {
+            // An exploding beam stops at the first wall or monster.
+            if (solid && !beam.can_affect_wall(grd(pc)))
+                break;
+            path_end = pc;
+            auto it = path_aff.find(pc);
+            if (it == path_aff.end())
+                path_aff[pc] = AFF_YES;
+            else
+                it->second = AFF_MULTIPLE;
+        }
+        else
+        {
+            auto it = path_aff.find(pc);
+            if (it == path_aff.end())
+            {
+                if (!solid)
+                    path_aff[pc] = AFF_YES;
+                else
+                {
+                    path_aff[pc] = beam.can_affect_wall(grd(pc)) ? current
+                                                                 : AFF_NO;
+                }
+            }
+            else if (!solid)
+                it->second = AFF_MULTIPLE;
+        }
+
+        if (anyone_there(pc)
+            && !penetrates_targets
+            && !beam.ignores_monster(monster_at(pc)))
+        {
+            // We assume an exploding spell will always stop here.
+            if (max_expl_rad > 0)
+                break;
+            current = AFF_MAYBE;
+        }
+    }
+}
+
 void targetter_beam::set_explosion_aim(bolt tempbeam)
 {
     set_explosion_target(tempbeam);
@@ -159,49 +212,11 @@ bool targetter_beam::can_affect_outside_range()
 
 aff_type targetter_beam::is_affected(coord_def loc)
 {
-    bool on_path = false;
-    int visit_count = 0;
-    coord_def c;
-    aff_type current = AFF_YES;
-    for (auto pc : path_taken)
-    {
-        if (cell_is_solid(pc)
-            && !beam.can_affect_wall(grd(pc))
-            && max_expl_rad > 0)
-        {
-            break;
-        }
-
-        c = pc;
-        if (c == loc)
-        {
-            visit_count++;
-            if (max_expl_rad > 0)
-                on_path = true;
-            else if (cell_is_solid(pc))
-            {
-                bool res = beam.can_affect_wall(grd(pc));
-                if (res)
-                    return current;
-                else
-                    return AFF_NO;
-
-            }
-            else
-                continue;
-        }
-        if (anyone_there(pc)
-            && !penetrates_targets
-            && !beam.ignores_monster(monster_at(pc)))
-        {
-            // We assume an exploding spell will always stop here.
-            if (max_expl_rad > 0)
-                break;
-            current = AFF_MAYBE;
-        }
-    }
+    auto it = path_aff.find(loc);
+    const bool on_path = it != path_aff.end();
     if (max_expl_rad > 0)
     {
+        const coord_def c = path_end;
         if ((loc - c).rdist() <= 9)
         {
             bool aff_wall = beam.can_affect_wall(grd(loc));
@@ -221,9 +236,7 @@ aff_type targetter_beam::is_affected(coord_def loc)
             return on_path ? AFF_TRACER : AFF_NO;
     }
 
-    return visit_count == 0 ? AFF_NO :
-           visit_count == 1 ? AFF_YES :
-                              AFF_MULTIPLE;
+    return on_path ? it->second : AFF_NO;
 }
 
 bool targetter_beam::affects_monster(const monster_info& mon)
@@ -269,7 +282,7 @@ bool targetter_unravelling::set_aim(coord_def a)
     tempbeam.target = aim;
     tempbeam.path_taken.clear();
     tempbeam.fire();
-    path_taken = tempbeam.path_taken;
+    set_path(tempbeam.path_taken);
 
     bolt explosion_beam = beam;
     set_explosion_target(beam);
@@ -640,13 +653,13 @@ bool targetter_cloud::set_aim(coord_def a)
         for (coord_def c : queue[d1])
         {
             for (adjacent_iterator ai(c); ai; ++ai)
-                if (_cloudable(*ai, avoid_clouds) && !seen.count(*ai))
+                if (_cloudable(*ai, avoid_clouds)
+                    && seen.emplace(*ai, AFF_TRACER).second)
                 {
                     unsigned int d2 = d1 + 1;
                     if (d2 >= queue.size())
                         queue.resize(d2 + 1);
                     queue[d2].push_back(*ai);
-                    seen[*ai] = AFF_TRACER;
                 }
 
             seen[c] = placed <= cnt_min ? AFF_YES : AFF_MAYBE;
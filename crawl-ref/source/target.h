@@ -50,6 +50,7 @@ public:
     virtual bool affects_monster(const monster_info& mon) override;
 protected:
     vector<coord_def> path_taken; // Path beam took.
+    void set_path(const vector<coord_def> &path);
     void set_explosion_aim(bolt tempbeam);
     void set_explosion_target(bolt &tempbeam);
     int min_expl_rad, max_expl_rad;
@@ -57,6 +58,10 @@ private:
     bool penetrates_targets;
     int range;
     explosion_map exp_map_min, exp_map_max;
+    // What the path alone does to each cell on it, worked out once per
+    // aim by set_path() rather than on every is_affected() call.
+    map<coord_def, aff_type> path_aff;
+    coord_def path_end; // Where an explosion along the path goes off.
 };
 
 class targetter_unravelling : public targetter_beam
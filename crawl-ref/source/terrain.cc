@@ -31,6 +31,7 @@
 #include "mapmark.h"
 #include "message.h"
 #include "misc.h"
+#include "mon-pathfind.h"
 #include "mon-place.h"
 #include "mon-util.h"
 #include "ouch.h"
@@ -1877,6 +1878,7 @@ void set_terrain_changed(const coord_def p)
     dungeon_events.fire_position_event(DET_FEAT_CHANGE, p);
 
     los_terrain_changed(p);
+    invalidate_player_flow();
 
     for (orth_adjacent_iterator ai(p); ai; ++ai)
         if (actor *act = actor_at(*ai))
@@ -19,7 +19,8 @@ VertBuffer::VertBuffer(bool texture, bool colour, const GenericTexture *tex,
     m_tex(tex),
     m_prim(prim),
     m_colour_verts(colour),
-    m_texture_verts(texture)
+    m_texture_verts(texture),
+    m_recorder(nullptr)
 {
     m_vert_buf = GLShapeBuffer::create(texture, m_colour_verts, m_prim);
     ASSERT(m_vert_buf);
@@ -63,6 +64,8 @@ void VertBuffer::clear()
 void VertBuffer::add_primitive(const GLWPrim &rect)
 {
     m_vert_buf->add(rect);
+    if (m_recorder)
+        m_recorder->push_back(rect);
 }
 
 unsigned int VertBuffer::size() const
@@ -31,6 +31,10 @@ public:
     void add_primitive(const GLWPrim &rect);
     void clear();
 
+    // While a recorder is set, every primitive added is also appended to it,
+    // so that it can be added again later without being rebuilt.
+    void set_recorder(vector<GLWPrim> *recorder) { m_recorder = recorder; }
+
     // Note: this could invalidate previous additions if they were
     // from a different texture.
     // But we leave it here as a convenience and because it is required to set
@@ -45,6 +49,7 @@ protected:
     drawing_modes m_prim;
     bool m_colour_verts;
     bool m_texture_verts;
+    vector<GLWPrim> *m_recorder;
 };
 
 class FontBuffer : public VertBuffer
@@ -96,6 +101,9 @@ public:
     void draw() const;
     void clear();
 
+    VertBuffer &below_water() { return m_below_water; }
+    VertBuffer &above_water() { return m_above_water; }
+
 protected:
     int m_water_level;
 
@@ -74,6 +74,83 @@ void DungeonCellBuffer::add(const packed_cell &cell, int x, int y)
     }
 }
 
+// The buffers that add() can put primitives in for a cell.
+void DungeonCellBuffer::cell_buffers(VertBuffer *bufs[NUM_CELL_BUFS])
+{
+    int n = 0;
+    bufs[n++] = &m_buf_floor;
+    bufs[n++] = &m_buf_wall;
+    bufs[n++] = &m_buf_feat;
+    bufs[n++] = &m_buf_feat_trans.below_water();
+    bufs[n++] = &m_buf_feat_trans.above_water();
+    bufs[n++] = &m_buf_doll.below_water();
+    bufs[n++] = &m_buf_doll.above_water();
+    bufs[n++] = &m_buf_main_trans.below_water();
+    bufs[n++] = &m_buf_main_trans.above_water();
+    bufs[n++] = &m_buf_main;
+    ASSERT(n == NUM_CELL_BUFS);
+}
+
+static bool _same_flavour(const tile_flavour &a, const tile_flavour &b)
+{
+    return a.floor_idx == b.floor_idx && a.wall_idx == b.wall_idx
+           && a.feat_idx == b.feat_idx && a.floor == b.floor
+           && a.wall == b.wall && a.feat == b.feat && a.special == b.special;
+}
+
+// Cells whose drawing depends on more than the packed cell itself: dolls
+// and monster caches can change under the same tile, and umbras flicker.
+static bool _cell_cacheable(const packed_cell &cell)
+{
+    const tileidx_t fg_idx = cell.fg & TILE_FLAG_MASK;
+    return fg_idx < TILEP_MCACHE_START && fg_idx != TILEP_PLAYER
+           && cell.halo != HALO_UMBRA;
+}
+
+// As add(), but for cells of the dungeon view: a cell that is the same as
+// the last time it was packed at this position just has its primitives
+// from then added again.
+void DungeonCellBuffer::add_cached(const packed_cell &cell, int x, int y)
+{
+    if (x < 0 || x >= GXM || y < 0 || y >= GYM || !_cell_cacheable(cell))
+    {
+        add(cell, x, y);
+        return;
+    }
+
+    if (m_cell_cache.empty())
+        m_cell_cache.resize(GXM * GYM);
+    cell_cache_entry &entry = m_cell_cache[y * GXM + x];
+
+    VertBuffer *bufs[NUM_CELL_BUFS];
+    cell_buffers(bufs);
+
+    if (entry.valid && entry.cell == cell
+        && _same_flavour(entry.cell.flv, cell.flv))
+    {
+        for (int i = 0; i < NUM_CELL_BUFS; ++i)
+            for (const GLWPrim &prim : entry.prims[i])
+                bufs[i]->add_primitive(prim);
+        return;
+    }
+
+    entry.cell = cell;
+    for (int i = 0; i < NUM_CELL_BUFS; ++i)
+    {
+        entry.prims[i].clear();
+        bufs[i]->set_recorder(&entry.prims[i]);
+    }
+    add(cell, x, y);
+    for (VertBuffer *buf : bufs)
+        buf->set_recorder(nullptr);
+    entry.valid = true;
+}
+
+void DungeonCellBuffer::clear_cache()
+{
+    m_cell_cache.clear();
+}
+
 void DungeonCellBuffer::add_dngn_tile(int tileidx, int x, int y,
                                       bool in_water)
 {
@@ -23,6 +23,8 @@ public:
     DungeonCellBuffer(ImageManager *im);
 
     void add(const packed_cell &cell, int x, int y);
+    void add_cached(const packed_cell &cell, int x, int y);
+    void clear_cache();
     void add_dngn_tile(int tileidx, int x, int y, bool in_water = false);
     void add_main_tile(int tileidx, int x, int y);
     void add_main_tile(int tileidx, int x, int y, int ox, int oy);
@@ -57,6 +59,20 @@ protected:
     TileBuffer m_buf_skills;
     TileBuffer m_buf_commands;
     TileBuffer m_buf_icons;
+
+    // The primitives each buffer got for a cell the last time it was packed.
+    enum { NUM_CELL_BUFS = 10 };
+    struct cell_cache_entry
+    {
+        cell_cache_entry() : valid(false) { }
+
+        bool valid;
+        packed_cell cell;
+        vector<GLWPrim> prims[NUM_CELL_BUFS];
+    };
+    vector<cell_cache_entry> m_cell_cache;
+
+    void cell_buffers(VertBuffer *bufs[NUM_CELL_BUFS]);
 };
 
 #endif
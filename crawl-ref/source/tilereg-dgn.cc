@@ -126,7 +126,7 @@ void DungeonRegion::pack_buffers()
                 tile_cell.flv.feat    = 0;
             }
 
-            m_buf_dngn.add(tile_cell, x, y);
+            m_buf_dngn.add_cached(tile_cell, x, y);
 
             const int fcol = vbuf_cell->flash_colour;
             if (fcol)
@@ -351,6 +351,7 @@ void DungeonRegion::clear()
 void DungeonRegion::on_resize()
 {
     // TODO enne
+    m_buf_dngn.clear_cache();
 }
 
 // FIXME: If the player is targeted, the game asks the player to target
@@ -17,8 +17,14 @@
 
 MapRegion::MapRegion(int pixsz) :
     m_buf(nullptr),
+    m_buf_map(true, false, &m_tex),
     m_dirty(true),
-    m_far_view(false)
+    m_far_view(false),
+    m_tex_w(0),
+    m_tex_h(0),
+    m_tex_loaded(false),
+    m_dirty_min_y(0),
+    m_dirty_max_y(-1)
 {
     ASSERT(pixsz > 0);
 
@@ -35,6 +41,39 @@ void MapRegion::on_resize()
     int size = mx * my;
     m_buf    = new unsigned char[size];
     memset(m_buf, 0, sizeof(unsigned char) * size);
+
+    m_tex_w = 1;
+    while (m_tex_w < mx)
+        m_tex_w *= 2;
+    m_tex_h = 1;
+    while (m_tex_h < my)
+        m_tex_h *= 2;
+    m_pixels.assign(4 * m_tex_w * m_tex_h, 0);
+    m_tex_loaded = false;
+    repaint();
+}
+
+void MapRegion::paint_cell(int x, int y)
+{
+    const VColour &col = m_colours[m_buf[x + y * mx]];
+    unsigned char *texel = &m_pixels[4 * (x + y * m_tex_w)];
+    texel[0] = col.r;
+    texel[1] = col.g;
+    texel[2] = col.b;
+    texel[3] = col.a;
+
+    m_dirty_min_y = min(m_dirty_min_y, y);
+    m_dirty_max_y = max(m_dirty_max_y, y);
+}
+
+void MapRegion::repaint()
+{
+    if (!m_buf)
+        return;
+
+    for (int y = 0; y < my; y++)
+        for (int x = 0; x < mx; x++)
+            paint_cell(x, y);
 }
 
 void MapRegion::init_colours()
@@ -65,6 +104,8 @@ void MapRegion::init_colours()
     m_colours[MF_EXCL_ROOT]     = Options.tile_excl_centre_col;
     m_colours[MF_EXCL]          = Options.tile_excluded_col;
     m_colours[MF_PLAYER]        = Options.tile_player_col;
+
+    repaint();
 }
 
 MapRegion::~MapRegion()
@@ -77,15 +118,11 @@ void MapRegion::pack_buffers()
     m_buf_map.clear();
     m_buf_lines.clear();
 
-    for (int x = m_min_gx; x <= m_max_gx; x++)
-        for (int y = m_min_gy; y <= m_max_gy; y++)
-        {
-            map_feature f = (map_feature)m_buf[x + y * mx];
-
-            float pos_x = x - m_min_gx;
-            float pos_y = y - m_min_gy;
-            m_buf_map.add(pos_x, pos_y, pos_x + 1, pos_y + 1, m_colours[f]);
-        }
+    GLWPrim rect(0, 0, m_max_gx - m_min_gx + 1, m_max_gy - m_min_gy + 1);
+    rect.set_tex(m_min_gx / (float)m_tex_w, m_min_gy / (float)m_tex_h,
+                 (m_max_gx + 1) / (float)m_tex_w,
+                 (m_max_gy + 1) / (float)m_tex_h);
+    m_buf_map.add_primitive(rect);
 
     // Draw window box.
     if (m_win_start.x == -1 && m_win_end.x == -1)
@@ -108,6 +145,22 @@ void MapRegion::render()
 #ifdef DEBUG_TILES_REDRAW
     cprintf("rendering MapRegion\n");
 #endif
+    if (!m_tex_loaded)
+    {
+        m_tex.unload_texture();
+        m_tex.load_texture(&m_pixels[0], m_tex_w, m_tex_h, MIPMAP_NONE);
+        m_tex_loaded = true;
+    }
+    else if (m_dirty_min_y <= m_dirty_max_y)
+    {
+        // Rows are contiguous in m_pixels, so send them in one go.
+        m_tex.load_texture(&m_pixels[4 * m_dirty_min_y * m_tex_w], m_tex_w,
+                           m_dirty_max_y - m_dirty_min_y + 1, MIPMAP_NONE,
+                           0, m_dirty_min_y);
+    }
+    m_dirty_min_y = my;
+    m_dirty_max_y = -1;
+
     if (m_dirty)
     {
         pack_buffers();
@@ -129,7 +182,12 @@ void MapRegion::recenter()
 void MapRegion::set(const coord_def &gc, map_feature f)
 {
     ASSERT((unsigned int)f <= (unsigned char)~0);
-    m_buf[gc.x + gc.y * mx] = f;
+    unsigned char &cell = m_buf[gc.x + gc.y * mx];
+    if (cell != f)
+    {
+        cell = f;
+        paint_cell(gc.x, gc.y);
+    }
 
     if (f == MF_UNSEEN)
         return;
@@ -199,6 +257,7 @@ void MapRegion::clear()
 
     if (m_buf)
         memset(m_buf, 0, sizeof(*m_buf) * mx * my);
+    repaint();
 
     m_buf_map.clear();
     m_buf_lines.clear();
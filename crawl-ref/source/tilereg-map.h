@@ -4,6 +4,7 @@
 
 #include "tilebuf.h"
 #include "tilereg.h"
+#include "tiletex.h"
 
 class MapRegion : public Region
 {
@@ -25,6 +26,8 @@ protected:
     virtual void on_resize() override;
     void recenter();
     void pack_buffers();
+    void paint_cell(int x, int y);
+    void repaint();
 
     VColour m_colours[MF_MAX];
     int m_min_gx, m_max_gx, m_min_gy, m_max_gy;
@@ -32,10 +35,21 @@ protected:
     coord_def m_win_end;
     unsigned char *m_buf;
 
-    ShapeBuffer m_buf_map;
+    VertBuffer m_buf_map;
     LineBuffer m_buf_lines;
     bool m_dirty;
     bool m_far_view;
+
+    // The minimap is drawn as one quad of m_tex, one texel per cell.
+    // m_pixels is the RGBA copy of it; rows m_dirty_min_y..m_dirty_max_y
+    // have changed since they were last uploaded.
+    GenericTexture m_tex;
+    vector<unsigned char> m_pixels;
+    int m_tex_w;
+    int m_tex_h;
+    bool m_tex_loaded;
+    int m_dirty_min_y;
+    int m_dirty_max_y;
 };
 
 #endif
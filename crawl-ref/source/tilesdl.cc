@@ -641,8 +641,20 @@ int TilesFramework::getch_ck()
 
     const unsigned int ticks_per_screen_redraw = Options.tile_update_rate;
 
-    unsigned int res = Options.tile_tooltip_ms;
-    unsigned int timer_id = wm->set_timer(res, &_timer_callback);
+    // The timer only wakes us up to show a tooltip once the mouse has come
+    // to rest, so it only runs while one might be due; otherwise an idle
+    // game just sleeps in wait_event(). It goes away however we return.
+    struct tooltip_timer
+    {
+        unsigned int id = 0;
+        ~tooltip_timer()
+        {
+            if (id)
+                wm->remove_timer(id);
+        }
+    } timer;
+    // When we last looked for a tooltip to show, by m_last_tick_moved.
+    unsigned int tooltip_tried = UINT_MAX;
 
     m_tooltip.clear();
     m_region_msg->alt_text().clear();
@@ -655,6 +667,19 @@ int TilesFramework::getch_ck()
         if (crawl_state.seen_hups)
             return ESCAPE;
 
+        const bool tooltip_due = !mouse_target_mode
+                                 && Options.tile_tooltip_ms > 0
+                                 && m_last_tick_moved != UINT_MAX
+                                 && m_last_tick_moved != tooltip_tried
+                                 && m_tooltip.empty();
+        if (tooltip_due && !timer.id)
+            timer.id = wm->set_timer(Options.tile_tooltip_ms, &_timer_callback);
+        else if (!tooltip_due && timer.id)
+        {
+            wm->remove_timer(timer.id);
+            timer.id = 0;
+        }
+
         unsigned int ticks = 0;
         last_loc = m_cur_loc;
 
@@ -826,6 +851,7 @@ int TilesFramework::getch_ck()
 
             if (timeout)
             {
+                tooltip_tried = m_last_tick_moved;
                 tiles.clear_text_tags(TAG_CELL_DESC);
                 if (Options.tile_tooltip_ms > 0 && m_tooltip.empty())
                 {
@@ -861,8 +887,6 @@ int TilesFramework::getch_ck()
     // We got some input, so we'll probably have to redraw something.
     set_need_redraw();
 
-    wm->remove_timer(timer_id);
-
     return key;
 }
 
@@ -108,22 +108,25 @@ void WebTextArea::send(bool force)
     {
         last_col = -1;
         space_count = 0;
-        dirty = false;
         html.clear();
 
+        // Unchanged rows aren't sent unless forced, so don't build them.
+        const int row = y * mx;
+        dirty = memcmp(m_cbuf + row, m_old_cbuf + row, mx * sizeof(ucs_t))
+                || memcmp(m_abuf + row, m_old_abuf + row, mx);
+        if (dirty)
+        {
+            memcpy(m_old_cbuf + row, m_cbuf + row, mx * sizeof(ucs_t));
+            memcpy(m_old_abuf + row, m_abuf + row, mx);
+        }
+        else if (!force)
+            continue;
+
         for (int x = 0; x < mx; ++x)
         {
             ucs_t chr = m_cbuf[x + y * mx];
             uint8_t col = m_abuf[x + y * mx];
 
-            if (chr != m_old_cbuf[x + y * mx] ||
-                col != m_old_abuf[x + y * mx])
-            {
-                dirty = true;
-                m_old_cbuf[x + y * mx] = chr;
-                m_old_abuf[x + y * mx] = col;
-            }
-
             if (chr != ' ' || ((col >> 4) & 0xF) != 0)
             {
                 while (space_count)
@@ -137,8 +140,10 @@ void WebTextArea::send(bool force)
             {
                 if (last_col != -1)
                     html += "</span>";
-                html += make_stringf("<span class=\\\"fg%d bg%d\\\">",
-                                     col & 0xf, (col >> 4) & 0xf);
+                char span[32];
+                snprintf(span, sizeof(span), "<span class=\\\"fg%d bg%d\\\">",
+                         col & 0xf, (col >> 4) & 0xf);
+                html += span;
                 last_col = col;
             }
 
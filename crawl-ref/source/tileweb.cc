@@ -6,7 +6,9 @@
 
 #include <cerrno>
 #include <cstdarg>
+#include <fcntl.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -15,6 +17,8 @@
 #include "artefact.h"
 #include "branch.h"
 #include "coord.h"
+#include "dbg-util.h"
+#include "dgl-message.h"
 #include "directn.h"
 #include "english.h"
 #include "env.h"
@@ -35,6 +39,7 @@
 #include "skills.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "throw.h"
 #include "tiledef-dngn.h"
 #include "tiledef-gui.h"
@@ -53,20 +58,36 @@
 #include "viewgeom.h"
 #include "view.h"
 
-static unsigned int get_milliseconds()
-{
-    // This is Unix-only, but so is Webtiles at the moment.
-    timeval tv;
-    gettimeofday(&tv, nullptr);
+#ifndef MSG_NOSIGNAL
+// OS X has no MSG_NOSIGNAL; SO_NOSIGPIPE is set on the socket instead.
+# define MSG_NOSIGNAL 0
+#endif
 
-    return ((unsigned int) tv.tv_sec) * 1000 + tv.tv_usec / 1000;
-}
+// How often a recording starts over with the full state, in milliseconds.
+#define WEBTILES_KEYFRAME_INTERVAL (2 * 60 * 1000)
+
+// Finished messages are held back until the next flush, unless they pile up
+// past this many bytes (for instance while the game is busy without waiting
+// for input).
+#define WEBTILES_OUTPUT_LIMIT (256 * 1024)
 
 TilesFramework tiles;
 
+WebtilesReceiver::WebtilesReceiver()
+    : fd(-1), attached(false), binary_map(false), batched(false)
+{
+    memset(&addr, 0, sizeof(addr));
+}
+
 TilesFramework::TilesFramework()
-    : m_crt_mode(CRT_NORMAL),
+    : m_sock_stream(false),
+      m_crt_mode(CRT_NORMAL),
+      m_record(nullptr),
+      m_record_index(nullptr),
+      m_record_start(0),
+      m_record_keyframe(0),
       m_controlled_from_web(false),
+      m_spectator_joined(false),
       m_last_ui_state(UI_INIT),
       m_view_loaded(false),
       m_next_view_tl(0, 0),
@@ -90,6 +111,21 @@ TilesFramework::~TilesFramework()
 
 void TilesFramework::shutdown()
 {
+    _flush_output();
+    if (m_record)
+    {
+        gzclose(m_record);
+        m_record = nullptr;
+    }
+    if (m_record_index)
+    {
+        fclose(m_record_index);
+        m_record_index = nullptr;
+    }
+    for (const WebtilesReceiver &r : m_receivers)
+        if (r.fd >= 0)
+            close(r.fd);
+    m_receivers.clear();
     close(m_sock);
     remove(m_sock_name.c_str());
 }
@@ -101,7 +137,7 @@ void TilesFramework::draw_doll_edit()
 bool TilesFramework::initialise()
 {
     // Init socket
-    m_sock = socket(PF_UNIX, SOCK_DGRAM, 0);
+    m_sock = socket(PF_UNIX, m_sock_stream ? SOCK_STREAM : SOCK_DGRAM, 0);
     if (m_sock < 0)
         die("Can't open the webtiles socket!");
     sockaddr_un addr;
@@ -109,6 +145,8 @@ bool TilesFramework::initialise()
     strcpy(addr.sun_path, m_sock_name.c_str());
     if (::bind(m_sock, (sockaddr*) &addr, sizeof(sockaddr_un)))
         die("Can't bind the webtiles socket!");
+    if (m_sock_stream && listen(m_sock, 8))
+        die("Can't listen on the webtiles socket!");
 
     int bufsize = 64 * 1024;
     if (setsockopt(m_sock, SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize)))
@@ -122,6 +160,18 @@ bool TilesFramework::initialise()
     if (setsockopt(m_sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) < 0)
         die("Can't set send timeout!");
 
+    if (!m_record_name.empty())
+    {
+        // Start both files afresh; keyframes are appended as they come.
+        FILE *record = fopen_u(m_record_name.c_str(), "wb");
+        m_record_index = fopen_u((m_record_name + ".idx").c_str(), "w");
+        if (!record || !m_record_index)
+            die("Can't create the webtiles recording %s!",
+                m_record_name.c_str());
+        fclose(record);
+        m_record_start = get_milliseconds();
+    }
+
     if (m_await_connection)
         _await_connection();
 
@@ -148,17 +198,27 @@ string TilesFramework::get_message()
 void TilesFramework::write_message(const char *format, ...)
 {
     char buf[2048];
-    int len;
 
-    va_list argp;
+    va_list argp, argp2;
     va_start(argp, format);
-    if ((len = vsnprintf(buf, sizeof(buf), format, argp)) < 0)
-        die("Webtiles message format error! (%s)", format);
-    else if (len >= (int)sizeof(buf))
-        die("Webtiles message too long! (%d)", len);
+    va_copy(argp2, argp);
+    const int len = vsnprintf(buf, sizeof(buf), format, argp);
     va_end(argp);
+    if (len < 0)
+        die("Webtiles message format error! (%s)", format);
 
-    m_msg_buf.append(buf);
+    if (len < (int)sizeof(buf))
+        m_msg_buf.append(buf, len);
+    else
+    {
+        // Too long for the stack buffer: format again straight into the
+        // end of the message.
+        const size_t start = m_msg_buf.size();
+        m_msg_buf.resize(start + len + 1);
+        vsnprintf(&m_msg_buf[start], len + 1, format, argp2);
+        m_msg_buf.resize(start + len);
+    }
+    va_end(argp2);
 }
 
 void TilesFramework::finish_message()
@@ -167,56 +227,195 @@ void TilesFramework::finish_message()
         return;
 
     m_msg_buf.append("\n");
-    const char* fragment_start = m_msg_buf.data();
-    const char* data_end = m_msg_buf.data() + m_msg_buf.size();
+    m_out_buf.append(m_msg_buf);
+    m_out_ends.push_back(m_out_buf.size());
+    m_msg_buf.clear();
+    m_need_flush = true;
+
+    if (m_out_buf.size() >= WEBTILES_OUTPUT_LIMIT)
+        _flush_output();
+}
+
+// Sends everything finish_message() has collected to every attached
+// receiver: a stream receiver gets it in one write, a batching datagram
+// receiver in as few datagrams as the size limit allows, and an older
+// server one message (in fragments) at a time, as it did before batching.
+void TilesFramework::_flush_output()
+{
+    if (m_out_buf.empty())
+        return;
+
+    _record_output();
+
+    for (unsigned int i = 0; i < m_receivers.size(); ++i)
+    {
+        const WebtilesReceiver &r = m_receivers[i];
+        if (!r.attached)
+            continue;
+
+        bool ok = true;
+        if (r.fd >= 0)
+            ok = _send_stream(r, m_out_buf.data(), m_out_buf.size());
+        else if (r.batched)
+            ok = _send_datagrams(r, m_out_buf.data(), m_out_buf.size());
+        else
+        {
+            size_t start = 0;
+            for (size_t end : m_out_ends)
+            {
+                ok = _send_datagrams(r, m_out_buf.data() + start, end - start);
+                if (!ok)
+                    break;
+                start = end;
+            }
+        }
+
+        if (!ok)
+        {
+            _drop_receiver(i);
+            i--;
+        }
+    }
+
+    m_out_buf.clear();
+    m_out_ends.clear();
+}
+
+// Returns false if the other side is gone.
+bool TilesFramework::_send_datagrams(const WebtilesReceiver &r,
+                                     const char *data, size_t len)
+{
+    const char* fragment_start = data;
+    const char* data_end = data + len;
     while (fragment_start < data_end)
     {
         int fragment_size = data_end - fragment_start;
         if (fragment_size > m_max_msg_size)
             fragment_size = m_max_msg_size;
 
-        for (unsigned int i = 0; i < m_dest_addrs.size(); ++i)
+        int retries = 30;
+        ssize_t sent = 0;
+        while (sent < fragment_size)
         {
-            int retries = 30;
-            ssize_t sent = 0;
-            while (sent < fragment_size)
+            ssize_t retval = sendto(m_sock, fragment_start + sent,
+                fragment_size - sent, 0, (const sockaddr*) &r.addr,
+                sizeof(sockaddr_un));
+            if (retval <= 0)
             {
-                ssize_t retval = sendto(m_sock, fragment_start + sent,
-                    fragment_size - sent, 0, (sockaddr*) &m_dest_addrs[i],
-                    sizeof(sockaddr_un));
-                if (retval <= 0)
-                {
-                    const char *errmsg = retval == 0 ? "No bytes sent"
-                                                     : strerror(errno);
-                    if (--retries <= 0)
-                        die("Socket write error: %s", errmsg);
+                const char *errmsg = retval == 0 ? "No bytes sent"
+                                                 : strerror(errno);
+                if (--retries <= 0)
+                    die("Socket write error: %s", errmsg);
 
-                    if (retval == 0 || errno == ENOBUFS || errno == EWOULDBLOCK
-                        || errno == EINTR || errno == EAGAIN)
-                    {
-                        // Wait for half a second at first (up to five), then
-                        // try again.
-                        usleep(retries <= 10 ? 5000 * 1000 : 500 * 1000);
-                    }
-                    else if (errno == ECONNREFUSED || errno == ENOENT)
-                    {
-                        // the other side is dead
-                        m_dest_addrs.erase(m_dest_addrs.begin() + i);
-                        i--;
-                        break;
-                    }
-                    else
-                        die("Socket write error: %s", errmsg);
+                if (retval == 0 || errno == ENOBUFS || errno == EWOULDBLOCK
+                    || errno == EINTR || errno == EAGAIN)
+                {
+                    // Wait for half a second at first (up to five), then
+                    // try again.
+                    usleep(retries <= 10 ? 5000 * 1000 : 500 * 1000);
                 }
+                else if (errno == ECONNREFUSED || errno == ENOENT)
+                    return false; // the other side is dead
                 else
-                    sent += retval;
+                    die("Socket write error: %s", errmsg);
             }
+            else
+                sent += retval;
         }
 
         fragment_start += fragment_size;
     }
-    m_msg_buf.clear();
-    m_need_flush = true;
+    return true;
+}
+
+// Returns false if the other side is gone. Sends block for at most the
+// socket's send timeout, so there is no need to sleep between retries.
+bool TilesFramework::_send_stream(const WebtilesReceiver &r,
+                                  const char *data, size_t len)
+{
+    int retries = 10;
+    size_t sent = 0;
+    while (sent < len)
+    {
+        ssize_t retval = send(r.fd, data + sent, len - sent, MSG_NOSIGNAL);
+        if (retval > 0)
+        {
+            sent += retval;
+            continue;
+        }
+
+        if (retval < 0 && errno == EINTR)
+            continue;
+        if (retval == 0 || errno == EPIPE || errno == ECONNRESET)
+            return false;
+        if ((errno == EWOULDBLOCK || errno == EAGAIN) && --retries > 0)
+            continue;
+        die("Socket write error: %s", strerror(errno));
+    }
+    return true;
+}
+
+void TilesFramework::_drop_receiver(unsigned int i)
+{
+    if (m_receivers[i].fd >= 0)
+        close(m_receivers[i].fd);
+    m_receivers.erase(m_receivers.begin() + i);
+}
+
+// Each batch goes into the recording after a "#<milliseconds>" line.
+void TilesFramework::_record_output()
+{
+    if (!m_record)
+        return;
+
+    char stamp[32];
+    const int len = snprintf(stamp, sizeof(stamp), "#%u\n",
+                             get_milliseconds() - m_record_start);
+    if (gzwrite(m_record, stamp, len) != len
+        || gzwrite(m_record, m_out_buf.data(), m_out_buf.size())
+           != (int) m_out_buf.size())
+    {
+        die("Can't write the webtiles recording %s!", m_record_name.c_str());
+    }
+}
+
+bool TilesFramework::_recording_keyframe_due() const
+{
+    return m_record_index
+           && (!m_record
+               || get_milliseconds() - m_record_keyframe
+                  >= WEBTILES_KEYFRAME_INTERVAL);
+}
+
+// Closes the current gzip member of the recording and starts another one,
+// noting where it starts in the index. The full state sent next is its
+// first batch.
+void TilesFramework::_start_recording_keyframe()
+{
+    if (m_record)
+        gzclose(m_record);
+
+    struct stat st;
+    if (stat(m_record_name.c_str(), &st))
+        die("Can't find the webtiles recording %s!", m_record_name.c_str());
+
+    m_record = gzopen(m_record_name.c_str(), "ab");
+    if (!m_record)
+        die("Can't append to the webtiles recording %s!",
+            m_record_name.c_str());
+
+    m_record_keyframe = get_milliseconds();
+    fprintf(m_record_index, "%u %lld\n", m_record_keyframe - m_record_start,
+            (long long) st.st_size);
+    fflush(m_record_index);
+}
+
+bool TilesFramework::has_receivers() const
+{
+    for (const WebtilesReceiver &r : m_receivers)
+        if (r.attached)
+            return true;
+    return false;
 }
 
 void TilesFramework::send_message(const char *format, ...)
@@ -243,17 +442,28 @@ void TilesFramework::send_message(const char *format, ...)
 
 void TilesFramework::flush_messages()
 {
+    PROFILE_SECTION(PROF_WEBTILES);
     if (m_need_flush)
     {
         send_message("*{\"msg\":\"flush_messages\"}");
         m_need_flush = false;
     }
+    _flush_output();
 }
 
 void TilesFramework::_await_connection()
 {
-    while (m_dest_addrs.size() == 0)
-        _receive_control_message();
+    while (!has_receivers())
+    {
+        if (m_sock_stream)
+        {
+            wint_t c;
+            _wait_for_stream();
+            _handle_stream_input(c);
+        }
+        else
+            _receive_control_message();
+    }
 }
 
 wint_t TilesFramework::_receive_control_message()
@@ -274,7 +484,7 @@ wint_t TilesFramework::_receive_control_message()
     string data(buf, len);
     try
     {
-        return _handle_control_message(srcaddr, data);
+        return _handle_control_message(srcaddr, -1, data);
     }
     catch (JsonWrapper::MalformedException&)
     {
@@ -283,8 +493,172 @@ wint_t TilesFramework::_receive_control_message()
     }
 }
 
-wint_t TilesFramework::_handle_control_message(sockaddr_un addr, string data)
+bool TilesFramework::_control_message_waiting() const
+{
+    char dummy;
+    return recv(m_sock, &dummy, sizeof(dummy), MSG_PEEK | MSG_DONTWAIT) >= 0;
+}
+
+// Handles every datagram already queued on the control socket, stopping at
+// the first keypress, so that a burst of messages costs one wake-up (and
+// one flush) instead of one each. Returns whether c was set.
+bool TilesFramework::_drain_control_messages(wint_t &c)
+{
+    do
+    {
+        c = _receive_control_message();
+        if (c != 0)
+            return true;
+    }
+    while (_control_message_waiting());
+
+    return false;
+}
+
+void TilesFramework::_accept_connection()
+{
+    int fd = accept(m_sock, nullptr, nullptr);
+    if (fd < 0)
+    {
+        if (errno == EINTR || errno == EAGAIN || errno == ECONNABORTED)
+            return;
+        die("Socket accept error: %s", strerror(errno));
+    }
+
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    int bufsize = 256 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize));
+    struct timeval tv;
+    tv.tv_sec = 1;
+    tv.tv_usec = 0;
+    if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) < 0)
+        die("Can't set send timeout!");
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    WebtilesReceiver r;
+    r.fd = fd;
+    m_receivers.push_back(r);
+}
+
+// Reads whatever receiver i has sent; complete control messages are
+// handled by _handle_stream_input.
+void TilesFramework::_read_stream(unsigned int i)
+{
+    char buf[4096];
+    ssize_t len = recv(m_receivers[i].fd, buf, sizeof(buf), 0);
+    if (len > 0)
+        m_receivers[i].input.append(buf, len);
+    else if (len == 0 || errno != EINTR && errno != EAGAIN)
+        _drop_receiver(i);
+}
+
+// Handles the newline-terminated control messages read so far, stopping at
+// the first one that is a keypress. Returns whether c was set.
+bool TilesFramework::_handle_stream_input(wint_t &c)
+{
+    for (unsigned int i = 0; i < m_receivers.size(); ++i)
+    {
+        string::size_type end;
+        while (i < m_receivers.size()
+               && (end = m_receivers[i].input.find('\n')) != string::npos)
+        {
+            string data = m_receivers[i].input.substr(0, end);
+            m_receivers[i].input.erase(0, end + 1);
+            try
+            {
+                c = _handle_control_message(m_receivers[i].addr,
+                                            m_receivers[i].fd, data);
+            }
+            catch (JsonWrapper::MalformedException&)
+            {
+                dprf("Malformed control message!");
+                c = 0;
+            }
+            if (c != 0)
+                return true;
+        }
+    }
+    return false;
+}
+
+// Blocks until a new server connects or an existing one sends something.
+void TilesFramework::_wait_for_stream()
+{
+    fd_set fds;
+    int result;
+    int maxfd;
+    do
+    {
+        FD_ZERO(&fds);
+        FD_SET(m_sock, &fds);
+        maxfd = m_sock;
+        for (const WebtilesReceiver &r : m_receivers)
+        {
+            FD_SET(r.fd, &fds);
+            maxfd = max(maxfd, r.fd);
+        }
+        result = select(maxfd + 1, &fds, nullptr, nullptr, nullptr);
+    }
+    while (result == -1 && errno == EINTR);
+
+    if (result < 0)
+        die("select error: %s", strerror(errno));
+
+    for (int i = m_receivers.size() - 1; i >= 0; --i)
+        if (FD_ISSET(m_receivers[i].fd, &fds))
+            _read_stream(i);
+    if (FD_ISSET(m_sock, &fds))
+        _accept_connection();
+}
+
+// The client sends every keypress as exactly {"msg":"key","keycode":N}.
+// Recognise that form without building a JSON tree; anything else, even
+// an equivalent key message spelt differently, returns false.
+static bool _parse_key_message(const string &data, int &keycode)
+{
+    static const char prefix[] = "{\"msg\":\"key\",\"keycode\":";
+    const size_t prefix_len = sizeof(prefix) - 1;
+
+    if (data.size() < prefix_len + 2
+        || data.compare(0, prefix_len, prefix) != 0
+        || data[data.size() - 1] != '}')
+    {
+        return false;
+    }
+
+    size_t i = prefix_len;
+    const bool negative = data[i] == '-';
+    if (negative)
+        ++i;
+
+    const size_t digits_start = i;
+    int value = 0;
+    for (; i < data.size() - 1; ++i)
+    {
+        if (!isadigit(data[i]) || i - digits_start >= 9)
+            return false;
+        value = value * 10 + (data[i] - '0');
+    }
+    // No digits, or a leading zero that JSON doesn't allow.
+    if (i == digits_start || data[digits_start] == '0' && i > digits_start + 1)
+        return false;
+
+    keycode = negative ? -value : value;
+    return true;
+}
+
+wint_t TilesFramework::_handle_control_message(const sockaddr_un &addr,
+                                               int fd, string data)
 {
+    // Keypresses are by far the most common message.
+    int key;
+    if (_parse_key_message(data, key))
+        return key;
+
     JsonWrapper obj = json_decode(data.c_str());
     obj.check(JSON_OBJECT);
 
@@ -299,8 +673,33 @@ wint_t TilesFramework::_handle_control_message(sockaddr_un addr, string data)
         JsonWrapper primary = json_find_member(obj.node, "primary");
         primary.check(JSON_BOOL);
 
-        m_dest_addrs.push_back(addr);
+        // Older servers don't know about binary map cells.
+        JsonNode *binary = json_find_member(obj.node, "binary_map");
+        // ... nor about several messages sharing one datagram.
+        JsonNode *batched = json_find_member(obj.node, "batched");
+
+        WebtilesReceiver *r = nullptr;
+        for (WebtilesReceiver &other : m_receivers)
+            if (fd >= 0 && other.fd == fd)
+                r = &other;
+        if (!r)
+        {
+            m_receivers.emplace_back();
+            r = &m_receivers.back();
+            r->addr = addr;
+        }
+        r->attached = true;
+        r->binary_map = binary && binary->tag == JSON_BOOL && binary->bool_;
+        r->batched = batched && batched->tag == JSON_BOOL && batched->bool_;
         m_controlled_from_web = primary->bool_;
+#ifdef DGL_SIMPLE_MESSAGING
+        // Servers that push "dgl_messages" spare us polling the mail file.
+        if (primary->bool_)
+        {
+            JsonNode *push = json_find_member(obj.node, "push_messages");
+            set_messages_pushed(push && push->tag == JSON_BOOL && push->bool_);
+        }
+#endif
     }
     else if (msgtype == "key")
     {
@@ -310,11 +709,11 @@ wint_t TilesFramework::_handle_control_message(sockaddr_un addr, string data)
         c = (int) keycode->number_;
     }
     else if (msgtype == "spectator_joined")
-    {
-        flush_messages();
-        _send_everything();
-        flush_messages();
-    }
+        m_spectator_joined = true;
+#ifdef DGL_SIMPLE_MESSAGING
+    else if (msgtype == "dgl_messages")
+        notify_messages();
+#endif
     else if (msgtype == "menu_scroll")
     {
         JsonWrapper first = json_find_member(obj.node, "first");
@@ -345,6 +744,13 @@ wint_t TilesFramework::_handle_control_message(sockaddr_un addr, string data)
         if (Options.note_chat_messages)
             take_note(Note(NOTE_MESSAGE, MSGCH_PLAIN, 0, content->string_));
     }
+#ifdef DEBUG_PROFILE
+    else if (msgtype == "profile")
+    {
+        send_message("{\"msg\":\"profile\",\"profile\":%s}",
+                     profile_json().c_str());
+    }
+#endif
 
     return c;
 }
@@ -353,15 +759,30 @@ bool TilesFramework::await_input(wint_t& c, bool block)
 {
     int result;
     fd_set fds;
-    int maxfd = m_sock;
+    int maxfd;
 
     while (true)
     {
+        if (m_sock_stream && _handle_stream_input(c))
+            return true;
+
+        // Any joins read so far are answered before waiting again.
+        _send_everything_if_joined();
+
         do
         {
             FD_ZERO(&fds);
             FD_SET(STDIN_FILENO, &fds);
             FD_SET(m_sock, &fds);
+            maxfd = m_sock;
+            for (const WebtilesReceiver &r : m_receivers)
+            {
+                if (r.fd >= 0)
+                {
+                    FD_SET(r.fd, &fds);
+                    maxfd = max(maxfd, r.fd);
+                }
+            }
 
             if (block)
             {
@@ -383,13 +804,18 @@ bool TilesFramework::await_input(wint_t& c, bool block)
             return false;
         else if (result > 0)
         {
-            if (FD_ISSET(m_sock, &fds))
+            if (m_sock_stream)
             {
-                c = _receive_control_message();
-
-                if (c != 0)
+                for (int i = m_receivers.size() - 1; i >= 0; --i)
+                    if (FD_ISSET(m_receivers[i].fd, &fds))
+                        _read_stream(i);
+                if (FD_ISSET(m_sock, &fds))
+                    _accept_connection();
+                if (_handle_stream_input(c))
                     return true;
             }
+            else if (FD_ISSET(m_sock, &fds) && _drain_control_messages(c))
+                return true;
 
             if (FD_ISSET(STDIN_FILENO, &fds))
             {
@@ -815,6 +1241,15 @@ void TilesFramework::_send_player(bool force_full)
     json_open_object("inv");
     for (unsigned int i = 0; i < ENDOFPACK; ++i)
     {
+        // Empty slots that were already empty have nothing to send; don't
+        // build an item_info and a JSON object just to find that out.
+        if (!force_full && !you.inv[i].defined() && !c.inv[i].defined()
+            && c.inv[i].base_type == you.inv[i].base_type
+            && c.inv[i].quantity == you.inv[i].quantity)
+        {
+            continue;
+        }
+
         json_open_object(to_string(i));
         _send_item(c.inv[i], get_item_info(you.inv[i]), force_full);
         json_close_object(true);
@@ -1074,6 +1509,242 @@ static inline void _write_tileidx(tileidx_t t)
         tiles.write_message("[%d,%d]", lo, hi);
 }
 
+// Compact encoding for map cells, used instead of JSON for receivers that
+// ask for it. Cells that carry monsters or dolls still go out as JSON; the
+// rest are packed into one buffer per map message, sent base64-encoded as
+// "bcells" and unpacked by map_knowledge.js. Each cell is
+//   varint  number of grid cells skipped since the previous one
+//   varint  mask of the BC_* fields that follow, in bit order
+// followed by the fields, all varints.
+enum binary_cell_field
+{
+    BC_FEAT,
+    BC_MAP_FEAT,
+    BC_GLYPH,
+    BC_COLOUR,
+    BC_FG,              // also resets doll and mcache
+    BC_BASE,
+    BC_BG,
+    BC_CLOUD,
+    BC_FLAGS,           // (changed, value) bit pairs, see _binary_flags()
+    BC_HALO,
+    BC_ORB_GLOW,
+    BC_BLOOD_ROTATION,
+    BC_TRAVEL_TRAIL,
+    BC_HEAT_AURA,
+    BC_FLAVOUR,         // floor, special (0 for none)
+    BC_OVERLAYS,        // count, then the overlays
+};
+
+static void _write_varint(vector<uint8_t> &buf, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        buf.push_back((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    buf.push_back(v);
+}
+
+// Must match the order of binary_flag_names in map_knowledge.js.
+static uint32_t _binary_flags(const packed_cell &cur, const packed_cell &next)
+{
+    const int flags[][2] =
+    {
+        { cur.is_bloody, next.is_bloody },
+        { cur.old_blood, next.old_blood },
+        { cur.is_silenced, next.is_silenced },
+        { cur.is_moldy, next.is_moldy },
+        { cur.glowing_mold, next.glowing_mold },
+        { cur.is_sanctuary, next.is_sanctuary },
+        { cur.is_liquefied, next.is_liquefied },
+        { cur.quad_glow, next.quad_glow },
+        { cur.disjunct, next.disjunct },
+        { cur.mangrove_water, next.mangrove_water },
+    };
+    uint32_t bits = 0;
+    for (unsigned int i = 0; i < ARRAYSZ(flags); ++i)
+        if (flags[i][0] != flags[i][1])
+            bits |= (flags[i][1] ? 3 : 1) << (2 * i);
+    return bits;
+}
+
+static string _base64(const vector<uint8_t> &data)
+{
+    static const char digits[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        uint32_t v = data[i] << 16;
+        if (i + 1 < data.size())
+            v |= data[i + 1] << 8;
+        if (i + 2 < data.size())
+            v |= data[i + 2];
+        out += digits[(v >> 18) & 0x3f];
+        out += digits[(v >> 12) & 0x3f];
+        out += i + 1 < data.size() ? digits[(v >> 6) & 0x3f] : '=';
+        out += i + 2 < data.size() ? digits[v & 0x3f] : '=';
+    }
+    return out;
+}
+
+bool TilesFramework::_use_binary_map() const
+{
+    if (!has_receivers())
+        return false;
+    for (const WebtilesReceiver &r : m_receivers)
+        if (r.attached && !r.binary_map)
+            return false;
+    return true;
+}
+
+// Packs the changes to a cell the way _send_cell would describe them. Returns
+// false, without writing anything, for cells that need the JSON path.
+bool TilesFramework::_pack_cell(vector<uint8_t> &buf, int &last_idx,
+                                const coord_def &gc,
+                                const screen_cell_t &current_sc,
+                                const screen_cell_t &next_sc,
+                                const map_cell &current_mc,
+                                const map_cell &next_mc, bool force_full)
+{
+    const packed_cell &next_pc = next_sc.tile;
+    const packed_cell &current_pc = current_sc.tile;
+    const tileidx_t fg_idx = next_pc.fg & TILE_FLAG_MASK;
+
+    if (next_mc.monsterinfo() || current_mc.monsterinfo()
+        || fg_idx >= TILE_MAIN_MAX)
+    {
+        return false;
+    }
+
+    uint32_t mask = 0;
+    vector<uint8_t> fields;
+
+    if (current_mc.feat() != next_mc.feat())
+    {
+        mask |= 1 << BC_FEAT;
+        _write_varint(fields, next_mc.feat());
+    }
+
+    map_feature mf = get_cell_map_feature(next_mc);
+    if (get_cell_map_feature(current_mc) != mf)
+    {
+        mask |= 1 << BC_MAP_FEAT;
+        _write_varint(fields, mf);
+    }
+
+    const ucs_t glyph = next_sc.glyph;
+    if (current_sc.glyph != glyph)
+    {
+        mask |= 1 << BC_GLYPH;
+        _write_varint(fields, glyph);
+    }
+    if ((current_sc.colour != next_sc.colour
+         || current_sc.glyph == ' ') && glyph != ' ')
+    {
+        int col = next_sc.colour;
+        col = (_get_brand(col) << 4) | macro_colour(col & 0xF);
+        mask |= 1 << BC_COLOUR;
+        _write_varint(fields, col);
+    }
+
+    if (next_pc.fg != current_pc.fg)
+    {
+        mask |= 1 << BC_FG;
+        _write_varint(fields, next_pc.fg);
+        if (fg_idx)
+        {
+            mask |= 1 << BC_BASE;
+            _write_varint(fields, tileidx_known_base_item(fg_idx));
+        }
+    }
+
+    if (next_pc.bg != current_pc.bg)
+    {
+        mask |= 1 << BC_BG;
+        _write_varint(fields, next_pc.bg);
+    }
+
+    if (next_pc.cloud != current_pc.cloud)
+    {
+        mask |= 1 << BC_CLOUD;
+        _write_varint(fields, next_pc.cloud);
+    }
+
+    if (uint32_t flags = _binary_flags(current_pc, next_pc))
+    {
+        mask |= 1 << BC_FLAGS;
+        _write_varint(fields, flags);
+    }
+
+    if (next_pc.halo != current_pc.halo)
+    {
+        mask |= 1 << BC_HALO;
+        _write_varint(fields, next_pc.halo);
+    }
+
+    if (next_pc.orb_glow != current_pc.orb_glow)
+    {
+        mask |= 1 << BC_ORB_GLOW;
+        _write_varint(fields, next_pc.orb_glow);
+    }
+
+    if (next_pc.blood_rotation != current_pc.blood_rotation)
+    {
+        mask |= 1 << BC_BLOOD_ROTATION;
+        _write_varint(fields, next_pc.blood_rotation);
+    }
+
+    if (next_pc.travel_trail != current_pc.travel_trail)
+    {
+        mask |= 1 << BC_TRAVEL_TRAIL;
+        _write_varint(fields, next_pc.travel_trail);
+    }
+
+#if TAG_MAJOR_VERSION == 34
+    if (next_pc.heat_aura != current_pc.heat_aura)
+    {
+        mask |= 1 << BC_HEAT_AURA;
+        _write_varint(fields, next_pc.heat_aura);
+    }
+#endif
+
+    if (_needs_flavour(next_pc) &&
+        (next_pc.flv.floor != current_pc.flv.floor
+         || next_pc.flv.special != current_pc.flv.special
+         || !_needs_flavour(current_pc)
+         || force_full))
+    {
+        mask |= 1 << BC_FLAVOUR;
+        _write_varint(fields, next_pc.flv.floor);
+        _write_varint(fields, next_pc.flv.special);
+    }
+
+    bool overlays_changed =
+        next_pc.num_dngn_overlay != current_pc.num_dngn_overlay;
+    for (int i = 0; !overlays_changed && i < next_pc.num_dngn_overlay; i++)
+        overlays_changed = next_pc.dngn_overlay[i] != current_pc.dngn_overlay[i];
+    if (overlays_changed)
+    {
+        mask |= 1 << BC_OVERLAYS;
+        _write_varint(fields, next_pc.num_dngn_overlay);
+        for (int i = 0; i < next_pc.num_dngn_overlay; ++i)
+            _write_varint(fields, next_pc.dngn_overlay[i]);
+    }
+
+    if (!mask)
+        return true;
+
+    const int idx = gc.y * GXM + gc.x;
+    _write_varint(buf, idx - last_idx - 1);
+    _write_varint(buf, mask);
+    buf.insert(buf.end(), fields.begin(), fields.end());
+    last_idx = idx;
+    return true;
+}
+
 void TilesFramework::_send_cell(const coord_def &gc,
                                 const screen_cell_t &current_sc, const screen_cell_t &next_sc,
                                 const map_cell &current_mc, const map_cell &next_mc,
@@ -1378,6 +2049,13 @@ void TilesFramework::_send_map(bool force_full)
     coord_def last_gc(0, 0);
     bool send_gc = true;
 
+    const bool binary = _use_binary_map();
+    vector<uint8_t> bcells;
+    int last_bcell = -1;
+
+    // Only the cells sent below can differ from what the client has.
+    vector<coord_def> sent_cells;
+
     json_open_array("cells");
     for (int y = 0; y < GYM; y++)
         for (int x = 0; x < GXM; x++)
@@ -1397,6 +2075,7 @@ void TilesFramework::_send_map(bool force_full)
             }
 
             mark_clean(gc);
+            sent_cells.push_back(gc);
 
             if (m_origin.equals(-1, -1))
                 m_origin = gc;
@@ -1415,6 +2094,13 @@ void TilesFramework::_send_map(bool force_full)
                 : m_current_view(gc);
             const map_cell& mc = force_full ? default_map_cell
                 : m_current_map_knowledge(gc);
+            if (binary
+                && _pack_cell(bcells, last_bcell, gc, sc, m_next_view(gc),
+                              mc, env.map_knowledge(gc), force_full))
+            {
+                json_close_object(true);
+                continue;
+            }
             _send_cell(gc,
                        sc,
                        m_next_view(gc),
@@ -1430,6 +2116,18 @@ void TilesFramework::_send_map(bool force_full)
         }
     json_close_array(true);
 
+    if (!bcells.empty())
+    {
+        // Cells are packed by grid index; the client needs the origin to
+        // place them.
+        json_open_object("bcells");
+        json_write_int("w", GXM);
+        json_write_int("x", -m_origin.x);
+        json_write_int("y", -m_origin.y);
+        json_write_string("data", _base64(bcells));
+        json_close_object();
+    }
+
     json_close_object(true);
 
     finish_message();
@@ -1440,8 +2138,21 @@ void TilesFramework::_send_map(bool force_full)
     if (m_mcache_ref_done)
         _mcache_ref(false);
 
-    m_current_map_knowledge = env.map_knowledge;
-    m_current_view = m_next_view;
+    // Copying the whole of map_knowledge deep-copies every remembered
+    // monster and item on the level, so bring over just what was sent.
+    if (force_full)
+    {
+        m_current_map_knowledge = env.map_knowledge;
+        m_current_view = m_next_view;
+    }
+    else
+    {
+        for (const coord_def &gc : sent_cells)
+        {
+            m_current_map_knowledge(gc) = env.map_knowledge(gc);
+            m_current_view(gc) = m_next_view(gc);
+        }
+    }
 
     _mcache_ref(true);
     m_mcache_ref_done = true;
@@ -1583,6 +2294,23 @@ void TilesFramework::resize()
     m_text_menu.resize(crawl_view.termsz.x, crawl_view.termsz.y);
 }
 
+void TilesFramework::_send_everything_if_joined()
+{
+    // A recording gets the full state again every so often, so that it can
+    // be replayed from there; everyone else gets it too, exactly as when a
+    // spectator joins, so that the deltas after it suit every receiver.
+    const bool keyframe = _recording_keyframe_due();
+    if (!m_spectator_joined && !keyframe)
+        return;
+
+    m_spectator_joined = false;
+    flush_messages();
+    if (keyframe)
+        _start_recording_keyframe();
+    _send_everything();
+    flush_messages();
+}
+
 /*
   Send everything a newly joined spectator needs
  */
@@ -1689,6 +2417,7 @@ void TilesFramework::cgotoxy(int x, int y, GotoRegion region)
 
 void TilesFramework::redraw()
 {
+    PROFILE_SECTION(PROF_WEBTILES);
     if (!has_receivers())
     {
         if (m_mcache_ref_done)
@@ -1938,25 +2667,42 @@ bool TilesFramework::cell_needs_redraw(const coord_def& gc)
     return m_cells_needing_redraw[gc.y * GXM + gc.x];
 }
 
+static inline bool _json_needs_escape(unsigned char c)
+{
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
 void TilesFramework::write_message_escaped(const string& s)
 {
+    static const char hex[] = "0123456789abcdef";
+
     m_msg_buf.reserve(m_msg_buf.size() + s.size());
 
-    for (unsigned char c : s)
+    const size_t len = s.size();
+    size_t run = 0;
+    for (size_t i = 0; i < len; ++i)
     {
-        if (c == '"')
-            m_msg_buf.append("\\\"");
-        else if (c == '\\')
-            m_msg_buf.append("\\\\");
-        else if (c < 0x20)
+        const unsigned char c = s[i];
+        if (!_json_needs_escape(c))
+            continue;
+
+        // Copy the unescaped stretch before this character in one go.
+        m_msg_buf.append(s, run, i - run);
+        run = i + 1;
+
+        if (c == '"' || c == '\\')
         {
-            char buf[7];
-            snprintf(buf, sizeof(buf), "\\u%04x", c);
-            m_msg_buf.append(buf);
+            m_msg_buf += '\\';
+            m_msg_buf += c;
         }
         else
-            m_msg_buf.append(1, c);
+        {
+            const char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4],
+                                  hex[c & 0xf] };
+            m_msg_buf.append(esc, sizeof(esc));
+        }
     }
+    m_msg_buf.append(s, run, len - run);
 }
 
 void TilesFramework::json_open(const string& name, char opener, char type)
@@ -2036,23 +2782,37 @@ void TilesFramework::json_write_comma()
     if (m_msg_buf.empty()) return;
     char last = m_msg_buf[m_msg_buf.size() - 1];
     if (last == '{' || last == '[' || last == ',' || last == ':') return;
-    write_message(",");
+    m_msg_buf += ',';
 }
 
 void TilesFramework::json_write_name(const string& name)
 {
     json_write_comma();
 
-    write_message("\"");
+    m_msg_buf += '"';
     write_message_escaped(name);
-    write_message("\":");
+    m_msg_buf.append("\":", 2);
 }
 
 void TilesFramework::json_write_int(int value)
 {
     json_write_comma();
 
-    write_message("%d", value);
+    // Format by hand; this is called for most fields of every cell, item
+    // and player update.
+    char buf[12];
+    char *end = buf + sizeof(buf);
+    char *p = end;
+    unsigned int u = value < 0 ? 0u - (unsigned int) value : value;
+    do
+    {
+        *--p = '0' + u % 10;
+        u /= 10;
+    }
+    while (u);
+    if (value < 0)
+        *--p = '-';
+    m_msg_buf.append(p, end - p);
 }
 
 void TilesFramework::json_write_int(const string& name, int value)
@@ -2068,9 +2828,9 @@ void TilesFramework::json_write_bool(bool value)
     json_write_comma();
 
     if (value)
-        write_message("true");
+        m_msg_buf.append("true", 4);
     else
-        write_message("false");
+        m_msg_buf.append("false", 5);
 }
 
 void TilesFramework::json_write_bool(const string& name, bool value)
@@ -2085,7 +2845,7 @@ void TilesFramework::json_write_null()
 {
     json_write_comma();
 
-    write_message("null");
+    m_msg_buf.append("null", 4);
 }
 
 void TilesFramework::json_write_null(const string& name)
@@ -2100,9 +2860,9 @@ void TilesFramework::json_write_string(const string& value)
 {
     json_write_comma();
 
-    write_message("\"");
+    m_msg_buf += '"';
     write_message_escaped(value);
-    write_message("\"");
+    m_msg_buf += '"';
 }
 
 void TilesFramework::json_write_string(const string& name, const string& value)
@@ -9,6 +9,7 @@
 #include <bitset>
 #include <map>
 #include <sys/un.h>
+#include <zlib.h>
 
 #include "map_knowledge.h"
 #include "status.h"
@@ -33,6 +34,19 @@ enum WebtilesUIState
     UI_VIEW_MAP,
 };
 
+// A webtiles server process attached to the game's socket.
+struct WebtilesReceiver
+{
+    WebtilesReceiver();
+
+    sockaddr_un addr;   // datagram sockets only
+    int fd;             // stream sockets only; -1 otherwise
+    bool attached;      // has sent its attach message
+    bool binary_map;    // asked for binary map cells
+    bool batched;       // can split a datagram holding several messages
+    string input;       // partially read control messages (stream only)
+};
+
 struct player_info
 {
     player_info();
@@ -144,7 +158,7 @@ public:
     void send_message(PRINTF(1, ));
     void flush_messages();
 
-    bool has_receivers() { return !m_dest_addrs.empty(); }
+    bool has_receivers() const;
     bool is_controlled_from_web() { return m_controlled_from_web; }
 
     /* Webtiles can receive input both via stdin, and on the
@@ -190,7 +204,10 @@ public:
     bool json_is_empty();
 
     string m_sock_name;
+    bool m_sock_stream;
     bool m_await_connection;
+    // -webtiles-record: everything sent is also written to this file.
+    string m_record_name;
 
     WebtilesCRTMode m_crt_mode;
 
@@ -207,14 +224,46 @@ protected:
     int m_sock;
     int m_max_msg_size;
     string m_msg_buf;
-    vector<sockaddr_un> m_dest_addrs;
+    vector<WebtilesReceiver> m_receivers;
+    // Finished messages not yet sent, and where each of them ends. They go
+    // out together at the next flush_messages().
+    string m_out_buf;
+    vector<size_t> m_out_ends;
+
+    // The recording is a series of gzip members, each starting with the
+    // full state, whose offsets are listed with their times in
+    // m_record_name + ".idx", so that a replay can start at any of them.
+    gzFile m_record;
+    FILE *m_record_index;
+    unsigned int m_record_start;
+    unsigned int m_record_keyframe;
+    bool _recording_keyframe_due() const;
+    void _start_recording_keyframe();
+    void _record_output();
 
     bool m_controlled_from_web;
     bool m_need_flush;
+    // A spectator joined since the full state was last sent; several
+    // joins in one batch of control messages share one resend.
+    bool m_spectator_joined;
 
     void _await_connection();
-    wint_t _handle_control_message(sockaddr_un addr, string data);
+    wint_t _handle_control_message(const sockaddr_un &addr, int fd,
+                                   string data);
     wint_t _receive_control_message();
+    bool _control_message_waiting() const;
+    bool _drain_control_messages(wint_t &c);
+    void _accept_connection();
+    void _read_stream(unsigned int i);
+    bool _handle_stream_input(wint_t &c);
+    void _wait_for_stream();
+
+    void _flush_output();
+    bool _send_datagrams(const WebtilesReceiver &r, const char *data,
+                         size_t len);
+    bool _send_stream(const WebtilesReceiver &r, const char *data,
+                      size_t len);
+    void _drop_receiver(unsigned int i);
 
     struct JsonFrame
     {
@@ -293,12 +342,19 @@ protected:
     void _send_layout();
 
     void _send_everything();
+    void _send_everything_if_joined();
 
     bool m_mcache_ref_done;
     void _mcache_ref(bool inc);
 
     void _send_cursor(cursor_type type);
     void _send_map(bool force_full = false);
+    bool _use_binary_map() const;
+    bool _pack_cell(vector<uint8_t> &buf, int &last_idx, const coord_def &gc,
+                    const screen_cell_t &current_sc,
+                    const screen_cell_t &next_sc,
+                    const map_cell &current_mc, const map_cell &next_mc,
+                    bool force_full);
     void _send_cell(const coord_def &gc,
                     const screen_cell_t &current_sc, const screen_cell_t &next_sc,
                     const map_cell &current_mc, const map_cell &next_mc,
@@ -15,6 +15,7 @@
 #include "cloud.h"
 #include "coordit.h"
 #include "database.h"
+#include "dbg-util.h"
 #include "dgn-shoals.h"
 #include "dgnevent.h"
 #include "dungeon.h"
@@ -46,6 +47,7 @@
 #include "spl-clouds.h"
 #include "spl-miscast.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "teleport.h"
 #include "terrain.h"
 #include "tileview.h"
@@ -411,20 +413,20 @@ void change_labyrinth(bool msg)
         c1 = coord_def(x, y);
         c2 = coord_def(x + size, y + size);
 
+        // Fill a vector with wall grids that are potential targets for
+        // swapping against floor, i.e. are flanked by walls to two cardinal
+        // directions, and by floor on the two remaining sides. Count the
+        // known grids in the same pass.
         int count_known = 0;
         for (rectangle_iterator ri(c1, c2); ri; ++ri)
+        {
             if (env.map_knowledge(*ri).seen())
+            {
                 count_known++;
+                continue;
+            }
 
-        if (tries > 1 && count_known > size * size / 6)
-            continue;
-
-        // Fill a vector with wall grids that are potential targets for
-        // swapping against floor, i.e. are flanked by walls to two cardinal
-        // directions, and by floor on the two remaining sides.
-        for (rectangle_iterator ri(c1, c2); ri; ++ri)
-        {
-            if (env.map_knowledge(*ri).seen() || !feat_is_wall(grd(*ri)))
+            if (!feat_is_wall(grd(*ri)))
                 continue;
 
             // Skip on grids inside vaults so as not to disrupt them.
@@ -436,6 +438,9 @@ void change_labyrinth(bool msg)
                 targets.push_back(*ri);
         }
 
+        if (tries > 1 && count_known > size * size / 6)
+            continue;
+
         if (targets.size() >= 8)
             break;
     }
@@ -510,10 +515,10 @@ void change_labyrinth(bool msg)
         // we find no floor grid to swap with.
         // It's better if the change is done now, so the grid can be
         // treated as floor rather than a wall, and we don't need any
-        // special cases.
+        // special cases. Nothing else looks at the grid until the switch
+        // is decided, so only announce the change once it sticks.
         dungeon_feature_type old_grid = grd(c);
         grd(c) = DNGN_FLOOR;
-        set_terrain_changed(c);
 
         // Add all floor grids meeting a couple of conditions to a vector
         // of potential switch points.
@@ -548,9 +553,9 @@ void change_labyrinth(bool msg)
         {
             // Take back the previous change.
             grd(c) = old_grid;
-            set_terrain_changed(c);
             continue;
         }
+        set_terrain_changed(c);
 
         // Randomly pick one floor grid from the vector and replace it
         // with an adjacent wall type.
@@ -680,6 +685,7 @@ void change_labyrinth(bool msg)
             {
                 // Once a valid grid is found, move all items from the
                 // stack onto it.
+                // This also updates the items' coordinates.
                 move_items(*ri, p);
 
                 if (msg)
@@ -692,9 +698,6 @@ void change_labyrinth(bool msg)
         }
     }
 
-    // Recheck item coordinates, to make totally sure.
-    fix_item_coordinates();
-
     // Finally, give the player a clue about what just happened.
     const int which = (silenced(you.pos()) ? 2 + random2(2)
                                            : random2(4));
@@ -1412,12 +1415,15 @@ void monster::timeout_enchantments(int levels)
  */
 void update_level(int elapsedTime)
 {
+    PROFILE_SECTION(PROF_UPDATE_LEVEL);
+
     ASSERT(!crawl_state.game_is_arena());
 
     const int turns = elapsedTime / 10;
 
 #ifdef DEBUG_DIAGNOSTICS
     int mons_total = 0;
+    const unsigned int catchup_start = get_milliseconds();
 
     dprf("turns: %d", turns);
 #endif
@@ -1472,11 +1478,14 @@ void update_level(int elapsedTime)
             mi->timeout_enchantments(turns / 10);
     }
 
+    delete_all_clouds();
+
 #ifdef DEBUG_DIAGNOSTICS
     dprf("total monsters on level = %d", mons_total);
+    dprf("caught up %d turns on %s in %u ms", turns,
+         level_id::current().describe().c_str(),
+         get_milliseconds() - catchup_start);
 #endif
-
-    delete_all_clouds();
 }
 
 static void _recharge_rod(item_def &rod, int aut, bool in_inv)
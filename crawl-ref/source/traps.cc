@@ -1034,9 +1034,8 @@ int reveal_traps(const int range)
 {
     int traps_found = 0;
 
-    for (auto& entry : env.trap)
+    for (trap_def& trap : env.trap)
     {
-        trap_def& trap = entry.second;
         if (!trap.active())
             continue;
         if (grid_distance(you.pos(), trap.pos) < range && !trap.is_known())
@@ -1062,12 +1061,12 @@ trap_def* trap_at(const coord_def& pos)
     if (!feat_is_trap(grd(pos), true))
         return nullptr;
 
-    auto it = env.trap.find(pos);
-    ASSERT(it != env.trap.end());
-    ASSERT(it->second.pos == pos);
-    ASSERT(it->second.type != TRAP_UNASSIGNED);
+    trap_def *trap = env.trap.find(pos);
+    ASSERT(trap);
+    ASSERT(trap->pos == pos);
+    ASSERT(trap->type != TRAP_UNASSIGNED);
 
-    return &it->second;
+    return trap;
 }
 
 trap_type get_trap_type(const coord_def& pos)
@@ -1865,8 +1864,8 @@ trap_type random_vault_trap()
 int count_traps(trap_type ttyp)
 {
     int num = 0;
-    for (const auto& entry : env.trap)
-        if (entry.second.type == ttyp)
+    for (const trap_def& trap : env.trap)
+        if (trap.type == ttyp)
             num++;
     return num;
 }
@@ -35,6 +35,7 @@
 #include "format.h"
 #include "godabil.h"
 #include "godprayer.h"
+#include "hash.h"
 #include "hints.h"
 #include "itemname.h"
 #include "itemprop.h"
@@ -99,6 +100,13 @@ static level_id _Src_Level;
 // Remember the last place explore stopped because autopickup failed.
 static coord_def explore_stopped_pos;
 
+// An unmapped square that the current explore target can see. While it stays
+// unmapped the target remains worth visiting, so we can skip rescanning the
+// target's LOS on every step of a long explore run.
+static level_id explore_witness_level;
+static coord_def explore_witness_target;
+static coord_def explore_witness;
+
 // The place in the Vestibule of Hell where all portals to Hell land.
 static level_pos travel_hell_entry;
 
@@ -335,47 +343,88 @@ static bool _is_reseedable(const coord_def& c, bool ignore_danger = false)
            || !_is_safe_cloud(c);
 }
 
-struct cell_travel_safety
+// Cached _is_travelsafe_square() answers. Each of the eight combinations of
+// (ignore_hostile, ignore_danger, try_fallback) has a "known" bit in the low
+// byte of a cell and its answer in the matching bit of the high byte. Cells
+// are filled in lazily, so a flood only pays for the squares it reaches.
+typedef FixedArray<uint16_t, GXM, GYM> travel_safe_grid;
+static travel_safe_grid _travel_safe_grid;
+static bool _travel_safe_grid_active = false;
+
+// Everything the cached answers depend on. Map knowledge, clouds, monsters
+// and player form can only change when time passes, so the cache survives
+// the several floods of a single travel or explore step and is thrown away
+// on the next one.
+struct travel_safety_key
 {
-    bool safe;
-    bool safe_if_ignoring_hostile_terrain;
+    level_id place;
+    coord_def pos;
+    int turns;
+    int elapsed_time;
+    unsigned int exclusion_changes;
+    bool slime_wall_check;
+    bool ignore_traversability;
+
+    travel_safety_key()
+        : place(), pos(), turns(-1), elapsed_time(-1), exclusion_changes(0),
+          slime_wall_check(false), ignore_traversability(false)
+    {
+    }
 
-    cell_travel_safety() : safe(false), safe_if_ignoring_hostile_terrain(false)
+    static travel_safety_key current()
     {
+        travel_safety_key key;
+        key.place = level_id::current();
+        key.pos = you.pos();
+        key.turns = you.num_turns;
+        key.elapsed_time = you.elapsed_time;
+        key.exclusion_changes = curr_excludes.changes();
+        key.slime_wall_check = g_Slime_Wall_Check;
+        key.ignore_traversability = ignore_player_traversability;
+        return key;
+    }
+
+    bool operator == (const travel_safety_key &other) const
+    {
+        return place == other.place && pos == other.pos
+               && turns == other.turns && elapsed_time == other.elapsed_time
+               && exclusion_changes == other.exclusion_changes
+               && slime_wall_check == other.slime_wall_check
+               && ignore_traversability == other.ignore_traversability;
     }
 };
 
-typedef FixedArray<cell_travel_safety, GXM, GYM> travel_safe_grid;
-static unique_ptr<travel_safe_grid> _travel_safe_grid;
+static travel_safety_key _travel_safe_key;
 
 class precompute_travel_safety_grid
 {
 private:
-    bool did_compute;
+    bool did_enable;
+    travel_safety_key old_key;
 
 public:
-    precompute_travel_safety_grid() : did_compute(false)
+    precompute_travel_safety_grid()
+        : did_enable(!_travel_safe_grid_active), old_key(_travel_safe_key)
     {
-        if (!_travel_safe_grid.get())
+        const travel_safety_key key = travel_safety_key::current();
+        if (!(key == _travel_safe_key))
         {
-            did_compute = true;
-            auto tsgrid = make_unique<travel_safe_grid>();
-            travel_safe_grid &safegrid(*tsgrid);
-            for (rectangle_iterator ri(1); ri; ++ri)
-            {
-                const coord_def p(*ri);
-                cell_travel_safety &ts(safegrid(p));
-                ts.safe = _is_travelsafe_square(p, false);
-                ts.safe_if_ignoring_hostile_terrain =
-                    _is_travelsafe_square(p, true);
-            }
-            _travel_safe_grid = move(tsgrid);
+            _travel_safe_grid.init(0);
+            _travel_safe_key = key;
         }
+        _travel_safe_grid_active = true;
     }
     ~precompute_travel_safety_grid()
     {
-        if (did_compute)
-            _travel_safe_grid.reset(nullptr);
+        if (did_enable)
+            _travel_safe_grid_active = false;
+        // A nested user with different settings must not leave its answers
+        // behind for the enclosing one.
+        else if (!(old_key == _travel_safe_key))
+        {
+            _travel_safe_grid.init(0);
+            _travel_safe_key = old_key;
+        }
     }
 };
 
@@ -390,19 +439,11 @@ bool is_stair_exclusion(const coord_def &p)
 // Returns true if the square at (x,y) is okay to travel over. If ignore_hostile
 // is true, returns true even for dungeon features the character can normally
 // not cross safely (deep water, lava, traps).
-static bool _is_travelsafe_square(const coord_def& c, bool ignore_hostile,
-                                  bool ignore_danger, bool try_fallback)
+static bool _is_travelsafe_square_uncached(const coord_def& c,
+                                           bool ignore_hostile,
+                                           bool ignore_danger,
+                                           bool try_fallback)
 {
-    if (!in_bounds(c))
-        return false;
-
-    if (_travel_safe_grid.get())
-    {
-        const cell_travel_safety &cell((*_travel_safe_grid)(c));
-        return ignore_hostile? cell.safe_if_ignoring_hostile_terrain
-               : cell.safe;
-    }
-
     if (!env.map_knowledge(c).known())
         return false;
 
@@ -460,6 +501,33 @@ static bool _is_travelsafe_square(const coord_def& c, bool ignore_hostile,
     return feat_is_traversable_now(grid, try_fallback);
 }
 
+static bool _is_travelsafe_square(const coord_def& c, bool ignore_hostile,
+                                  bool ignore_danger, bool try_fallback)
+{
+    if (!in_bounds(c))
+        return false;
+
+    if (!_travel_safe_grid_active)
+    {
+        return _is_travelsafe_square_uncached(c, ignore_hostile,
+                                              ignore_danger, try_fallback);
+    }
+
+    const int known = 1 << (ignore_hostile | ignore_danger << 1
+                            | try_fallback << 2);
+    uint16_t &cell(_travel_safe_grid(c));
+    if (!(cell & known))
+    {
+        cell |= known;
+        if (_is_travelsafe_square_uncached(c, ignore_hostile, ignore_danger,
+                                           try_fallback))
+        {
+            cell |= known << 8;
+        }
+    }
+    return cell & known << 8;
+}
+
 // Returns true if the location at (x,y) is monster-free and contains
 // no clouds. Travel uses this to check if the square the player is
 // about to move to is safe.
@@ -507,6 +575,7 @@ void travel_init_new_level()
     travel_init_load_level();
 
     explore_stopped_pos.reset();
+    explore_witness_target.reset();
 }
 
 // Given a dungeon feature description, returns the feature number. This is a
@@ -629,10 +698,23 @@ void stop_running()
 
 static bool _is_valid_explore_target(const coord_def& where)
 {
+    const level_id here = level_id::current();
+    if (explore_witness_target == where && explore_witness_level == here
+        && !env.map_knowledge(explore_witness).seen())
+    {
+        return true;
+    }
+    explore_witness_target.reset();
+
     // If a square in LOS is unmapped, it's valid.
     for (radius_iterator ri(where, LOS_DEFAULT, true); ri; ++ri)
         if (!env.map_knowledge(*ri).seen())
+        {
+            explore_witness_level = here;
+            explore_witness_target = where;
+            explore_witness = *ri;
             return true;
+        }
 
     if (you.running == RMODE_EXPLORE_GREEDY)
     {
@@ -1326,6 +1408,7 @@ coord_def travel_pathfind::pathfind(run_mode_type rmode, bool fallback_explore)
     unwind_bool slime_wall_check(g_Slime_Wall_Check,
                                  !actor_slime_wall_immune(&you));
     unwind_slime_wall_precomputer slime_neighbours(g_Slime_Wall_Check);
+    precompute_travel_safety_grid travel_safety_calc;
 
     // How many points are we currently considering? We start off with just one
     // point, and spread outwards like a flood-filler.
@@ -2822,8 +2905,30 @@ static int _find_transtravel_stair(const level_id &cur,
     return local_distance;
 }
 
+// If the target is itself a stair we know about, LevelInfo already holds
+// its distance to every other stair on that level, so there is no need to
+// load the level and flood it again.
+static bool _cached_stair_distances(const level_pos &target)
+{
+    LevelInfo &li = travel_cache.get_level_info(target.id);
+    const stair_info *dest = li.get_stair(target.pos);
+    if (!dest || !dest->can_travel())
+        return false;
+
+    curr_stairs.clear();
+    for (stair_info si : li.get_stairs())
+    {
+        si.distance = li.distance_between(&si, dest);
+        curr_stairs.push_back(si);
+    }
+    return true;
+}
+
 static bool _loadlev_populate_stair_distances(const level_pos &target)
 {
+    if (_cached_stair_distances(target))
+        return true;
+
     level_excursion excursion;
     excursion.go_to(target.id);
     _populate_stair_distances(target);
@@ -3258,6 +3363,29 @@ void LevelInfo::update_excludes()
     excludes = curr_excludes;
 }
 
+// A hash of what the stair-to-stair floods in update_stair_distances() look
+// at: stair positions, terrain costs and the travel safety of every square.
+// If it hasn't changed, neither have the distances.
+static uint64_t _stair_distance_signature(const vector<stair_info> &stairs)
+{
+    uint64_t signature = stairs.size();
+    for (const stair_info &si : stairs)
+        signature = hash3(signature, si.position.x, si.position.y);
+
+    for (rectangle_iterator ri(1); ri; ++ri)
+    {
+        const coord_def p(*ri);
+        const uint64_t safety =
+              _is_travelsafe_square(p, false, false, false)
+            | _is_travelsafe_square(p, false, false, true) << 1
+            | _is_travelsafe_square(p, true, false, false) << 2
+            | _is_travelsafe_square(p, true, false, true) << 3
+            | _is_reseedable(p) << 4;
+        signature = hash3(signature, env.map_knowledge(p).feat(), safety);
+    }
+    return signature;
+}
+
 void LevelInfo::update()
 {
     // First, set excludes, so that stair distances will be correctly populated.
@@ -3267,6 +3395,13 @@ void LevelInfo::update()
     vector<coord_def> stair_positions;
     get_stairs(stair_positions);
 
+    // correct_stair_list() throws the distances away; keep them in case
+    // nothing relevant has changed since they were computed.
+    vector<coord_def> old_positions;
+    for (const stair_info &si : stairs)
+        old_positions.push_back(si.position);
+    vector<short> old_distances(stair_distances);
+
     // Make sure our stair list is correct.
     correct_stair_list(stair_positions);
 
@@ -3274,10 +3409,24 @@ void LevelInfo::update()
 
     // If the player isn't immune to slimy walls, precalculate
     // neighbours of slimy walls now.
-    unwind_slime_wall_precomputer slime_wall_neighbours(
-        !actor_slime_wall_immune(&you));
+    const bool slime_check = !actor_slime_wall_immune(&you);
+    unwind_slime_wall_precomputer slime_wall_neighbours(slime_check);
+    unwind_bool slime_wall_check(g_Slime_Wall_Check, slime_check);
     precompute_travel_safety_grid travel_safety_calc;
-    update_stair_distances();
+
+    const uint64_t signature = _stair_distance_signature(stairs);
+    bool same_stairs = old_positions.size() == stairs.size()
+                       && old_distances.size() == stair_distances.size();
+    for (int i = 0, size = stairs.size(); same_stairs && i < size; ++i)
+        same_stairs = old_positions[i] == stairs[i].position;
+
+    if (same_stairs && stair_signature && signature == stair_signature)
+        stair_distances = old_distances;
+    else
+    {
+        update_stair_distances();
+        stair_signature = signature;
+    }
 
     update_daction_counters(this);
 }
@@ -3620,6 +3769,7 @@ void LevelInfo::load(reader& inf, int minorVersion)
     }
 
     stair_distances.clear();
+    stair_signature = 0;
     if (stair_count)
     {
         stair_distances.reserve(stair_count * stair_count);
@@ -4141,7 +4291,8 @@ bool runrest::run_should_stop() const
 void runrest::stop()
 {
     bool need_redraw =
-        (runmode > 0 || runmode < 0 && Options.travel_delay == -1);
+        (runmode > 0 || runmode < 0 && Options.travel_delay == -1
+         || runmode != RMODE_NOT_RUNNING && Options.runrest_redraw_rate > 0);
     _userdef_run_stoprunning_hook();
     runmode = RMODE_NOT_RUNNING;
 
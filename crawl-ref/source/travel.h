@@ -291,7 +291,8 @@ public:
 // Information on a level that interlevel travel needs.
 struct LevelInfo
 {
-    LevelInfo() : stairs(), excludes(), stair_distances(), id()
+    LevelInfo() : stairs(), excludes(), stair_distances(), id(),
+                  stair_signature(0)
     {
         daction_counters.init(0);
     }
@@ -360,6 +361,11 @@ private:
     vector<short> stair_distances;  // Dist between stairs
     level_id id;
 
+    // What the level looked like to travel when stair_distances was last
+    // computed; 0 if unknown. Not saved, so the first update() after a load
+    // recomputes.
+    uint64_t stair_signature;
+
     friend class TravelCache;
 
 private:
@@ -471,13 +471,28 @@ string UTF8FileLineInput::get_line()
     return utf8_validate(out.c_str());
 }
 
+// Printable 7-bit characters are one byte and one column wide, so runs of
+// them can be measured without decoding or calling wcwidth().
+static inline bool _is_printable_ascii(char c)
+{
+    return c >= 0x20 && c < 0x7f;
+}
+
 int strwidth(const char *s)
 {
     ucs_t c;
     int w = 0;
 
-    while (int l = utf8towc(&c, s))
+    while (true)
     {
+        const char *run = s;
+        while (_is_printable_ascii(*s))
+            s++;
+        w += s - run;
+
+        int l = utf8towc(&c, s);
+        if (!l)
+            break;
         s += l;
         int cw = wcwidth(c);
         if (cw != -1) // shouldn't ever happen
@@ -536,8 +551,14 @@ string chop_string(const char *s, int width, bool spaces)
     const char *s0 = s;
     ucs_t c;
 
-    while (int clen = utf8towc(&c, s))
+    while (true)
     {
+        while (width > 0 && _is_printable_ascii(*s))
+            s++, width--;
+
+        int clen = utf8towc(&c, s);
+        if (!clen)
+            break;
         int cw = wcwidth(c);
         // Due to combining chars, we can't stop at merely reaching the
         // target width, the next character needs to exceed it.
@@ -565,8 +586,17 @@ string chop_tagged_string(const char *s, int width, bool spaces)
     bool tag_first = false; // is this the first character of a tag?
     ucs_t c;
 
-    while (int clen = utf8towc(&c, s))
+    while (true)
     {
+        if (!in_tag)
+        {
+            while (width > 0 && _is_printable_ascii(*s) && *s != '<')
+                s++, width--;
+        }
+
+        int clen = utf8towc(&c, s);
+        if (!clen)
+            break;
         bool visible = true;
 
         if (in_tag)
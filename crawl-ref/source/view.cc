@@ -23,6 +23,7 @@
 #include "coord.h"
 #include "coordit.h"
 #include "database.h"
+#include "dbg-util.h"
 #include "delay.h"
 #include "dgn-overview.h"
 #include "directn.h"
@@ -57,6 +58,7 @@
 #include "showsymb.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "target.h"
 #include "terrain.h"
 #include "tilemcache.h"
@@ -76,6 +78,8 @@
 
 static layers_type _layers = LAYERS_ALL;
 static layers_type _layers_saved = LAYERS_NONE;
+// When the view was last drawn during a run, for runrest_redraw_rate.
+static unsigned int _last_run_redraw = 0;
 
 crawl_view_geometry crawl_view;
 
@@ -125,10 +129,11 @@ void seen_monsters_react(int stealth)
     if (you.duration[DUR_TIME_STEP] || crawl_state.game_is_arena())
         return;
 
+    const player_stealth_info you_info(stealth);
     for (monster_near_iterator mi(you.pos()); mi; ++mi)
     {
         if ((mi->asleep() || mons_is_wandering(*mi))
-            && check_awaken(*mi, stealth))
+            && check_awaken(*mi, you_info))
         {
             behaviour_event(*mi, ME_ALERT, &you, you.pos(), false);
 
@@ -1260,6 +1265,8 @@ void run_animation(animation_type anim, use_animation_type type, bool cleanup)
  */
 void viewwindow(bool show_updates, bool tiles_only, animation *a)
 {
+    PROFILE_SECTION(PROF_VIEW);
+
     // The player could be at (0,0) if we are called during level-gen; this can
     // happen via mpr -> interrupt_activity -> stop_delay -> runrest::stop
     if (you.duration[DUR_TIME_STEP] || you.pos().origin())
@@ -1297,12 +1304,37 @@ void viewwindow(bool show_updates, bool tiles_only, animation *a)
         show_init(_layers);
     }
 
+    // Nothing changes monsters between here and the end of the redraw, so
+    // the panes can reuse the monster_info just built.
+    fresh_monster_info_scope fresh_minfo(show_updates
+                                         && _layers == LAYERS_ALL);
+
     if (show_updates)
         player_view_update();
 
     bool run_dont_draw = you.running && Options.travel_delay < 0
                 && (!you.running.is_explore() || Options.explore_delay < 0);
 
+    // Likewise while resting with rest_delay = -1: the turns are still
+    // simulated in full, and runrest::stop() draws the final view.
+    if (you.running.is_rest() && Options.rest_delay < 0)
+        run_dont_draw = true;
+
+    // Skip frames while running if we drew one recently; the state above
+    // is still kept current, and runrest::stop() draws the final view.
+    if (!run_dont_draw && you.running && !a
+        && Options.runrest_redraw_rate > 0)
+    {
+        const unsigned int now = get_milliseconds();
+        if (now - _last_run_redraw
+            < (unsigned int) Options.runrest_redraw_rate)
+        {
+            run_dont_draw = true;
+        }
+        else
+            _last_run_redraw = now;
+    }
+
     if (run_dont_draw || you.asleep())
     {
         // Reset env.show if we munged it.
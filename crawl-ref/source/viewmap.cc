@@ -345,6 +345,48 @@ static void _draw_level_map(int start_x, int start_y, bool travel_mode,
 }
 #endif // USE_TILE_LOCAL
 
+#ifndef USE_TILE_LOCAL
+// Commands that only move the cursor (and maybe scroll), leaving both the
+// map and the rest of the screen alone.
+static bool _is_map_cursor_command(command_type cmd)
+{
+    switch (cmd)
+    {
+    case CMD_MAP_MOVE_DOWN_LEFT:
+    case CMD_MAP_MOVE_DOWN:
+    case CMD_MAP_MOVE_UP_RIGHT:
+    case CMD_MAP_MOVE_UP:
+    case CMD_MAP_MOVE_UP_LEFT:
+    case CMD_MAP_MOVE_LEFT:
+    case CMD_MAP_MOVE_DOWN_RIGHT:
+    case CMD_MAP_MOVE_RIGHT:
+    case CMD_MAP_JUMP_DOWN_LEFT:
+    case CMD_MAP_JUMP_DOWN:
+    case CMD_MAP_JUMP_UP_RIGHT:
+    case CMD_MAP_JUMP_UP:
+    case CMD_MAP_JUMP_UP_LEFT:
+    case CMD_MAP_JUMP_LEFT:
+    case CMD_MAP_JUMP_DOWN_RIGHT:
+    case CMD_MAP_JUMP_RIGHT:
+    case CMD_MAP_SCROLL_DOWN:
+    case CMD_MAP_SCROLL_UP:
+    case CMD_MAP_FIND_YOU:
+    case CMD_MAP_FIND_UPSTAIR:
+    case CMD_MAP_FIND_DOWNSTAIR:
+    case CMD_MAP_FIND_PORTAL:
+    case CMD_MAP_FIND_TRAP:
+    case CMD_MAP_FIND_ALTAR:
+    case CMD_MAP_FIND_EXCLUDED:
+    case CMD_MAP_FIND_WAYPOINT:
+    case CMD_MAP_FIND_STASH:
+    case CMD_MAP_FIND_STASH_REVERSE:
+        return true;
+    default:
+        return false;
+    }
+}
+#endif
+
 static void _reset_travel_colours(vector<coord_def> &features, bool on_level)
 {
     // We now need to redo travel colours.
@@ -626,6 +668,10 @@ bool show_map(level_pos &lpos,
         bool redraw_map = true;
 
 #ifndef USE_TILE_LOCAL
+        // The map only needs repainting when it scrolls or something on
+        // it changes; plain cursor movement just redraws the title.
+        bool map_stale = true;
+        int drawn_start_y = INT_MIN;
         const int top = 2;
         clrscr();
 #endif
@@ -722,6 +768,9 @@ bool show_map(level_pos &lpos,
 
                 redraw_map = true;
                 new_level = false;
+#ifndef USE_TILE_LOCAL
+                map_stale = true;
+#endif
             }
 
             // If we've received a HUP signal then the user can't choose a
@@ -753,7 +802,12 @@ bool show_map(level_pos &lpos,
 #endif
 #ifndef USE_TILE_LOCAL
                 _draw_title(lpos.pos, feats);
-                _draw_level_map(start_x, start_y, travel_mode, on_level);
+                if (map_stale || start_y != drawn_start_y)
+                {
+                    _draw_level_map(start_x, start_y, travel_mode, on_level);
+                    drawn_start_y = start_y;
+                    map_stale = false;
+                }
 #endif
             }
 #ifndef USE_TILE_LOCAL
@@ -811,6 +865,9 @@ bool show_map(level_pos &lpos,
 
             if (key == CK_REDRAW)
             {
+#ifndef USE_TILE_LOCAL
+                map_stale = true;
+#endif
                 viewwindow();
                 display_message_window();
                 continue;
@@ -818,6 +875,11 @@ bool show_map(level_pos &lpos,
 
             c_input_reset(false);
 
+#ifndef USE_TILE_LOCAL
+            if (!_is_map_cursor_command(cmd))
+                map_stale = true;
+#endif
+
             switch (cmd)
             {
             case CMD_MAP_HELP:
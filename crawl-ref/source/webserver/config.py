@@ -154,6 +154,15 @@ daemon = False # If true, the server will detach from the session after startup
 # Set to None to disable player page hyperlinks
 player_url = None
 
+# Ask games to send map cells in a compact binary encoding instead of JSON.
+# Games too old to know about it ignore this and keep sending JSON.
+binary_map_updates = True
+
+# Talk to games over a stream socket instead of datagrams. This avoids
+# fragmenting large updates, but needs a game version that understands
+# -webtiles-stream. Games are found either way when spectating.
+stream_game_socket = False
+
 # Only for development:
 # Disable caching of static files which are not part of game data.
 no_cache = False
@@ -1,4 +1,5 @@
 import socket
+import errno
 import fcntl
 import os, os.path
 import time
@@ -7,6 +8,7 @@ import warnings
 from datetime import datetime, timedelta
 from tornado.escape import json_encode
 
+import config
 from config import server_socket_path
 
 class WebtilesSocketConnection(object):
@@ -19,6 +21,7 @@ class WebtilesSocketConnection(object):
         self.socketpath = None
         self.open = False
         self.close_callback = None
+        self.stream = False
 
         self.msg_buffer = None
 
@@ -28,23 +31,33 @@ class WebtilesSocketConnection(object):
             self.io_loop.add_timeout(time.time() + 1, self.connect)
             return
 
-        self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM)
+        # Games started with -webtiles-stream listen on a stream socket;
+        # connecting to a datagram socket that way fails with EPROTOTYPE.
+        self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
         self.socket.settimeout(10)
+        try:
+            self.socket.connect(self.crawl_socketpath)
+            self.stream = True
+        except socket.error:
+            self.socket.close()
+            self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM)
+            self.socket.settimeout(10)
 
         # Set close-on-exec
         flags = fcntl.fcntl(self.socket.fileno(), fcntl.F_GETFD)
         fcntl.fcntl(self.socket.fileno(), flags | fcntl.FD_CLOEXEC)
 
-        self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        if not self.stream:
+            self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
 
-        # Bind to a temp path
-        # Ignore the security warning about tempnam; in this case,
-        # there is no security risk (the most that can happen is that
-        # the bind call fails)
-        with warnings.catch_warnings():
-            warnings.simplefilter("ignore")
-            self.socketpath = os.tempnam(server_socket_path, "crawl")
-        self.socket.bind(self.socketpath)
+            # Bind to a temp path
+            # Ignore the security warning about tempnam; in this case,
+            # there is no security risk (the most that can happen is that
+            # the bind call fails)
+            with warnings.catch_warnings():
+                warnings.simplefilter("ignore")
+                self.socketpath = os.tempnam(server_socket_path, "crawl")
+            self.socket.bind(self.socketpath)
 
         # Install handler
         self.io_loop.add_handler(self.socket.fileno(),
@@ -53,7 +66,10 @@ class WebtilesSocketConnection(object):
 
         msg = json_encode({
                 "msg": "attach",
-                "primary": primary
+                "primary": primary,
+                "binary_map": (hasattr(config, "binary_map_updates") and
+                               config.binary_map_updates),
+                "batched": True,
                 })
 
         self.open = True
@@ -62,7 +78,17 @@ class WebtilesSocketConnection(object):
 
     def _handle_read(self, fd, events):
         if events & self.io_loop.READ:
-            data = self.socket.recv(128 * 1024, socket.MSG_DONTWAIT)
+            try:
+                data = self.socket.recv(128 * 1024, socket.MSG_DONTWAIT)
+            except socket.error, e:
+                if e.errno in (errno.EAGAIN, errno.EWOULDBLOCK, errno.EINTR):
+                    return
+                raise
+
+            if not data and self.stream:
+                # The game closed the connection
+                self.close()
+                return
 
             self._handle_data(data)
 
@@ -73,21 +99,30 @@ class WebtilesSocketConnection(object):
         if self.msg_buffer is not None:
             data = self.msg_buffer + data
 
-        if data[-1] != "\n":
-            # All messages from crawl end with \n.
-            # If this one doesn't, it's fragmented.
-            self.msg_buffer = data
-
+        # All messages from crawl end with \n, and that is the only raw
+        # newline in them. One read can carry several of them (crawl sends
+        # everything since the last flush at once) and end in the middle
+        # of another.
+        end = data.rfind("\n")
+        if end < len(data) - 1:
+            self.msg_buffer = data[end + 1:]
         else:
             self.msg_buffer = None
 
+        if end == -1:
+            return
+
+        for msg in data[:end].split("\n"):
             if self.message_callback:
-                self.message_callback(data)
+                self.message_callback(msg)
 
     def send_message(self, data):
         start = datetime.now()
         try:
-            self.socket.sendto(data, self.crawl_socketpath)
+            if self.stream:
+                self.socket.sendall(data + "\n")
+            else:
+                self.socket.sendto(data, self.crawl_socketpath)
         except socket.timeout:
             self.logger.warning("Game socket send timeout", exc_info=True)
             self.close()
@@ -100,7 +135,8 @@ class WebtilesSocketConnection(object):
         if self.socket:
             self.io_loop.remove_handler(self.socket.fileno())
             self.socket.close()
-            os.remove(self.socketpath)
+            if self.socketpath:
+                os.remove(self.socketpath)
             self.socket = None
         if self.close_callback:
             self.close_callback()
@@ -207,9 +207,130 @@ define(["jquery", "./enums", "./util"], function ($, enums, util) {
         clean_monster_table();
     };
 
+    // Binary cells, see _pack_cell() in tileweb.cc. The field numbers and
+    // flag order have to match binary_cell_field and _binary_flags() there.
+    var binary_flag_names = ["bloody", "old_blood", "silenced", "moldy",
+                             "glowing_mold", "sanctuary", "liquefied",
+                             "quad_glow", "disjunct", "mangrove_water"];
+    var binary_int_fields = { 9: "halo", 10: "orb_glow", 11: "blood_rotation",
+                              12: "travel_trail", 13: "heat_aura" };
+
+    function merge_binary(b)
+    {
+        var data = atob(b.data);
+        var pos = 0;
+
+        function varint()
+        {
+            var v = 0, mul = 1, byte;
+            do
+            {
+                byte = data.charCodeAt(pos++);
+                v += (byte & 0x7f) * mul;
+                mul *= 128;
+            } while (byte & 0x80);
+            return v;
+        }
+
+        // Tile indices use all 64 bits; split them into signed 32-bit
+        // halves the way the JSON encoding does.
+        function tileidx()
+        {
+            var lo = 0, hi = 0, shift = 0, byte, bits;
+            do
+            {
+                byte = data.charCodeAt(pos++);
+                bits = byte & 0x7f;
+                if (shift < 32)
+                    lo |= bits << shift;
+                if (shift + 7 > 32)
+                {
+                    hi |= shift < 32 ? bits >>> (32 - shift)
+                                     : bits << (shift - 32);
+                }
+                shift += 7;
+            } while (byte & 0x80);
+            return hi ? [lo | 0, hi | 0] : lo | 0;
+        }
+
+        function glyph(c)
+        {
+            if (c < 0x10000)
+                return String.fromCharCode(c);
+            c -= 0x10000;
+            return String.fromCharCode(0xD800 + (c >> 10),
+                                       0xDC00 + (c & 0x3FF));
+        }
+
+        var idx = -1;
+        while (pos < data.length)
+        {
+            idx += varint() + 1;
+            var mask = varint();
+            var val = {
+                x: idx % b.w + b.x,
+                y: Math.floor(idx / b.w) + b.y
+            };
+            var t = {};
+
+            if (mask & (1 << 0))
+                val.f = varint();
+            if (mask & (1 << 1))
+                val.mf = varint();
+            if (mask & (1 << 2))
+                val.g = glyph(varint());
+            if (mask & (1 << 3))
+                val.col = varint();
+            if (mask & (1 << 4))
+            {
+                t.fg = tileidx();
+                t.doll = null;
+                t.mcache = null;
+            }
+            if (mask & (1 << 5))
+                t.base = varint();
+            if (mask & (1 << 6))
+                t.bg = tileidx();
+            if (mask & (1 << 7))
+                t.cloud = tileidx();
+            if (mask & (1 << 8))
+            {
+                var flags = varint();
+                for (var i = 0; i < binary_flag_names.length; ++i)
+                {
+                    var pair = Math.floor(flags / Math.pow(4, i)) % 4;
+                    if (pair & 1)
+                        t[binary_flag_names[i]] = (pair & 2) != 0;
+                }
+            }
+            for (var bit = 9; bit <= 13; ++bit)
+                if (mask & (1 << bit))
+                    t[binary_int_fields[bit]] = varint();
+            if (mask & (1 << 14))
+            {
+                t.flv = { f: varint() };
+                var special = varint();
+                if (special)
+                    t.flv.s = special;
+            }
+            if (mask & (1 << 15))
+            {
+                var n = varint();
+                t.ov = [];
+                for (var j = 0; j < n; ++j)
+                    t.ov.push(varint());
+            }
+
+            if (mask >= (1 << 4))
+                val.t = t;
+            merge(val);
+        }
+    }
+
     return {
         get: get,
         merge: merge_diff,
+        merge_binary: merge_binary,
         clear: clear,
         touch: touch,
         visible: visible,
@@ -7,7 +7,7 @@ import re
 
 import config
 
-from tornado.escape import json_decode, json_encode, xhtml_escape
+from tornado.escape import json_decode, json_encode, xhtml_escape, utf8
 from tornado.ioloop import PeriodicCallback, IOLoop
 
 from terminal import TerminalRecorder
@@ -138,12 +138,16 @@ class CrawlProcessHandlerBase(object):
             receiver.flush_messages()
 
     def write_to_all(self, msg, send):
+        # Encode once, rather than once per watcher.
+        msg = utf8(msg)
         for receiver in self._receivers:
             receiver.write_message(msg, send)
 
     def send_to_all(self, msg, **data):
+        data["msg"] = msg
+        encoded = utf8(json_encode(data))
         for receiver in self._receivers:
-            receiver.send_message(msg, **data)
+            receiver.write_message(encoded)
 
     def handle_chat_message(self, username, text):
         chat_msg = ("<span class='chat_sender'>%s</span>: <span class='chat_msg'>%s</span>" %
@@ -500,6 +504,8 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
 
         call = self._base_call() + ["-webtiles-socket", self.socketpath,
                                     "-await-connection"]
+        if hasattr(config, "stream_game_socket") and config.stream_game_socket:
+            call.append("-webtiles-stream")
 
         ttyrec_path = self.config_path("ttyrec_path")
         if ttyrec_path:
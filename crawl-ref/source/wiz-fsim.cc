@@ -8,6 +8,10 @@
 #include "wiz-fsim.h"
 
 #include <cerrno>
+#ifndef TARGET_OS_WINDOWS
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
 
 #include "beam.h"
 #include "bitary.h"
@@ -33,11 +37,13 @@
 #include "output.h"
 #include "player-equip.h"
 #include "player.h"
+#include "random.h"
 #include "ranged_attack.h"
 #include "skills.h"
 #include "species.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "throw.h"
 #include "unwind.h"
 #include "version.h"
@@ -45,9 +51,19 @@
 
 #ifdef WIZARD
 
-fight_data null_fight = {0.0, 0, 0, 0.0, 0, 0.0, 0.0};
+fight_data null_fight = {0.0, 0, 0, 0.0, 0, 0.0, 0.0, 0.0, 0, 0};
 typedef map<skill_type, int8_t> skill_map;
 
+// The raw results of some rounds of a fight, kept so that batches from
+// different workers can be merged.
+struct fight_tally
+{
+    int rounds = 0;
+    int hits = 0;
+    unsigned long long time_taken = 0;
+    map<int, int> damage; // damage in a round -> number of such rounds
+};
+
 static const char* _title_line =
     "AvHitDam | MaxDam | Accuracy | AvDam | AvTime | AvSpeed | AvEffDam"; // 64 columns
 static const char* _csv_title_line =
@@ -63,6 +79,16 @@ static string _fight_string(fight_data fdata, bool csv)
                         fdata.av_eff_dam);
 }
 
+// Columns about the spread of the results, only written to the output file.
+static const char* _stats_title_line = " |  DamCI | P95Dam |  Rounds";
+static const char* _csv_stats_title_line = "\tDamCI\tP95Dam\tRounds";
+
+static string _fight_stats_string(fight_data fdata, bool csv)
+{
+    return make_stringf(csv ? "\t%.2f\t%d\t%d" : " | %6.2f |    %3d | %7d",
+                        fdata.dam_ci, fdata.p95_dam, fdata.rounds);
+}
+
 static skill_type _equipped_skill()
 {
     const int weapon = you.equip[EQ_WEAPON];
@@ -327,14 +353,12 @@ static void _uninit_fsim(monster *mon)
     reset_training();
 }
 
-static fight_data _get_fight_data(monster &mon, int iter_limit, bool defend)
+// Run rounds of the fight, adding their results to the tally.
+static void _run_fight_rounds(monster &mon, const monster &orig, int iter_limit,
+                              bool defend, fight_tally &tally)
 {
-    const monster orig = mon;
-    unsigned int cumulative_damage = 0;
-    unsigned int time_taken = 0;
     int hits = 0;
-    fight_data fdata;
-    fdata.max_dam = 0;
+    unsigned long long time_taken = 0;
 
     const int weapon = you.equip[EQ_WEAPON];
     const item_def *iweap = weapon != -1 ? &you.inv[weapon] : nullptr;
@@ -398,10 +422,7 @@ static fight_data _get_fight_data(monster &mon, int iter_limit, bool defend)
             you.hunger = hunger;
             time_taken += you.time_taken * 10;
 
-            int damage = (mon.max_hit_points - mon.hit_points);
-            cumulative_damage += damage;
-            if (damage > fdata.max_dam)
-                fdata.max_dam = damage;
+            tally.damage[mon.max_hit_points - mon.hit_points]++;
         }
     }
     else // you're defending
@@ -415,12 +436,9 @@ static fight_data _get_fight_data(monster &mon, int iter_limit, bool defend)
 
             time_taken += 1000 / (mon.speed ? mon.speed : 10);
 
-            int damage = you.hp_max - you.hp;
             if (did_hit)
                 hits++;
-            cumulative_damage += damage;
-            if (damage > fdata.max_dam)
-                fdata.max_dam = damage;
+            tally.damage[you.hp_max - you.hp]++;
 
             // Re-place the combatants if they e.g. blinked away or were
             // trampled.
@@ -431,16 +449,200 @@ static fight_data _get_fight_data(monster &mon, int iter_limit, bool defend)
         you.hp_max = ymhp;
     }
 
-    fdata.av_hit_dam = hits ? double(cumulative_damage) / hits : 0.0;
-    fdata.accuracy = 100 * hits / iter_limit;
-    fdata.av_dam = double(cumulative_damage) / iter_limit;
-    fdata.av_time = double(time_taken) / iter_limit + 0.5; // round to nearest
-    fdata.av_speed = double(iter_limit) * 100 / time_taken;
+    tally.rounds += iter_limit;
+    tally.hits += hits;
+    tally.time_taken += time_taken;
+}
+
+static fight_data _fight_data_from_tally(const fight_tally &tally)
+{
+    const int rounds = tally.rounds;
+    const int hits = tally.hits;
+    double cumulative_damage = 0.0;
+    double damage_squares = 0.0;
+    for (const auto &entry : tally.damage)
+    {
+        cumulative_damage += double(entry.first) * entry.second;
+        damage_squares += double(entry.first) * entry.first * entry.second;
+    }
+
+    fight_data fdata;
+    fdata.max_dam = tally.damage.empty() ? 0 : tally.damage.rbegin()->first;
+    fdata.av_hit_dam = hits ? cumulative_damage / hits : 0.0;
+    fdata.accuracy = 100 * hits / rounds;
+    fdata.av_dam = cumulative_damage / rounds;
+    fdata.av_time = double(tally.time_taken) / rounds + 0.5; // round to nearest
+    fdata.av_speed = double(rounds) * 100 / tally.time_taken;
     fdata.av_eff_dam = fdata.av_dam * 100 / fdata.av_time;
 
+    // Normal approximation for the 95% confidence interval of av_dam.
+    const double variance = rounds > 1
+        ? max(0.0, (damage_squares - cumulative_damage * fdata.av_dam)
+                   / (rounds - 1))
+        : 0.0;
+    fdata.dam_ci = 1.96 * sqrt(variance / rounds);
+
+    fdata.p95_dam = 0;
+    int seen = 0;
+    for (const auto &entry : tally.damage)
+    {
+        seen += entry.second;
+        if (seen * 20 >= rounds * 19)
+        {
+            fdata.p95_dam = entry.first;
+            break;
+        }
+    }
+    fdata.rounds = rounds;
+
     return fdata;
 }
 
+#ifndef TARGET_OS_WINDOWS
+static string _fsim_worker_file(int job)
+{
+    return make_stringf("fsim.worker%d.tmp", job);
+}
+
+static bool _write_fight_tally(FILE *f, const fight_tally &tally)
+{
+    fprintf(f, "%d %d %llu %u\n", tally.rounds, tally.hits, tally.time_taken,
+            (unsigned int)tally.damage.size());
+    for (const auto &entry : tally.damage)
+        fprintf(f, "%d %d\n", entry.first, entry.second);
+    return !ferror(f);
+}
+
+static bool _merge_fight_tally(FILE *f, fight_tally &tally)
+{
+    int rounds, hits;
+    unsigned long long time_taken;
+    unsigned int n;
+    if (fscanf(f, "%d %d %llu %u\n", &rounds, &hits, &time_taken, &n) != 4)
+        return false;
+    tally.rounds += rounds;
+    tally.hits += hits;
+    tally.time_taken += time_taken;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        int damage, count;
+        if (fscanf(f, "%d %d\n", &damage, &count) != 2)
+            return false;
+        tally.damage[damage] += count;
+    }
+    return true;
+}
+
+// Split the rounds between forked workers, each with its own RNG stream,
+// and merge their tallies. A share that can't be farmed out is run here.
+static void _run_fight_rounds_in_workers(monster &mon, const monster &orig,
+                                         int iter_limit, bool defend,
+                                         int jobs, fight_tally &tally)
+{
+    const uint64_t base_seed = get_uint64();
+    vector<pid_t> workers;
+    fflush(stdout);
+    for (int job = 0; job < jobs; ++job)
+    {
+        const int rounds = iter_limit * (job + 1) / jobs
+                           - iter_limit * job / jobs;
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            uint64_t seed[2] = { base_seed, uint64_t(job) };
+            seed_rng(seed, ARRAYSZ(seed));
+            fight_tally part;
+            _run_fight_rounds(mon, orig, rounds, defend, part);
+            FILE *f = fopen_u(_fsim_worker_file(job).c_str(), "w");
+            if (!f)
+                _exit(1);
+            const bool ok = _write_fight_tally(f, part);
+            _exit(fclose(f) || !ok ? 1 : 0);
+        }
+        if (pid == -1)
+            _run_fight_rounds(mon, orig, rounds, defend, tally);
+        workers.push_back(pid);
+    }
+
+    for (int job = 0; job < jobs; ++job)
+    {
+        if (workers[job] == -1)
+            continue;
+
+        int status = 0;
+        waitpid(workers[job], &status, 0);
+        const string file = _fsim_worker_file(job);
+        FILE *f = fopen_u(file.c_str(), "r");
+        fight_tally part;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) || !f
+            || !_merge_fight_tally(f, part))
+        {
+            mprf(MSGCH_ERROR, "Fight simulation worker %d failed.", job);
+        }
+        else
+        {
+            tally.rounds += part.rounds;
+            tally.hits += part.hits;
+            tally.time_taken += part.time_taken;
+            for (const auto &entry : part.damage)
+                tally.damage[entry.first] += entry.second;
+        }
+        if (f)
+            fclose(f);
+        unlink_u(file.c_str());
+    }
+}
+#endif
+
+// Rounds are run in batches of this many when fsim_precision is set.
+#define FSIM_BATCH_ROUNDS 1000
+
+/**
+ * Simulate up to iter_limit rounds of the fight.
+ *
+ * With fsim_jobs, the rounds are split between that many worker processes.
+ * With fsim_precision, they are run in batches, stopping early once the 95%
+ * confidence interval of the average damage is within that many percent of
+ * it.
+ */
+static fight_data _get_fight_data(monster &mon, int iter_limit, bool defend)
+{
+    const monster orig = mon;
+    fight_tally tally;
+
+    const int batch = Options.fsim_precision ? FSIM_BATCH_ROUNDS : iter_limit;
+    while (tally.rounds < iter_limit)
+    {
+        const int rounds = min(batch, iter_limit - tally.rounds);
+        const int before = tally.rounds;
+#ifndef TARGET_OS_WINDOWS
+        if (Options.fsim_jobs > 1)
+        {
+            _run_fight_rounds_in_workers(mon, orig, rounds, defend,
+                                         Options.fsim_jobs, tally);
+        }
+        else
+#endif
+            _run_fight_rounds(mon, orig, rounds, defend, tally);
+
+        // Every worker failed; don't spin.
+        if (tally.rounds == before)
+            break;
+
+        if (Options.fsim_precision)
+        {
+            const fight_data fdata = _fight_data_from_tally(tally);
+            if (fdata.dam_ci * 100 <= fdata.av_dam * Options.fsim_precision)
+                break;
+        }
+    }
+
+    if (!tally.rounds)
+        return null_fight;
+
+    return _fight_data_from_tally(tally);
+}
+
 // this is the skeletal simulator call, and the one that's easily accessed
 void wizard_quick_fsim()
 {
@@ -529,9 +731,12 @@ static void _fsim_simple_scale(FILE * o, monster* mon, bool defense)
     const string title = make_stringf("%10.10s | %s", col_name.c_str(),
                                       _title_line);
     if (Options.fsim_csv)
-        fprintf(o, "%s\t%s\n", col_name.c_str(), _csv_title_line);
+    {
+        fprintf(o, "%s\t%s%s\n", col_name.c_str(), _csv_title_line,
+                _csv_stats_title_line);
+    }
     else
-        fprintf(o, "%s\n", title.c_str());
+        fprintf(o, "%s%s\n", title.c_str(), _stats_title_line);
 
     mpr(title);
 
@@ -552,10 +757,14 @@ static void _fsim_simple_scale(FILE * o, monster* mon, bool defense)
         const string line = make_stringf("        %2d | %s", i,
                                          _fight_string(fdata, false).c_str());
         mpr(line);
+        const string stats = _fight_stats_string(fdata, Options.fsim_csv);
         if (Options.fsim_csv)
-            fprintf(o, "%d\t%s\n", i, _fight_string(fdata, true).c_str());
+        {
+            fprintf(o, "%d\t%s%s\n", i, _fight_string(fdata, true).c_str(),
+                    stats.c_str());
+        }
         else
-            fprintf(o, "%s\n", line.c_str());
+            fprintf(o, "%s%s\n", line.c_str(), stats.c_str());
         fflush(o);
 
         // kill the loop if the user hits escape
@@ -15,6 +15,9 @@ struct fight_data
     int av_time;
     double av_speed;
     double av_eff_dam;
+    double dam_ci;      // half-width of the 95% confidence interval of av_dam
+    int p95_dam;        // 95th percentile of the damage per round
+    int rounds;
 };
 
 void wizard_quick_fsim();
@@ -229,6 +229,13 @@ namespace worley
             /* delta from feature point to sample location */
             dx=xi+fx-at[0];
             dy=yi+fy-at[1];
+
+            /* Most points are too far away already in the xy plane; since
+               dz*dz can only increase the sum, they can be skipped early
+               without changing the result. */
+            if (dx*dx+dy*dy>=F[max_order-1])
+                continue;
+
             dz=zi+fz-at[2];
 
             /* Distance computation!  Lots of interesting variations are